@@ -0,0 +1,91 @@
+/**
+ * @file usb_app.c
+ * @brief Contains application specific functions.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - USB Application file (This file is for the Audio Tone Example).
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+ 
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../../USB/usb.h"
+#include "../../../../USB/usb_app.h"
+#include "../../../../USB/usb_audio.h"
+
+
+bool usb_service_class_request(void)
+{
+    return audio_class_request();
+}
+
+
+bool usb_get_class_descriptor(const uint8_t** descriptor, uint16_t* size)
+{
+    return false;
+}
+
+
+void usb_app_init(void)
+{
+    audio_init();
+}
+
+
+void usb_app_tasks(void)
+{
+}
+
+
+void usb_app_clear_halt(uint8_t bd_table_index, uint8_t ep, uint8_t dir)
+{
+}
+
+
+bool usb_app_set_interface(uint8_t alternate_setting, uint8_t interface)
+{
+    return audio_set_interface(alternate_setting, interface);
+}
+
+
+bool usb_app_get_interface(uint8_t* alternate_setting_result, uint8_t interface)
+{
+    return audio_get_interface(alternate_setting_result, interface);
+}
+
+
+bool usb_out_control_finished(void)
+{
+    return audio_out_control_tasks();
+}
+
+
+uint16_t usb_iso_in(uint8_t ep, uint8_t** p_buffer)
+{
+    if(ep == AUDIO_EP) return audio_iso_in(p_buffer);
+    return 0;
+}
+
+
+void usb_iso_out(uint8_t ep, uint8_t* buffer, uint16_t cnt)
+{
+}
@@ -0,0 +1,281 @@
+/**
+ * @file usb_descriptors.h
+ * @brief Contains core USB stack descriptors stored in ROM.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - USB Stack (This file is for the Audio Tone Example).
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "usb_config.h"
+#include "usb_audio.h"
+#include "usb_ch9.h"
+
+/** Device Descriptor */
+const ch9_device_descriptor_t g_device_descriptor =
+{
+    0x12,           // bLength:8 -  Size of descriptor in bytes
+    DEVICE_DESC,    // bDescriptorType:8  - Device descriptor type
+    0x0200,         // bcdUSB:16 -  USB in BCD (2.0H)
+    0x00,           // bDeviceClass:8
+    0x00,           // bDeviceSubClass:8
+    0x00,           // bDeviceProtocol:8
+    EP0_SIZE,       // bMaxPacketSize0:8 - Maximum packet size
+    0x04D8,         // idVendor:16 - Microchip VID = 0x04D8
+    0x000C,         // idProduct:16 - Product ID (VID) = 0x000C
+    0x0001,         // bcdDevice:16 - Device release number in BCD
+    0x01,           // iManufacturer:8 - Manufacturer string index
+    0x02,           // iProduct:8 - Product string index
+    0x00,           // iSerialNumber:8 - Device serial number string index
+    0x01            // bNumConfigurations:8 - Number of possible configurations
+};
+
+/** AudioControl Class-Specific Descriptors Structure */
+typedef struct
+{
+    audio_ac_header_descriptor_t       header_descriptor;
+    audio_input_terminal_descriptor_t  input_terminal_descriptor;
+    audio_output_terminal_descriptor_t output_terminal_descriptor;
+}ac_descriptors_t;
+
+/** Configuration Descriptor Structure */
+typedef struct
+{
+    ch9_configutarion_descriptor_t      configuration0_descriptor;
+    ch9_standard_interface_descriptor_t interface0_descriptor;
+    ac_descriptors_t                    ac_descriptors;
+    ch9_standard_interface_descriptor_t interface1_alt0_descriptor;
+    ch9_standard_interface_descriptor_t interface1_alt1_descriptor;
+    audio_as_general_descriptor_t       as_general_descriptor;
+    audio_format_type_i_descriptor_t    format_descriptor;
+    audio_iso_endpoint_descriptor_t     ep1_in_descriptor;
+    audio_cs_iso_endpoint_descriptor_t  cs_ep1_in_descriptor;
+}config_descriptor_t;
+
+/** Configuration Descriptor */
+static const config_descriptor_t config_descriptor0 =
+{
+    // Configuration Descriptor
+    {
+        9,                          // bLength:8 - Size of configuration descriptor in bytes
+        CONFIGURATION_DESC,         // bDescriptorType:8 - Configuration descriptor type
+        sizeof(config_descriptor0), // wTotalLength:16 - Total amount of bytes in descriptors belonging to this configuration
+        0x02,                       // bNumInterfaces:8 - Number of interfaces in this configuration
+        0x01,                       // bConfigurationValue:8 - Index value for this configuration
+        0x00,                       // iConfiguration:8 - Index of string describing this configuration
+        0xC0,                       // bmAttributes:8 {0:5,RemoteWakeup:1,SelfPowered:1,1:1} - Self Powered
+        50                          // bMaxPower:8 - 100mA power allowed (increments of 2mA)
+    },
+
+    // AudioControl Interface Descriptor
+    {
+        9,                      // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC,         // bDescriptorType:8 - Interface descriptor type
+        AUDIO_AC_INT,           // bInterfaceNumber:8 - Index number of interface
+        0x00,                   // bAlternateSetting:8 - Value used to select alternate setting
+        0x00,                   // bNumEndpoints:8 - Number of endpoints used in this interface
+        0x01,                   // bInterfaceClass:8 - Class Code (Audio)
+        AUDIO_SUBCLASS_CONTROL, // bInterfaceSubClass:8 - Subclass Code (AudioControl)
+        0x00,                   // bInterfaceProtocol:8 - Protocol Code
+        0x00                    // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    {
+        // Class-Specific AC Interface Header Descriptor
+        {
+            9,                        // bLength:8 - Size of descriptor in bytes
+            AUDIO_CS_INTERFACE,       // bDescriptorType:8 - CS_INTERFACE
+            AUDIO_AC_HEADER,          // bDescriptorSubtype:8 - HEADER
+            0x0100,                   // bcdADC:16 - Audio Class 1.0
+            sizeof(ac_descriptors_t), // wTotalLength:16 - Size of the class-specific AC descriptors
+            0x01,                     // bInCollection:8 - Number of streaming interfaces
+            AUDIO_AS_INT              // baInterfaceNr:8 - AudioStreaming interface in the collection
+        },
+
+        // Input Terminal Descriptor
+        {
+            12,                         // bLength:8 - Size of descriptor in bytes
+            AUDIO_CS_INTERFACE,         // bDescriptorType:8 - CS_INTERFACE
+            AUDIO_AC_INPUT_TERMINAL,    // bDescriptorSubtype:8 - INPUT_TERMINAL
+            0x01,                       // bTerminalID:8 - ID of this terminal
+            AUDIO_TERMINAL_MICROPHONE,  // wTerminalType:16 - Microphone
+            0x00,                       // bAssocTerminal:8 - No associated terminal
+            AUDIO_CHANNELS,             // bNrChannels:8 - Number of channels
+            #if AUDIO_CHANNELS == 1
+            0x0000,                     // wChannelConfig:16 - Mono (no spatial location)
+            #else
+            0x0003,                     // wChannelConfig:16 - Left and right front
+            #endif
+            0x00,                       // iChannelNames:8 - Unused
+            0x00                        // iTerminal:8 - Unused
+        },
+
+        // Output Terminal Descriptor
+        {
+            9,                            // bLength:8 - Size of descriptor in bytes
+            AUDIO_CS_INTERFACE,           // bDescriptorType:8 - CS_INTERFACE
+            AUDIO_AC_OUTPUT_TERMINAL,     // bDescriptorSubtype:8 - OUTPUT_TERMINAL
+            0x02,                         // bTerminalID:8 - ID of this terminal
+            AUDIO_TERMINAL_USB_STREAMING, // wTerminalType:16 - USB streaming
+            0x00,                         // bAssocTerminal:8 - No associated terminal
+            0x01,                         // bSourceID:8 - Input terminal
+            0x00                          // iTerminal:8 - Unused
+        }
+    },
+
+    // AudioStreaming Interface Descriptor (alt 0, no bandwidth)
+    {
+        9,                        // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC,           // bDescriptorType:8 - Interface descriptor type
+        AUDIO_AS_INT,             // bInterfaceNumber:8 - Index number of interface
+        0x00,                     // bAlternateSetting:8 - Value used to select alternate setting
+        0x00,                     // bNumEndpoints:8 - Number of endpoints used in this interface
+        0x01,                     // bInterfaceClass:8 - Class Code (Audio)
+        AUDIO_SUBCLASS_STREAMING, // bInterfaceSubClass:8 - Subclass Code (AudioStreaming)
+        0x00,                     // bInterfaceProtocol:8 - Protocol Code
+        0x00                      // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    // AudioStreaming Interface Descriptor (alt 1, streaming)
+    {
+        9,                        // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC,           // bDescriptorType:8 - Interface descriptor type
+        AUDIO_AS_INT,             // bInterfaceNumber:8 - Index number of interface
+        0x01,                     // bAlternateSetting:8 - Value used to select alternate setting
+        0x01,                     // bNumEndpoints:8 - Number of endpoints used in this interface
+        0x01,                     // bInterfaceClass:8 - Class Code (Audio)
+        AUDIO_SUBCLASS_STREAMING, // bInterfaceSubClass:8 - Subclass Code (AudioStreaming)
+        0x00,                     // bInterfaceProtocol:8 - Protocol Code
+        0x00                      // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    // Class-Specific AS Interface Descriptor
+    {
+        7,                  // bLength:8 - Size of descriptor in bytes
+        AUDIO_CS_INTERFACE, // bDescriptorType:8 - CS_INTERFACE
+        AUDIO_AS_GENERAL,   // bDescriptorSubtype:8 - AS_GENERAL
+        0x02,               // bTerminalLink:8 - Output terminal
+        0x01,               // bDelay:8 - Frames of delay
+        AUDIO_FORMAT_PCM    // wFormatTag:16 - PCM
+    },
+
+    // Type I Format Type Descriptor
+    {
+        14,                                        // bLength:8 - Size of descriptor in bytes
+        AUDIO_CS_INTERFACE,                        // bDescriptorType:8 - CS_INTERFACE
+        AUDIO_AS_FORMAT_TYPE,                      // bDescriptorSubtype:8 - FORMAT_TYPE
+        AUDIO_FORMAT_TYPE_I,                       // bFormatType:8 - FORMAT_TYPE_I
+        AUDIO_CHANNELS,                            // bNrChannels:8 - Number of channels
+        0x02,                                      // bSubframeSize:8 - Bytes per sample
+        16,                                        // bBitResolution:8 - Bits per sample
+        0x00,                                      // bSamFreqType:8 - Continuous range
+        {AUDIO_RATE_BYTES(AUDIO_MIN_SAMPLE_RATE)}, // tLowerSamFreq:24 - Lowest sample rate
+        {AUDIO_RATE_BYTES(AUDIO_MAX_SAMPLE_RATE)}  // tUpperSamFreq:24 - Highest sample rate
+    },
+
+    // Endpoint Descriptor
+    {
+        9,                   // bLength:8 - Size of EP descriptor in bytes
+        ENDPOINT_DESC,       // bDescriptorType:8 - Endpoint Descriptor Type
+        AUDIO_EP | 0x80,     // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
+        AUDIO_EP_ATTRIBUTES, // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes (Isochronous, Asynchronous)
+        AUDIO_EP_SIZE,       // wMaxPacketSize:16 - Maximum packet size for this endpoint
+        0x01,                // bInterval:8 - Interval (every frame)
+        0x00,                // bRefresh:8 - Unused
+        0x00                 // bSynchAddress:8 - No synch EP
+    },
+
+    // Class-Specific Endpoint Descriptor
+    {
+        7,                              // bLength:8 - Size of descriptor in bytes
+        AUDIO_CS_ENDPOINT,              // bDescriptorType:8 - CS_ENDPOINT
+        AUDIO_EP_GENERAL,               // bDescriptorSubtype:8 - EP_GENERAL
+        AUDIO_EP_SAMPLING_FREQ_CONTROL, // bmAttributes:8 - Sampling frequency control
+        0x00,                           // bLockDelayUnits:8 - Unused
+        0x0000                          // wLockDelay:16 - Unused
+    }
+};
+
+/** Configuration Descriptor Addresses Array */
+const uint16_t g_config_descriptors[] = 
+{
+    (uint16_t)&config_descriptor0
+};
+
+/** String Zero Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t wLANGID[1];
+}string_zero_descriptor_t;
+
+/** Vendor String Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bString[6];
+}vendor_string_descriptor_t;
+
+/** Product String Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bString[10];
+}product_string_descriptor_t;
+    
+/** String Zero Descriptor */
+static const string_zero_descriptor_t string_zero_descriptor =
+{
+    sizeof(string_zero_descriptor_t),
+    STRING_DESC,
+    {0x0409}
+};
+
+/** Vendor String Descriptor */
+static const vendor_string_descriptor_t vendor_string_descriptor =
+{
+    sizeof(vendor_string_descriptor_t),
+    STRING_DESC,
+    {'J','o','h','n','n','y'}
+};
+
+/** Product String Descriptor */
+static const product_string_descriptor_t product_string_descriptor =
+{
+    sizeof(product_string_descriptor_t),
+    STRING_DESC,
+    {'A','u','d','i','o',' ','T','o','n','e'}
+};
+
+/** String Descriptor Addresses Array */
+const uint16_t g_string_descriptors[] =
+{
+    (uint16_t)&string_zero_descriptor,
+    (uint16_t)&vendor_string_descriptor,
+    (uint16_t)&product_string_descriptor
+};
+
+/** String Descriptor Addresses Array Size */
+const uint8_t g_size_of_sd = sizeof(g_string_descriptors);
@@ -267,31 +267,40 @@ static void flash_led(void)
 }
 #endif
 
-void cdc_set_control_line_state(void)
+void cdc_set_control_line_state(uint8_t port)
 {
 
 }
 
-void cdc_set_line_coding(void)
+void cdc_set_line_coding(uint8_t port)
 {
     
 }
 
-void cdc_data_out(void)
+void cdc_data_out(uint8_t port)
 {
     m_serial_pkt_rcv = true;
 }
 
-void cdc_data_in(void)
+void cdc_data_in(uint8_t port)
 {
     m_serial_pkt_sent = true;
 }
 
-void cdc_notification(void)
+void cdc_notification(uint8_t port)
 {
 
 }
 
+#ifdef USE_SOF
+void usb_sof(void)
+{
+    #if defined(USE_DTR) || defined(USE_DCD)
+    cdc_sof();
+    #endif
+}
+#endif
+
 static void serial_print_string(char* string)
 {
     uint8_t i = 0;
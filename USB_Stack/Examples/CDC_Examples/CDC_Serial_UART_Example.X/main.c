@@ -103,24 +103,45 @@ static void example_init(void);
 static void flash_led(void);
 #endif
 static void __interrupt() isr(void);
-static void vcp_tasks(void);
-static void uart_tx_byte(void);
-static void copy_ep_out_to_tx_buffer(void);
-static void copy_rx_buffer_to_ep_in(void);
+static void vcp_tasks(uint8_t port);
+static void copy_ep_out_to_tx_buffer(uint8_t port);
+static void copy_rx_buffer_to_ep_in(uint8_t port);
+static void debug_tasks(void);
+static void debug_write(const char* string);
+static void debug_write_u32(uint32_t value);
 
-#define RX_BUFFER_SIZE 64
-#define TX_BUFFER_SIZE 64
+#define RX_BUFFER_SIZE    64
+#define TX_BUFFER_SIZE    64
+#define DEBUG_BUFFER_SIZE 64
 
-static bool volatile m_serial_pkt_sent = true;
-static bool volatile m_serial_pkt_rcv = false;
+// CDC port n is UART n, the port after them is a debug channel.
+#define DEBUG_PORT NUM_UARTS
 
-static uint8_t m_rx_buffer[RX_BUFFER_SIZE];
-static uint8_t m_rx_index = 0;
-static bool volatile m_rx_buffer_almost_full = false;
+#if CDC_NUM_PORTS != (NUM_UARTS + 1)
+#error "This example needs a CDC port for each UART and one for debug, check CDC_UART_EXAMPLE is defined."
+#endif
+
+// A CDC port bridged to a UART.
+typedef struct
+{
+    volatile bool Pkt_Sent;
+    volatile bool Pkt_Rcv;
+    volatile bool Baud_Changed;
+    uint32_t      Baud;
+    uint8_t       Rx_Buffer[RX_BUFFER_SIZE];
+    uint8_t       Rx_Index;
+    uint8_t       Tx_Buffer[TX_BUFFER_SIZE];
+    uint8_t       Tx_Index;
+    uint8_t       Tx_To_Cpy;
+}vcp_t;
+
+static vcp_t m_vcp[NUM_UARTS];
+static bool volatile m_rx_buffer_almost_full = false; // UART 0 only, it has the RTS line.
 
-static uint8_t m_tx_buffer[TX_BUFFER_SIZE];
-static uint8_t m_tx_index = 0;
-static uint8_t m_tx_to_cpy = 0;
+static bool volatile m_debug_pkt_sent = true;
+static bool volatile m_debug_pkt_rcv = false;
+static uint8_t m_debug_buffer[DEBUG_BUFFER_SIZE];
+static uint8_t m_debug_index = 0;
 
 void main(void)
 {
@@ -131,7 +152,11 @@ void main(void)
     flash_led();
 	#endif
     
-    uart__init(0);
+    for(uint8_t port = 0; port < NUM_UARTS; port++)
+    {
+        uart__init(port);
+        m_vcp[port].Pkt_Sent = true;
+    }
     
     // Make UART pins digital.
     #if defined(_18F13K50) || defined(_18F14K50)
@@ -151,7 +176,8 @@ void main(void)
     while(1)
     {
         while(usb_get_state() < STATE_CONFIGURED){} // Pause if not configured or suspended.
-        vcp_tasks();
+        for(uint8_t port = 0; port < NUM_UARTS; port++) vcp_tasks(port);
+        debug_tasks();
     }
     
     return;
@@ -283,8 +309,9 @@ static void flash_led(void)
 }
 #endif
 
-void cdc_set_control_line_state(void)
+void cdc_set_control_line_state(uint8_t port)
 {
+    if(port != 0) return; // Only UART 0 has handshake lines.
     #ifdef USE_RTS
     g_cdc_has_set_rts = g_cdc_set_control_line_state.RTS_bit ? true : false;
     
@@ -296,116 +323,202 @@ void cdc_set_control_line_state(void)
     #endif
 }
 
-void cdc_set_line_coding(void)
+void cdc_set_line_coding(uint8_t port)
 {
-    uint16_t calc_SPBRG = (uint16_t)((_XTAL_FREQ / (g_cdc_set_line_coding.dwDTERate << 2)) - 1);
-    SPBRG  = (uint8_t)calc_SPBRG;
-    SPBRGH = (uint8_t)(calc_SPBRG >> 8);
+    uint16_t calc_SPBRG;
+    
+    if(port == DEBUG_PORT) return; // No UART behind it, any line coding will do.
+    calc_SPBRG = (uint16_t)((_XTAL_FREQ / (g_cdc_set_line_coding.dwDTERate << 2)) - 1);
+    if(port == 0)
+    {
+        SPBRG  = (uint8_t)calc_SPBRG;
+        SPBRGH = (uint8_t)(calc_SPBRG >> 8);
+    }
+    #if NUM_UARTS >= 2
+    else
+    {
+        SPBRG2  = (uint8_t)calc_SPBRG;
+        SPBRGH2 = (uint8_t)(calc_SPBRG >> 8);
+    }
+    #endif
+    m_vcp[port].Baud = g_cdc_set_line_coding.dwDTERate;
+    m_vcp[port].Baud_Changed = true; // Reported on the debug port.
 }
 
-void cdc_data_out(void)
+void cdc_data_out(uint8_t port)
 {
-    m_serial_pkt_rcv = true;
+    if(port == DEBUG_PORT) m_debug_pkt_rcv = true;
+    else m_vcp[port].Pkt_Rcv = true;
 }
 
-void cdc_data_in(void)
+void cdc_data_in(uint8_t port)
 {
-    m_serial_pkt_sent = true;
+    if(port == DEBUG_PORT) m_debug_pkt_sent = true;
+    else m_vcp[port].Pkt_Sent = true;
 }
 
-void cdc_notification(void)
+void cdc_notification(uint8_t port)
+{
+
+}
+
+#ifdef USE_SOF
+void usb_sof(void)
 {
     #if defined(USE_DTR) || defined(USE_DCD)
-    g_cdc_sent_last_notification = true;
+    cdc_sof();
     #endif
 }
+#endif
 
-static void vcp_tasks(void)
+static void vcp_tasks(uint8_t port)
 {
-    // If UART packet received, add to m_rx_buffer.
-    if(PIR1bits.RCIF)
+    vcp_t *p_vcp = &m_vcp[port];
+    #if defined(USE_DTR) || defined(USE_DCD)
+    uint8_t line_state;
+    #endif
+    
+    // If UART packet received, add to Rx_Buffer.
+    if(uart__data_ready(port))
     {
         #ifdef USE_RTS
-        if(m_rx_index == RX_BUFFER_SIZE - 5) // If buffer is almost full
+        if(port == 0 && p_vcp->Rx_Index == RX_BUFFER_SIZE - 5) // If buffer is almost full
         {
             m_rx_buffer_almost_full = true;
             RTS = RTS_ACTIVE ^ 1;
         }
         #endif
-        if(m_rx_index < RX_BUFFER_SIZE) m_rx_buffer[m_rx_index++] = uart__read(0); // If m_rx_index is not out of bounds, read the Rx data and put in buffer.
-    }                                                                              // If this is false (buffer is full) data will be lost.
+        if(p_vcp->Rx_Index < RX_BUFFER_SIZE) p_vcp->Rx_Buffer[p_vcp->Rx_Index++] = uart__read(port); // If Rx_Index is not out of bounds, read the Rx data and put in buffer.
+        else uart__read(port);                                                                         // If the buffer is full the data is lost.
+    }
 
-    // If there is data in m_rx_buffer and USB is not busy, send it.
-    if(m_serial_pkt_sent && m_rx_index)
+    // If there is data in Rx_Buffer and USB is not busy, send it.
+    if(p_vcp->Pkt_Sent && p_vcp->Rx_Index)
     {
-        m_serial_pkt_sent = false;
-        copy_rx_buffer_to_ep_in();
+        p_vcp->Pkt_Sent = false;
+        copy_rx_buffer_to_ep_in(port);
         #ifdef USE_RTS
-        if(g_cdc_has_set_rts) RTS = RTS_ACTIVE;
-        m_rx_buffer_almost_full = false;
+        if(port == 0)
+        {
+            if(g_cdc_has_set_rts) RTS = RTS_ACTIVE;
+            m_rx_buffer_almost_full = false;
+        }
         #endif
     }
 
     // If serial data was received on the CDC endpoint, and UART currently has no data to send.
-    if(m_serial_pkt_rcv && !m_tx_to_cpy)
+    if(p_vcp->Pkt_Rcv && !p_vcp->Tx_To_Cpy)
     {
-        m_serial_pkt_rcv = false; // Reset m_serial_pkt_rcv.
-        copy_ep_out_to_tx_buffer();
-        cdc_arm_data_ep_out();
+        p_vcp->Pkt_Rcv = false; // Reset Pkt_Rcv.
+        copy_ep_out_to_tx_buffer(port);
+        cdc_port_arm_data_ep_out(port);
     }
 
-    // If there is data in m_tx_buffer, send one byte over UART.
-    if(m_tx_to_cpy)
+    // If there is data in Tx_Buffer and the UART is free, send one byte.
+    if(p_vcp->Tx_To_Cpy && uart__tx_idle(port))
     {
         #if defined(USE_RTS) && !defined(USE_DTR)
         // Block if CTS is not active.
-        if(CTS == CTS_ACTIVE) uart_tx_byte();
+        if(port != 0 || CTS == CTS_ACTIVE)
         #elif !defined(USE_RTS) && defined(USE_DTR)
         // Block if DSR is not active.
-        if(DSR == DSR_ACTIVE) uart_tx_byte();
+        if(port != 0 || DSR == DSR_ACTIVE)
         #elif defined(USE_RTS) && defined(USE_DTR)
         // Block if either CTS or DSR is not active.
-        if(CTS == CTS_ACTIVE && DSR == DSR_ACTIVE) uart_tx_byte();
-        #else
-        uart_tx_byte();
+        if(port != 0 || (CTS == CTS_ACTIVE && DSR == DSR_ACTIVE))
         #endif
+        {
+            uart__write(port, p_vcp->Tx_Buffer[p_vcp->Tx_Index++]);
+            p_vcp->Tx_To_Cpy--;
+        }
     }
 
+    #if defined(USE_DTR) || defined(USE_DCD)
+    if(port != 0) return;
+    // Report DSR and DCD, bouncing lines are merged by cdc_notification_tasks().
+    line_state = CDC_STATE_RX_CARRIER | CDC_STATE_TX_CARRIER;
     #ifdef USE_DTR
-    if((DSR ^ DSR_ACTIVE) == g_cdc_serial_state.bTxCarrier) // Detect change on DSR.
-    {
-        g_cdc_serial_state.bTxCarrier ^= 1;
-        g_cdc_send_notification = true;
-    }
+    if(DSR != DSR_ACTIVE) line_state &= ~CDC_STATE_TX_CARRIER;
     #endif
     #ifdef USE_DCD
-    if((DCD ^ DCD_ACTIVE) == g_cdc_serial_state.bRxCarrier) // Detect change on DCD.
-    {
-        g_cdc_serial_state.bRxCarrier ^= 1;
-        g_cdc_send_notification = true;
-    }
+    if(DCD != DCD_ACTIVE) line_state &= ~CDC_STATE_RX_CARRIER;
     #endif
-    #if defined(USE_DTR) || defined(USE_DCD)
+    cdc_set_serial_state(0, line_state);
     cdc_notification_tasks();
     #endif
 }
 
-static void uart_tx_byte(void)
+static void copy_ep_out_to_tx_buffer(uint8_t port)
 {
-    uart__write(0, m_tx_buffer[m_tx_index++]);
-    m_tx_to_cpy--;
+    vcp_t *p_vcp = &m_vcp[port];
+    
+    p_vcp->Tx_To_Cpy = g_usb_bd_table[g_cdc_ports[port].Dat_BD_Out].CNT; // Number of bytes to grab from EP, g_cdc_num_data_out may be another port's by now.
+    p_vcp->Tx_Index  = 0;                                                  // Reset Tx_Index.
+    usb_ram_copy(g_cdc_ports[port].Dat_EP_Out, p_vcp->Tx_Buffer, p_vcp->Tx_To_Cpy); // Copy from endpoint to Tx_Buffer.
 }
 
-static void copy_ep_out_to_tx_buffer(void)
+static void copy_rx_buffer_to_ep_in(uint8_t port)
 {
-    m_tx_to_cpy = g_cdc_num_data_out;        // Number of bytes to grab from EP.
-    m_tx_index = 0;                          // Reset m_tx_index.
-    usb_ram_copy(g_cdc_dat_ep_out, m_tx_buffer, m_tx_to_cpy); // Copy from endpoint to m_tx_buffer.
+    vcp_t *p_vcp = &m_vcp[port];
+    
+    usb_ram_copy(p_vcp->Rx_Buffer, g_cdc_ports[port].Dat_EP_In, p_vcp->Rx_Index);
+    cdc_port_arm_data_ep_in(port, p_vcp->Rx_Index);
+    p_vcp->Rx_Index = 0;
 }
 
-static void copy_rx_buffer_to_ep_in(void)
+static void debug_tasks(void)
 {
-    usb_ram_copy(m_rx_buffer, g_cdc_dat_ep_in, m_rx_index);
-    cdc_arm_data_ep_in(m_rx_index);
-    m_rx_index = 0;
+    uint8_t count;
+    
+    // Echo what the host sends, text lands in the same buffer as reports.
+    if(m_debug_pkt_rcv)
+    {
+        m_debug_pkt_rcv = false;
+        count = g_usb_bd_table[g_cdc_ports[DEBUG_PORT].Dat_BD_Out].CNT;
+        if(count > DEBUG_BUFFER_SIZE - m_debug_index) count = DEBUG_BUFFER_SIZE - m_debug_index; // Dropped if full.
+        usb_ram_copy(g_cdc_ports[DEBUG_PORT].Dat_EP_Out, &m_debug_buffer[m_debug_index], count);
+        m_debug_index += count;
+        cdc_port_arm_data_ep_out(DEBUG_PORT);
+    }
+    
+    // Report baud rate changes of the UART ports.
+    for(uint8_t port = 0; port < NUM_UARTS; port++)
+    {
+        if(!m_vcp[port].Baud_Changed) continue;
+        m_vcp[port].Baud_Changed = false;
+        debug_write("UART");
+        debug_write_u32(port);
+        debug_write(" baud ");
+        debug_write_u32(m_vcp[port].Baud);
+        debug_write("\r\n");
+    }
+    
+    if(m_debug_pkt_sent && m_debug_index)
+    {
+        m_debug_pkt_sent = false;
+        count = m_debug_index < CDC_DAT_EP_SIZE ? m_debug_index : CDC_DAT_EP_SIZE;
+        usb_ram_copy(m_debug_buffer, g_cdc_ports[DEBUG_PORT].Dat_EP_In, count);
+        cdc_port_arm_data_ep_in(DEBUG_PORT, count);
+        m_debug_index -= count;
+        usb_ram_copy(&m_debug_buffer[count], m_debug_buffer, m_debug_index);
+    }
+}
+
+static void debug_write(const char* string)
+{
+    while(*string && m_debug_index < DEBUG_BUFFER_SIZE) m_debug_buffer[m_debug_index++] = (uint8_t)*string++;
+}
+
+static void debug_write_u32(uint32_t value)
+{
+    char digits[11];
+    uint8_t i = sizeof(digits) - 1;
+    
+    digits[i] = 0;
+    do
+    {
+        digits[--i] = (char)('0' + (value % 10));
+        value /= 10;
+    }while(value);
+    debug_write(&digits[i]);
 }
\ No newline at end of file
@@ -68,18 +68,7 @@ bool usb_app_set_interface(uint8_t alternate_setting, uint8_t interface)
 #if NUM_ALT_INTERFACES != 0
     if(g_set_interface.Interface < NUM_INTERFACES) return true;
 #else
-    if(alternate_setting == 0 && interface == 0)
-    {
-        CDC_COM_EP_IN_DATA_TOGGLE_VAL = 0;
-        return true;
-    }
-    else if(alternate_setting == 0 && interface == 1)
-    {
-        CDC_DAT_EP_OUT_DATA_TOGGLE_VAL = 0;
-        CDC_DAT_EP_IN_DATA_TOGGLE_VAL = 0;
-        return true;
-    }
-    return false;
+    return cdc_set_interface(alternate_setting, interface);
 #endif
 }
 
@@ -56,12 +56,24 @@
 #define PINGPONG_MODE     PINGPONG_0_OUT
 
 #define NUM_CONFIGURATIONS 1
+#ifdef CDC_UART_EXAMPLE
+#include "uart_settings.h"
+#define NUM_INTERFACES     ((NUM_UARTS + 1) * 2)     // Two for each CDC port (see CDC_NUM_PORTS).
+#define NUM_ALT_INTERFACES 0
+#define NUM_ENDPOINTS      (((NUM_UARTS + 1) * 2) + 1)
+#else
 #define NUM_INTERFACES     2
 #define NUM_ALT_INTERFACES 0
 #define NUM_ENDPOINTS      3
+#endif
 #define EP0_SIZE           8
 #define EP1_SIZE           10
+#if defined(CDC_UART_EXAMPLE) && (defined(_18F13K50) || defined(_18F14K50) || defined(_18F2450) || defined(_18F4450) || \
+    defined(_18F26J53) || defined(_18F46J53) || defined(_18F27J53) || defined(_18F47J53))
+#define EP2_SIZE           32 // Smaller USB RAM, room for the UART and debug ports' buffers.
+#else
 #define EP2_SIZE           64
+#endif
 
 /* ************************************************************************** */
 
@@ -81,14 +93,14 @@
  * _URSTIE  - USB Reset Interrupt (Mandatory)
  */
 
-#define INTERRUPTS_MASK (_IDLEIE | _TRNIE | _ACTVIE | _URSTIE)
+#define INTERRUPTS_MASK (_IDLEIE | _TRNIE | _ACTVIE | _URSTIE | _SOFIE)
 #define ERROR_INTERRUPT_MASK 0
 
 //#define USE_RESET
 //#define USE_ERROR
 //#define USE_IDLE
 //#define USE_ACTIVITY
-//#define USE_SOF
+#define USE_SOF // Paces SERIAL_STATE notifications (CDC_NOTIFICATION_INTERVAL).
 #define USE_OUT_CONTROL_FINISHED
 
 /* ************************************************************************** */
@@ -36,9 +36,15 @@ const ch9_device_descriptor_t g_device_descriptor =
     0x12,           // bLength:8 -  Size of descriptor in bytes
     DEVICE_DESC,    // bDescriptorType:8  - Device descriptor type
     0x0200,         // bcdUSB:16 -  USB in BCD (2.0H)
+#if CDC_NUM_PORTS > 1
+    MISC,                 // bDeviceClass:8 - Functions are grouped by IADs
+    MISC_SUBCLASS_COMMON, // bDeviceSubClass:8
+    MISC_PROTOCOL_IAD,    // bDeviceProtocol:8
+#else
     CDC_CLASS,      // bDeviceClass:8
     0x00,           // bDeviceSubClass:8
     0x00,           // bDeviceProtocol:8
+#endif
     EP0_SIZE,       // bMaxPacketSize0:8 - Maximum packet size
     0x04D8,         // idVendor:16 - Microchip VID = 0x04D8
     0x000A,         // idProduct:16 - Product ID (VID)
@@ -49,21 +55,120 @@ const ch9_device_descriptor_t g_device_descriptor =
     0x01            // bNumConfigurations:8 - Number of possible configurations
 };
 
-/** Configuration Descriptor Structure */
+/** CDC-ACM Function Descriptors Structure (one per port) */
 typedef struct
 {
-    ch9_configutarion_descriptor_t         configuration0_descriptor;
-    ch9_standard_interface_descriptor_t    interface0_descriptor;
+#if CDC_NUM_PORTS > 1
+    ch9_interface_association_descriptor_t iad_descriptor;
+#endif
+    ch9_standard_interface_descriptor_t    com_interface_descriptor;
     cdc_header_functional_descriptor_t     cdc_header_descriptor;
     cdc_acm_functional_descriptor_t        cdc_acm_descriptor;
     cdc_union_functional_descriptor_t      cdc_union_descriptor;
     cdc_cm_functional_descriptor_t         cdc_cm_descriptor;
-    ch9_standard_endpoint_descriptor_t     ep1_in_descriptor;
-    ch9_standard_interface_descriptor_t    interface1_descriptor;
-    ch9_standard_endpoint_descriptor_t     ep2_out_descriptor;
-    ch9_standard_endpoint_descriptor_t     ep2_in_descriptor;
+    ch9_standard_endpoint_descriptor_t     com_ep_in_descriptor;
+    ch9_standard_interface_descriptor_t    dat_interface_descriptor;
+    ch9_standard_endpoint_descriptor_t     dat_ep_out_descriptor;
+    ch9_standard_endpoint_descriptor_t     dat_ep_in_descriptor;
+}cdc_acm_function_descriptor_t;
+
+/** Configuration Descriptor Structure */
+typedef struct
+{
+    ch9_configutarion_descriptor_t configuration0_descriptor;
+    cdc_acm_function_descriptor_t  cdc_port_descriptor[CDC_NUM_PORTS];
 }config_descriptor_t;
 
+#if CDC_NUM_PORTS > 1
+#define CDC_IAD(com_int)                                                       \
+    {                                                                          \
+        8,                          /* bLength:8 */                            \
+        INTERFACE_ASSOCIATION_DESC, /* bDescriptorType:8 */                    \
+        com_int,                    /* bFirstInterface:8 - COM interface */    \
+        2,                          /* bInterfaceCount:8 - COM and DAT */      \
+        CIC_CODE,                   /* bFunctionClass:8 */                     \
+        CIC_ACM,                    /* bFunctionSubClass:8 */                  \
+        CIC_V25TER,                 /* bFunctionProtocol:8 */                  \
+        0x00                        /* iFunction:8 */                          \
+    },
+#else
+#define CDC_IAD(com_int)
+#endif
+
+/** CDC-ACM Function Descriptors (one per port) */
+#define CDC_ACM_FUNCTION(com_int, dat_int, com_ep, dat_ep)                     \
+{                                                                              \
+    CDC_IAD(com_int)                                                           \
+                                                                               \
+    /* COM Interface Descriptor */                                             \
+    {                                                                          \
+        9,              /* bLength:8 */                                        \
+        INTERFACE_DESC, /* bDescriptorType:8 */                                \
+        com_int,        /* bInterfaceNumber:8 */                               \
+        0x00,           /* bAlternateSetting:8 */                              \
+        0x01,           /* bNumEndpoints:8 */                                  \
+        CIC_CODE,       /* bInterfaceClass:8 */                                \
+        CIC_ACM,        /* bInterfaceSubClass:8 */                             \
+        CIC_V25TER,     /* bInterfaceProtocol:8 */                             \
+        0x00            /* iInterface:8 */                                     \
+    },                                                                         \
+                                                                               \
+    /* Header Functional Descriptor */                                         \
+    {5, CS_INTERFACE, DESC_SUB_HEADER, 0x0110},                                \
+                                                                               \
+    /* Abstract Control Management Functional Descriptor */                    \
+    {4, CS_INTERFACE, DESC_SUB_ACM, 0x02},                                     \
+                                                                               \
+    /* Union Functional Descriptor */                                          \
+    {5, CS_INTERFACE, DESC_SUB_UNION, com_int, {dat_int}},                     \
+                                                                               \
+    /* Call Management Functional Descriptor */                                \
+    {5, CS_INTERFACE, DESC_SUB_CM, 0x00, dat_int},                             \
+                                                                               \
+    /* COM EP IN Descriptor */                                                 \
+    {                                                                          \
+        7,               /* bLength:8 */                                       \
+        ENDPOINT_DESC,   /* bDescriptorType:8 */                               \
+        0x80 | com_ep,   /* bEndpointAddress:8 */                              \
+        0x03,            /* bmAttributes:8 - Interrupt */                      \
+        CDC_COM_EP_SIZE, /* wMaxPacketSize:16 */                               \
+        0x02             /* bInterval:8 */                                     \
+    },                                                                         \
+                                                                               \
+    /* DAT Interface Descriptor */                                             \
+    {                                                                          \
+        9,              /* bLength:8 */                                        \
+        INTERFACE_DESC, /* bDescriptorType:8 */                                \
+        dat_int,        /* bInterfaceNumber:8 */                               \
+        0x00,           /* bAlternateSetting:8 */                              \
+        0x02,           /* bNumEndpoints:8 */                                  \
+        DIC_CODE,       /* bInterfaceClass:8 */                                \
+        0x00,           /* bInterfaceSubClass:8 */                             \
+        DIC_NONE,       /* bInterfaceProtocol:8 */                             \
+        0x00            /* iInterface:8 */                                     \
+    },                                                                         \
+                                                                               \
+    /* DAT EP OUT Descriptor */                                                \
+    {                                                                          \
+        7,               /* bLength:8 */                                       \
+        ENDPOINT_DESC,   /* bDescriptorType:8 */                               \
+        dat_ep,          /* bEndpointAddress:8 */                              \
+        0x02,            /* bmAttributes:8 - Bulk */                           \
+        CDC_DAT_EP_SIZE, /* wMaxPacketSize:16 */                               \
+        0x00             /* bInterval:8 */                                     \
+    },                                                                         \
+                                                                               \
+    /* DAT EP IN Descriptor */                                                 \
+    {                                                                          \
+        7,               /* bLength:8 */                                       \
+        ENDPOINT_DESC,   /* bDescriptorType:8 */                               \
+        0x80 | dat_ep,   /* bEndpointAddress:8 */                              \
+        0x02,            /* bmAttributes:8 - Bulk */                           \
+        CDC_DAT_EP_SIZE, /* wMaxPacketSize:16 */                               \
+        0x00             /* bInterval:8 */                                     \
+    }                                                                          \
+}
+
 /** Configuration Descriptor */
 static const config_descriptor_t config_descriptor0 =
 {
@@ -71,102 +176,23 @@ static const config_descriptor_t config_descriptor0 =
     {
         9,                          // bLength:8 - Size of configuration descriptor in bytes
         CONFIGURATION_DESC,         // bDescriptorType:8 - Configuration descriptor type
-        sizeof(config_descriptor0), // wTotalLength:16 - Total amount of bytes in descriptors belonging to this configuration    //0x34
-        0x02,                       // bNumInterfaces:8 - Number of interfaces in this configuration
+        sizeof(config_descriptor0), // wTotalLength:16 - Total amount of bytes in descriptors belonging to this configuration
+        CDC_NUM_PORTS * 2,          // bNumInterfaces:8 - Number of interfaces in this configuration
         0x01,                       // bConfigurationValue:8 - Index value for this configuration
         0x00,                       // iConfiguration:8 - Index of string describing this configuration
         0xC0,                       // bmAttributes:8 {0:5,RemoteWakeup:1,SelfPowered:1,1:1}
         50                          // bMaxPower:8 - 100mA power allowed (increments of 2mA)
     },
 
-    // Interface0 Descriptor
-    {
-        9,              // bLength:8 - Size of interface descriptor in bytes           
-        INTERFACE_DESC, // bDescriptorType:8 - Interface descriptor type
-        0x00,           // bInterfaceNumber:8 - Index number of interface
-        0x00,           // bAlternateSetting:8 - Value used to select alternate setting
-        0x01,           // bNumEndpoints:8 - Number of endpoints used in this interface
-        CIC_CODE,       // bInterfaceClass:8 - Class Code (Assigned by USB Org)                       *0x08 is MSD*
-        CIC_ACM,        // bInterfaceSubClass:8 - Subclass Code (Assigned by USB Org)                 *0x01 if Boot Interface Subclass*
-        CIC_V25TER,     // bInterfaceProtocol:8 - Protocol Code (Assigned by USB Org)                 *0x01 is Keyboard protocol*
-        0x00            // iInterface:8 - Index of String Descriptor Describing this interface
-    },
-    
-    // Header Functional Descriptor
-    {
-        5,
-        CS_INTERFACE,
-        DESC_SUB_HEADER,
-        0x0110
-    },
-    
-    // Abstract Control Management Functional Descriptor
-    {
-        4,
-        CS_INTERFACE,
-        DESC_SUB_ACM,
-        0x02
-    },
-    
-    // Union Functional Descriptor
-    {
-        5,
-        CS_INTERFACE,
-        DESC_SUB_UNION,
-        0x00,
-        0x01
-    },
-    
-    // Call Management Functional Descriptor
-    {
-        5,
-        CS_INTERFACE,
-        DESC_SUB_CM,
-        0x00,
-        0x01
-    },
-
-    // Endpoint Descriptor
-    {
-        7,                  // bLength:8 - Size of EP descriptor in bytes
-        ENDPOINT_DESC,      // bDescriptorType:8 - Endpoint Descriptor Type
-        0x81,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
-        0x03,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
-        EP1_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
-        0x02                // bInterval:8 - Interval
-    },
-    
-    // Interface1 Descriptor
-    {
-        9,              // bLength:8 - Size of interface descriptor in bytes           
-        INTERFACE_DESC, // bDescriptorType:8 - Interface descriptor type
-        0x01,           // bInterfaceNumber:8 - Index number of interface
-        0x00,           // bAlternateSetting:8 - Value used to select alternate setting
-        0x02,           // bNumEndpoints:8 - Number of endpoints used in this interface
-        DIC_CODE,       // bInterfaceClass:8 - Class Code (Assigned by USB Org)                       *0x08 is MSD*
-        0x00,           // bInterfaceSubClass:8 - Subclass Code (Assigned by USB Org)                 *0x01 if Boot Interface Subclass*
-        DIC_NONE,       // bInterfaceProtocol:8 - Protocol Code (Assigned by USB Org)                 *0x01 is Keyboard protocol*
-        0x00            // iInterface:8 - Index of String Descriptor Describing this interface
-    },
-    
-    // Endpoint Descriptor
-    {
-        7,                  // bLength:8 - Size of EP descriptor in bytes
-        ENDPOINT_DESC,      // bDescriptorType:8 - Endpoint Descriptor Type
-        0x02,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
-        0x02,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
-        EP2_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
-        0x00                // bInterval:8 - Interval
-    },
-    
-    // Endpoint Descriptor
+    // CDC-ACM Ports
     {
-        7,                  // bLength:8 - Size of EP descriptor in bytes
-        ENDPOINT_DESC,      // bDescriptorType:8 - Endpoint Descriptor Type
-        0x82,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
-        0x02,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
-        EP2_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
-        0x00                // bInterval:8 - Interval
+        CDC_ACM_FUNCTION(CDC_COM_INT, CDC_DAT_INT, CDC_COM_EP, CDC_DAT_EP),
+        #if CDC_NUM_PORTS > 1
+        CDC_ACM_FUNCTION(CDC1_COM_INT, CDC1_DAT_INT, CDC1_COM_EP, CDC1_DAT_EP),
+        #endif
+        #if CDC_NUM_PORTS > 2
+        CDC_ACM_FUNCTION(CDC2_COM_INT, CDC2_DAT_INT, CDC2_COM_EP, CDC2_DAT_EP),
+        #endif
     }
 };
 
@@ -0,0 +1,304 @@
+/**
+ * @file flash.c
+ * @author John Izzard
+ * @date 2024-11-14
+ * 
+ * USB uC - USB MSD Bootloader.
+ * Copyright (C) 2017-2024 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <xc.h>
+#include "flash.h"
+
+#define LOOPS _FLASH_ERASE_SIZE/_FLASH_WRITE_SIZE
+
+#if defined(_PIC14E)
+#define _EECON1 PMCON1
+#define _EECON1bits PMCON1bits
+#define _EECON2 PMCON2
+#define _EEADR PMADRL
+#define _EEADRH PMADRH
+#define _EEDATA PMDATL
+#define _EEDATH PMDATH
+#else
+#define _EECON1 EECON1
+#define _EECON1bits EECON1bits
+#define _EECON2 EECON2
+#define _EEADR EEADR
+#define _EEADRH EEADRH
+#define _EEDATA EEDATA
+#define _EEDATH EEDATH
+#endif
+
+#if defined(_PIC14)||defined(_PIC14E) 
+void Flash_ReadBytes(uint16_t start_addr, uint16_t bytes, uint8_t *flash_array)
+{
+    _EECON1 = 0x80;
+    while(bytes)
+    {
+        _EEADRH = (uint8_t)(start_addr>>8);
+        _EEADR = (uint8_t)(start_addr);
+        
+        _EECON1bits.RD = 1;
+        NOP();
+        NOP();
+        
+        *flash_array++ = _EEDATA;
+        bytes--;
+        if(bytes == 0) break;
+        
+        *flash_array++ = _EEDATH;
+        bytes--;
+        if(bytes == 0) break;
+        
+        start_addr++;
+    }
+}
+void Flash_Erase(uint16_t start_addr, uint16_t end_addr)
+{
+    uint8_t gie = INTCONbits.GIE; // Called from the main loop, the unlock sequence can't be interrupted.
+    
+    INTCONbits.GIE = 0;
+    _EECON1 = 0x84;
+    while(start_addr<end_addr)
+    {
+        _EEADRH = (uint8_t)(start_addr>>8);
+        _EEADR = (uint8_t)(start_addr);
+        _EECON1bits.FREE = 1;
+        _EECON2 = 0x55;
+        _EECON2 = 0xAA;
+        _EECON1bits.WR = 1;
+        NOP();
+        NOP();
+        start_addr += _FLASH_ERASE_SIZE;
+    }
+    _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
+}
+void Flash_EraseWriteBlock(uint16_t start_addr, uint8_t *flash_array)
+{
+#if _FLASH_ERASE_SIZE>_FLASH_WRITE_SIZE
+    uint8_t i;
+    
+    Flash_Erase(start_addr, start_addr + _FLASH_ERASE_SIZE);
+    
+    for(i=0;i<LOOPS;i++)
+    {
+        Flash_WriteBlock(start_addr, flash_array);
+        flash_array+= (_FLASH_WRITE_SIZE*2);
+        start_addr += _FLASH_WRITE_SIZE;
+    }
+#else
+    Flash_Erase(start_addr,start_addr + _FLASH_ERASE_SIZE);
+    Flash_WriteBlock(start_addr, flash_array);
+#endif
+}
+void Flash_WriteBlock(uint16_t start_addr, uint8_t *flash_array)
+{
+    uint8_t gie = INTCONbits.GIE; // Latch loads and unlock sequences can't be interrupted.
+#ifdef _PIC14
+    uint8_t i;
+    
+    INTCONbits.GIE = 0;
+    _EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
+    _EEADRH = (uint8_t)(start_addr>>8);
+    _EEADR = (uint8_t)(start_addr);
+    for(i=0;i<_FLASH_WRITE_SIZE;i++)
+    {
+        _EEADRH = (uint8_t)(start_addr>>8);
+        _EEADR = (uint8_t)(start_addr);
+        _EEDATA = *flash_array++;
+        _EEDATH = *flash_array++;
+        _EECON2 = 0x55;
+        _EECON2 = 0xAA;
+        _EECON1bits.WR = 1;
+        NOP();
+        NOP();
+        _EEADR++;
+    }
+    _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
+#else
+    uint8_t word_cnt = _FLASH_WRITE_SIZE;
+    
+    INTCONbits.GIE = 0;
+    _EECON1 = 0xA4; // EEPGD = 1, CFGS = 0, FREE = 0, LWLO = 1, WREN = 1
+    _EEADRH = (uint8_t)(start_addr>>8);
+    _EEADR = (uint8_t)(start_addr);
+    while(1)
+    {
+        _EEDATA = *flash_array++;
+        _EEDATH = *flash_array++;
+        word_cnt--;
+        if(word_cnt == 0)break;
+        _EECON2 = 0x55;
+        _EECON2 = 0xAA;
+        _EECON1bits.WR = 1;
+        NOP();
+        NOP();
+        _EEADR++;
+    }
+    _EECON1bits.LWLO = 0;
+    _EECON2 = 0x55;
+    _EECON2 = 0xAA;
+    _EECON1bits.WR = 1;
+    NOP();
+    NOP();
+    _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
+#endif
+}
+#elif defined(_PIC18)
+void Flash_ReadBytes(uint24_t start_addr, uint24_t bytes, uint8_t *flash_array)
+{
+    EECON1 = 0x80; // EEPGD = 1 and CFGS = 0
+    while(bytes)
+    {
+        TBLPTRU = (uint8_t)(start_addr>>16);
+        TBLPTRH = (uint8_t)(start_addr>>8);
+        TBLPTRL = (uint8_t)(start_addr);
+        
+        asm("TBLRDPOSTINC");
+        *flash_array++ = TABLAT;
+        bytes--;
+        if(bytes == 0) break;
+        
+        asm("TBLRDPOSTINC");
+        *flash_array++ = TABLAT;
+        bytes--;
+        if(bytes == 0) break;
+        
+        start_addr+=2;
+    }
+}
+void Flash_Erase(uint24_t start_addr, uint24_t end_addr)
+{
+    uint8_t gie = INTCONbits.GIE; // Called from the main loop, the unlock sequence can't be interrupted.
+    
+    INTCONbits.GIE = 0;
+    EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
+    while(start_addr<end_addr)
+    {
+        TBLPTRU = (uint8_t)(start_addr>>16);
+        TBLPTRH = (uint8_t)(start_addr>>8);
+        TBLPTRL = (uint8_t)(start_addr);
+        EECON1bits.FREE = 1;
+        EECON2 = 0x55;
+        EECON2 = 0xAA;
+        EECON1bits.WR = 1;
+        start_addr += _FLASH_ERASE_SIZE;
+    }
+    EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
+}
+void Flash_EraseWriteBlock(uint24_t start_addr, uint8_t *flash_array)
+{
+#if _FLASH_ERASE_SIZE>_FLASH_WRITE_SIZE
+    uint8_t i;
+    
+    Flash_Erase(start_addr, start_addr + _FLASH_ERASE_SIZE);
+    
+    for(i=0;i<LOOPS;i++)
+    {
+        Flash_WriteBlock(start_addr, flash_array);
+        flash_array+= _FLASH_WRITE_SIZE;
+        start_addr += _FLASH_WRITE_SIZE;
+    }
+#else
+    Flash_Erase(start_addr,start_addr + _FLASH_ERASE_SIZE);
+    Flash_WriteBlock(start_addr, flash_array);
+#endif
+}
+void Flash_WriteBlock(uint24_t start_addr, uint8_t *flash_array)
+{
+    uint8_t i;
+    uint8_t gie = INTCONbits.GIE; // The ISR's table reads (descriptors) would move TBLPTR between the TBLWTs.
+    
+    INTCONbits.GIE = 0;
+    EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
+    TBLPTR = 0;
+    for(i=0;i<_FLASH_WRITE_SIZE;i++)
+    {
+        TABLAT = *flash_array++;
+        asm("TBLWTPOSTINC");
+    }
+    TBLPTRU = (uint8_t)(start_addr>>16);
+    TBLPTRH = (uint8_t)(start_addr>>8);
+    TBLPTRL = (uint8_t)(start_addr);
+    EECON2 = 0x55;
+    EECON2 = 0xAA;
+    EECON1bits.WR = 1;
+    EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
+}
+#else
+#error FLASH - DEVICE NOT YET SUPPORTED
+#endif
+
+
+#if defined(_PIC14)||defined(_PIC14E)
+typedef uint16_t flash_addr_t;
+#define BLOCK_BYTES (_FLASH_WRITE_SIZE*2) // Two array bytes per word.
+#else
+typedef uint24_t flash_addr_t;
+#define BLOCK_BYTES _FLASH_WRITE_SIZE
+#endif
+
+static flash_addr_t m_job_addr;   // Next row to erase or block to write.
+static flash_addr_t m_job_end;
+static uint8_t     *m_job_array;  // 0 for an erase only job.
+static bool         m_job_erased; // Row at m_job_addr is erased, its blocks are next.
+
+void Flash_StartErase(flash_addr_t start_addr, flash_addr_t end_addr)
+{
+    Flash_StartEraseWrite(start_addr, end_addr, 0);
+}
+void Flash_StartEraseWrite(flash_addr_t start_addr, flash_addr_t end_addr, uint8_t *flash_array)
+{
+    m_job_addr   = start_addr;
+    m_job_end    = end_addr;
+    m_job_array  = flash_array;
+    m_job_erased = false;
+}
+bool Flash_Busy(void)
+{
+    return m_job_addr < m_job_end;
+}
+bool Flash_Tasks(void)
+{
+    if(m_job_addr >= m_job_end) return false;
+    
+    if(!m_job_erased)
+    {
+        Flash_Erase(m_job_addr, m_job_addr + _FLASH_ERASE_SIZE);
+        if(m_job_array) m_job_erased = true;
+        else m_job_addr += _FLASH_ERASE_SIZE;
+    }
+    else
+    {
+        Flash_WriteBlock(m_job_addr, m_job_array);
+        m_job_array += BLOCK_BYTES;
+        m_job_addr  += _FLASH_WRITE_SIZE;
+        if((m_job_addr & (_FLASH_ERASE_SIZE - 1)) == 0) m_job_erased = false; // On to the next row.
+    }
+    return m_job_addr < m_job_end;
+}
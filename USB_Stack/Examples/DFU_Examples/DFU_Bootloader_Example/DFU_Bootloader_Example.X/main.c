@@ -0,0 +1,241 @@
+/**
+ * @file main.c
+ * @brief Main C file.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * DFU Bootloader Example.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * DFU BOOTLOADER INSTRUCTIONS
+ * 
+ * This example is itself the bootloader, build it without a Codeoffset. It 
+ * sits below DFU_APP_START (0x2000) and programs your application above it 
+ * from any DFU 1.1 host, such as dfu-util. PIC16F145X, PIC18FX450 and 
+ * PIC18F13K50 don't have the flash or RAM to spare for it.
+ * 
+ * 1. SETUP YOUR APPLICATION
+ * Right click on your application's MPLABX project, and select Properties. 
+ * Under XC8 global options, click XC8 linker. In the Option categories 
+ * dropdown, select Additional options. In the Codeoffset input, put an offset 
+ * of 0x2000. The bootloader sends the interrupt vectors on to 0x2008 and 0x2018.
+ * 
+ * If you are using a J Series part:
+ * In the Option categories dropdown, select Memory Model. In the ROM ranges 
+ * input, put a range from 0x2000 to 1KB from the last byte in flash, e.g. 
+ * 2000-1FBFF for X7J53. The last page holds the Config Words, and the 
+ * bootloader won't program it (DFU_APP_END).
+ * 
+ * 2. MAKE A BINARY
+ * DFU downloads a raw image, the first byte going to DFU_APP_START. Cut your 
+ * application's hex down to its code and make it binary, e.g. with SRecord 
+ * (for a 32KB PIC18F45K50):
+ * 
+ * srec_cat app.hex -Intel -crop 0x2000 0x8000 -offset -0x2000 -o app.bin -Binary
+ * 
+ * 3. START BOOTLOADER
+ * Reset your device or insert the USB cable whilst holding down the 
+ * bootloader button. If no application is present, the bootloader starts 
+ * without it. The bootloader LED will turn on to indicate "bootloader mode" 
+ * is active.
+ * 
+ * 4. DOWNLOAD/UPLOAD
+ * dfu-util -d 04d8:000e -D app.bin
+ * dfu-util -d 04d8:000e -U backup.bin
+ * 
+ * The download is checked by the host with GETSTATUS after each block, and 
+ * ends with dfuIDLE once every block is programmed. Reset your device to 
+ * start the application.
+ * 
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "fuses.h"
+#include "config.h"
+#include "flash.h"
+#include "usb.h"
+#include "usb_dfu.h"
+
+#if !defined(_PIC18) || (_ROMSIZE <= DFU_APP_START)
+#error "The DFU Bootloader Example needs a PIC18 with flash above DFU_APP_START."
+#endif
+
+static void example_init(void);
+static bool app_present(void);
+
+// Interrupt vectors go to the application, the bootloader itself is polled.
+asm("PSECT HiVector,class=CODE,delta=1,abs");
+asm("ORG 0x08");
+asm("GOTO 0x2008"); // DFU_APP_START + 0x08
+asm("PSECT LoVector,class=CODE,delta=1,abs");
+asm("ORG 0x18");
+asm("GOTO 0x2018"); // DFU_APP_START + 0x18
+
+void main(void)
+{
+    example_init();
+    if(BUTTON_RELEASED && app_present()) asm("GOTO 0x2000"); // DFU_APP_START
+    
+    #ifdef USE_BOOT_LED
+    LED_ON();
+    LED_OUPUT();
+    #endif
+    
+    // Polled, so the erases and writes in dfu_tasks() never interrupt usb_tasks().
+    usb_init();
+    
+    while(1)
+    {
+        usb_tasks();
+        dfu_tasks();
+    }
+}
+
+void dfu_read(dfu_addr_t addr, uint16_t bytes, uint8_t* p_data)
+{
+    Flash_ReadBytes(addr, bytes, p_data);
+}
+
+void dfu_erase(dfu_addr_t addr)
+{
+    Flash_Erase(addr, addr + _FLASH_ERASE_SIZE);
+}
+
+void dfu_write_block(dfu_addr_t addr, uint8_t* p_data)
+{
+    Flash_WriteBlock(addr, p_data);
+}
+
+static bool app_present(void)
+{
+    uint8_t reset_vector[2];
+    
+    Flash_ReadBytes(DFU_APP_START, 2, reset_vector);
+    return (reset_vector[0] & reset_vector[1]) != 0xFF;
+}
+
+static void example_init(void)
+{
+    // Oscillator Settings.
+    // PIC16F145X.
+    #if defined(_PIC14E)
+    #if XTAL_USED == NO_XTAL
+    OSCCONbits.IRCF = 0xF;
+    #endif
+    #if XTAL_USED != MHz_12
+    OSCCONbits.SPLLMULT = 1;
+    #endif
+    OSCCONbits.SPLLEN = 1;
+    PLL_STARTUP_DELAY();
+    #if XTAL_USED == NO_XTAL
+    ACTCONbits.ACTSRC = 1;
+    ACTCONbits.ACTEN = 1;
+    #endif
+
+    // PIC18FX450, PIC18FX550, and PIC18FX455.
+    #elif defined(_18F4450_FAMILY_) || defined(_18F4550_FAMILY_)
+    PLL_STARTUP_DELAY();
+    
+    // PIC18F14K50.
+    #elif defined(_18F13K50) || defined(_18F14K50)
+    OSCTUNEbits.SPLLEN = 1;
+    PLL_STARTUP_DELAY();
+    
+    // PIC18F2XK50.
+    #elif defined(_18F24K50) || defined(_18F25K50) || defined(_18F45K50)
+    #if XTAL_USED == NO_XTAL
+    OSCCONbits.IRCF = 7;
+    #endif
+    #if (XTAL_USED != MHz_12)
+    OSCTUNEbits.SPLLMULT = 1;
+    #endif
+    OSCCON2bits.PLLEN = 1;
+    PLL_STARTUP_DELAY();
+    #if XTAL_USED == NO_XTAL
+    ACTCONbits.ACTSRC = 1;
+    ACTCONbits.ACTEN = 1;
+    #endif
+
+    // PIC18F2XJ53 and PIC18F4XJ53.
+    #elif defined(__J_PART)
+    OSCTUNEbits.PLLEN = 1;
+    PLL_STARTUP_DELAY();
+    #endif
+
+    
+    // Make boot pin digital.
+    #if defined(BUTTON_ANSEL) 
+    BUTTON_ANSEL &= ~(1<<BUTTON_ANSEL_BIT);
+    #elif defined(BUTTON_ANCON)
+    BUTTON_ANCON |= (1<<BUTTON_ANCON_BIT);
+    #endif
+
+
+    // Apply pull-up.
+    #ifdef BUTTON_WPU
+    #if defined(_PIC14E)
+    WPUA = 0;
+    #if defined(_16F1459)
+    WPUB = 0;
+    #endif
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    OPTION_REGbits.nWPUEN = 0;
+    
+    #elif defined(_18F4450_FAMILY_) || defined(_18F4550_FAMILY_)
+    LATB = 0;
+    LATD = 0;
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    #if BUTTON_RXPU_REG == INTCON2
+    INTCON2 &= 7F;
+    #else
+    PORTE |= 80;
+    #endif
+    
+    #elif defined(_18F13K50) || defined(_18F14K50)
+    WPUA = 0;
+    WPUB = 0;
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    INTCON2bits.nRABPU = 0;
+    
+    #elif defined(_18F24K50) || defined(_18F25K50) || defined(_18F45K50)
+    WPUB = 0;
+    TRISE &= 0x7F;
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    INTCON2bits.nRBPU = 0;
+    
+    #elif defined(_18F24J50) || defined(_18F25J50) || defined(_18F26J50) || defined(_18F26J53) || defined(_18F27J53)
+    LATB = 0;
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    BUTTON_RXPU_REG &= ~(1 << BUTTON_RXPU_BIT);
+    
+    #elif defined(_18F44J50) || defined(_18F45J50) || defined(_18F46J50) || defined(_18F46J53) || defined(_18F47J53)
+    LATB = 0;
+    LATD = 0;
+    LATE = 0;
+    BUTTON_WPU |= (1 << BUTTON_WPU_BIT);
+    BUTTON_RXPU_REG &= ~(1 << BUTTON_RXPU_BIT);
+    #endif
+    #endif
+}
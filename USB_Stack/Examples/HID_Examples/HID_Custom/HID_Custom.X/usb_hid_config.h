@@ -49,6 +49,10 @@
 // Idle_Settings
 #define DEFAULT_IDLE 500 // in mS
 
+// IN Report Queue
+#define HID_IN_QUEUE_SIZE        2 // Reports waiting to be sent, power of 2.
+#define HID_IN_QUEUE_REPORT_SIZE 64 // Largest IN report in bytes, including Report ID.
+
 // HID Endpoint HAL
 #define HID_EP      EP1
 #define HID_EP_SIZE EP1_SIZE
@@ -145,7 +145,7 @@ void main(void)
         service_reports_to_send();
         
         // Uncomment the following for Keyboard Example
-        if(g_hid_sent_report[0] == true && g_hid_report_sent)
+        if(g_hid_sent_report[0] == true && g_hid_interface_report_sent[0]) // Only the keyboard interface, a consumer report can't hold it up.
         {
             if(BUTTON_WAS_PRESSED)
             {
@@ -164,7 +164,7 @@ void main(void)
         }
         
         // Uncomment the following for Consumer Example
-//        if(g_hid_sent_report[1] == true && g_hid_report_sent)
+//        if(g_hid_sent_report[1] == true && g_hid_interface_report_sent[1])
 //        {
 //            if(BUTTON_WAS_PRESSED)
 //            {
@@ -299,22 +299,20 @@ static void flash_led(void)
 
 static void service_reports_to_send(void)
 {
-    if((g_hid_in_report_settings[0].Idle_Count_Overflow || m_send_report0) && g_hid_report_sent)
+    if(g_hid_in_report_settings[0].Idle_Count_Overflow || m_send_report0)
     {
-        m_send_report0 = false;
-        hid_send_report(0);
+        if(hid_send_report(0)) m_send_report0 = false;
     }
-    if((g_hid_in_report_settings[1].Idle_Count_Overflow || m_send_report1) && g_hid_report_sent)
+    if(g_hid_in_report_settings[1].Idle_Count_Overflow || m_send_report1)
     {
-        m_send_report1 = false;
-        hid_send_report(1);
+        if(hid_send_report(1)) m_send_report1 = false;
     }
 }
 
 static void send_key(uint8_t modifier, uint8_t key_code)
 {
-    g_hid_in_report1.Modifiers = modifier;
-    g_hid_in_report1.Keycode   = key_code;
+    g_hid_in_report1.Modifiers  = modifier;
+    g_hid_in_report1.Keycode[0] = key_code;
     m_send_report0 = true;
 }
 
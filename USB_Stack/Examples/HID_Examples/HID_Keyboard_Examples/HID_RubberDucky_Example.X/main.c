@@ -97,6 +97,7 @@
 #include "usb_hid.h"
 #include "usb_hid_reports.h"
 #include "ascii_2_key.h"
+#include "hid_typer.h"
 
 #if INTERRUPTS_MASK == 0
 #error "RubberDucky Example needs usb interrupt method, because blocking is used."
@@ -109,7 +110,6 @@ static void flash_led(void);
 static void __interrupt() isr(void);
 static void send_key(uint8_t modifier, uint8_t key_code);
 static void send_consumer(uint8_t consumer_val);
-static void print_keys(const uint8_t * str);
 
 static const uint8_t message[] = "https://youtu.be/dQw4w9WgXcQ?t=43s\r";
 
@@ -139,7 +139,7 @@ void main(void)
     __delay_ms(100);
     send_key(0,0);
     __delay_ms(500);
-    print_keys(message);
+    typer_print(message);
     while(1){}
 }
 
@@ -262,35 +262,21 @@ static void flash_led(void)
 
 static void send_key(uint8_t modifier, uint8_t key_code)
 {
-    g_hid_in_report1.Modifiers = modifier;
-    g_hid_in_report1.Keycode   = key_code;
-    hid_send_report(0);
-    while(!g_hid_report_sent){}
+    g_hid_in_report1.Modifiers  = modifier;
+    g_hid_in_report1.Keycode[0] = key_code;
+    while(!hid_send_report(0)){} // Only waits when the IN queue is full.
 }
 
 static void send_consumer(uint8_t consumer_val)
 {
     g_hid_in_report2.Consumer_Byte = consumer_val;
-    hid_send_report(1);
-    while(!g_hid_report_sent){}
-}
-
-static void print_keys(const uint8_t * str)
-{
-    uint8_t i = 0;
-    while(str[i])
-    {
-        ascii_2_key(str[i]);
-        send_key(g_key_result.Modifier, g_key_result.KeyCode);
-        i++;
-        if(str[i] == str[i - 1]) send_key(0,0);  // Repeated letters need to be released first.
-    }
-    send_key(0,0);
+    while(!hid_send_report(1)){}
 }
 
 void usb_sof(void)
 {
     //hid_service_sof(); // We ignore idle in this example
+    typer_sof();
 }
 
 void USB_ServiceAppOut(void)
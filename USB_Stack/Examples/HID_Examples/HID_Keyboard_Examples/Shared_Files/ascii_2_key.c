@@ -1,11 +1,11 @@
 /**
  * @file ascii_2_key.c
- * @brief Convert ASCII to HID Key values.
+ * @brief Convert ASCII/UTF-8 to HID Key values.
  * @author John Izzard
- * @date 2024-11-14
+ * @date 2026-10-18
  * 
  * USB uC - HID Examples.
- * Copyright (C) 2017-2024 John Izzard
+ * Copyright (C) 2017-2026 John Izzard
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the “Software”), to deal
@@ -30,130 +30,88 @@
 #include <stdbool.h>
 #include "ascii_2_key.h"
 
-#define IS_CHARACTER      (val > 31 && val < 127)
-#define IS_CAPITAL_LETTER (val > 64 && val < 91)
-#define IS_LOWER_LETTER   (val > 96 && val < 123)
-#define IS_NUMBER         (val > 47 && val < 58)
-
-#define IS_SYMBOL_AREA_1  (val < 48)
-#define IS_SYMBOL_AREA_2  (val < 65)
-#define IS_SYMBOL_AREA_3  (val < 97)
-#define IS_SYMBOL_AREA_4  (val < 127)
+#define REPLACEMENT_CHARACTER 0xFFFD
 
 Key_Result_t g_key_result;
 
-const uint8_t symbol_lookup_1[16] =
-{
-    KEY_SPACE,      // ' '
-    KEY_1,          // '!'
-    KEY_APOSTROPHE, // '\"'
-    KEY_3,          // '#'
-    KEY_4,          // '$'
-    KEY_5,          // '%'
-    KEY_7,          // '&'
-    KEY_APOSTROPHE, // '\''
-    KEY_9,          // '('
-    KEY_0,          // ')'
-    KEY_8,          // '*'
-    KEY_EQUAL,      // '+'
-    KEY_COMMA,      // ','
-    KEY_MINUS,      // '-'
-    KEY_DOT,        // '.'
-    KEY_SLASH       // '/'
-};
-
-const uint8_t symbol_lookup_2[7] =
-{
-    KEY_SEMICOLON,  // ':'
-    KEY_SEMICOLON,  // ';'
-    KEY_COMMA,      // '<'
-    KEY_EQUAL,      // '='
-    KEY_DOT,        // '>'
-    KEY_SLASH,      // '?'
-    KEY_2           // '@'
-};
-
-const uint8_t symbol_lookup_3[6] =
+void ascii_2_key(uint8_t val)
 {
-    KEY_LEFTBRACE,  // '['
-    KEY_BACKSLASH,  // '\'
-    KEY_RIGHTBRACE, // ']'
-    KEY_6,          // '^'
-    KEY_MINUS,      // '_'
-    KEY_GRAVE       // '`'
-};
+    unicode_2_key(val);
+}
 
-const uint8_t symbol_lookup_4[4] =
+void unicode_2_key(uint16_t codepoint)
 {
-    KEY_LEFTBRACE,  // '{'
-    KEY_BACKSLASH,  // '|'
-    KEY_RIGHTBRACE, // '{'
-    KEY_GRAVE       // '~'
-};
-
-void ascii_2_key(uint8_t val)
-{
-    g_key_result.Modifier = 0;
-    g_key_result.KeyCode  = KEY_NULL;
+    uint8_t modifier = 0;
+    uint8_t key_code = KEY_NULL;
+    uint8_t low;
+    uint8_t high;
+    uint8_t mid;
     
-    if(IS_CHARACTER)
+    if(codepoint < 128)
     {
-        if(IS_LOWER_LETTER)
-        {
-            g_key_result.KeyCode = val - ('a' - KEY_A); // 'a' - KEY_A = 97 - 4 = 93.
-        }
-        else if(IS_CAPITAL_LETTER)
-        {
-            g_key_result.Modifier = MOD_KEY_LEFTSHIFT;
-            g_key_result.KeyCode = val - ('A' - KEY_A);  // 'A' - KEY_A = 65 - 4 = 61.
-        }
-        else if(IS_NUMBER)
+        // Only the chosen End of Line Character is typed, so \r\n gives one enter.
+        if(codepoint != ELC && (codepoint == '\r' || codepoint == '\n')) codepoint = 0;
+        modifier = g_ascii_keys[codepoint].Modifier;
+        key_code = g_ascii_keys[codepoint].KeyCode;
+    }
+    else
+    {
+        low  = 0;
+        high = g_num_ext_keys;
+        while(low < high)
         {
-            if(val == '0') g_key_result.KeyCode = KEY_0;
-            else g_key_result.KeyCode = val - ('1' - KEY_1);  // '1' - KEY_1 = 49 - 30 = 19.
+            mid = (uint8_t)((low + high) >> 1);
+            if(g_ext_keys[mid].Codepoint < codepoint) low = mid + 1u;
+            else high = mid;
         }
-        else
+        if(low < g_num_ext_keys && g_ext_keys[low].Codepoint == codepoint)
         {
-            if(IS_SYMBOL_AREA_1)
-            {
-                if((val != ' ') && 
-                   (val != '\'') && 
-                   (val != ',') &&
-                   (val != '-') &&
-                   (val != '.') &&
-                   (val != '/')) g_key_result.Modifier = MOD_KEY_LEFTSHIFT;
-                g_key_result.KeyCode = symbol_lookup_1[val - ' '];
-            }
-            else if(IS_SYMBOL_AREA_2)
-            {
-                if((val != ';')&&(val != '=')) g_key_result.Modifier = MOD_KEY_LEFTSHIFT;
-                g_key_result.KeyCode = symbol_lookup_2[val - ':'];
-            }
-            else if(IS_SYMBOL_AREA_3)
-            {
-                if((val == '^')||(val == '_')) g_key_result.Modifier = MOD_KEY_LEFTSHIFT;
-                g_key_result.KeyCode = symbol_lookup_3[val - '['];
-            }
-            else if(IS_SYMBOL_AREA_4)
-            {
-                g_key_result.Modifier = MOD_KEY_LEFTSHIFT;
-                g_key_result.KeyCode = symbol_lookup_4[val - '{'];
-            }
+            modifier = g_ext_keys[low].Modifier;
+            key_code = g_ext_keys[low].KeyCode;
         }
     }
-    else
+    
+    g_key_result.Modifier = modifier;
+    g_key_result.KeyCode  = key_code & (uint8_t)~KEY_DEAD;
+    g_key_result.Dead_Key = (key_code & KEY_DEAD) != 0;
+}
+
+uint16_t utf8_decode(const uint8_t** p_str)
+{
+    const uint8_t* p = *p_str;
+    uint16_t codepoint;
+    uint8_t  follow;
+    
+    if(*p == 0) return 0;
+    
+    codepoint = *p++;
+    if(codepoint < 0x80) follow = 0;
+    else if((codepoint & 0xE0) == 0xC0)
+    {
+        codepoint &= 0x1F;
+        follow = 1;
+    }
+    else if((codepoint & 0xF0) == 0xE0)
+    {
+        codepoint &= 0x0F;
+        follow = 2;
+    }
+    else // Stray continuation byte, or beyond the BMP.
+    {
+        while((*p & 0xC0) == 0x80) p++;
+        *p_str = p;
+        return REPLACEMENT_CHARACTER;
+    }
+    
+    while(follow--)
     {
-        switch(val)
+        if((*p & 0xC0) != 0x80) // Cut short.
         {
-            case ELC: // End of Line Character set in header file.
-                g_key_result.KeyCode = KEY_ENTER;
-                break;
-            case '\t':
-                g_key_result.KeyCode = KEY_TAB;
-                break;
-            case '\b':
-                g_key_result.KeyCode = KEY_BACKSPACE;
-                break;
+            *p_str = p;
+            return REPLACEMENT_CHARACTER;
         }
+        codepoint = (codepoint << 6) | (*p++ & 0x3F);
     }
-}
\ No newline at end of file
+    *p_str = p;
+    return codepoint;
+}
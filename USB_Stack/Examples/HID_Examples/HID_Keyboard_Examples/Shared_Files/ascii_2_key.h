@@ -1,11 +1,11 @@
 /**
  * @file ascii_2_key.h
- * @brief Convert ASCII to HID Key values.
+ * @brief Convert ASCII/UTF-8 to HID Key values.
  * @author John Izzard
- * @date 2024-11-14
+ * @date 2026-10-18
  * 
  * USB uC - HID Examples.
- * Copyright (C) 2017-2024 John Izzard
+ * Copyright (C) 2017-2026 John Izzard
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the “Software”), to deal
@@ -30,8 +30,10 @@
 #define ASCII_2_KEY_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "usb_hid.h"
 #include "usb_hid_pages.h"
+#include "key_layouts.h"
 
 // Choose a End of Line Character (\n or \r) used to convert to enter/return.
 // Windows uses \r\n so use either \n or \r.
@@ -39,14 +41,65 @@
 // Mac uses \r.
 #define ELC '\r'
 
+// Keyboard layout the host is set to (LAYOUT_US, LAYOUT_UK, LAYOUT_DE or
+// LAYOUT_FR). Tables are made with USB_Stack/Tools/gen_key_layouts.py.
+#define KEYBOARD_LAYOUT LAYOUT_US
+
 typedef struct
 {
     uint8_t Modifier;
     uint8_t KeyCode;
+    bool    Dead_Key; // Type a space after the key to get the character.
 }Key_Result_t;
 
 extern Key_Result_t g_key_result;
 
+/**
+ * @fn void ascii_2_key(uint8_t val)
+ * 
+ * @brief Looks up the key and modifiers that type an ASCII character.
+ * 
+ * The result is put in g_key_result, KeyCode is KEY_NULL when the character
+ * can't be typed on the selected layout.
+ * 
+ * @param[in] val ASCII character.
+ */
 void ascii_2_key(uint8_t val);
 
+/**
+ * @fn void unicode_2_key(uint16_t codepoint)
+ * 
+ * @brief Looks up the key and modifiers that type a Unicode character.
+ * 
+ * ASCII is one table load, other characters are a binary search of the
+ * layout's extension table. The result is put in g_key_result.
+ * 
+ * @param[in] codepoint Unicode character (Basic Multilingual Plane).
+ */
+void unicode_2_key(uint16_t codepoint);
+
+/**
+ * @fn uint16_t utf8_decode(const uint8_t** p_str)
+ * 
+ * @brief Reads the next character of a UTF-8 string.
+ * 
+ * The string pointer is moved past the character, but not past the null
+ * terminator. Invalid sequences and characters outside the Basic Multilingual
+ * Plane return 0xFFFD, which no layout can type.
+ * 
+ * @param[in,out] p_str Pointer to the string pointer.
+ * 
+ * @return Unicode character, 0 at the end of the string.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * const uint8_t* p = message;
+ * uint16_t c;
+ * while((c = utf8_decode(&p)) != 0) unicode_2_key(c);
+ * @endcode
+ * </li></ul>
+ */
+uint16_t utf8_decode(const uint8_t** p_str);
+
 #endif /* ASCII_2_KEY_H */
\ No newline at end of file
@@ -0,0 +1,137 @@
+/**
+ * @file hid_typer.c
+ * @brief Types strings as keyboard reports, one report per frame.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+ 
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_hid.h"
+#include "usb_hid_reports.h"
+#include "ascii_2_key.h"
+#include "hid_typer.h"
+
+static const uint8_t*   m_str;
+static volatile bool    m_busy;
+static uint8_t          m_keys[TYPER_MAX_KEYS]; // Keys held by the last report, oldest first.
+static uint8_t          m_num_keys;
+static uint8_t          m_modifiers;
+static bool             m_dead_pending; // Dead key sent, space still to type.
+
+static bool has_key(uint8_t key);
+
+void typer_print(const uint8_t* str)
+{
+    USB_INTERRUPT_ENABLE = 0;
+    m_str  = str;
+    m_dead_pending = false;
+    m_busy = true;
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+bool typer_busy(void)
+{
+    return m_busy;
+}
+
+void typer_sof(void)
+{
+    const uint8_t* p = m_str;
+    uint8_t  key = KEY_NULL;
+    uint8_t  modifiers = 0;
+    uint8_t  i;
+    uint16_t c;
+    
+    if(!m_busy) return;
+    if(hid_in_queue_space(0) != HID_IN_QUEUE_SIZE) return; // Last report hasn't been armed yet.
+    
+    if(m_dead_pending) key = KEY_SPACE; // Space after a dead key types the accent itself.
+    else
+    {
+        while(1)
+        {
+            c = utf8_decode(&p);
+            if(c == 0) break;
+            unicode_2_key(c);
+            if(g_key_result.KeyCode != KEY_NULL)
+            {
+                key = g_key_result.KeyCode;
+                modifiers = g_key_result.Modifier;
+                break;
+            }
+            m_str = p; // Can't be typed, skip it.
+        }
+    }
+    
+    if(key == KEY_NULL) // Nothing left, release everything.
+    {
+        if(m_num_keys == 0 && m_modifiers == 0)
+        {
+            m_busy = false;
+            return;
+        }
+        m_num_keys  = 0;
+        m_modifiers = 0;
+    }
+    else if(has_key(key)) m_num_keys = 0; // A repeat needs a release, it's pressed in the next report.
+    else
+    {
+        // One new key per report, hosts don't keep the order of keys pressed together.
+        if(modifiers != m_modifiers) m_num_keys = 0; // Held keys mustn't get the new modifiers.
+        if(m_num_keys == TYPER_MAX_KEYS) // Full, release the oldest.
+        {
+            for(i = 1; i < TYPER_MAX_KEYS; i++) m_keys[i - 1] = m_keys[i];
+            m_num_keys--;
+        }
+        m_keys[m_num_keys++] = key;
+        m_modifiers = modifiers;
+        if(m_dead_pending) m_dead_pending = false;
+        else
+        {
+            m_str = p;
+            m_dead_pending = g_key_result.Dead_Key;
+        }
+    }
+    
+    g_hid_in_report1.Modifiers = m_modifiers;
+    for(i = 0; i < TYPER_MAX_KEYS; i++)
+    {
+        g_hid_in_report1.Keycode[i] = i < m_num_keys ? m_keys[i] : KEY_NULL;
+    }
+    hid_send_report(0);
+}
+
+static bool has_key(uint8_t key)
+{
+    uint8_t i;
+    
+    for(i = 0; i < m_num_keys; i++)
+    {
+        if(m_keys[i] == key) return true;
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file hid_typer.h
+ * @brief Types strings as keyboard reports, one report per frame.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+ 
+#ifndef HID_TYPER_H
+#define HID_TYPER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Keys a boot keyboard report can hold.
+#define TYPER_MAX_KEYS 6
+
+/**
+ * @fn void typer_print(const uint8_t* str)
+ * 
+ * @brief Starts typing a string.
+ * 
+ * Characters are turned into keyboard reports by typer_sof(), one new key
+ * per report so the host types them in order. Up to five earlier keys stay
+ * held instead of being released, the oldest is let go when all six are in
+ * use. A release report is only sent when a key repeats. Keys held when the
+ * modifiers change are released in the same report. Dead keys (accents on
+ * some layouts) are followed by a space. The string must stay valid until
+ * typer_busy() returns false.
+ * 
+ * @param[in] str Null terminated UTF-8 string (RAM or ROM), characters the
+ *                layout can't type are skipped.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * typer_print(message);
+ * while(typer_busy()){}
+ * @endcode
+ * </li></ul>
+ */
+void typer_print(const uint8_t* str);
+
+/**
+ * @fn bool typer_busy(void)
+ * 
+ * @brief Returns true while a string is being typed.
+ */
+bool typer_busy(void);
+
+/**
+ * @fn void typer_sof(void)
+ * 
+ * @brief Queues the next keyboard report, call from usb_sof().
+ * 
+ * A report is only built when the HID IN queue is empty, so no more than one
+ * report is waiting for the host's next poll.
+ */
+void typer_sof(void);
+
+#endif /* HID_TYPER_H */
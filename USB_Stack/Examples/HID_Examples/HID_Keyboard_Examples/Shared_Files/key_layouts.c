@@ -0,0 +1,635 @@
+/**
+ * @file key_layouts.c
+ * @brief Keyboard layout tables.
+ * @author John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_key_layouts.py from the layouts in
+ * USB_Stack/Tools/Keyboard_Layouts, do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include "ascii_2_key.h"
+#include "key_layouts.h"
+
+#if KEYBOARD_LAYOUT == LAYOUT_US
+const key_entry_t g_ascii_keys[128] =
+{
+    {0, KEY_NULL},                                          // NUL
+    {0, KEY_NULL},                                          // 0x01
+    {0, KEY_NULL},                                          // 0x02
+    {0, KEY_NULL},                                          // 0x03
+    {0, KEY_NULL},                                          // 0x04
+    {0, KEY_NULL},                                          // 0x05
+    {0, KEY_NULL},                                          // 0x06
+    {0, KEY_NULL},                                          // 0x07
+    {0, KEY_BACKSPACE},                                     // \b
+    {0, KEY_TAB},                                           // \t
+    {0, KEY_ENTER},                                         // \n
+    {0, KEY_NULL},                                          // 0x0B
+    {0, KEY_NULL},                                          // 0x0C
+    {0, KEY_ENTER},                                         // \r
+    {0, KEY_NULL},                                          // 0x0E
+    {0, KEY_NULL},                                          // 0x0F
+    {0, KEY_NULL},                                          // 0x10
+    {0, KEY_NULL},                                          // 0x11
+    {0, KEY_NULL},                                          // 0x12
+    {0, KEY_NULL},                                          // 0x13
+    {0, KEY_NULL},                                          // 0x14
+    {0, KEY_NULL},                                          // 0x15
+    {0, KEY_NULL},                                          // 0x16
+    {0, KEY_NULL},                                          // 0x17
+    {0, KEY_NULL},                                          // 0x18
+    {0, KEY_NULL},                                          // 0x19
+    {0, KEY_NULL},                                          // 0x1A
+    {0, KEY_ESC},                                           // ESC
+    {0, KEY_NULL},                                          // 0x1C
+    {0, KEY_NULL},                                          // 0x1D
+    {0, KEY_NULL},                                          // 0x1E
+    {0, KEY_NULL},                                          // 0x1F
+    {0, KEY_SPACE},                                         // ' '
+    {MOD_KEY_LEFTSHIFT, KEY_1},                             // '!'
+    {MOD_KEY_LEFTSHIFT, KEY_APOSTROPHE},                    // '"'
+    {MOD_KEY_LEFTSHIFT, KEY_3},                             // '#'
+    {MOD_KEY_LEFTSHIFT, KEY_4},                             // '$'
+    {MOD_KEY_LEFTSHIFT, KEY_5},                             // '%'
+    {MOD_KEY_LEFTSHIFT, KEY_7},                             // '&'
+    {0, KEY_APOSTROPHE},                                    // '\''
+    {MOD_KEY_LEFTSHIFT, KEY_9},                             // '('
+    {MOD_KEY_LEFTSHIFT, KEY_0},                             // ')'
+    {MOD_KEY_LEFTSHIFT, KEY_8},                             // '*'
+    {MOD_KEY_LEFTSHIFT, KEY_EQUAL},                         // '+'
+    {0, KEY_COMMA},                                         // ','
+    {0, KEY_MINUS},                                         // '-'
+    {0, KEY_DOT},                                           // '.'
+    {0, KEY_SLASH},                                         // '/'
+    {0, KEY_0},                                             // '0'
+    {0, KEY_1},                                             // '1'
+    {0, KEY_2},                                             // '2'
+    {0, KEY_3},                                             // '3'
+    {0, KEY_4},                                             // '4'
+    {0, KEY_5},                                             // '5'
+    {0, KEY_6},                                             // '6'
+    {0, KEY_7},                                             // '7'
+    {0, KEY_8},                                             // '8'
+    {0, KEY_9},                                             // '9'
+    {MOD_KEY_LEFTSHIFT, KEY_SEMICOLON},                     // ':'
+    {0, KEY_SEMICOLON},                                     // ';'
+    {MOD_KEY_LEFTSHIFT, KEY_COMMA},                         // '<'
+    {0, KEY_EQUAL},                                         // '='
+    {MOD_KEY_LEFTSHIFT, KEY_DOT},                           // '>'
+    {MOD_KEY_LEFTSHIFT, KEY_SLASH},                         // '?'
+    {MOD_KEY_LEFTSHIFT, KEY_2},                             // '@'
+    {MOD_KEY_LEFTSHIFT, KEY_A},                             // 'A'
+    {MOD_KEY_LEFTSHIFT, KEY_B},                             // 'B'
+    {MOD_KEY_LEFTSHIFT, KEY_C},                             // 'C'
+    {MOD_KEY_LEFTSHIFT, KEY_D},                             // 'D'
+    {MOD_KEY_LEFTSHIFT, KEY_E},                             // 'E'
+    {MOD_KEY_LEFTSHIFT, KEY_F},                             // 'F'
+    {MOD_KEY_LEFTSHIFT, KEY_G},                             // 'G'
+    {MOD_KEY_LEFTSHIFT, KEY_H},                             // 'H'
+    {MOD_KEY_LEFTSHIFT, KEY_I},                             // 'I'
+    {MOD_KEY_LEFTSHIFT, KEY_J},                             // 'J'
+    {MOD_KEY_LEFTSHIFT, KEY_K},                             // 'K'
+    {MOD_KEY_LEFTSHIFT, KEY_L},                             // 'L'
+    {MOD_KEY_LEFTSHIFT, KEY_M},                             // 'M'
+    {MOD_KEY_LEFTSHIFT, KEY_N},                             // 'N'
+    {MOD_KEY_LEFTSHIFT, KEY_O},                             // 'O'
+    {MOD_KEY_LEFTSHIFT, KEY_P},                             // 'P'
+    {MOD_KEY_LEFTSHIFT, KEY_Q},                             // 'Q'
+    {MOD_KEY_LEFTSHIFT, KEY_R},                             // 'R'
+    {MOD_KEY_LEFTSHIFT, KEY_S},                             // 'S'
+    {MOD_KEY_LEFTSHIFT, KEY_T},                             // 'T'
+    {MOD_KEY_LEFTSHIFT, KEY_U},                             // 'U'
+    {MOD_KEY_LEFTSHIFT, KEY_V},                             // 'V'
+    {MOD_KEY_LEFTSHIFT, KEY_W},                             // 'W'
+    {MOD_KEY_LEFTSHIFT, KEY_X},                             // 'X'
+    {MOD_KEY_LEFTSHIFT, KEY_Y},                             // 'Y'
+    {MOD_KEY_LEFTSHIFT, KEY_Z},                             // 'Z'
+    {0, KEY_LEFTBRACE},                                     // '['
+    {0, KEY_BACKSLASH},                                     // '\\'
+    {0, KEY_RIGHTBRACE},                                    // ']'
+    {MOD_KEY_LEFTSHIFT, KEY_6},                             // '^'
+    {MOD_KEY_LEFTSHIFT, KEY_MINUS},                         // '_'
+    {0, KEY_GRAVE},                                         // '`'
+    {0, KEY_A},                                             // 'a'
+    {0, KEY_B},                                             // 'b'
+    {0, KEY_C},                                             // 'c'
+    {0, KEY_D},                                             // 'd'
+    {0, KEY_E},                                             // 'e'
+    {0, KEY_F},                                             // 'f'
+    {0, KEY_G},                                             // 'g'
+    {0, KEY_H},                                             // 'h'
+    {0, KEY_I},                                             // 'i'
+    {0, KEY_J},                                             // 'j'
+    {0, KEY_K},                                             // 'k'
+    {0, KEY_L},                                             // 'l'
+    {0, KEY_M},                                             // 'm'
+    {0, KEY_N},                                             // 'n'
+    {0, KEY_O},                                             // 'o'
+    {0, KEY_P},                                             // 'p'
+    {0, KEY_Q},                                             // 'q'
+    {0, KEY_R},                                             // 'r'
+    {0, KEY_S},                                             // 's'
+    {0, KEY_T},                                             // 't'
+    {0, KEY_U},                                             // 'u'
+    {0, KEY_V},                                             // 'v'
+    {0, KEY_W},                                             // 'w'
+    {0, KEY_X},                                             // 'x'
+    {0, KEY_Y},                                             // 'y'
+    {0, KEY_Z},                                             // 'z'
+    {MOD_KEY_LEFTSHIFT, KEY_LEFTBRACE},                     // '{'
+    {MOD_KEY_LEFTSHIFT, KEY_BACKSLASH},                     // '|'
+    {MOD_KEY_LEFTSHIFT, KEY_RIGHTBRACE},                    // '}'
+    {MOD_KEY_LEFTSHIFT, KEY_GRAVE},                         // '~'
+    {0, KEY_DELETE}                                         // DEL
+};
+
+const key_ext_entry_t g_ext_keys[] =
+{
+    {0xFFFF, 0, KEY_NULL}
+};
+
+const uint8_t g_num_ext_keys = 0;
+
+#elif KEYBOARD_LAYOUT == LAYOUT_UK
+const key_entry_t g_ascii_keys[128] =
+{
+    {0, KEY_NULL},                                          // NUL
+    {0, KEY_NULL},                                          // 0x01
+    {0, KEY_NULL},                                          // 0x02
+    {0, KEY_NULL},                                          // 0x03
+    {0, KEY_NULL},                                          // 0x04
+    {0, KEY_NULL},                                          // 0x05
+    {0, KEY_NULL},                                          // 0x06
+    {0, KEY_NULL},                                          // 0x07
+    {0, KEY_BACKSPACE},                                     // \b
+    {0, KEY_TAB},                                           // \t
+    {0, KEY_ENTER},                                         // \n
+    {0, KEY_NULL},                                          // 0x0B
+    {0, KEY_NULL},                                          // 0x0C
+    {0, KEY_ENTER},                                         // \r
+    {0, KEY_NULL},                                          // 0x0E
+    {0, KEY_NULL},                                          // 0x0F
+    {0, KEY_NULL},                                          // 0x10
+    {0, KEY_NULL},                                          // 0x11
+    {0, KEY_NULL},                                          // 0x12
+    {0, KEY_NULL},                                          // 0x13
+    {0, KEY_NULL},                                          // 0x14
+    {0, KEY_NULL},                                          // 0x15
+    {0, KEY_NULL},                                          // 0x16
+    {0, KEY_NULL},                                          // 0x17
+    {0, KEY_NULL},                                          // 0x18
+    {0, KEY_NULL},                                          // 0x19
+    {0, KEY_NULL},                                          // 0x1A
+    {0, KEY_ESC},                                           // ESC
+    {0, KEY_NULL},                                          // 0x1C
+    {0, KEY_NULL},                                          // 0x1D
+    {0, KEY_NULL},                                          // 0x1E
+    {0, KEY_NULL},                                          // 0x1F
+    {0, KEY_SPACE},                                         // ' '
+    {MOD_KEY_LEFTSHIFT, KEY_1},                             // '!'
+    {MOD_KEY_LEFTSHIFT, KEY_2},                             // '"'
+    {0, KEY_HASHTILDE},                                     // '#'
+    {MOD_KEY_LEFTSHIFT, KEY_4},                             // '$'
+    {MOD_KEY_LEFTSHIFT, KEY_5},                             // '%'
+    {MOD_KEY_LEFTSHIFT, KEY_7},                             // '&'
+    {0, KEY_APOSTROPHE},                                    // '\''
+    {MOD_KEY_LEFTSHIFT, KEY_9},                             // '('
+    {MOD_KEY_LEFTSHIFT, KEY_0},                             // ')'
+    {MOD_KEY_LEFTSHIFT, KEY_8},                             // '*'
+    {MOD_KEY_LEFTSHIFT, KEY_EQUAL},                         // '+'
+    {0, KEY_COMMA},                                         // ','
+    {0, KEY_MINUS},                                         // '-'
+    {0, KEY_DOT},                                           // '.'
+    {0, KEY_SLASH},                                         // '/'
+    {0, KEY_0},                                             // '0'
+    {0, KEY_1},                                             // '1'
+    {0, KEY_2},                                             // '2'
+    {0, KEY_3},                                             // '3'
+    {0, KEY_4},                                             // '4'
+    {0, KEY_5},                                             // '5'
+    {0, KEY_6},                                             // '6'
+    {0, KEY_7},                                             // '7'
+    {0, KEY_8},                                             // '8'
+    {0, KEY_9},                                             // '9'
+    {MOD_KEY_LEFTSHIFT, KEY_SEMICOLON},                     // ':'
+    {0, KEY_SEMICOLON},                                     // ';'
+    {MOD_KEY_LEFTSHIFT, KEY_COMMA},                         // '<'
+    {0, KEY_EQUAL},                                         // '='
+    {MOD_KEY_LEFTSHIFT, KEY_DOT},                           // '>'
+    {MOD_KEY_LEFTSHIFT, KEY_SLASH},                         // '?'
+    {MOD_KEY_LEFTSHIFT, KEY_APOSTROPHE},                    // '@'
+    {MOD_KEY_LEFTSHIFT, KEY_A},                             // 'A'
+    {MOD_KEY_LEFTSHIFT, KEY_B},                             // 'B'
+    {MOD_KEY_LEFTSHIFT, KEY_C},                             // 'C'
+    {MOD_KEY_LEFTSHIFT, KEY_D},                             // 'D'
+    {MOD_KEY_LEFTSHIFT, KEY_E},                             // 'E'
+    {MOD_KEY_LEFTSHIFT, KEY_F},                             // 'F'
+    {MOD_KEY_LEFTSHIFT, KEY_G},                             // 'G'
+    {MOD_KEY_LEFTSHIFT, KEY_H},                             // 'H'
+    {MOD_KEY_LEFTSHIFT, KEY_I},                             // 'I'
+    {MOD_KEY_LEFTSHIFT, KEY_J},                             // 'J'
+    {MOD_KEY_LEFTSHIFT, KEY_K},                             // 'K'
+    {MOD_KEY_LEFTSHIFT, KEY_L},                             // 'L'
+    {MOD_KEY_LEFTSHIFT, KEY_M},                             // 'M'
+    {MOD_KEY_LEFTSHIFT, KEY_N},                             // 'N'
+    {MOD_KEY_LEFTSHIFT, KEY_O},                             // 'O'
+    {MOD_KEY_LEFTSHIFT, KEY_P},                             // 'P'
+    {MOD_KEY_LEFTSHIFT, KEY_Q},                             // 'Q'
+    {MOD_KEY_LEFTSHIFT, KEY_R},                             // 'R'
+    {MOD_KEY_LEFTSHIFT, KEY_S},                             // 'S'
+    {MOD_KEY_LEFTSHIFT, KEY_T},                             // 'T'
+    {MOD_KEY_LEFTSHIFT, KEY_U},                             // 'U'
+    {MOD_KEY_LEFTSHIFT, KEY_V},                             // 'V'
+    {MOD_KEY_LEFTSHIFT, KEY_W},                             // 'W'
+    {MOD_KEY_LEFTSHIFT, KEY_X},                             // 'X'
+    {MOD_KEY_LEFTSHIFT, KEY_Y},                             // 'Y'
+    {MOD_KEY_LEFTSHIFT, KEY_Z},                             // 'Z'
+    {0, KEY_LEFTBRACE},                                     // '['
+    {0, KEY_102ND},                                         // '\\'
+    {0, KEY_RIGHTBRACE},                                    // ']'
+    {MOD_KEY_LEFTSHIFT, KEY_6},                             // '^'
+    {MOD_KEY_LEFTSHIFT, KEY_MINUS},                         // '_'
+    {0, KEY_GRAVE},                                         // '`'
+    {0, KEY_A},                                             // 'a'
+    {0, KEY_B},                                             // 'b'
+    {0, KEY_C},                                             // 'c'
+    {0, KEY_D},                                             // 'd'
+    {0, KEY_E},                                             // 'e'
+    {0, KEY_F},                                             // 'f'
+    {0, KEY_G},                                             // 'g'
+    {0, KEY_H},                                             // 'h'
+    {0, KEY_I},                                             // 'i'
+    {0, KEY_J},                                             // 'j'
+    {0, KEY_K},                                             // 'k'
+    {0, KEY_L},                                             // 'l'
+    {0, KEY_M},                                             // 'm'
+    {0, KEY_N},                                             // 'n'
+    {0, KEY_O},                                             // 'o'
+    {0, KEY_P},                                             // 'p'
+    {0, KEY_Q},                                             // 'q'
+    {0, KEY_R},                                             // 'r'
+    {0, KEY_S},                                             // 's'
+    {0, KEY_T},                                             // 't'
+    {0, KEY_U},                                             // 'u'
+    {0, KEY_V},                                             // 'v'
+    {0, KEY_W},                                             // 'w'
+    {0, KEY_X},                                             // 'x'
+    {0, KEY_Y},                                             // 'y'
+    {0, KEY_Z},                                             // 'z'
+    {MOD_KEY_LEFTSHIFT, KEY_LEFTBRACE},                     // '{'
+    {MOD_KEY_LEFTSHIFT, KEY_102ND},                         // '|'
+    {MOD_KEY_LEFTSHIFT, KEY_RIGHTBRACE},                    // '}'
+    {MOD_KEY_LEFTSHIFT, KEY_HASHTILDE},                     // '~'
+    {0, KEY_DELETE}                                         // DEL
+};
+
+const key_ext_entry_t g_ext_keys[] =
+{
+    {0x00A3, MOD_KEY_LEFTSHIFT, KEY_3},                     // '£'
+    {0x00A6, MOD_KEY_RIGHTALT, KEY_GRAVE},                  // '¦'
+    {0x00AC, MOD_KEY_LEFTSHIFT, KEY_GRAVE},                 // '¬'
+    {0x00C1, MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT, KEY_A},  // 'Á'
+    {0x00C9, MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT, KEY_E},  // 'É'
+    {0x00CD, MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT, KEY_I},  // 'Í'
+    {0x00D3, MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT, KEY_O},  // 'Ó'
+    {0x00DA, MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT, KEY_U},  // 'Ú'
+    {0x00E1, MOD_KEY_RIGHTALT, KEY_A},                      // 'á'
+    {0x00E9, MOD_KEY_RIGHTALT, KEY_E},                      // 'é'
+    {0x00ED, MOD_KEY_RIGHTALT, KEY_I},                      // 'í'
+    {0x00F3, MOD_KEY_RIGHTALT, KEY_O},                      // 'ó'
+    {0x00FA, MOD_KEY_RIGHTALT, KEY_U},                      // 'ú'
+    {0x20AC, MOD_KEY_RIGHTALT, KEY_4}                       // '€'
+};
+
+const uint8_t g_num_ext_keys = 14;
+
+#elif KEYBOARD_LAYOUT == LAYOUT_DE
+const key_entry_t g_ascii_keys[128] =
+{
+    {0, KEY_NULL},                                          // NUL
+    {0, KEY_NULL},                                          // 0x01
+    {0, KEY_NULL},                                          // 0x02
+    {0, KEY_NULL},                                          // 0x03
+    {0, KEY_NULL},                                          // 0x04
+    {0, KEY_NULL},                                          // 0x05
+    {0, KEY_NULL},                                          // 0x06
+    {0, KEY_NULL},                                          // 0x07
+    {0, KEY_BACKSPACE},                                     // \b
+    {0, KEY_TAB},                                           // \t
+    {0, KEY_ENTER},                                         // \n
+    {0, KEY_NULL},                                          // 0x0B
+    {0, KEY_NULL},                                          // 0x0C
+    {0, KEY_ENTER},                                         // \r
+    {0, KEY_NULL},                                          // 0x0E
+    {0, KEY_NULL},                                          // 0x0F
+    {0, KEY_NULL},                                          // 0x10
+    {0, KEY_NULL},                                          // 0x11
+    {0, KEY_NULL},                                          // 0x12
+    {0, KEY_NULL},                                          // 0x13
+    {0, KEY_NULL},                                          // 0x14
+    {0, KEY_NULL},                                          // 0x15
+    {0, KEY_NULL},                                          // 0x16
+    {0, KEY_NULL},                                          // 0x17
+    {0, KEY_NULL},                                          // 0x18
+    {0, KEY_NULL},                                          // 0x19
+    {0, KEY_NULL},                                          // 0x1A
+    {0, KEY_ESC},                                           // ESC
+    {0, KEY_NULL},                                          // 0x1C
+    {0, KEY_NULL},                                          // 0x1D
+    {0, KEY_NULL},                                          // 0x1E
+    {0, KEY_NULL},                                          // 0x1F
+    {0, KEY_SPACE},                                         // ' '
+    {MOD_KEY_LEFTSHIFT, KEY_1},                             // '!'
+    {MOD_KEY_LEFTSHIFT, KEY_2},                             // '"'
+    {0, KEY_HASHTILDE},                                     // '#'
+    {MOD_KEY_LEFTSHIFT, KEY_4},                             // '$'
+    {MOD_KEY_LEFTSHIFT, KEY_5},                             // '%'
+    {MOD_KEY_LEFTSHIFT, KEY_6},                             // '&'
+    {MOD_KEY_LEFTSHIFT, KEY_HASHTILDE},                     // '\''
+    {MOD_KEY_LEFTSHIFT, KEY_8},                             // '('
+    {MOD_KEY_LEFTSHIFT, KEY_9},                             // ')'
+    {MOD_KEY_LEFTSHIFT, KEY_RIGHTBRACE},                    // '*'
+    {0, KEY_RIGHTBRACE},                                    // '+'
+    {0, KEY_COMMA},                                         // ','
+    {0, KEY_SLASH},                                         // '-'
+    {0, KEY_DOT},                                           // '.'
+    {MOD_KEY_LEFTSHIFT, KEY_7},                             // '/'
+    {0, KEY_0},                                             // '0'
+    {0, KEY_1},                                             // '1'
+    {0, KEY_2},                                             // '2'
+    {0, KEY_3},                                             // '3'
+    {0, KEY_4},                                             // '4'
+    {0, KEY_5},                                             // '5'
+    {0, KEY_6},                                             // '6'
+    {0, KEY_7},                                             // '7'
+    {0, KEY_8},                                             // '8'
+    {0, KEY_9},                                             // '9'
+    {MOD_KEY_LEFTSHIFT, KEY_DOT},                           // ':'
+    {MOD_KEY_LEFTSHIFT, KEY_COMMA},                         // ';'
+    {0, KEY_102ND},                                         // '<'
+    {MOD_KEY_LEFTSHIFT, KEY_0},                             // '='
+    {MOD_KEY_LEFTSHIFT, KEY_102ND},                         // '>'
+    {MOD_KEY_LEFTSHIFT, KEY_MINUS},                         // '?'
+    {MOD_KEY_RIGHTALT, KEY_Q},                              // '@'
+    {MOD_KEY_LEFTSHIFT, KEY_A},                             // 'A'
+    {MOD_KEY_LEFTSHIFT, KEY_B},                             // 'B'
+    {MOD_KEY_LEFTSHIFT, KEY_C},                             // 'C'
+    {MOD_KEY_LEFTSHIFT, KEY_D},                             // 'D'
+    {MOD_KEY_LEFTSHIFT, KEY_E},                             // 'E'
+    {MOD_KEY_LEFTSHIFT, KEY_F},                             // 'F'
+    {MOD_KEY_LEFTSHIFT, KEY_G},                             // 'G'
+    {MOD_KEY_LEFTSHIFT, KEY_H},                             // 'H'
+    {MOD_KEY_LEFTSHIFT, KEY_I},                             // 'I'
+    {MOD_KEY_LEFTSHIFT, KEY_J},                             // 'J'
+    {MOD_KEY_LEFTSHIFT, KEY_K},                             // 'K'
+    {MOD_KEY_LEFTSHIFT, KEY_L},                             // 'L'
+    {MOD_KEY_LEFTSHIFT, KEY_M},                             // 'M'
+    {MOD_KEY_LEFTSHIFT, KEY_N},                             // 'N'
+    {MOD_KEY_LEFTSHIFT, KEY_O},                             // 'O'
+    {MOD_KEY_LEFTSHIFT, KEY_P},                             // 'P'
+    {MOD_KEY_LEFTSHIFT, KEY_Q},                             // 'Q'
+    {MOD_KEY_LEFTSHIFT, KEY_R},                             // 'R'
+    {MOD_KEY_LEFTSHIFT, KEY_S},                             // 'S'
+    {MOD_KEY_LEFTSHIFT, KEY_T},                             // 'T'
+    {MOD_KEY_LEFTSHIFT, KEY_U},                             // 'U'
+    {MOD_KEY_LEFTSHIFT, KEY_V},                             // 'V'
+    {MOD_KEY_LEFTSHIFT, KEY_W},                             // 'W'
+    {MOD_KEY_LEFTSHIFT, KEY_X},                             // 'X'
+    {MOD_KEY_LEFTSHIFT, KEY_Z},                             // 'Y'
+    {MOD_KEY_LEFTSHIFT, KEY_Y},                             // 'Z'
+    {MOD_KEY_RIGHTALT, KEY_8},                              // '['
+    {MOD_KEY_RIGHTALT, KEY_MINUS},                          // '\\'
+    {MOD_KEY_RIGHTALT, KEY_9},                              // ']'
+    {0, KEY_DEAD | KEY_GRAVE},                              // '^'
+    {MOD_KEY_LEFTSHIFT, KEY_SLASH},                         // '_'
+    {MOD_KEY_LEFTSHIFT, KEY_DEAD | KEY_EQUAL},              // '`'
+    {0, KEY_A},                                             // 'a'
+    {0, KEY_B},                                             // 'b'
+    {0, KEY_C},                                             // 'c'
+    {0, KEY_D},                                             // 'd'
+    {0, KEY_E},                                             // 'e'
+    {0, KEY_F},                                             // 'f'
+    {0, KEY_G},                                             // 'g'
+    {0, KEY_H},                                             // 'h'
+    {0, KEY_I},                                             // 'i'
+    {0, KEY_J},                                             // 'j'
+    {0, KEY_K},                                             // 'k'
+    {0, KEY_L},                                             // 'l'
+    {0, KEY_M},                                             // 'm'
+    {0, KEY_N},                                             // 'n'
+    {0, KEY_O},                                             // 'o'
+    {0, KEY_P},                                             // 'p'
+    {0, KEY_Q},                                             // 'q'
+    {0, KEY_R},                                             // 'r'
+    {0, KEY_S},                                             // 's'
+    {0, KEY_T},                                             // 't'
+    {0, KEY_U},                                             // 'u'
+    {0, KEY_V},                                             // 'v'
+    {0, KEY_W},                                             // 'w'
+    {0, KEY_X},                                             // 'x'
+    {0, KEY_Z},                                             // 'y'
+    {0, KEY_Y},                                             // 'z'
+    {MOD_KEY_RIGHTALT, KEY_7},                              // '{'
+    {MOD_KEY_RIGHTALT, KEY_102ND},                          // '|'
+    {MOD_KEY_RIGHTALT, KEY_0},                              // '}'
+    {MOD_KEY_RIGHTALT, KEY_RIGHTBRACE},                     // '~'
+    {0, KEY_DELETE}                                         // DEL
+};
+
+const key_ext_entry_t g_ext_keys[] =
+{
+    {0x00A7, MOD_KEY_LEFTSHIFT, KEY_3},                     // '§'
+    {0x00B0, MOD_KEY_LEFTSHIFT, KEY_GRAVE},                 // '°'
+    {0x00B2, MOD_KEY_RIGHTALT, KEY_2},                      // '²'
+    {0x00B3, MOD_KEY_RIGHTALT, KEY_3},                      // '³'
+    {0x00B4, 0, KEY_DEAD | KEY_EQUAL},                      // '´'
+    {0x00B5, MOD_KEY_RIGHTALT, KEY_M},                      // 'µ'
+    {0x00C4, MOD_KEY_LEFTSHIFT, KEY_APOSTROPHE},            // 'Ä'
+    {0x00D6, MOD_KEY_LEFTSHIFT, KEY_SEMICOLON},             // 'Ö'
+    {0x00DC, MOD_KEY_LEFTSHIFT, KEY_LEFTBRACE},             // 'Ü'
+    {0x00DF, 0, KEY_MINUS},                                 // 'ß'
+    {0x00E4, 0, KEY_APOSTROPHE},                            // 'ä'
+    {0x00F6, 0, KEY_SEMICOLON},                             // 'ö'
+    {0x00FC, 0, KEY_LEFTBRACE},                             // 'ü'
+    {0x20AC, MOD_KEY_RIGHTALT, KEY_E}                       // '€'
+};
+
+const uint8_t g_num_ext_keys = 14;
+
+#elif KEYBOARD_LAYOUT == LAYOUT_FR
+const key_entry_t g_ascii_keys[128] =
+{
+    {0, KEY_NULL},                                          // NUL
+    {0, KEY_NULL},                                          // 0x01
+    {0, KEY_NULL},                                          // 0x02
+    {0, KEY_NULL},                                          // 0x03
+    {0, KEY_NULL},                                          // 0x04
+    {0, KEY_NULL},                                          // 0x05
+    {0, KEY_NULL},                                          // 0x06
+    {0, KEY_NULL},                                          // 0x07
+    {0, KEY_BACKSPACE},                                     // \b
+    {0, KEY_TAB},                                           // \t
+    {0, KEY_ENTER},                                         // \n
+    {0, KEY_NULL},                                          // 0x0B
+    {0, KEY_NULL},                                          // 0x0C
+    {0, KEY_ENTER},                                         // \r
+    {0, KEY_NULL},                                          // 0x0E
+    {0, KEY_NULL},                                          // 0x0F
+    {0, KEY_NULL},                                          // 0x10
+    {0, KEY_NULL},                                          // 0x11
+    {0, KEY_NULL},                                          // 0x12
+    {0, KEY_NULL},                                          // 0x13
+    {0, KEY_NULL},                                          // 0x14
+    {0, KEY_NULL},                                          // 0x15
+    {0, KEY_NULL},                                          // 0x16
+    {0, KEY_NULL},                                          // 0x17
+    {0, KEY_NULL},                                          // 0x18
+    {0, KEY_NULL},                                          // 0x19
+    {0, KEY_NULL},                                          // 0x1A
+    {0, KEY_ESC},                                           // ESC
+    {0, KEY_NULL},                                          // 0x1C
+    {0, KEY_NULL},                                          // 0x1D
+    {0, KEY_NULL},                                          // 0x1E
+    {0, KEY_NULL},                                          // 0x1F
+    {0, KEY_SPACE},                                         // ' '
+    {0, KEY_SLASH},                                         // '!'
+    {0, KEY_3},                                             // '"'
+    {MOD_KEY_RIGHTALT, KEY_3},                              // '#'
+    {0, KEY_RIGHTBRACE},                                    // '$'
+    {MOD_KEY_LEFTSHIFT, KEY_APOSTROPHE},                    // '%'
+    {0, KEY_1},                                             // '&'
+    {0, KEY_4},                                             // '\''
+    {0, KEY_5},                                             // '('
+    {0, KEY_MINUS},                                         // ')'
+    {0, KEY_HASHTILDE},                                     // '*'
+    {MOD_KEY_LEFTSHIFT, KEY_EQUAL},                         // '+'
+    {0, KEY_M},                                             // ','
+    {0, KEY_6},                                             // '-'
+    {MOD_KEY_LEFTSHIFT, KEY_COMMA},                         // '.'
+    {MOD_KEY_LEFTSHIFT, KEY_DOT},                           // '/'
+    {MOD_KEY_LEFTSHIFT, KEY_0},                             // '0'
+    {MOD_KEY_LEFTSHIFT, KEY_1},                             // '1'
+    {MOD_KEY_LEFTSHIFT, KEY_2},                             // '2'
+    {MOD_KEY_LEFTSHIFT, KEY_3},                             // '3'
+    {MOD_KEY_LEFTSHIFT, KEY_4},                             // '4'
+    {MOD_KEY_LEFTSHIFT, KEY_5},                             // '5'
+    {MOD_KEY_LEFTSHIFT, KEY_6},                             // '6'
+    {MOD_KEY_LEFTSHIFT, KEY_7},                             // '7'
+    {MOD_KEY_LEFTSHIFT, KEY_8},                             // '8'
+    {MOD_KEY_LEFTSHIFT, KEY_9},                             // '9'
+    {0, KEY_DOT},                                           // ':'
+    {0, KEY_COMMA},                                         // ';'
+    {0, KEY_102ND},                                         // '<'
+    {0, KEY_EQUAL},                                         // '='
+    {MOD_KEY_LEFTSHIFT, KEY_102ND},                         // '>'
+    {MOD_KEY_LEFTSHIFT, KEY_M},                             // '?'
+    {MOD_KEY_RIGHTALT, KEY_0},                              // '@'
+    {MOD_KEY_LEFTSHIFT, KEY_Q},                             // 'A'
+    {MOD_KEY_LEFTSHIFT, KEY_B},                             // 'B'
+    {MOD_KEY_LEFTSHIFT, KEY_C},                             // 'C'
+    {MOD_KEY_LEFTSHIFT, KEY_D},                             // 'D'
+    {MOD_KEY_LEFTSHIFT, KEY_E},                             // 'E'
+    {MOD_KEY_LEFTSHIFT, KEY_F},                             // 'F'
+    {MOD_KEY_LEFTSHIFT, KEY_G},                             // 'G'
+    {MOD_KEY_LEFTSHIFT, KEY_H},                             // 'H'
+    {MOD_KEY_LEFTSHIFT, KEY_I},                             // 'I'
+    {MOD_KEY_LEFTSHIFT, KEY_J},                             // 'J'
+    {MOD_KEY_LEFTSHIFT, KEY_K},                             // 'K'
+    {MOD_KEY_LEFTSHIFT, KEY_L},                             // 'L'
+    {MOD_KEY_LEFTSHIFT, KEY_SEMICOLON},                     // 'M'
+    {MOD_KEY_LEFTSHIFT, KEY_N},                             // 'N'
+    {MOD_KEY_LEFTSHIFT, KEY_O},                             // 'O'
+    {MOD_KEY_LEFTSHIFT, KEY_P},                             // 'P'
+    {MOD_KEY_LEFTSHIFT, KEY_A},                             // 'Q'
+    {MOD_KEY_LEFTSHIFT, KEY_R},                             // 'R'
+    {MOD_KEY_LEFTSHIFT, KEY_S},                             // 'S'
+    {MOD_KEY_LEFTSHIFT, KEY_T},                             // 'T'
+    {MOD_KEY_LEFTSHIFT, KEY_U},                             // 'U'
+    {MOD_KEY_LEFTSHIFT, KEY_V},                             // 'V'
+    {MOD_KEY_LEFTSHIFT, KEY_Z},                             // 'W'
+    {MOD_KEY_LEFTSHIFT, KEY_X},                             // 'X'
+    {MOD_KEY_LEFTSHIFT, KEY_Y},                             // 'Y'
+    {MOD_KEY_LEFTSHIFT, KEY_W},                             // 'Z'
+    {MOD_KEY_RIGHTALT, KEY_5},                              // '['
+    {MOD_KEY_RIGHTALT, KEY_8},                              // '\\'
+    {MOD_KEY_RIGHTALT, KEY_MINUS},                          // ']'
+    {MOD_KEY_RIGHTALT, KEY_9},                              // '^'
+    {0, KEY_8},                                             // '_'
+    {MOD_KEY_RIGHTALT, KEY_DEAD | KEY_7},                   // '`'
+    {0, KEY_Q},                                             // 'a'
+    {0, KEY_B},                                             // 'b'
+    {0, KEY_C},                                             // 'c'
+    {0, KEY_D},                                             // 'd'
+    {0, KEY_E},                                             // 'e'
+    {0, KEY_F},                                             // 'f'
+    {0, KEY_G},                                             // 'g'
+    {0, KEY_H},                                             // 'h'
+    {0, KEY_I},                                             // 'i'
+    {0, KEY_J},                                             // 'j'
+    {0, KEY_K},                                             // 'k'
+    {0, KEY_L},                                             // 'l'
+    {0, KEY_SEMICOLON},                                     // 'm'
+    {0, KEY_N},                                             // 'n'
+    {0, KEY_O},                                             // 'o'
+    {0, KEY_P},                                             // 'p'
+    {0, KEY_A},                                             // 'q'
+    {0, KEY_R},                                             // 'r'
+    {0, KEY_S},                                             // 's'
+    {0, KEY_T},                                             // 't'
+    {0, KEY_U},                                             // 'u'
+    {0, KEY_V},                                             // 'v'
+    {0, KEY_Z},                                             // 'w'
+    {0, KEY_X},                                             // 'x'
+    {0, KEY_Y},                                             // 'y'
+    {0, KEY_W},                                             // 'z'
+    {MOD_KEY_RIGHTALT, KEY_4},                              // '{'
+    {MOD_KEY_RIGHTALT, KEY_6},                              // '|'
+    {MOD_KEY_RIGHTALT, KEY_EQUAL},                          // '}'
+    {MOD_KEY_RIGHTALT, KEY_DEAD | KEY_2},                   // '~'
+    {0, KEY_DELETE}                                         // DEL
+};
+
+const key_ext_entry_t g_ext_keys[] =
+{
+    {0x00A3, MOD_KEY_LEFTSHIFT, KEY_RIGHTBRACE},            // '£'
+    {0x00A4, MOD_KEY_RIGHTALT, KEY_RIGHTBRACE},             // '¤'
+    {0x00A7, MOD_KEY_LEFTSHIFT, KEY_SLASH},                 // '§'
+    {0x00A8, MOD_KEY_LEFTSHIFT, KEY_DEAD | KEY_LEFTBRACE},  // '¨'
+    {0x00B0, MOD_KEY_LEFTSHIFT, KEY_MINUS},                 // '°'
+    {0x00B2, 0, KEY_GRAVE},                                 // '²'
+    {0x00B5, MOD_KEY_LEFTSHIFT, KEY_HASHTILDE},             // 'µ'
+    {0x00E0, 0, KEY_0},                                     // 'à'
+    {0x00E7, 0, KEY_9},                                     // 'ç'
+    {0x00E8, 0, KEY_7},                                     // 'è'
+    {0x00E9, 0, KEY_2},                                     // 'é'
+    {0x00F9, 0, KEY_APOSTROPHE},                            // 'ù'
+    {0x20AC, MOD_KEY_RIGHTALT, KEY_E}                       // '€'
+};
+
+const uint8_t g_num_ext_keys = 13;
+
+#else
+#error "Unknown KEYBOARD_LAYOUT."
+#endif
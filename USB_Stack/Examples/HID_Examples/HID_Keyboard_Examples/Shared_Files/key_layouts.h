@@ -0,0 +1,62 @@
+/**
+ * @file key_layouts.h
+ * @brief Keyboard layout IDs and table types.
+ * @author John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_key_layouts.py from the layouts in
+ * USB_Stack/Tools/Keyboard_Layouts, do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef KEY_LAYOUTS_H
+#define KEY_LAYOUTS_H
+
+#include <stdint.h>
+
+// Layout IDs for KEYBOARD_LAYOUT.
+#define LAYOUT_US 0
+#define LAYOUT_UK 1
+#define LAYOUT_DE 2
+#define LAYOUT_FR 3
+
+// KeyCode flag for a dead key, it is typed by following it with a space.
+#define KEY_DEAD 0x80
+
+typedef struct
+{
+    uint8_t Modifier;
+    uint8_t KeyCode;
+}key_entry_t;
+
+typedef struct
+{
+    uint16_t Codepoint;
+    uint8_t  Modifier;
+    uint8_t  KeyCode;
+}key_ext_entry_t;
+
+extern const key_entry_t     g_ascii_keys[128]; // Indexed by ASCII value.
+extern const key_ext_entry_t g_ext_keys[];      // Other characters, sorted by codepoint.
+extern const uint8_t         g_num_ext_keys;
+
+#endif /* KEY_LAYOUTS_H */
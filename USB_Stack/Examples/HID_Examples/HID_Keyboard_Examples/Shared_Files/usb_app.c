@@ -52,7 +52,7 @@ void usb_app_init(void)
 
 void usb_app_tasks(void)
 {
-    if(TRANSACTION_EP == HID_EP) hid_tasks();
+    hid_tasks();
 }
 
 
@@ -67,7 +67,7 @@ bool usb_app_set_interface(uint8_t alternate_setting, uint8_t interface)
 #if NUM_ALT_INTERFACES != 0
     if(g_set_interface.Interface < NUM_INTERFACES) return true;
 #else
-    if(alternate_setting != 0 || interface != 0) return false;
+    if(alternate_setting != 0 || interface >= NUM_INTERFACES) return false;
 
     hid_clear_ep_toggle();
     return true;
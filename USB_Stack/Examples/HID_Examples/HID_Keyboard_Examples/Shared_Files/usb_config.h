@@ -56,11 +56,12 @@
 #define PINGPONG_MODE     PINGPONG_0_OUT
 
 #define NUM_CONFIGURATIONS 1
-#define NUM_INTERFACES     1
+#define NUM_INTERFACES     2
 #define NUM_ALT_INTERFACES 0
-#define NUM_ENDPOINTS      2
+#define NUM_ENDPOINTS      3
 #define EP0_SIZE           8
 #define EP1_SIZE           16
+#define EP2_SIZE           16
 
 /* ************************************************************************** */
 
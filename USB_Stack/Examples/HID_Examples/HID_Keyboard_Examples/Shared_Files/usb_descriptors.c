@@ -28,73 +28,11 @@
 
 #include "usb_config.h"
 #include "usb_hid.h"
+#include "usb_hid_reports.h"
 #include "usb_hid_report_defines.h"
 #include "usb_hid_pages.h"
 #include "usb_ch9.h"
 
-// Report Descriptor (Keyboard)
-const uint8_t g_hid_report_descriptor[] =
-{
-    Usage_Page(GENERIC_DESKTOP_PAGE),
-    Usage(KEYBOARD),
-    Collection(APPLICATION),
-        Report_ID(1),
-    
-        Usage_Page(LED_PAGE),
-        Usage_Minimum(LED_NUM_LOCK),
-        Usage_Maximum(LED_KANA),
-        Logic_Minimum(0),
-        Logic_Maximum(1),
-        Report_Size(1),
-        Report_Count(5),
-        Output(DATA|VARIABLE|ABSOLUTE),
-        Logic_Minimum(0),
-        Logic_Maximum(0),
-        Report_Count(1),
-        Report_Size(3),
-        Output(CONSTANT),
-    
-        Usage_Page(KEYBOARD_KEYPAD_PAGE),
-        Usage_Minimum(KEY_LEFTCTRL),
-        Usage_Maximum(KEY_RIGHTMETA),
-        Logic_Minimum(0),
-        Logic_Maximum(1),
-        Report_Size(1),
-        Report_Count(8),
-        Input(DATA|VARIABLE|ABSOLUTE),
-    
-        Usage_Minimum(0),
-        Usage_Maximum(101),
-        Logic_Minimum(0),
-        Logic_Maximum(101),      
-        Report_Size(8),
-        Report_Count(1),
-        Input(DATA|ARRAY),
-    End_Collection(),
-    
-    Usage_Page(CONSUMER_PAGE),
-    Usage(CONSUMER_CONSUMER_CONTROL),
-    Collection(APPLICATION),
-        Report_ID(2),
-        Usage_Page(CONSUMER_PAGE),
-        Usage(CONSUMER_SCAN_NEXT_TRACK),
-        Usage(CONSUMER_SCAN_PREVIOUS_TRACK),
-        Usage(CONSUMER_STOP),
-        Usage(CONSUMER_EJECT),
-        Usage(CONSUMER_PLAY_PAUSE),
-        Usage(CONSUMER_MUTE),
-        Usage(CONSUMER_VOLUME_INCREMENT),
-        Usage(CONSUMER_VOLUME_DECREMENT),
-        Logic_Minimum(0),
-        Logic_Maximum(1),
-        Report_Size(1),
-        Report_Count(8),
-        Input(DATA|VARIABLE|ABSOLUTE),
-    End_Collection()
-};
-
-const uint16_t g_hid_report_descriptor_size = sizeof(g_hid_report_descriptor);
-
 /** Device Descriptor */
 const ch9_device_descriptor_t g_device_descriptor =
 {
@@ -122,6 +60,9 @@ typedef struct
     hid_descriptor_t                    hid_descriptor;
     ch9_standard_endpoint_descriptor_t  ep1_in_descriptor;
     ch9_standard_endpoint_descriptor_t  ep1_out_descriptor;
+    ch9_standard_interface_descriptor_t interface1_descriptor;
+    hid_descriptor_t                    hid1_descriptor;
+    ch9_standard_endpoint_descriptor_t  ep2_in_descriptor;
 }config_descriptor_t;
 
 /** Configuration Descriptor */
@@ -132,7 +73,7 @@ static const config_descriptor_t config_descriptor0 =
         9,                          // bLength:8 - Size of configuration descriptor in bytes
         CONFIGURATION_DESC,         // bDescriptorType:8 - Configuration descriptor type
         sizeof(config_descriptor0), // wTotalLength:16 - Total amount of bytes in descriptors belonging to this configuration
-        0x01,                       // bNumInterfaces:8 - Number of interfaces in this configuration
+        0x02,                       // bNumInterfaces:8 - Number of interfaces in this configuration
         0x01,                       // bConfigurationValue:8 - Index value for this configuration
         0x00,                       // iConfiguration:8 - Index of string describing this configuration
         0xC0,                       // bmAttributes:8 {0:5,RemoteWakeup:1,SelfPowered:1,1:1} - Self Powered
@@ -160,7 +101,7 @@ static const config_descriptor_t config_descriptor0 =
         0x00,               // bCountryCode:8 - Country code of localized hardware
         HID_NUM_DESC,       // bNumDescriptors:8 - Number of HID class descriptors 
         HID_REPORT_DESC,    // bClassDescriptorType:8 - HID class descriptor type
-        sizeof(g_hid_report_descriptor) // wDescriptorLength:16 - Size of HID report descriptor in bytes  // 0x003F
+        HID_REPORT_DESC_SIZE // wDescriptorLength:16 - Size of HID report descriptor in bytes
     },
 
     // Endpoint Descriptor
@@ -170,7 +111,7 @@ static const config_descriptor_t config_descriptor0 =
         0x81,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
         0x03,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
         EP1_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
-        0x0A                // bInterval:8 - Interval   //0x01
+        0x01                // bInterval:8 - Interval (1 ms, one report per frame)
     },
 
     // Endpoint Descriptor
@@ -181,11 +122,46 @@ static const config_descriptor_t config_descriptor0 =
         0x03,             // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
         EP1_SIZE,         // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
         0x0A              // bInterval:8 - Interval
+    },
+
+    // Interface Descriptor
+    {
+        9,              // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC, // bDescriptorType:8 - Interface descriptor type
+        0x01,           // bInterfaceNumber:8 - Index number of interface
+        0x00,           // bAlternateSetting:8 - Value used to select alternate setting
+        0x01,           // bNumEndpoints:8 - Number of endpoints used in this interface
+        HID,            // bInterfaceClass:8 - Class Code (Assigned by USB Org)
+        0,              // bInterfaceSubClass:8 - Subclass Code (Assigned by USB Org)
+        0,              // bInterfaceProtocol:8 - Protocol Code (Assigned by USB Org)
+        0x00            // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    // HID Descriptor
+    {
+        9,                    // bLength:8 - Size of HID descriptor in bytes
+        HID_DESC,             // bDescriptorType:8 - HID descriptor type
+        0x0111,               // bcdHID:16 - HID spec release (1.11)
+        0x00,                 // bCountryCode:8 - Country code of localized hardware
+        HID_NUM_DESC,         // bNumDescriptors:8 - Number of HID class descriptors
+        HID_REPORT_DESC,      // bClassDescriptorType:8 - HID class descriptor type
+        HID1_REPORT_DESC_SIZE // wDescriptorLength:16 - Size of HID report descriptor in bytes
+    },
+
+    // Endpoint Descriptor
+    {
+        7,                  // bLength:8 - Size of EP descriptor in bytes
+        ENDPOINT_DESC,      // bDescriptorType:8 - Endpoint Descriptor Type
+        0x82,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
+        0x03,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
+        EP2_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
+        0x0A                // bInterval:8 - Interval
     }
 };
 
-/** hid_descriptor Address */
-const uint8_t* g_hid_descriptor = (uint8_t*)&config_descriptor0.hid_descriptor;
+/** hid_descriptor Addresses */
+const uint8_t* g_hid_descriptor  = (uint8_t*)&config_descriptor0.hid_descriptor;
+const uint8_t* g_hid1_descriptor = (uint8_t*)&config_descriptor0.hid1_descriptor;
 
 /** Configuration Descriptor Addresses Array */
 const uint16_t g_config_descriptors[] = 
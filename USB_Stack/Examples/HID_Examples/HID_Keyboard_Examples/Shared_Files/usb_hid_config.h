@@ -30,6 +30,7 @@
 #define USB_HID_CONFIG_H
 
 #include "usb_config.h"
+#include "usb_hid_reports.h" // Report counts and sizes, made by Tools/gen_hid_reports.py.
 
 /* SETTINGS */
 // Number of HID descriptors
@@ -50,6 +51,10 @@
 // Idle_Settings
 #define DEFAULT_IDLE 500 // in mS
 
+// IN Report Queue
+#define HID_IN_QUEUE_SIZE        8 // Reports waiting to be sent, power of 2.
+#define HID_IN_QUEUE_REPORT_SIZE HID_LARGEST_IN_REPORT // Largest IN report in bytes, including Report ID.
+
 // HID Endpoint HAL
 #define HID_EP      EP1
 #define HID_EP_SIZE EP1_SIZE
@@ -67,14 +72,20 @@
 
 #define HID_UEPbits UEP1bits
 
-/* NUMBER OF REPORTS */
-#define HID_NUM_IN_REPORTS       2
-#define HID_NUM_OUT_REPORTS      1
-#define HID_NUM_FEATURE_REPORTS  0
+// HID Interfaces, the keyboard is interface 0 and Consumer Control interface 1.
+// Report counts for interface 1 come from usb_hid_reports.h.
+#define HID_NUM_INTERFACES 2
+#define HID_INT            0
 
-/* REPORT STRUCTURES/VARS/DEFINES */
-#define HID_USE_REPORT_IDS 0
-#define HID_NUM_REPORT_IDS 2
+#define HID1_INT         1
+#define HID1_EP          EP2
+#define HID1_BD_OUT      BD2_OUT
+#define HID1_BD_OUT_EVEN BD2_OUT_EVEN
+#define HID1_BD_OUT_ODD  BD2_OUT_ODD
+#define HID1_BD_IN       BD2_IN
+#define HID1_BD_IN_EVEN  BD2_IN_EVEN
+#define HID1_BD_IN_ODD   BD2_IN_ODD
+#define HID1_UEPbits     UEP2bits
 
 // KEY MODIFIERS
 #define MOD_KEY_LEFTCTRL    0x01 // LeftControl
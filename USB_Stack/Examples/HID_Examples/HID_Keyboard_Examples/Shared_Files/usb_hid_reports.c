@@ -1,11 +1,13 @@
 /**
  * @file usb_hid_reports.c
- * @brief <i>Human Interface Device Class</i> user reports.
+ * @brief HID report descriptor and report tables, made from usb_hid_reports.spec.
  * @author John Izzard
- * @date 2024-11-14
- * 
- * USB uC - HID Library.
- * Copyright (C) 2017-2024 John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_hid_reports.py from usb_hid_reports.spec,
+ * do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the “Software”), to deal
@@ -25,44 +27,92 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
-
+ 
+#include <stdint.h>
+#include "usb_hid_report_defines.h"
+#include "usb_hid_pages.h"
 #include "usb_hid_reports.h"
 
-volatile hid_in_report1_t g_hid_in_report1 = {1,0,0};
-volatile hid_in_report2_t g_hid_in_report2 = {2,0};
+const uint8_t g_hid_report_descriptor[HID_REPORT_DESC_SIZE] =
+{
+    Usage_Page(GENERIC_DESKTOP_PAGE),
+    Usage(KEYBOARD),
+    Collection(APPLICATION),
+        Usage_Page(LED_PAGE),
+        Usage_Minimum(LED_NUM_LOCK),
+        Usage_Maximum(LED_KANA),
+        Logic_Minimum(0),
+        Logic_Maximum(1),
+        Report_Size(1),
+        Report_Count(5),
+        Output(DATA|VARIABLE|ABSOLUTE),
+        Report_Size(3),
+        Report_Count(1),
+        Output(CONSTANT),
+        Usage_Page(KEYBOARD_KEYPAD_PAGE),
+        Usage_Minimum(KEY_LEFTCTRL),
+        Usage_Maximum(KEY_RIGHTMETA),
+        Report_Size(1),
+        Report_Count(8),
+        Input(DATA|VARIABLE|ABSOLUTE),
+        Report_Size(8),
+        Report_Count(1),
+        Input(CONSTANT),
+        Usage_Minimum(0),
+        Usage_Maximum(101),
+        Logic_Maximum(101),
+        Report_Count(6),
+        Input(DATA|ARRAY),
+    End_Collection()
+};
+
+const uint16_t g_hid_report_descriptor_size = HID_REPORT_DESC_SIZE;
+
+const uint8_t g_hid1_report_descriptor[HID1_REPORT_DESC_SIZE] =
+{
+    Usage_Page(CONSUMER_PAGE),
+    Usage(CONSUMER_CONSUMER_CONTROL),
+    Collection(APPLICATION),
+        Usage(CONSUMER_SCAN_NEXT_TRACK),
+        Usage(CONSUMER_SCAN_PREVIOUS_TRACK),
+        Usage(CONSUMER_STOP),
+        Usage(CONSUMER_EJECT),
+        Usage(CONSUMER_PLAY_PAUSE),
+        Usage(CONSUMER_MUTE),
+        Usage(CONSUMER_VOLUME_INCREMENT),
+        Usage(CONSUMER_VOLUME_DECREMENT),
+        Logic_Minimum(0),
+        Logic_Maximum(1),
+        Report_Size(1),
+        Report_Count(8),
+        Input(DATA|VARIABLE|ABSOLUTE),
+    End_Collection()
+};
+
+const uint16_t g_hid1_report_descriptor_size = HID1_REPORT_DESC_SIZE;
+
+volatile hid_in_report1_t g_hid_in_report1;
+volatile hid_in_report2_t g_hid_in_report2;
+volatile hid_out_report1_t g_hid_out_report1;
 
 const uint16_t g_hid_in_reports[] =
 {
     (uint16_t)&g_hid_in_report1,
-    (uint16_t)&g_hid_in_report2
+    (uint16_t)&g_hid_in_report2,
 };
 
 const uint8_t g_hid_in_report_size[] =
 {
     sizeof(g_hid_in_report1),
-    sizeof(g_hid_in_report2)
+    sizeof(g_hid_in_report2),
 };
 
-volatile hid_out_report1_t g_hid_out_report1;
-
 const uint16_t g_hid_out_reports[] =
 {
-    (uint16_t)&g_hid_out_report1
+    (uint16_t)&g_hid_out_report1,
 };
 
 const uint8_t g_hid_out_report_size[] =
 {
-    sizeof(g_hid_out_report1)
+    sizeof(g_hid_out_report1),
 };
-
-//volatile hid_feature_report1_t g_hid_feature_report1;
-//
-//uint16_t g_hid_feature_reports[] =
-//{
-//    (uint16_t)&g_hid_feature_report1,
-//};
-//
-//uint8_t g_hid_feature_report_size[] =
-//{
-//    sizeof(g_hid_feature_report1)
-//};
\ No newline at end of file
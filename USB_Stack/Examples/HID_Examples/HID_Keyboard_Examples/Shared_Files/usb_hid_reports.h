@@ -1,11 +1,13 @@
 /**
  * @file usb_hid_reports.h
- * @brief <i>Human Interface Device Class</i> user report types.
+ * @brief HID report structs, made from usb_hid_reports.spec.
  * @author John Izzard
- * @date 2024-11-14
- * 
- * USB uC - HID Library.
- * Copyright (C) 2017-2024 John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_hid_reports.py from usb_hid_reports.spec,
+ * do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the “Software”), to deal
@@ -25,15 +27,27 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
-
+ 
 #ifndef USB_HID_REPORTS_H
 #define USB_HID_REPORTS_H
 
 #include <stdint.h>
 
+/* NUMBER OF REPORTS */
+#define HID_NUM_IN_REPORTS       2
+#define HID_NUM_OUT_REPORTS      1
+#define HID_NUM_FEATURE_REPORTS  0
+#define HID1_NUM_IN_REPORTS      1
+#define HID1_NUM_OUT_REPORTS     0
+#define HID1_NUM_FEATURE_REPORTS 0
+
+/* REPORT STRUCTURES/VARS/DEFINES */
+#define HID_USE_REPORT_IDS 0
+#define HID_NUM_REPORT_IDS 0
+#define HID1_NUM_REPORT_IDS 0
+
 typedef struct
 {
-    uint8_t Report_ID;
     union
     {
         uint8_t Modifiers;
@@ -49,14 +63,12 @@ typedef struct
             unsigned RIGHT_GUI   :1;
         };
     };
-    //uint8_t Reserved;
-    //uint8_t Keycode[6];
-    uint8_t Keycode;
-}hid_in_report1_t;
+    uint8_t Reserved;
+    uint8_t Keycode[6];
+}hid_in_report1_t; // 8 bytes
 
 typedef struct
 {
-    uint8_t Report_ID;
     union
     {
         uint8_t Consumer_Byte;
@@ -72,33 +84,41 @@ typedef struct
             unsigned VOLUME_DECREMENT    :1;
         };
     };
-}hid_in_report2_t;
+}hid_in_report2_t; // 1 bytes
 
 typedef struct
 {
-    uint8_t Report_ID;
-    struct{
-        unsigned NUM_LOCK    :1;
-        unsigned CAPS_LOCK   :1;
-        unsigned SCROLL_LOCK :1;
-        unsigned COMPOSE     :1;
-        unsigned KANA        :1;
-        unsigned             :3;
+    union
+    {
+        uint8_t Leds;
+        struct
+        {
+            unsigned NUM_LOCK    :1;
+            unsigned CAPS_LOCK   :1;
+            unsigned SCROLL_LOCK :1;
+            unsigned COMPOSE     :1;
+            unsigned KANA        :1;
+            unsigned             :3;
+        };
     };
-}hid_out_report1_t;
+}hid_out_report1_t; // 1 bytes
 
-typedef struct
-{
+#define HID_REPORT_DESC_SIZE  57 // Size of g_hid_report_descriptor.
+#define HID1_REPORT_DESC_SIZE 33 // Size of g_hid1_report_descriptor.
+#define HID_LARGEST_IN_REPORT 8 // For HID_IN_QUEUE_REPORT_SIZE.
 
-}hid_feature_report1_t;
+extern const uint8_t  g_hid_report_descriptor[HID_REPORT_DESC_SIZE];
+extern const uint16_t g_hid_report_descriptor_size;
 
-extern volatile hid_in_report1_t  g_hid_in_report1;
-extern volatile hid_in_report2_t  g_hid_in_report2;
-extern const    uint16_t          g_hid_in_reports[];
-extern const    uint8_t           g_hid_in_report_size[];
+extern const uint8_t  g_hid1_report_descriptor[HID1_REPORT_DESC_SIZE];
+extern const uint16_t g_hid1_report_descriptor_size;
 
+extern volatile hid_in_report1_t g_hid_in_report1;
+extern volatile hid_in_report2_t g_hid_in_report2;
 extern volatile hid_out_report1_t g_hid_out_report1;
-extern const    uint16_t          g_hid_out_reports[];
-extern const    uint8_t           g_hid_out_report_size[];
+extern const uint16_t g_hid_in_reports[];
+extern const uint8_t  g_hid_in_report_size[];
+extern const uint16_t g_hid_out_reports[];
+extern const uint8_t  g_hid_out_report_size[];
 
-#endif /* USB_HID_REPORTS_H */
\ No newline at end of file
+#endif /* USB_HID_REPORTS_H */
@@ -0,0 +1,24 @@
+# Keyboard + Consumer Control reports, made into usb_hid_reports.h/.c with:
+# python3 ../../../../Tools/gen_hid_reports.py usb_hid_reports.spec .
+#
+# The keyboard is interface 0 (EP1) and Consumer Control is interface 1 (EP2),
+# each with one report and no Report IDs, so the keyboard report is the plain
+# 8 byte layout BIOSes expect.
+
+usage_page GENERIC_DESKTOP_PAGE
+usage KEYBOARD
+collection APPLICATION
+    output Leds usage_page=LED_PAGE usage=LED_NUM_LOCK..LED_KANA logical=0..1 size=1 count=5 bits=NUM_LOCK,CAPS_LOCK,SCROLL_LOCK,COMPOSE,KANA
+    output - size=3
+    input Modifiers usage_page=KEYBOARD_KEYPAD_PAGE usage=KEY_LEFTCTRL..KEY_RIGHTMETA size=1 count=8 bits=LEFT_CTRL,LEFT_SHIFT,LEFT_ALT,LEFT_GUI,RIGHT_CTRL,RIGHT_SHIFT,RIGHT_ALT,RIGHT_GUI
+    input Reserved size=8 flags=CONSTANT
+    input Keycode usage=0..101 logical=0..101 size=8 count=6 flags=DATA|ARRAY
+end
+
+interface
+
+usage_page CONSUMER_PAGE
+usage CONSUMER_CONSUMER_CONTROL
+collection APPLICATION
+    input Consumer_Byte usage=CONSUMER_SCAN_NEXT_TRACK,CONSUMER_SCAN_PREVIOUS_TRACK,CONSUMER_STOP,CONSUMER_EJECT,CONSUMER_PLAY_PAUSE,CONSUMER_MUTE,CONSUMER_VOLUME_INCREMENT,CONSUMER_VOLUME_DECREMENT logical=0..1 size=1 count=8 bits=SCAN_NEXT_TRACK,SCAN_PREVIOUS_TRACK,STOP,EJECT,PLAY_PAUSE,MUTE,VOLUME_INCREMENT,VOLUME_DECREMENT
+end
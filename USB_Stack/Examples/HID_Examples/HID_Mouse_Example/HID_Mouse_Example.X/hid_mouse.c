@@ -0,0 +1,124 @@
+/**
+ * @file hid_mouse.c
+ * @brief Accumulating mouse report engine.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+ 
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_hid.h"
+#include "usb_hid_reports.h"
+#include "hid_mouse.h"
+
+#define ACCUMULATOR_LIMIT 32000 // Keeps sums from wrapping.
+
+static volatile int16_t m_acc_x;
+static volatile int16_t m_acc_y;
+static volatile int16_t m_acc_wheel;
+static volatile uint8_t m_buttons;        // Buttons held now.
+static volatile uint8_t m_press_latch;    // Presses not yet sent.
+static volatile uint8_t m_release_latch;  // Releases not yet sent.
+static uint8_t          m_sent_buttons;   // Buttons in the last report.
+static uint8_t          m_frames;         // Frames since the last report.
+
+static int16_t add_delta(int16_t acc, int16_t delta);
+static int8_t  take_delta(volatile int16_t* p_acc);
+
+void mouse_move(int16_t x, int16_t y, int8_t wheel)
+{
+    USB_INTERRUPT_ENABLE = 0;
+    m_acc_x     = add_delta(m_acc_x, x);
+    m_acc_y     = add_delta(m_acc_y, y);
+    m_acc_wheel = add_delta(m_acc_wheel, wheel);
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+void mouse_buttons(uint8_t buttons)
+{
+    USB_INTERRUPT_ENABLE = 0;
+    m_press_latch   |= buttons & (uint8_t)~m_buttons;
+    m_release_latch |= m_buttons & (uint8_t)~buttons;
+    m_buttons = buttons;
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+void mouse_sof(void)
+{
+    uint8_t down;
+    uint8_t up;
+    uint8_t buttons;
+    
+    if(m_frames < MOUSE_INTERVAL) m_frames++;
+    if(m_frames < MOUSE_INTERVAL) return;
+    if(!g_hid_report_sent) return; // Keep summing until the host takes the last report.
+    
+    if((m_acc_x == 0) && (m_acc_y == 0) && (m_acc_wheel == 0) && 
+       (m_press_latch == 0) && (m_release_latch == 0) && 
+       !g_hid_in_report_settings[0].Idle_Count_Overflow) return;
+    
+    // One edge per button per report, a click inside one poll is sent as press then release.
+    down    = m_press_latch & (uint8_t)~m_sent_buttons;
+    up      = m_release_latch & m_sent_buttons;
+    buttons = (m_sent_buttons | down) & (uint8_t)~up;
+    m_press_latch   &= (uint8_t)~down;
+    m_release_latch &= (uint8_t)~up;
+    m_press_latch   |= m_buttons & (uint8_t)~buttons; // Still differs after this report.
+    m_release_latch |= buttons & (uint8_t)~m_buttons;
+    
+    g_hid_in_report1.Buttons = buttons;
+    g_hid_in_report1.x       = take_delta(&m_acc_x);
+    g_hid_in_report1.y       = take_delta(&m_acc_y);
+    g_hid_in_report1.Wheel   = take_delta(&m_acc_wheel);
+    
+    hid_send_report(0); // Can't fail, nothing is queued.
+    m_sent_buttons = buttons;
+    m_frames = 0;
+    
+    // An idle repeat must not move the pointer again.
+    g_hid_in_report1.x     = 0;
+    g_hid_in_report1.y     = 0;
+    g_hid_in_report1.Wheel = 0;
+}
+
+static int16_t add_delta(int16_t acc, int16_t delta)
+{
+    int32_t sum = (int32_t)acc + delta;
+    
+    if(sum > ACCUMULATOR_LIMIT) sum = ACCUMULATOR_LIMIT;
+    else if(sum < -ACCUMULATOR_LIMIT) sum = -ACCUMULATOR_LIMIT;
+    return (int16_t)sum;
+}
+
+static int8_t take_delta(volatile int16_t* p_acc)
+{
+    int16_t delta = *p_acc;
+    
+    if(delta > MOUSE_MAX_DELTA) delta = MOUSE_MAX_DELTA;
+    else if(delta < -MOUSE_MAX_DELTA) delta = -MOUSE_MAX_DELTA;
+    *p_acc -= delta;
+    return (int8_t)delta;
+}
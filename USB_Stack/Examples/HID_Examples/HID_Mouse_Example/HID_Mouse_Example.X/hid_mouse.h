@@ -0,0 +1,85 @@
+/**
+ * @file hid_mouse.h
+ * @brief Accumulating mouse report engine.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+ 
+#ifndef HID_MOUSE_H
+#define HID_MOUSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Largest movement one report can hold, set by the report descriptor.
+#define MOUSE_MAX_DELTA 127
+
+/**
+ * @fn void mouse_move(int16_t x, int16_t y, int8_t wheel)
+ * 
+ * @brief Adds movement to be sent with the next reports.
+ * 
+ * Movement is summed between host polls, so nothing is lost while a report is
+ * waiting to be sent. Totals larger than MOUSE_MAX_DELTA are split across 
+ * consecutive reports.
+ * 
+ * @param[in] x     X movement, positive is right.
+ * @param[in] y     Y movement, positive is down.
+ * @param[in] wheel Wheel movement, positive is away from the user.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * mouse_move(sensor_dx, sensor_dy, 0);
+ * @endcode
+ * </li></ul>
+ */
+void mouse_move(int16_t x, int16_t y, int8_t wheel);
+
+/**
+ * @fn void mouse_buttons(uint8_t buttons)
+ * 
+ * @brief Sets which buttons are held (bit 0 is button 1).
+ * 
+ * Every press and release is sent, even when a button is clicked faster 
+ * than the host polls.
+ * 
+ * @param[in] buttons Button bitmap.
+ */
+void mouse_buttons(uint8_t buttons);
+
+/**
+ * @fn void mouse_sof(void)
+ * 
+ * @brief Queues the next mouse report, call from usb_sof() after 
+ * hid_service_sof().
+ * 
+ * A report is only built once the last one has been sent and MOUSE_INTERVAL
+ * frames have passed, and only when something changed or the idle period 
+ * ended.
+ */
+void mouse_sof(void);
+
+#endif /* HID_MOUSE_H */
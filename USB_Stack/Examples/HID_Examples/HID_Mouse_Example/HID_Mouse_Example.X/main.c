@@ -96,6 +96,7 @@
 #include "usb.h"
 #include "usb_hid.h"
 #include "usb_hid_reports.h"
+#include "hid_mouse.h"
 
 #define BUTTON_WAS_PRESSED  (BUTTON_PRESSED && m_released)
 #define BUTTON_WAS_RELEASED (BUTTON_RELEASED && !m_released)
@@ -105,10 +106,8 @@ static void example_init(void);
 static void flash_led(void);
 #endif
 static void __interrupt() isr(void);
-static void service_reports_to_send(void);
 
-static bool m_released    = true;
-static bool m_send_report = false;
+static bool m_released = true;
 
 void main(void)
 {
@@ -126,8 +125,6 @@ void main(void)
     USB_INTERRUPT_ENABLE = 1;
     INTCONbits.GIE = 1;
     
-    m_send_report = true;
-    
     while(1)
     {
         // Uncomment out the following for polling method.
@@ -135,38 +132,27 @@ void main(void)
         
         if(usb_get_state() != STATE_CONFIGURED) continue;
         
-        service_reports_to_send();
-        
         // Uncomment the following for Button Example
-//        if(g_hid_report_sent)
+//        if(BUTTON_WAS_PRESSED)
+//        {
+//            m_released = false;
+//            mouse_buttons(0x01);
+//        }
+//        else if(BUTTON_WAS_RELEASED)
 //        {
-//            if(BUTTON_WAS_PRESSED)
-//            {
-//                m_released = false;
-//                g_hid_in_report1.BUTTON_1 = 1;
-//                m_send_report = true;
-//            }
-//            else if(BUTTON_WAS_RELEASED)
-//            {
-//                m_released = true;
-//                *((uint8_t*)&g_hid_in_report1) = 0;
-//                m_send_report = true;
-//            }
+//            m_released = true;
+//            mouse_buttons(0);
 //        }
         
         // Uncomment the following for Pointer Example
-        if(g_hid_report_sent)
+        if(BUTTON_WAS_PRESSED)
+        {
+            m_released = false;
+            mouse_move(0, -65, 0);
+        }
+        else if(BUTTON_WAS_RELEASED)
         {
-            if(BUTTON_WAS_PRESSED)
-            {
-                m_released = false;
-                g_hid_in_report1.y = -65;
-                m_send_report = true;
-            }
-            else if(BUTTON_WAS_RELEASED)
-            {
-                m_released = true;
-            }
+            m_released = true;
         }
     }
 }
@@ -288,18 +274,10 @@ static void flash_led(void)
 }
 #endif
 
-static void service_reports_to_send(void)
-{
-    if((g_hid_in_report_settings[0].Idle_Count_Overflow || m_send_report) && g_hid_report_sent)
-    {
-        m_send_report = false;
-        hid_send_report(0);
-    }
-}
-
 void usb_sof(void)
 {
     hid_service_sof();
+    mouse_sof();
 }
 
 static void __interrupt() isr(void)
@@ -52,7 +52,7 @@ void usb_app_init(void)
 
 void usb_app_tasks(void)
 {
-    if(TRANSACTION_EP == HID_EP) hid_tasks();
+    hid_tasks();
 }
 
 
@@ -55,10 +55,11 @@ const uint8_t g_hid_report_descriptor[] =
             Usage_Page(GENERIC_DESKTOP_PAGE),
             Usage(AXIS_X),
             Usage(AXIS_Y),
+            Usage(MISC_WHEEL),
             Logic_Minimum(-127),
             Logic_Maximum(127),      
             Report_Size(8),
-            Report_Count(2),
+            Report_Count(3),
             Input(DATA|VARIABLE|RELATIVE),
             End_Collection(),
     End_Collection(),
@@ -141,7 +142,7 @@ static const config_descriptor_t config_descriptor0 =
         0x81,               // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
         0x03,               // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes
         EP1_SIZE,           // wMaxPacketSize:16 - Maximum packet size for this endpoint (send & receive)
-        0x0A                // bInterval:8 - Interval   //0x01
+        MOUSE_INTERVAL      // bInterval:8 - Interval
     },
 
     // Endpoint Descriptor
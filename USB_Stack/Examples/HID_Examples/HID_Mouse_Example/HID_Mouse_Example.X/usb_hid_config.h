@@ -50,6 +50,13 @@
 // Idle_Settings
 #define DEFAULT_IDLE 500 // in mS
 
+// Mouse Settings
+#define MOUSE_INTERVAL 10 // IN EP bInterval and report spacing in mS, 1 for 1 kHz polling.
+
+// IN Report Queue
+#define HID_IN_QUEUE_SIZE        4 // Reports waiting to be sent, power of 2.
+#define HID_IN_QUEUE_REPORT_SIZE 8 // Largest IN report in bytes, including Report ID.
+
 // HID Endpoint HAL
 #define HID_EP      EP1
 #define HID_EP_SIZE EP1_SIZE
@@ -48,6 +48,7 @@ typedef struct
     };
     int8_t x;
     int8_t y;
+    int8_t Wheel;
 }hid_in_report1_t;
 
 typedef struct
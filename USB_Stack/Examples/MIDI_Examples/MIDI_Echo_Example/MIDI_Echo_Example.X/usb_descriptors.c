@@ -0,0 +1,301 @@
+/**
+ * @file usb_descriptors.h
+ * @brief Contains core USB stack descriptors stored in ROM.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - USB Stack (This file is for the MIDI Echo Example).
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "usb_config.h"
+#include "usb_midi.h"
+#include "usb_ch9.h"
+
+#if MIDI_NUM_CABLES != 1
+#error "These descriptors have one cable (one pair of embedded jacks)."
+#endif
+
+/** Device Descriptor */
+const ch9_device_descriptor_t g_device_descriptor =
+{
+    0x12,           // bLength:8 -  Size of descriptor in bytes
+    DEVICE_DESC,    // bDescriptorType:8  - Device descriptor type
+    0x0200,         // bcdUSB:16 -  USB in BCD (2.0H)
+    0x00,           // bDeviceClass:8
+    0x00,           // bDeviceSubClass:8
+    0x00,           // bDeviceProtocol:8
+    EP0_SIZE,       // bMaxPacketSize0:8 - Maximum packet size
+    0x04D8,         // idVendor:16 - Microchip VID = 0x04D8
+    0x000D,         // idProduct:16 - Product ID (VID) = 0x000D
+    0x0001,         // bcdDevice:16 - Device release number in BCD
+    0x01,           // iManufacturer:8 - Manufacturer string index
+    0x02,           // iProduct:8 - Product string index
+    0x00,           // iSerialNumber:8 - Device serial number string index
+    0x01            // bNumConfigurations:8 - Number of possible configurations
+};
+
+/** MIDIStreaming Class-Specific Descriptors Structure (jacks only) */
+typedef struct
+{
+    midi_ms_header_descriptor_t header_descriptor;
+    midi_in_jack_descriptor_t   embedded_in_jack_descriptor;
+    midi_in_jack_descriptor_t   external_in_jack_descriptor;
+    midi_out_jack_descriptor_t  embedded_out_jack_descriptor;
+    midi_out_jack_descriptor_t  external_out_jack_descriptor;
+}ms_descriptors_t;
+
+/** Configuration Descriptor Structure */
+typedef struct
+{
+    ch9_configutarion_descriptor_t      configuration0_descriptor;
+    ch9_standard_interface_descriptor_t interface0_descriptor;
+    midi_ac_header_descriptor_t         ac_header_descriptor;
+    ch9_standard_interface_descriptor_t interface1_descriptor;
+    ms_descriptors_t                    ms_descriptors;
+    midi_endpoint_descriptor_t          ep1_out_descriptor;
+    midi_cs_endpoint_descriptor_t       cs_ep1_out_descriptor;
+    midi_endpoint_descriptor_t          ep1_in_descriptor;
+    midi_cs_endpoint_descriptor_t       cs_ep1_in_descriptor;
+}config_descriptor_t;
+
+// Jack IDs, the embedded jacks are the USB side of cable 0.
+#define EMBEDDED_IN_JACK  1
+#define EXTERNAL_IN_JACK  2
+#define EMBEDDED_OUT_JACK 3
+#define EXTERNAL_OUT_JACK 4
+
+/** Configuration Descriptor */
+static const config_descriptor_t config_descriptor0 =
+{
+    // Configuration Descriptor
+    {
+        9,                          // bLength:8 - Size of configuration descriptor in bytes
+        CONFIGURATION_DESC,         // bDescriptorType:8 - Configuration descriptor type
+        sizeof(config_descriptor0), // wTotalLength:16 - Total amount of bytes in descriptors belonging to this configuration
+        0x02,                       // bNumInterfaces:8 - Number of interfaces in this configuration
+        0x01,                       // bConfigurationValue:8 - Index value for this configuration
+        0x00,                       // iConfiguration:8 - Index of string describing this configuration
+        0xC0,                       // bmAttributes:8 {0:5,RemoteWakeup:1,SelfPowered:1,1:1} - Self Powered
+        50                          // bMaxPower:8 - 100mA power allowed (increments of 2mA)
+    },
+
+    // AudioControl Interface Descriptor
+    {
+        9,                          // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC,             // bDescriptorType:8 - Interface descriptor type
+        MIDI_AC_INT,                // bInterfaceNumber:8 - Index number of interface
+        0x00,                       // bAlternateSetting:8 - Value used to select alternate setting
+        0x00,                       // bNumEndpoints:8 - Number of endpoints used in this interface
+        0x01,                       // bInterfaceClass:8 - Class Code (Audio)
+        MIDI_SUBCLASS_AUDIOCONTROL, // bInterfaceSubClass:8 - Subclass Code (AudioControl)
+        0x00,                       // bInterfaceProtocol:8 - Protocol Code
+        0x00                        // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    // Class-Specific AC Interface Header Descriptor
+    {
+        9,                 // bLength:8 - Size of descriptor in bytes
+        MIDI_CS_INTERFACE, // bDescriptorType:8 - CS_INTERFACE
+        MIDI_AC_HEADER,    // bDescriptorSubtype:8 - HEADER
+        0x0100,            // bcdADC:16 - Audio Class 1.0
+        9,                 // wTotalLength:16 - Size of the class-specific AC descriptors
+        0x01,              // bInCollection:8 - Number of streaming interfaces
+        MIDI_MS_INT        // baInterfaceNr:8 - MIDIStreaming interface in the collection
+    },
+
+    // MIDIStreaming Interface Descriptor
+    {
+        9,                           // bLength:8 - Size of interface descriptor in bytes
+        INTERFACE_DESC,              // bDescriptorType:8 - Interface descriptor type
+        MIDI_MS_INT,                 // bInterfaceNumber:8 - Index number of interface
+        0x00,                        // bAlternateSetting:8 - Value used to select alternate setting
+        0x02,                        // bNumEndpoints:8 - Number of endpoints used in this interface
+        0x01,                        // bInterfaceClass:8 - Class Code (Audio)
+        MIDI_SUBCLASS_MIDISTREAMING, // bInterfaceSubClass:8 - Subclass Code (MIDIStreaming)
+        0x00,                        // bInterfaceProtocol:8 - Protocol Code
+        0x00                         // iInterface:8 - Index of String Descriptor Describing this interface
+    },
+
+    {
+        // Class-Specific MS Interface Header Descriptor
+        {
+            7,                 // bLength:8 - Size of descriptor in bytes
+            MIDI_CS_INTERFACE, // bDescriptorType:8 - CS_INTERFACE
+            MIDI_MS_HEADER,    // bDescriptorSubtype:8 - MS_HEADER
+            0x0100,            // bcdMSC:16 - MIDIStreaming 1.0
+            sizeof(ms_descriptors_t) + (2 * (sizeof(midi_endpoint_descriptor_t) + sizeof(midi_cs_endpoint_descriptor_t))) // wTotalLength:16 - Size of the class-specific MS descriptors, with the EPs
+        },
+
+        // MIDI IN Jack Descriptor (embedded, from the host)
+        {
+            6,                  // bLength:8 - Size of descriptor in bytes
+            MIDI_CS_INTERFACE,  // bDescriptorType:8 - CS_INTERFACE
+            MIDI_MIDI_IN_JACK,  // bDescriptorSubtype:8 - MIDI_IN_JACK
+            MIDI_JACK_EMBEDDED, // bJackType:8 - Embedded
+            EMBEDDED_IN_JACK,   // bJackID:8 - ID of this jack
+            0x00                // iJack:8 - Unused
+        },
+
+        // MIDI IN Jack Descriptor (external)
+        {
+            6,                  // bLength:8 - Size of descriptor in bytes
+            MIDI_CS_INTERFACE,  // bDescriptorType:8 - CS_INTERFACE
+            MIDI_MIDI_IN_JACK,  // bDescriptorSubtype:8 - MIDI_IN_JACK
+            MIDI_JACK_EXTERNAL, // bJackType:8 - External
+            EXTERNAL_IN_JACK,   // bJackID:8 - ID of this jack
+            0x00                // iJack:8 - Unused
+        },
+
+        // MIDI OUT Jack Descriptor (embedded, to the host)
+        {
+            9,                  // bLength:8 - Size of descriptor in bytes
+            MIDI_CS_INTERFACE,  // bDescriptorType:8 - CS_INTERFACE
+            MIDI_MIDI_OUT_JACK, // bDescriptorSubtype:8 - MIDI_OUT_JACK
+            MIDI_JACK_EMBEDDED, // bJackType:8 - Embedded
+            EMBEDDED_OUT_JACK,  // bJackID:8 - ID of this jack
+            0x01,               // bNrInputPins:8 - Number of input pins
+            EXTERNAL_IN_JACK,   // baSourceID:8 - Connected to the external IN jack
+            0x01,               // baSourcePin:8 - Output pin of that jack
+            0x00                // iJack:8 - Unused
+        },
+
+        // MIDI OUT Jack Descriptor (external)
+        {
+            9,                  // bLength:8 - Size of descriptor in bytes
+            MIDI_CS_INTERFACE,  // bDescriptorType:8 - CS_INTERFACE
+            MIDI_MIDI_OUT_JACK, // bDescriptorSubtype:8 - MIDI_OUT_JACK
+            MIDI_JACK_EXTERNAL, // bJackType:8 - External
+            EXTERNAL_OUT_JACK,  // bJackID:8 - ID of this jack
+            0x01,               // bNrInputPins:8 - Number of input pins
+            EMBEDDED_IN_JACK,   // baSourceID:8 - Connected to the embedded IN jack
+            0x01,               // baSourcePin:8 - Output pin of that jack
+            0x00                // iJack:8 - Unused
+        }
+    },
+
+    // Endpoint Descriptor
+    {
+        9,                // bLength:8 - Size of EP descriptor in bytes
+        ENDPOINT_DESC,    // bDescriptorType:8 - Endpoint Descriptor Type
+        MIDI_EP,          // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
+        0x02,             // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes (Bulk)
+        MIDI_EP_SIZE,     // wMaxPacketSize:16 - Maximum packet size for this endpoint
+        0x00,             // bInterval:8 - Interval (Unused for Bulk)
+        0x00,             // bRefresh:8 - Unused
+        0x00              // bSynchAddress:8 - Unused
+    },
+
+    // Class-Specific MS Endpoint Descriptor
+    {
+        5,                 // bLength:8 - Size of descriptor in bytes
+        MIDI_CS_ENDPOINT,  // bDescriptorType:8 - CS_ENDPOINT
+        MIDI_MS_GENERAL,   // bDescriptorSubtype:8 - MS_GENERAL
+        0x01,              // bNumEmbMIDIJack:8 - Number of embedded jacks
+        {EMBEDDED_IN_JACK} // baAssocJackID:8 - Cable 0
+    },
+
+    // Endpoint Descriptor
+    {
+        9,                // bLength:8 - Size of EP descriptor in bytes
+        ENDPOINT_DESC,    // bDescriptorType:8 - Endpoint Descriptor Type
+        MIDI_EP | 0x80,   // bEndpointAddress:8 {EndpointNum:4,0:3,Direction:1} - Endpoint address
+        0x02,             // bmAttributes:8 {TransferType:2,SyncType:2,UsageType:2,0:2} - Attributes (Bulk)
+        MIDI_EP_SIZE,     // wMaxPacketSize:16 - Maximum packet size for this endpoint
+        0x00,             // bInterval:8 - Interval (Unused for Bulk)
+        0x00,             // bRefresh:8 - Unused
+        0x00              // bSynchAddress:8 - Unused
+    },
+
+    // Class-Specific MS Endpoint Descriptor
+    {
+        5,                  // bLength:8 - Size of descriptor in bytes
+        MIDI_CS_ENDPOINT,   // bDescriptorType:8 - CS_ENDPOINT
+        MIDI_MS_GENERAL,    // bDescriptorSubtype:8 - MS_GENERAL
+        0x01,               // bNumEmbMIDIJack:8 - Number of embedded jacks
+        {EMBEDDED_OUT_JACK} // baAssocJackID:8 - Cable 0
+    }
+};
+
+/** Configuration Descriptor Addresses Array */
+const uint16_t g_config_descriptors[] = 
+{
+    (uint16_t)&config_descriptor0
+};
+
+/** String Zero Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t wLANGID[1];
+}string_zero_descriptor_t;
+
+/** Vendor String Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bString[6];
+}vendor_string_descriptor_t;
+
+/** Product String Descriptor Structure */
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bString[9];
+}product_string_descriptor_t;
+    
+/** String Zero Descriptor */
+static const string_zero_descriptor_t string_zero_descriptor =
+{
+    sizeof(string_zero_descriptor_t),
+    STRING_DESC,
+    {0x0409}
+};
+
+/** Vendor String Descriptor */
+static const vendor_string_descriptor_t vendor_string_descriptor =
+{
+    sizeof(vendor_string_descriptor_t),
+    STRING_DESC,
+    {'J','o','h','n','n','y'}
+};
+
+/** Product String Descriptor */
+static const product_string_descriptor_t product_string_descriptor =
+{
+    sizeof(product_string_descriptor_t),
+    STRING_DESC,
+    {'M','I','D','I',' ','E','c','h','o'}
+};
+
+/** String Descriptor Addresses Array */
+const uint16_t g_string_descriptors[] =
+{
+    (uint16_t)&string_zero_descriptor,
+    (uint16_t)&vendor_string_descriptor,
+    (uint16_t)&product_string_descriptor
+};
+
+/** String Descriptor Addresses Array Size */
+const uint8_t g_size_of_sd = sizeof(g_string_descriptors);
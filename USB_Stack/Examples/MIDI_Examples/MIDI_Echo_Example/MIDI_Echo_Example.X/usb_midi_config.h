@@ -0,0 +1,87 @@
+/**
+ * @file usb_midi_config.h
+ * @brief <i>USB-MIDI</i> settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MIDI Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_MIDI_CONFIG_H
+#define USB_MIDI_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* **************************** MIDI SETTINGS ******************************* */
+/* ************************************************************************** */
+
+// Virtual cables (pairs of embedded IN/OUT jacks), 1 to 16.
+#define MIDI_NUM_CABLES 1
+
+// Events queued in each direction, a power of 2 up to 128.
+#define MIDI_IN_FIFO_SIZE  64 // Device to host.
+#define MIDI_OUT_FIFO_SIZE 32 // Host to device.
+
+// Full IN packets are sent straight away. A partly filled one waits this many
+// frames for more events (needs USE_SOF and midi_sof() called from usb_sof()).
+// Without USE_SOF, midi_flush_tasks() sends whatever has been queued.
+#define MIDI_IN_FLUSH_FRAMES 1
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** MIDI INTERFACES ***************************** */
+/* ************************************************************************** */
+
+// AudioControl Interface Number
+#define MIDI_AC_INT 0
+
+// MIDIStreaming Interface Number
+#define MIDI_MS_INT 1
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** MIDI ENDPOINTS ***************************** */
+/* ************************************************************************** */
+
+// MIDI Endpoint HAL
+#define MIDI_EP      EP1
+#define MIDI_EP_SIZE EP1_SIZE // 32 packs 8 event packets in each transaction.
+
+#define MIDI_BD_OUT      BD1_OUT
+#define MIDI_BD_OUT_EVEN BD1_OUT_EVEN
+#define MIDI_BD_OUT_ODD  BD1_OUT_ODD
+#define MIDI_BD_IN       BD1_IN
+#define MIDI_BD_IN_EVEN  BD1_IN_EVEN
+#define MIDI_BD_IN_ODD   BD1_IN_ODD
+
+#define MIDI_UEPbits UEP1bits
+
+/* ************************************************************************** */
+
+#endif /* USB_MIDI_CONFIG_H */
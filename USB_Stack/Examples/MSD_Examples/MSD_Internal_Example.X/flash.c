@@ -75,6 +75,9 @@ void Flash_ReadBytes(uint16_t start_addr, uint16_t bytes, uint8_t *flash_array)
 }
 void Flash_Erase(uint16_t start_addr, uint16_t end_addr)
 {
+    uint8_t gie = INTCONbits.GIE; // Called from the main loop, the unlock sequence can't be interrupted.
+    
+    INTCONbits.GIE = 0;
     _EECON1 = 0x84;
     while(start_addr<end_addr)
     {
@@ -89,6 +92,7 @@ void Flash_Erase(uint16_t start_addr, uint16_t end_addr)
         start_addr += _FLASH_ERASE_SIZE;
     }
     _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
 }
 void Flash_EraseWriteBlock(uint16_t start_addr, uint8_t *flash_array)
 {
@@ -110,9 +114,11 @@ void Flash_EraseWriteBlock(uint16_t start_addr, uint8_t *flash_array)
 }
 void Flash_WriteBlock(uint16_t start_addr, uint8_t *flash_array)
 {
+    uint8_t gie = INTCONbits.GIE; // Latch loads and unlock sequences can't be interrupted.
 #ifdef _PIC14
     uint8_t i;
     
+    INTCONbits.GIE = 0;
     _EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
     _EEADRH = (uint8_t)(start_addr>>8);
     _EEADR = (uint8_t)(start_addr);
@@ -130,9 +136,11 @@ void Flash_WriteBlock(uint16_t start_addr, uint8_t *flash_array)
         _EEADR++;
     }
     _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
 #else
     uint8_t word_cnt = _FLASH_WRITE_SIZE;
     
+    INTCONbits.GIE = 0;
     _EECON1 = 0xA4; // EEPGD = 1, CFGS = 0, FREE = 0, LWLO = 1, WREN = 1
     _EEADRH = (uint8_t)(start_addr>>8);
     _EEADR = (uint8_t)(start_addr);
@@ -156,6 +164,7 @@ void Flash_WriteBlock(uint16_t start_addr, uint8_t *flash_array)
     NOP();
     NOP();
     _EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
 #endif
 }
 #elif defined(_PIC18)
@@ -183,6 +192,9 @@ void Flash_ReadBytes(uint24_t start_addr, uint24_t bytes, uint8_t *flash_array)
 }
 void Flash_Erase(uint24_t start_addr, uint24_t end_addr)
 {
+    uint8_t gie = INTCONbits.GIE; // Called from the main loop, the unlock sequence can't be interrupted.
+    
+    INTCONbits.GIE = 0;
     EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
     while(start_addr<end_addr)
     {
@@ -196,6 +208,7 @@ void Flash_Erase(uint24_t start_addr, uint24_t end_addr)
         start_addr += _FLASH_ERASE_SIZE;
     }
     EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
 }
 void Flash_EraseWriteBlock(uint24_t start_addr, uint8_t *flash_array)
 {
@@ -218,7 +231,9 @@ void Flash_EraseWriteBlock(uint24_t start_addr, uint8_t *flash_array)
 void Flash_WriteBlock(uint24_t start_addr, uint8_t *flash_array)
 {
     uint8_t i;
+    uint8_t gie = INTCONbits.GIE; // The ISR's table reads (descriptors) would move TBLPTR between the TBLWTs.
     
+    INTCONbits.GIE = 0;
     EECON1 = 0x84; // EEPGD = 1, CFGS = 0, WREN = 1
     TBLPTR = 0;
     for(i=0;i<_FLASH_WRITE_SIZE;i++)
@@ -233,7 +248,57 @@ void Flash_WriteBlock(uint24_t start_addr, uint8_t *flash_array)
     EECON2 = 0xAA;
     EECON1bits.WR = 1;
     EECON1bits.WREN = 0;
+    INTCONbits.GIE = gie;
 }
 #else
 #error FLASH - DEVICE NOT YET SUPPORTED
-#endif
\ No newline at end of file
+#endif
+
+
+#if defined(_PIC14)||defined(_PIC14E)
+typedef uint16_t flash_addr_t;
+#define BLOCK_BYTES (_FLASH_WRITE_SIZE*2) // Two array bytes per word.
+#else
+typedef uint24_t flash_addr_t;
+#define BLOCK_BYTES _FLASH_WRITE_SIZE
+#endif
+
+static flash_addr_t m_job_addr;   // Next row to erase or block to write.
+static flash_addr_t m_job_end;
+static uint8_t     *m_job_array;  // 0 for an erase only job.
+static bool         m_job_erased; // Row at m_job_addr is erased, its blocks are next.
+
+void Flash_StartErase(flash_addr_t start_addr, flash_addr_t end_addr)
+{
+    Flash_StartEraseWrite(start_addr, end_addr, 0);
+}
+void Flash_StartEraseWrite(flash_addr_t start_addr, flash_addr_t end_addr, uint8_t *flash_array)
+{
+    m_job_addr   = start_addr;
+    m_job_end    = end_addr;
+    m_job_array  = flash_array;
+    m_job_erased = false;
+}
+bool Flash_Busy(void)
+{
+    return m_job_addr < m_job_end;
+}
+bool Flash_Tasks(void)
+{
+    if(m_job_addr >= m_job_end) return false;
+    
+    if(!m_job_erased)
+    {
+        Flash_Erase(m_job_addr, m_job_addr + _FLASH_ERASE_SIZE);
+        if(m_job_array) m_job_erased = true;
+        else m_job_addr += _FLASH_ERASE_SIZE;
+    }
+    else
+    {
+        Flash_WriteBlock(m_job_addr, m_job_array);
+        m_job_array += BLOCK_BYTES;
+        m_job_addr  += _FLASH_WRITE_SIZE;
+        if((m_job_addr & (_FLASH_ERASE_SIZE - 1)) == 0) m_job_erased = false; // On to the next row.
+    }
+    return m_job_addr < m_job_end;
+}
@@ -29,18 +29,30 @@
 #define FLASH_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifndef _PIC18 // Non-PIC18
 void Flash_ReadBytes(uint16_t start_addr, uint16_t bytes, uint8_t *flash_array);
 void Flash_Erase(uint16_t start_addr, uint16_t end_addr);
 void Flash_EraseWriteBlock(uint16_t start_addr, uint8_t *flash_array);
 void Flash_WriteBlock(uint16_t start_addr, uint8_t *flash_array);
+void Flash_StartErase(uint16_t start_addr, uint16_t end_addr);
+void Flash_StartEraseWrite(uint16_t start_addr, uint16_t end_addr, uint8_t *flash_array);
 #else
 void Flash_ReadBytes(uint24_t start_addr, uint24_t bytes, uint8_t *flash_array);
 void Flash_Erase(uint24_t start_addr, uint24_t end_addr);
 void Flash_EraseWriteBlock(uint24_t start_addr, uint8_t *flash_array);
 void Flash_WriteBlock(uint24_t start_addr, uint8_t *flash_array);
 void Flash_WriteConfigBlock(uint8_t *flash_array);
+void Flash_StartErase(uint24_t start_addr, uint24_t end_addr);
+void Flash_StartEraseWrite(uint24_t start_addr, uint24_t end_addr, uint8_t *flash_array);
 #endif /* _PIC18 */
 
+// Started jobs are carried out one row erase or one block write per 
+// Flash_Tasks() call, so the CPU is never stalled longer than one of those. 
+// Addresses are row aligned, and the array must be left alone until 
+// Flash_Busy() returns false.
+bool Flash_Busy(void);
+bool Flash_Tasks(void);
+
 #endif /* FLASH_H */
\ No newline at end of file
@@ -33,11 +33,18 @@
 #include "usb.h"
 #include "usb_msd.h"
 #include "flash.h"
+#ifdef USE_LZ_VOLUME
+#include "usb_lzvol.h"
+#endif
 
 #if _HTC_EDITION_ == 0
 #error "Use optimization level 2 and above."
 #endif
 
+#if defined(USE_UF2) && defined(USE_LZ_VOLUME)
+#error "USE_UF2 and USE_LZ_VOLUME each replace the flash volume, define one or the other."
+#endif
+
 #if defined(_PIC14E)
 /* PIC16F145X ROM Space
              ______________
@@ -287,9 +294,9 @@
 #define BOOTSTRAP_SIZE        448
 #define SIGNATURE_WORD_START  (BOOTSTRAP_START + BOOTSTRAP_SIZE)
 #define SIGNATURE_WORD_SIZE   2
-#define FAT_DEFAULT_START     (FLASH_SPACE_START + 1024)
+#define FAT_DEFAULT_START     (FLASH_SPACE_START + 512)
 #define FAT_DEFAULT_SIZE      4
-#define ROOT_ENTRY_START      (FLASH_SPACE_START + 2048)
+#define ROOT_ENTRY_START      (FLASH_SPACE_START + 1024)
 
 #elif defined(_18F25J50) || defined(_18F45J50)
 /* PIC18FX5J50 ROM Space
@@ -317,9 +324,9 @@
 #define BOOTSTRAP_SIZE        448
 #define SIGNATURE_WORD_START  (BOOTSTRAP_START + BOOTSTRAP_SIZE)
 #define SIGNATURE_WORD_SIZE   2
-#define FAT_DEFAULT_START     (FLASH_SPACE_START + 1024)
+#define FAT_DEFAULT_START     (FLASH_SPACE_START + 512)
 #define FAT_DEFAULT_SIZE      4
-#define ROOT_ENTRY_START      (FLASH_SPACE_START + 2048)
+#define ROOT_ENTRY_START      (FLASH_SPACE_START + 1024)
 
 #elif defined(_18F26J50) || defined(_18F46J50)
 /* PIC18FX6J50 ROM Space
@@ -347,9 +354,9 @@
 #define BOOTSTRAP_SIZE        448
 #define SIGNATURE_WORD_START  (BOOTSTRAP_START + BOOTSTRAP_SIZE)
 #define SIGNATURE_WORD_SIZE   2
-#define FAT_DEFAULT_START     (FLASH_SPACE_START + 1024)
+#define FAT_DEFAULT_START     (FLASH_SPACE_START + 512)
 #define FAT_DEFAULT_SIZE      4
-#define ROOT_ENTRY_START      (FLASH_SPACE_START + 2048)
+#define ROOT_ENTRY_START      (FLASH_SPACE_START + 1024)
 
 #elif defined(_18F26J53) || defined(_18F46J53)
 /* PIC18FX6J53 ROM Space
@@ -377,9 +384,9 @@
 #define BOOTSTRAP_SIZE        448
 #define SIGNATURE_WORD_START  (BOOTSTRAP_START + BOOTSTRAP_SIZE)
 #define SIGNATURE_WORD_SIZE   2
-#define FAT_DEFAULT_START     (FLASH_SPACE_START + 1024)
+#define FAT_DEFAULT_START     (FLASH_SPACE_START + 512)
 #define FAT_DEFAULT_SIZE      4
-#define ROOT_ENTRY_START      (FLASH_SPACE_START + 2048)
+#define ROOT_ENTRY_START      (FLASH_SPACE_START + 1024)
 
 
 #elif defined(_18F27J53) || defined(_18F47J53)
@@ -408,11 +415,12 @@
 #define BOOTSTRAP_SIZE        448
 #define SIGNATURE_WORD_START  (BOOTSTRAP_START + BOOTSTRAP_SIZE)
 #define SIGNATURE_WORD_SIZE   2
-#define FAT_DEFAULT_START     (FLASH_SPACE_START + 1024)
+#define FAT_DEFAULT_START     (FLASH_SPACE_START + 512)
 #define FAT_DEFAULT_SIZE      4
-#define ROOT_ENTRY_START      (FLASH_SPACE_START + 2048)
+#define ROOT_ENTRY_START      (FLASH_SPACE_START + 1024)
 #endif
 
+#if !defined(USE_UF2) && !defined(USE_LZ_VOLUME) // Those volumes don't live in flash space.
 /*
  * The code directly below will pre-format the drive in such a way that we make use of most of the space.
  * Using our format method, we get 20.5KB volume.
@@ -513,12 +521,77 @@ static const DIR_ENTRY_t dir_entry __at(ROOT_ENTRY_START) =
     0,
     0
 };
+#endif
+
+#ifdef USE_UF2
+#if defined(_PIC14E)
+#define UF2_ROW_BYTES   (_FLASH_WRITE_SIZE * 2) // UF2 uses byte addresses, two per flash word.
+#define UF2_ADDR_SHIFT  1
+#else
+#define UF2_ROW_BYTES   _FLASH_WRITE_SIZE
+#define UF2_ADDR_SHIFT  0
+#endif
+
+#define UF2_ERASE_BLOCKS ((END_OF_FLASH - FLASH_SPACE_START) / _FLASH_ERASE_SIZE)
+
+static uint8_t  m_uf2_row[UF2_ROW_BYTES]; // Payload pieces are gathered into a write row.
+static uint32_t m_uf2_row_addr;
+static bool     m_uf2_row_used;
+static uint8_t  m_uf2_erased[(UF2_ERASE_BLOCKS + 7) / 8]; // Erase blocks erased for this file, one bit each.
+#endif
+
+#ifdef USE_WRITE_CACHE
+/* J parts erase 1024 byte rows, the host sees 512 byte blocks. The row being 
+ * written is held in RAM (read-modify-write) and only erased and programmed 
+ * (by Flash_Tasks()) once the host writes to another row, stops writing or 
+ * sends SYNCHRONIZE_CACHE_10, so a row written as two halves, even by two 
+ * commands, costs one erase and program. Reads of the held row come from RAM. */
+#define USE_ROW_CACHE
+#define ROW_SIZE        _FLASH_ERASE_SIZE
+#define ROW_IDLE_FRAMES 20 // Frames (ms) without writes before the row is programmed.
+#define FRAME_NUMBER()  ((((uint16_t)UFRMH << 8) | UFRML) & 0x7FF)
+
+static uint8_t  m_row[ROW_SIZE];
+static uint24_t m_row_addr;
+static bool     m_row_valid;
+static bool     m_row_dirty;
+static uint16_t m_row_frame; // Frame of the last write to the row.
+
+// A write to another row while the held one is being programmed waits here.
+#ifdef MSD_LIMITED_RAM
+static uint8_t  m_row_pend[MSD_EP_SIZE];
+#define ROW_PEND_DATA m_row_pend
+#else
+#define ROW_PEND_DATA g_msd_sect_data // Not refilled until msd_media_busy() is false.
+#endif
+static uint24_t m_row_pend_addr;
+static uint16_t m_row_pend_bytes;
+
+#elif defined(MSD_LIMITED_RAM) && !defined(USE_LZ_VOLUME)
+// Packets are programmed by Flash_Tasks() after the EP buffer is re-armed.
+#if defined(_PIC14E)
+static uint8_t m_flash_buf[MSD_EP_SIZE * 2]; // One data byte per flash word.
+#else
+static uint8_t m_flash_buf[MSD_EP_SIZE];
+#endif
+#endif
 
 static void example_init(void);
 #ifdef USE_BOOT_LED
 static void flash_led(void);
 #endif
+#ifndef USE_LZ_VOLUME
 static uint32_t LBA_to_flash_addr(uint32_t LBA);
+#endif
+#ifdef USE_UF2
+static void uf2_write_row(void);
+#endif
+#ifdef USE_ROW_CACHE
+static void row_read(uint24_t addr, uint16_t bytes, uint8_t* p_data);
+static void row_write(uint24_t addr, uint16_t bytes, uint8_t* p_data);
+static void row_flush(void);
+static void row_tasks(void);
+#endif
 static void __interrupt() isr(void);
 
 void main(void)
@@ -530,6 +603,9 @@ void main(void)
     flash_led();
     #endif
     
+    #ifdef USE_LZ_VOLUME
+    msd_set_capacity(0, g_lzvol_sectors, BYTES_PER_BLOCK_LE);
+    #endif
     usb_init();
     INTCONbits.PEIE = 1;
     USB_INTERRUPT_FLAG = 0;
@@ -540,6 +616,10 @@ void main(void)
     while(1)
     {
         //usb_tasks();
+        Flash_Tasks(); // One row erase or block write, MSD NAKs until they're done.
+        #ifdef USE_ROW_CACHE
+        row_tasks();
+        #endif
         msd_tasks();
     }
 }
@@ -670,6 +750,28 @@ static void flash_led(void)
 }
 #endif
 
+#ifdef USE_LZ_VOLUME
+void msd_rx_sector(void)
+{
+    #ifdef MSD_LIMITED_RAM
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    uint8_t *p_ep = MSD_EP_IN_LAST_PPB == ODD ? g_msd_ep_in_odd : g_msd_ep_in_even;
+    #else
+    uint8_t *p_ep = g_msd_ep_in;
+    #endif
+    
+    lzvol_read(g_msd_rw_10_vars.LBA, g_msd_byte_of_sect, p_ep, MSD_EP_SIZE); // Decoded a packet at a time.
+    #else
+    lzvol_read(g_msd_rw_10_vars.LBA, 0, g_msd_sect_data, BYTES_PER_BLOCK_LE);
+    #endif
+}
+
+void msd_tx_sector(void)
+{
+    // Read-only, USE_WRITE_10 isn't defined.
+}
+
+#else
 void msd_rx_sector(void)
 {
     uint32_t addr;
@@ -689,6 +791,14 @@ void msd_rx_sector(void)
         Flash_ReadBytes((uint24_t)(addr + 32 + g_msd_byte_of_sect), 64, buffer);
         for(i = 0, x = 32; i < 64; i += 2, x++) p_ep[x] = buffer[i];
         
+        #elif defined(USE_ROW_CACHE)
+        #ifdef MSD_LIMITED_RAM
+        if(MSD_EP_IN_LAST_PPB == ODD) row_read((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_in_odd);
+        else row_read((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_in_even);
+        #else
+        row_read((uint24_t)addr, 512, g_msd_sect_data);
+        #endif
+        
         #else
         #ifdef MSD_LIMITED_RAM
         if(MSD_EP_IN_LAST_PPB == ODD) Flash_ReadBytes((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_in_odd);
@@ -716,6 +826,13 @@ void msd_rx_sector(void)
         Flash_ReadBytes((uint24_t)(addr + 32 + g_msd_byte_of_sect), 64, buffer);
         for(i = 0, x = 32; i < 64; i += 2, x++) g_msd_ep_in[x] = buffer[i];
         
+        #elif defined(USE_ROW_CACHE)
+        #ifdef MSD_LIMITED_RAM
+        row_read((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_in);
+        #else
+        row_read((uint24_t)addr, 512, g_msd_sect_data);
+        #endif
+        
         #else
         #ifdef MSD_LIMITED_RAM
         Flash_ReadBytes((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_in);
@@ -736,7 +853,6 @@ void msd_tx_sector(void)
 {
     uint32_t addr;
     #if defined(_PIC14E)
-    uint8_t buffer[64];
     uint8_t i, x;
     #endif
     addr = LBA_to_flash_addr(g_msd_rw_10_vars.LBA); // Convert from LBA address space to flash address space.
@@ -746,63 +862,53 @@ void msd_tx_sector(void)
         #if defined(_PIC14E)
         uint8_t *p_ep = MSD_EP_OUT_LAST_PPB == ODD ? g_msd_ep_out_odd : g_msd_ep_out_even;
         
-        for(i = 0, x = 0; i < 64; i += 2, x++)
+        for(i = 0, x = 0; i < 128; i += 2, x++)
         {
-            buffer[i] = p_ep[x];
-            buffer[i + 1] = 0xFF;
+            m_flash_buf[i] = p_ep[x];
+            m_flash_buf[i + 1] = 0xFF;
         }
-        Flash_EraseWriteBlock((uint24_t)(addr + g_msd_byte_of_sect), buffer);
-        for(i = 0, x = 32; i < 64; i += 2, x++)
-        {
-            buffer[i] = p_ep[x];
-            buffer[i + 1] = 0xFF;
-        }
-        Flash_EraseWriteBlock((uint24_t)(addr + 32 + g_msd_byte_of_sect), buffer);
+        Flash_StartEraseWrite((uint24_t)(addr + g_msd_byte_of_sect), (uint24_t)(addr + 64 + g_msd_byte_of_sect), m_flash_buf);
         
-        #elif defined(__J_PART)
+        #elif defined(USE_ROW_CACHE)
         #ifdef MSD_LIMITED_RAM
-        if(MSD_EP_OUT_LAST_PPB == ODD) Flash_WriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out_odd);
-        else Flash_WriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out_even);
+        if(MSD_EP_OUT_LAST_PPB == ODD) row_write((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_out_odd);
+        else row_write((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_out_even);
         #else
-        for(uint16_t i = 0; i < 512; i += 64, addr += 64) Flash_WriteBlock((uint24_t)addr, g_msd_sect_data + i);
+        row_write((uint24_t)addr, 512, g_msd_sect_data);
         #endif
         #else
 
         #ifdef MSD_LIMITED_RAM
-        if(MSD_EP_OUT_LAST_PPB == ODD) Flash_EraseWriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out_odd);
-        else Flash_EraseWriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out_even);
+        if(MSD_EP_OUT_LAST_PPB == ODD) usb_ram_copy(g_msd_ep_out_odd, m_flash_buf, 64);
+        else usb_ram_copy(g_msd_ep_out_even, m_flash_buf, 64);
+        Flash_StartEraseWrite((uint24_t)(addr + g_msd_byte_of_sect), (uint24_t)(addr + 64 + g_msd_byte_of_sect), m_flash_buf);
         #else
-        for(uint16_t i = 0; i < 512; i += _FLASH_ERASE_SIZE, addr += _FLASH_ERASE_SIZE) Flash_EraseWriteBlock((uint24_t)addr, g_msd_sect_data + i);
+        Flash_StartEraseWrite((uint24_t)addr, (uint24_t)(addr + 512), g_msd_sect_data);
         #endif
         #endif
 
         #else
         #if defined(_PIC14E)
-        for(i = 0, x = 0; i < 64; i += 2, x++)
-        {
-            buffer[i] = g_msd_ep_out[x];
-            buffer[i + 1] = 0xFF;
-        }
-        Flash_EraseWriteBlock((uint24_t)(addr + g_msd_byte_of_sect), buffer);
-        for(i = 0, x = 32; i < 64; i += 2, x++)
+        for(i = 0, x = 0; i < 128; i += 2, x++)
         {
-            buffer[i] = g_msd_ep_out[x];
-            buffer[i + 1] = 0xFF;
+            m_flash_buf[i] = g_msd_ep_out[x];
+            m_flash_buf[i + 1] = 0xFF;
         }
-        Flash_EraseWriteBlock((uint24_t)(addr + 32 + g_msd_byte_of_sect), buffer);
+        Flash_StartEraseWrite((uint24_t)(addr + g_msd_byte_of_sect), (uint24_t)(addr + 64 + g_msd_byte_of_sect), m_flash_buf);
         
-        #elif defined(__J_PART)
+        #elif defined(USE_ROW_CACHE)
         #ifdef MSD_LIMITED_RAM
-        Flash_WriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out);
+        row_write((uint24_t)(addr + g_msd_byte_of_sect), 64, g_msd_ep_out);
         #else
-        for(uint16_t i = 0; i < 512; i += 64, addr += 64) Flash_WriteBlock((uint24_t)addr, g_msd_sect_data + i);
+        row_write((uint24_t)addr, 512, g_msd_sect_data);
         #endif
         
         #else
         #ifdef MSD_LIMITED_RAM
-        Flash_EraseWriteBlock((uint24_t)(addr + g_msd_byte_of_sect), g_msd_ep_out);
+        usb_ram_copy(g_msd_ep_out, m_flash_buf, 64);
+        Flash_StartEraseWrite((uint24_t)(addr + g_msd_byte_of_sect), (uint24_t)(addr + 64 + g_msd_byte_of_sect), m_flash_buf);
         #else
-        for(uint16_t i = 0; i < 512; i += _FLASH_ERASE_SIZE, addr += _FLASH_ERASE_SIZE) Flash_EraseWriteBlock((uint24_t)addr, g_msd_sect_data + i);
+        Flash_StartEraseWrite((uint24_t)addr, (uint24_t)(addr + 512), g_msd_sect_data);
         #endif
         #endif
         #endif
@@ -812,4 +918,140 @@ void msd_tx_sector(void)
 static uint32_t LBA_to_flash_addr(uint32_t LBA)
 {
     return (LBA * BYTES_PER_BLOCK_LE) + FLASH_SPACE_START;
-}
\ No newline at end of file
+}
+#endif
+
+#ifdef USE_ROW_CACHE
+static void row_read(uint24_t addr, uint16_t bytes, uint8_t* p_data)
+{
+    uint8_t *p_row;
+    
+    if(m_row_valid && (addr - m_row_addr) < ROW_SIZE) // Blocks never straddle rows.
+    {
+        p_row = &m_row[(uint16_t)(addr - m_row_addr)];
+        while(bytes--) *p_data++ = *p_row++;
+    }
+    else Flash_ReadBytes(addr, bytes, p_data);
+}
+
+static void row_write(uint24_t addr, uint16_t bytes, uint8_t* p_data)
+{
+    uint24_t row_addr = addr & ~((uint24_t)ROW_SIZE - 1);
+    uint8_t *p_row;
+    
+    if(!m_row_valid || row_addr != m_row_addr)
+    {
+        if(m_row_dirty) // Program the held row first, this write is finished by row_tasks().
+        {
+            row_flush();
+            #ifdef MSD_LIMITED_RAM
+            usb_ram_copy(p_data, m_row_pend, (uint8_t)bytes);
+            #endif
+            m_row_pend_addr  = addr;
+            m_row_pend_bytes = bytes;
+            return;
+        }
+        Flash_ReadBytes(row_addr, ROW_SIZE, m_row); // The half not being written is kept.
+        m_row_addr  = row_addr;
+        m_row_valid = true;
+    }
+    p_row = &m_row[(uint16_t)(addr - row_addr)];
+    while(bytes--) *p_row++ = *p_data++;
+    m_row_dirty = true;
+    m_row_frame = FRAME_NUMBER();
+}
+
+static void row_flush(void)
+{
+    if(!m_row_dirty) return;
+    m_row_dirty = false;
+    Flash_StartEraseWrite(m_row_addr, m_row_addr + ROW_SIZE, m_row);
+}
+
+static void row_tasks(void)
+{
+    if(Flash_Busy()) return;
+    if(m_row_pend_bytes)
+    {
+        row_write(m_row_pend_addr, m_row_pend_bytes, ROW_PEND_DATA);
+        m_row_pend_bytes = 0;
+        return;
+    }
+    if(!m_row_dirty) return;
+    // Frames stop while suspended, write the row straight away then.
+    if(usb_get_state() == STATE_SUSPENDED || ((FRAME_NUMBER() - m_row_frame) & 0x7FF) >= ROW_IDLE_FRAMES) row_flush();
+}
+#endif
+
+#ifdef USE_ROW_CACHE
+void msd_sync_cache(void)
+{
+    row_flush(); // msd_media_busy() holds the CSW until the row is programmed.
+}
+#endif
+
+bool msd_media_busy(void)
+{
+    #ifdef USE_ROW_CACHE
+    return Flash_Busy() || m_row_pend_bytes;
+    #else
+    return Flash_Busy();
+    #endif
+}
+
+#ifdef USE_UF2
+void msd_uf2_write(uint32_t target_addr, uint8_t* p_data, uint8_t bytes)
+{
+    uint8_t offset;
+    uint8_t run;
+    
+    while(bytes)
+    {
+        if(!m_uf2_row_used || (target_addr - m_uf2_row_addr) >= UF2_ROW_BYTES) // Moved on to another row.
+        {
+            uf2_write_row();
+            m_uf2_row_addr = target_addr & ~((uint32_t)UF2_ROW_BYTES - 1);
+            usb_ram_set(0xFF, m_uf2_row, UF2_ROW_BYTES);
+            m_uf2_row_used = true;
+        }
+        offset = (uint8_t)(target_addr - m_uf2_row_addr);
+        run = UF2_ROW_BYTES - offset;
+        if(run > bytes) run = bytes;
+        usb_ram_copy(p_data, m_uf2_row + offset, run);
+        p_data += run;
+        target_addr += run;
+        bytes -= run;
+        if((offset + run) == UF2_ROW_BYTES) uf2_write_row();
+    }
+}
+
+void msd_uf2_done(void)
+{
+    uf2_write_row(); // Last row may be partly filled.
+    usb_ram_set(0, m_uf2_erased, sizeof(m_uf2_erased)); // The next file erases again.
+}
+
+static void uf2_write_row(void)
+{
+    uint32_t addr;
+    uint32_t erase_addr;
+    uint16_t block;
+    
+    if(!m_uf2_row_used) return;
+    m_uf2_row_used = false;
+    
+    addr = m_uf2_row_addr >> UF2_ADDR_SHIFT;
+    if(addr < FLASH_SPACE_START || addr >= END_OF_FLASH) return; // Never touch the bootloader or config words.
+    
+    // An erase block is erased by the first row written into it, wherever in 
+    // the block that row is and whatever order the file's blocks come in.
+    block = (uint16_t)((addr - FLASH_SPACE_START) / _FLASH_ERASE_SIZE);
+    if(!(m_uf2_erased[block >> 3] & (1 << (block & 7))))
+    {
+        m_uf2_erased[block >> 3] |= (uint8_t)(1 << (block & 7));
+        erase_addr = FLASH_SPACE_START + ((uint32_t)block * _FLASH_ERASE_SIZE);
+        Flash_Erase((uint24_t)erase_addr, (uint24_t)(erase_addr + _FLASH_ERASE_SIZE));
+    }
+    Flash_WriteBlock((uint24_t)addr, m_uf2_row);
+}
+#endif
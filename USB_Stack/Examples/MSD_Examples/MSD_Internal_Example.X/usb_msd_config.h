@@ -34,34 +34,57 @@
 // External Media Support
 //#define USE_EXTERNAL_MEDIA
 
+// Compressed Read-Only Volume, shows an image packed by Tools/msd_pack_image.py instead of flash.
+// Add usb_lzvol.c and the packed image (lzvol_image.c) to the project.
+//#define USE_LZ_VOLUME
+
 // Support SCSI Command
+#ifndef USE_LZ_VOLUME
 #define USE_WRITE_10
-//#define USE_PREVENT_ALLOW_MEDIUM_REMOVAL
+#endif
+//#define USE_PREVENT_ALLOW_MEDIUM_REMOVAL // ALLOW always passes, this lets PREVENT pass too.
 //#define USE_VERIFY_10
 
 //#define USE_WR_PROTECT
 //#define USE_TEST_UNIT_READY
 //#define USE_START_STOP_UNIT
-//#define USE_READ_CAPACITY   // if not defined use the constant defines for capacity below. 
+#define USE_MEDIA_BUSY      // msd_media_busy() holds off MSD while flash is erased/programmed in steps.
+//#define USE_READ_CAPACITY   // if not defined READ_CAPACITY answers from the LUN capacities below (see msd_set_capacity()).
+
+// UF2 Mode, flash is programmed from a .uf2 file copied to a virtual drive.
+//#define USE_UF2
+
+#ifdef USE_UF2
+#define UF2_FAMILY_ID 0UL // Only take blocks with this family ID (0 takes blocks with or without one).
+#define UF2_INFO_TEXT "UF2 Bootloader\r\nModel: PIC16/PIC18 USB Stack\r\nBoard-ID: USB-Stack-MSD\r\n"
+#endif
+
+// Write Cache, SYNCHRONIZE_CACHE_10 calls msd_sync_cache() and MODE SENSE reports WCE.
+#if defined(__J_PART) && !defined(USE_UF2) && !defined(USE_LZ_VOLUME)
+#define USE_WRITE_CACHE     // J parts' 1024 byte rows are cached in RAM, msd_sync_cache() programs the held row.
+#endif
 
 // CAPACITY
-#if defined(__J_PART)
-#define BYTES_PER_BLOCK_LE 0x400 // 1024
-#define BYTES_PER_BLOCK_BE 0x00040000UL // Big-endian version
+#define BYTES_PER_BLOCK_LE 0x200 // 512, J parts' 1024 byte rows are cached by main.c.
+#if defined(USE_UF2)
+#define VOL_CAPACITY_IN_BLOCKS 4000UL // Virtual, room for a .uf2 file twice the size of flash. Stays FAT12.
+#elif defined(USE_LZ_VOLUME)
+#define VOL_CAPACITY_IN_BLOCKS 0UL // Set from g_lzvol_sectors by main.c (see msd_set_capacity()).
 #else
-#define BYTES_PER_BLOCK_LE 0x200 // 512
-#define BYTES_PER_BLOCK_BE 0x00020000UL // Big-endian version
-#endif
 #if defined(_PIC14E)
 #define VOL_CAPACITY_IN_BYTES  0x1000UL // 4KB
 #elif defined(__J_PART)
-#define VOL_CAPACITY_IN_BYTES (_ROMSIZE - 0x2000 - 0x3F8) // Don't include last block.
+#define VOL_CAPACITY_IN_BYTES (_ROMSIZE - 0x2000 - 0x400) // Don't include the last row, it holds the config words.
 #else
 #define VOL_CAPACITY_IN_BYTES (_ROMSIZE - 0x2000) // Code is expected to compile <8KB, offset is 0x2000.
 #endif
 #define VOL_CAPACITY_IN_BLOCKS (VOL_CAPACITY_IN_BYTES / BYTES_PER_BLOCK_LE)
-#define LAST_BLOCK_LE (VOL_CAPACITY_IN_BLOCKS - 1)
-#define LAST_BLOCK_BE (LAST_BLOCK_LE << 24) // This conversion method is fine unless number of blocks is greater than 255.
+#endif
+
+// Logical Units
+#define MSD_NUM_LUNS       1 // 1 to 16, callbacks check g_msd_lun for the unit being accessed.
+#define MSD_LUN_BLOCKS     VOL_CAPACITY_IN_BLOCKS // Starting capacity of each LUN in blocks, comma separated, LUN 0 first.
+#define MSD_LUN_BLOCK_SIZE BYTES_PER_BLOCK_LE     // Bytes per block of each LUN, multiples of MSD_EP_SIZE (512 max without MSD_LIMITED_RAM).
 
 // MSD Endpoint HAL
 #define MSD_EP EP1
@@ -78,6 +101,18 @@
 // MSD UEP1bits
 #define MSD_UEPbits UEP1bits
 
+// Statistics, per SCSI command latency histograms and sector call times in g_msd_stats (see msd_stats_read()).
+// Read with Tools/msd_stats.py. Costs about 200 bytes of RAM with the default rows.
+//#define USE_MSD_STATS
+
+#ifdef USE_MSD_STATS
+#define MSD_STATS_ROWS      4         // Commands with a row of their own, the first of the command table (READ_10, WRITE_10, TEST_UNIT_READY, REQUEST_SENSE).
+#define MSD_STATS_REQUEST   0x5A      // Vendor request reading (IN) or clearing (OUT) the statistics, not 0xFE or 0xFF.
+#define MSD_STATS_TIME()    ((((uint16_t)UFRMH << 8) | UFRML) & 0x7FF) // Frame number, a free running timer (e.g. TMR1) gives finer times.
+#define MSD_STATS_TIME_MASK 0x7FF     // Bits MSD_STATS_TIME() counts in.
+#define MSD_STATS_TICK_NS   1000000UL // 1ms frames.
+#endif
+
 // RAM Setting
 #if defined(_PIC14E) || defined(_18F14K50)
 #define MSD_LIMITED_RAM // PIC18F145X and PIC18F14K50 need this settings as RAM is tight on these parts.
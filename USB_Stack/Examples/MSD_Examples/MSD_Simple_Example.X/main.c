@@ -89,142 +89,34 @@
  * 
  */
 
-/* Emulated FAT12 File System
-             ______________
-    0x00000 |              |
-            |  BOOT SECT   | 0x200 (512B)
-    0x001FF |______________|
-    0x00200 |              |
-            |   FAT SECT   | 0x200 (512B)
-    0x003FF |______________|
-    0x00400 |              |
-            |  ROOT SECT   | 0x200 (512B)
-    0x005FF |______________|
-    0x00600 |              |
-            |  DATA SECT   | 0x1FA00 (126.5KB)
-    0x1FFFF |______________|
-
+/* Virtual FAT16 File System (usb_vfat.c)
+ * 
+ * Nothing is stored, every sector is generated when the PC reads it.
+ * HELLO.TXT comes from a string in program memory, RAMP.BIN is 1MB of 
+ * counting bytes made up on the fly.
  */
 
-#define BOOT_SECT_ADDR 0
-#define FAT_SECT_ADDR  1
-#define ROOT_SECT_ADDR 2
-#define DATA_SECT_ADDR 3
-#define FILE_SECT_ADDR DATA_SECT_ADDR
-
 #include <xc.h>
 #include <stdint.h>
 #include "fuses.h"
 #include "config.h"
 #include "usb.h"
 #include "usb_msd.h"
-
-/** Boot Sector */
-typedef struct
-{
-    uint8_t  jmpBoot[3];
-    uint8_t  OEMName[8];
-    uint16_t BytesPerSec;
-    uint8_t  SecPerClus;
-    uint16_t RsvdSecCnt;
-    uint8_t  NumFATs;
-    uint16_t RootEntCnt;
-    uint16_t TotSec16;
-    uint8_t  Media;
-    uint16_t FATSz16;
-    uint16_t SecPerTrk;
-    uint16_t NumHeads;
-    uint32_t HiddSec;
-    uint32_t TotSec32;
-    uint8_t  DrvNum;
-    uint8_t  Reserved1;
-    uint8_t  BootSig;
-    uint8_t  VolID[4];
-    uint8_t  VolLab[11];
-    uint8_t  FilSysType[8];
-}BOOT16_t;
-
-static const BOOT16_t boot16 =
-{
-    {0xEB,0x3C,0x90},
-    {'M','S','D','O','S','5','.','0'},
-    BYTES_PER_BLOCK_LE,
-    1,
-    1,
-    1,
-    16,
-    VOL_CAPACITY_IN_BLOCKS,
-    0xF8,
-    1,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0x29,
-    {0x86,0xE8,0xA3,0x56},
-    {'U','S','B',' ','D','R','I','V','E',' ',' '},
-    {'F','A','T','1','6',' ',' ',' '}
-};
-
-/** Directory Entry Structure */
-typedef struct
-{
-    uint8_t  Name[11];
-    uint8_t  Attr;
-    uint8_t  NTRes;
-    uint8_t  CrtTimeTenth;
-    uint16_t CrtTime;
-    uint16_t CrtDate;
-    uint16_t LstAccDate;
-    uint16_t FstClusHI;
-    uint16_t WrtTime;
-    uint16_t WrtDate;
-    uint16_t FstClusLO;
-    uint32_t FileSize;
-}DIR_ENTRY_t;
-
-/** Root Directory Structure */
-typedef struct
-{
-    DIR_ENTRY_t VOL;
-    DIR_ENTRY_t FILE1;
-}ROOT_DIR_t;
+#include "usb_vfat.h"
 
 static const uint8_t file[] = "Hello World!";
 
-/** Volume Root Entry */
-static const ROOT_DIR_t root =
+static void hello_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes);
+static void ramp_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes);
+
+/** Files on the drive. */
+const vfat_file_t g_vfat_files[VFAT_NUM_FILES] =
 {
-    {
-        {'U','S','B',' ','D','R','I','V','E',' ',' '},
-        0x08,
-        0,
-        0,
-        0x7BA0,
-        0x4B0B,
-        0x4B0B,
-        0,
-        0x7BA0,
-        0x4B0B,
-        0,
-        0
-    },
-    {
-       {'H','E','L','L','O',' ',' ',' ','T','X','T'},
-        0x20,
-        0,
-        0,
-        0x7BA0,
-        0x4B0B,
-        0x4B0B,
-        0,
-        0x7BA0,
-        0x4B0B,
-        2,
-        sizeof(file)
-    }
+    {{'H','E','L','L','O',' ',' ',' ','T','X','T'}, sizeof(file) - 1, hello_read},
+    {{'R','A','M','P',' ',' ',' ',' ','B','I','N'}, 0x100000UL,       ramp_read},
+    #ifdef USE_MSD_STATS
+    {{'S','T','A','T','S',' ',' ',' ','B','I','N'}, sizeof(msd_stats_t), msd_stats_read},
+    #endif
 };
 
 static void example_init(void);
@@ -242,6 +134,7 @@ void main(void)
     flash_led();
 	#endif
     
+    if(!vfat_init()) while(1){} // Shrink the files or grow the volume.
     usb_init();
     INTCONbits.PEIE = 1;
     USB_INTERRUPT_FLAG = 0;
@@ -383,6 +276,16 @@ static void flash_led(void)
 }
 #endif
 
+static void hello_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    usb_rom_copy(&file[offset], p_buffer, (uint8_t)bytes);
+}
+
+static void ramp_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    for(uint16_t i = 0; i < bytes; i++) p_buffer[i] = (uint8_t)(offset + i);
+}
+
 void msd_rx_sector(void)
 {
     #ifdef MSD_LIMITED_RAM
@@ -395,67 +298,9 @@ void msd_rx_sector(void)
     #define RSC_EP_ADDRESS g_msd_ep_in
     #endif
     
-    usb_ram_set(0, RSC_EP_ADDRESS, 64);
-    
-    if(g_msd_rw_10_vars.LBA == BOOT_SECT_ADDR)  // If PC is reading the Boot Sector.
-    {
-        if(g_msd_byte_of_sect == 0) usb_rom_copy((const uint8_t*)(&boot16), RSC_EP_ADDRESS, sizeof(boot16));
-        else if(g_msd_byte_of_sect == 448)
-        {
-            RSC_EP_ADDRESS[62] = 0x55;
-            RSC_EP_ADDRESS[63] = 0xAA;
-        }
-    }
-    else if(g_msd_rw_10_vars.LBA == FAT_SECT_ADDR) // If PC is reading the FAT.
-    {
-        if(g_msd_byte_of_sect == 0)
-        {
-            RSC_EP_ADDRESS[0] = 0xF8;
-            RSC_EP_ADDRESS[1] = 0xFF;
-            RSC_EP_ADDRESS[2] = 0xFF;
-            RSC_EP_ADDRESS[3] = 0xFF;
-            RSC_EP_ADDRESS[4] = 0x0F;
-        }
-    }
-    else if(g_msd_rw_10_vars.LBA == ROOT_SECT_ADDR) // If PC is reading the Root Sector.
-    {
-        if(g_msd_byte_of_sect == 0) usb_rom_copy((const uint8_t*)(&root), RSC_EP_ADDRESS, 64);
-    }
-    else if(g_msd_rw_10_vars.LBA >= DATA_SECT_ADDR) // If PC is reading the Data Sector.
-    {
-        if(g_msd_rw_10_vars.LBA == FILE_SECT_ADDR) // If PC is reading ABOUT file data.
-        {
-            if(g_msd_byte_of_sect == 0) usb_rom_copy(file, RSC_EP_ADDRESS, sizeof(file));
-        }
-    }
+    vfat_read(g_msd_rw_10_vars.LBA, g_msd_byte_of_sect, RSC_EP_ADDRESS, MSD_EP_SIZE);
     #else
-    usb_ram_set(0, g_msd_sect_data, 512); // Blank Regions of memory are read as zero.
-
-    if(g_msd_rw_10_vars.LBA == BOOT_SECT_ADDR)  // If PC is reading the Boot Sector.
-    {
-        usb_rom_copy((const uint8_t*)(&boot16), g_msd_sect_data, sizeof(boot16));
-        g_msd_sect_data[510] = 0x55;
-        g_msd_sect_data[511] = 0xAA;
-    }
-    else if(g_msd_rw_10_vars.LBA == FAT_SECT_ADDR) // If PC is reading the FAT.
-    {
-        g_msd_sect_data[0] = 0xF8;
-        g_msd_sect_data[1] = 0xFF;
-        g_msd_sect_data[2] = 0xFF;
-        g_msd_sect_data[3] = 0xFF;
-        g_msd_sect_data[4] = 0x0F;
-    }
-    else if(g_msd_rw_10_vars.LBA == ROOT_SECT_ADDR) // If PC is reading the Root Sector.
-    {
-        usb_rom_copy((const uint8_t*)(&root), g_msd_sect_data, 64);
-    }
-    else if(g_msd_rw_10_vars.LBA >= DATA_SECT_ADDR) // If PC is reading the Data Sector.
-    {
-        if(g_msd_rw_10_vars.LBA == FILE_SECT_ADDR) // If PC is reading ABOUT file data.
-        {
-            usb_rom_copy(file, g_msd_sect_data, sizeof(file));
-        }
-    }
+    vfat_read(g_msd_rw_10_vars.LBA, 0, g_msd_sect_data, BYTES_PER_BLOCK_LE);
     #endif
 }
 
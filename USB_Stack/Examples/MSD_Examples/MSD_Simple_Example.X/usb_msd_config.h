@@ -36,23 +36,25 @@
 
 // Support SCSI Command
 //#define USE_WRITE_10
-//#define USE_PREVENT_ALLOW_MEDIUM_REMOVAL
+//#define USE_PREVENT_ALLOW_MEDIUM_REMOVAL // ALLOW always passes, this lets PREVENT pass too.
 //#define USE_VERIFY_10
 
 //#define USE_WR_PROTECT
 //#define USE_TEST_UNIT_READY
 //#define USE_START_STOP_UNIT
-//#define USE_READ_CAPACITY   // if not defined use the constant defines for capacity below. 
+//#define USE_MEDIA_BUSY    // msd_media_busy() holds off MSD while the media is busy.
+//#define USE_READ_CAPACITY   // if not defined READ_CAPACITY answers from the LUN capacities below (see msd_set_capacity()).
 
 // CAPACITY
 #define BYTES_PER_BLOCK_LE 0x200 // 512
-#define BYTES_PER_BLOCK_BE 0x00020000UL // Big-endian version
 
-#define VOL_CAPACITY_IN_BYTES 0x20000UL // 128KB
-#define VOL_CAPACITY_IN_BLOCKS 0x100 // 256
+#define VOL_CAPACITY_IN_BYTES 0x400000UL // 4MB, virtual (usb_vfat.c), enough clusters to be FAT16.
+#define VOL_CAPACITY_IN_BLOCKS 0x2000UL // 8192
 
-#define LAST_BLOCK_LE 0xFF // 255 (VOL_CAPACITY_IN_BLOCKS - 1)
-#define LAST_BLOCK_BE 0xFF000000UL // Big-endian version
+// Logical Units
+#define MSD_NUM_LUNS       1 // 1 to 16, callbacks check g_msd_lun for the unit being accessed.
+#define MSD_LUN_BLOCKS     VOL_CAPACITY_IN_BLOCKS // Starting capacity of each LUN in blocks, comma separated, LUN 0 first.
+#define MSD_LUN_BLOCK_SIZE BYTES_PER_BLOCK_LE     // Bytes per block of each LUN, multiples of MSD_EP_SIZE (512 max without MSD_LIMITED_RAM).
 
 // MSD Endpoint HAL
 #define MSD_EP EP1
@@ -69,6 +71,18 @@
 // MSD UEP1bits
 #define MSD_UEPbits UEP1bits
 
+// Statistics, per SCSI command latency histograms and sector call times in g_msd_stats (see msd_stats_read()).
+// Read with Tools/msd_stats.py. Costs about 200 bytes of RAM with the default rows.
+//#define USE_MSD_STATS
+
+#ifdef USE_MSD_STATS
+#define MSD_STATS_ROWS      4         // Commands with a row of their own, the first of the command table (READ_10, WRITE_10, TEST_UNIT_READY, REQUEST_SENSE).
+#define MSD_STATS_REQUEST   0x5A      // Vendor request reading (IN) or clearing (OUT) the statistics, not 0xFE or 0xFF.
+#define MSD_STATS_TIME()    ((((uint16_t)UFRMH << 8) | UFRML) & 0x7FF) // Frame number, a free running timer (e.g. TMR1) gives finer times.
+#define MSD_STATS_TIME_MASK 0x7FF     // Bits MSD_STATS_TIME() counts in.
+#define MSD_STATS_TICK_NS   1000000UL // 1ms frames.
+#endif
+
 // RAM Setting
 #if defined(_PIC14E) || defined(_18F14K50)
 #define MSD_LIMITED_RAM // PIC18F145X and PIC18F14K50 need this settings as RAM is tight on these parts.
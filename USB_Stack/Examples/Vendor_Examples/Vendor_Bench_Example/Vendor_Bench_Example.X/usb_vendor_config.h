@@ -0,0 +1,100 @@
+/**
+ * @file usb_vendor_config.h
+ * @brief <i>Vendor Specific</i> bulk interface settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Vendor Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_VENDOR_CONFIG_H
+#define USB_VENDOR_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* *************************** VENDOR SETTINGS ****************************** */
+/* ************************************************************************** */
+
+// Uncomment to end every vendor_write() with a short packet, sending a ZLP
+// when the length is a multiple of VENDOR_EP_SIZE. Leave commented for a
+// continuous stream, where the host reads whatever size it likes.
+//#define VENDOR_IN_ZLP
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ MICROSOFT OS 2.0 SETTINGS *********************** */
+/* ************************************************************************** */
+
+// Uncomment to bind WinUSB to the interface without an INF (Windows 8.1 and
+// later). The device descriptor's bcdUSB must be 0x0201 or higher for Windows
+// to ask for the BOS descriptor, and usb_get_class_descriptor() and
+// usb_service_class_request() must pass requests on to the vendor library.
+#define USE_MS_OS_20
+
+#define VENDOR_MS_VENDOR_CODE 0x20 // bRequest of the MS OS 2.0 descriptor request.
+
+// Uncomment when the device has other interfaces, so the descriptors only
+// apply to the vendor interface.
+//#define VENDOR_MS_OS_20_COMPOSITE
+
+// DeviceInterfaceGUID applications open the device with, in the same form as
+// a string descriptor.
+#define VENDOR_DEVICE_INTERFACE_GUID '{','8','8','B','A','E','0','3','2','-','5','A','8','1','-','4','9','F','0','-',\
+                                     'B','C','3','D','-','A','4','F','F','1','3','8','2','1','6','D','6','}'
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** VENDOR INTERFACE ***************************** */
+/* ************************************************************************** */
+
+#define VENDOR_INT 0
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** VENDOR ENDPOINTS ***************************** */
+/* ************************************************************************** */
+
+// Vendor Endpoint HAL
+#define VENDOR_EP      EP1
+#define VENDOR_EP_SIZE EP1_SIZE // 8, 16, 32 or 64.
+
+#define VENDOR_BD_OUT      BD1_OUT
+#define VENDOR_BD_OUT_EVEN BD1_OUT_EVEN
+#define VENDOR_BD_OUT_ODD  BD1_OUT_ODD
+#define VENDOR_BD_IN       BD1_IN
+#define VENDOR_BD_IN_EVEN  BD1_IN_EVEN
+#define VENDOR_BD_IN_ODD   BD1_IN_ODD
+
+#define VENDOR_UEPbits UEP1bits
+
+/* ************************************************************************** */
+
+#endif /* USB_VENDOR_CONFIG_H */
@@ -0,0 +1,312 @@
+/**
+ * @file audio_host_sim.c
+ * @brief Runs usb_audio.c on a PC against a model of an audio host.
+ *
+ * The real usb_audio.c is built with the template's settings (see
+ * usb_audio_config.h here). The core's isochronous handling is followed:
+ * usb_iso_start() fills both IN BDs, and at each SOF the BD the host finished
+ * with in the last frame is filled again through usb_iso_in(). The host reads
+ * one packet per frame, half way through it, and an ADC feeds audio_put() at
+ * the selected rate with its clock off by up to +/-0.5%.
+ *
+ * For every rate and clock error the host checks:
+ *  - Each sample arrives once and in order, so nothing was dropped or sent
+ *    from a part of the ring the ADC had already written over.
+ *  - No packet was sent short and no sample was dropped once streaming began.
+ *  - The ring stays around its target, so the latency doesn't drift.
+ * SET_CUR/GET_CUR/GET_MAX of SAMPLING_FREQ_CONTROL are checked as well.
+ *
+ * Build and run (from this folder), mono and stereo:
+ *     gcc -std=gnu99 -Wall -I. -I../../USB -o audio_host_sim audio_host_sim.c ../../USB/usb_audio.c
+ *     ./audio_host_sim
+ *     gcc -std=gnu99 -Wall -DAUDIO_CHANNELS=2 -I. -I../../USB -o audio_host_sim audio_host_sim.c ../../USB/usb_audio.c
+ *     ./audio_host_sim
+ * Other sizes can be tried with -DAUDIO_RING_SAMPLES=N and -DAUDIO_MAX_SAMPLE_RATE=N.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "usb.h"
+#include "usb_ch9.h"
+#include "usb_audio.h"
+
+/* ************************************************************************** */
+/* ****************************** SIM DEFINES ******************************* */
+/* ************************************************************************** */
+
+#define SIM_FRAMES  5000 // Frames streamed for each rate and clock error.
+#define SIM_SETTLED 200  // Frames after priming before the ring's level is checked.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** DEVICE SIDE STUBS ***************************** */
+/* ************************************************************************** */
+
+ch9_setup_t g_usb_setup;
+
+typedef struct
+{
+    bool     Armed;
+    uint8_t* Data;
+    uint16_t Cnt;
+}sim_bd_t;
+
+static uint8_t*      m_ctrl_ptr;
+static uint16_t      m_ctrl_in_bytes;
+static uint8_t       m_ctrl_stage;
+static usb_iso_ep_t* m_iso;
+static sim_bd_t      m_bd[2];
+static uint8_t       m_last_ppb;    // Last BD armed, like Last_PPB in the core.
+static uint8_t       m_host_ppb;    // BD the host reads next.
+static uint32_t      m_rate_changed;
+
+void usb_set_ram_ptr(uint8_t* data){ m_ctrl_ptr = data; }
+void usb_in_control_transfer(void){}
+void usb_set_control_stage(uint8_t control_stage){ m_ctrl_stage = control_stage; }
+void usb_set_num_out_control_bytes(uint16_t bytes){}
+
+void usb_setup_in_control_transfer(uint8_t ram_rom, uint16_t bytes_available, uint16_t requested_length)
+{
+    m_ctrl_in_bytes = bytes_available < requested_length ? bytes_available : requested_length;
+}
+
+uint16_t usb_iso_in(uint8_t ep, uint8_t** p_buffer)
+{
+    if(ep == AUDIO_EP) return audio_iso_in(p_buffer);
+    return 0;
+}
+
+bool audio_sample_rate_changed(uint32_t rate)
+{
+    m_rate_changed = rate;
+    return true;
+}
+
+static void iso_service(void)
+{
+    uint8_t  ppb;
+    uint8_t* p_data;
+
+    while(1)
+    {
+        ppb = m_last_ppb ^ 1;
+        if(m_bd[ppb].Armed) return;
+        p_data = m_iso->Buffers[ppb];
+        m_bd[ppb].Cnt   = usb_iso_in(m_iso->EP, &p_data);
+        m_bd[ppb].Data  = p_data;
+        m_bd[ppb].Armed = true;
+        if(m_bd[ppb].Cnt > m_iso->Size) m_bd[ppb].Cnt = m_iso->Size;
+        m_last_ppb = ppb;
+    }
+}
+
+bool usb_iso_start(usb_iso_ep_t* p_iso)
+{
+    m_iso = p_iso;
+    m_iso->Running = true;
+    m_bd[0].Armed = false;
+    m_bd[1].Armed = false;
+    m_host_ppb = m_last_ppb ^ 1;
+    iso_service();
+    return true;
+}
+
+void usb_iso_stop(usb_iso_ep_t* p_iso)
+{
+    if(!p_iso->Running) return;
+    p_iso->Running = false;
+    if(m_bd[0].Armed ^ m_bd[1].Armed) m_last_ppb ^= 1;
+    m_bd[0].Armed = false;
+    m_bd[1].Armed = false;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* HELPERS ********************************** */
+/* ************************************************************************** */
+
+static int m_errors;
+
+static void fail(const char* format, ...)
+{
+    va_list args;
+
+    if(m_errors++ >= 20) return;
+    va_start(args, format);
+    printf("FAIL: ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+static void setup(uint8_t request, uint16_t length)
+{
+    memset(&g_usb_setup, 0, sizeof(g_usb_setup));
+    g_usb_setup.bmRequestType_bits.Recipient = ENDPOINT;
+    g_usb_setup.bmRequestType_bits.Type = CLASS;
+    g_usb_setup.bmRequestType_bits.DataTransferDirection = request & 0x80 ? DEVICE_TO_HOST : HOST_TO_DEVICE;
+    g_usb_setup.bRequest = request;
+    g_usb_setup.wValue   = AUDIO_SAMPLING_FREQ_CONTROL << 8;
+    g_usb_setup.wIndex   = AUDIO_EP | 0x80;
+    g_usb_setup.wLength  = length;
+    m_ctrl_stage = 0;
+}
+
+static uint32_t get_rate(uint8_t request)
+{
+    setup(request, 3);
+    if(!audio_class_request() || m_ctrl_stage != DATA_IN_STAGE || m_ctrl_in_bytes != 3)
+    {
+        fail("request 0x%02X not answered", request);
+        return 0;
+    }
+    return m_ctrl_ptr[0] | ((uint32_t)m_ctrl_ptr[1] << 8) | ((uint32_t)m_ctrl_ptr[2] << 16);
+}
+
+static bool set_rate(uint32_t rate)
+{
+    setup(AUDIO_SET_CUR, 3);
+    if(!audio_class_request() || m_ctrl_stage != DATA_OUT_STAGE)
+    {
+        fail("SET_CUR not accepted");
+        return false;
+    }
+    m_ctrl_ptr[0] = (uint8_t)rate;
+    m_ctrl_ptr[1] = (uint8_t)(rate >> 8);
+    m_ctrl_ptr[2] = (uint8_t)(rate >> 16);
+    return audio_out_control_tasks();
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ****************************** HOST CHECKS ******************************* */
+/* ************************************************************************** */
+
+static void check_controls(void)
+{
+    audio_init();
+    if(get_rate(AUDIO_GET_CUR) != AUDIO_SAMPLE_RATE) fail("GET_CUR isn't AUDIO_SAMPLE_RATE after audio_init()");
+    if(get_rate(AUDIO_GET_MIN) != AUDIO_MIN_SAMPLE_RATE) fail("GET_MIN is wrong");
+    if(get_rate(AUDIO_GET_MAX) != AUDIO_MAX_SAMPLE_RATE) fail("GET_MAX is wrong");
+    if(set_rate(AUDIO_MAX_SAMPLE_RATE + 1)) fail("a rate above AUDIO_MAX_SAMPLE_RATE was taken");
+    if(set_rate(AUDIO_MIN_SAMPLE_RATE - 1)) fail("a rate below AUDIO_MIN_SAMPLE_RATE was taken");
+    if(!set_rate(AUDIO_MIN_SAMPLE_RATE) || m_rate_changed != AUDIO_MIN_SAMPLE_RATE) fail("SET_CUR of AUDIO_MIN_SAMPLE_RATE failed");
+    if(get_rate(AUDIO_GET_CUR) != AUDIO_MIN_SAMPLE_RATE) fail("GET_CUR doesn't follow SET_CUR");
+}
+
+static void stream(uint32_t rate, int ppm)
+{
+    double   period = 1000.0 / (rate * (1.0 + ppm / 1e6)); // ADC sample period in ms.
+    double   next_sample = 0.37;  // SET_INTERFACE comes part way into a frame.
+    uint16_t produced = 0;        // Also the next sample's value.
+    uint16_t expected = 0;
+    uint32_t received = 0;
+    uint32_t frame;
+    uint32_t primed_frame = 0;
+    bool     primed = false;
+    int      used_min = 255, used_max = 0, used;
+    uint16_t i, cnt;
+    int16_t* p_samples;
+
+    audio_init();
+    if(!set_rate(rate)) fail("%lu Hz not taken", (unsigned long)rate);
+    if(!audio_set_interface(1, AUDIO_AS_INT)) fail("alt setting 1 not taken");
+
+    for(frame = 0; frame < SIM_FRAMES; frame++)
+    {
+        // SOF, then the host reads the packet armed at the last SOF half way
+        // through the frame, with the ADC running in between.
+        if(frame) iso_service();
+        while(next_sample < frame + 0.5)
+        {
+            #if AUDIO_CHANNELS == 1
+            audio_put((int16_t)produced);
+            #else
+            audio_put_stereo((int16_t)produced, (int16_t)~produced);
+            #endif
+            produced++;
+            next_sample += period;
+        }
+
+        if(!m_bd[m_host_ppb].Armed)
+        {
+            fail("%lu Hz %+d ppm: frame %lu had no packet armed", (unsigned long)rate, ppm, (unsigned long)frame);
+            continue;
+        }
+        cnt = m_bd[m_host_ppb].Cnt;
+        p_samples = (int16_t*)m_bd[m_host_ppb].Data;
+        m_bd[m_host_ppb].Armed = false;
+        m_host_ppb ^= 1;
+
+        if(cnt % AUDIO_SAMPLE_BYTES || cnt > AUDIO_EP_SIZE) fail("%lu Hz: %u byte packet", (unsigned long)rate, cnt);
+        if(cnt && !primed)
+        {
+            primed = true;
+            primed_frame = frame;
+        }
+        for(i = 0; i < cnt / AUDIO_SAMPLE_BYTES; i++)
+        {
+            #if AUDIO_CHANNELS == 1
+            if((uint16_t)p_samples[i] != expected)
+            #else
+            if((uint16_t)p_samples[i * 2] != expected || (uint16_t)p_samples[i * 2 + 1] != (uint16_t)~expected)
+            #endif
+            {
+                fail("%lu Hz %+d ppm: frame %lu has sample %u, %u expected", (unsigned long)rate, ppm,
+                     (unsigned long)frame, (uint16_t)p_samples[i * AUDIO_CHANNELS], expected);
+                expected = (uint16_t)p_samples[i * AUDIO_CHANNELS];
+            }
+            expected++;
+            received++;
+        }
+
+        if(primed && frame >= primed_frame + SIM_SETTLED)
+        {
+            used = (uint16_t)(produced - expected);
+            if(used < used_min) used_min = used;
+            if(used > used_max) used_max = used;
+        }
+    }
+    audio_set_interface(0, AUDIO_AS_INT);
+
+    if(g_audio_underruns) fail("%lu Hz %+d ppm: %u short packets", (unsigned long)rate, ppm, g_audio_underruns);
+    if(g_audio_overruns) fail("%lu Hz %+d ppm: %u samples dropped", (unsigned long)rate, ppm, g_audio_overruns);
+    if(!primed) fail("%lu Hz %+d ppm: streaming never started", (unsigned long)rate, ppm);
+    printf("%6lu Hz %+5d ppm: %7lu samples, first after %lu ms, %d-%d samples buffered\n", (unsigned long)rate, ppm,
+           (unsigned long)received, (unsigned long)primed_frame, used_min, used_max);
+}
+
+/* ************************************************************************** */
+
+
+int main(void)
+{
+    static const uint32_t rates[] = {AUDIO_MAX_SAMPLE_RATE, 44100, 22050, 11025, AUDIO_MIN_SAMPLE_RATE};
+    static const int ppms[] = {-5000, -500, 0, 500, 5000};
+    uint8_t r, p;
+
+    printf("%u channel(s), %u sample ring (%u bytes), %u byte packets\n", AUDIO_CHANNELS, AUDIO_RING_SAMPLES,
+           (unsigned)AUDIO_RING_BYTES, (unsigned)AUDIO_EP_SIZE);
+    check_controls();
+    for(r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        if(rates[r] > AUDIO_MAX_SAMPLE_RATE) continue;
+        for(p = 0; p < sizeof(ppms) / sizeof(ppms[0]); p++) stream(rates[r], ppms[p]);
+    }
+
+    if(m_errors)
+    {
+        printf("%d errors\n", m_errors);
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file usb_audio_config.h
+ * @brief Audio settings for the audio host simulation.
+ *
+ * The template's defaults, which can be overridden with -D to try others.
+ */
+
+#ifndef USB_AUDIO_CONFIG_H
+#define USB_AUDIO_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* **************************** CAPTURE FORMAT ****************************** */
+/* ************************************************************************** */
+
+#ifndef AUDIO_CHANNELS
+#define AUDIO_CHANNELS 1
+#endif
+
+#if AUDIO_CHANNELS == 1
+#define AUDIO_SAMPLE_RATE     48000UL
+#define AUDIO_MIN_SAMPLE_RATE 8000UL
+#ifndef AUDIO_MAX_SAMPLE_RATE
+#define AUDIO_MAX_SAMPLE_RATE 48000UL
+#endif
+#ifndef AUDIO_RING_SAMPLES
+#define AUDIO_RING_SAMPLES    240
+#endif
+#else
+#define AUDIO_SAMPLE_RATE     32000UL
+#define AUDIO_MIN_SAMPLE_RATE 8000UL
+#ifndef AUDIO_MAX_SAMPLE_RATE
+#define AUDIO_MAX_SAMPLE_RATE 32000UL
+#endif
+#ifndef AUDIO_RING_SAMPLES
+#define AUDIO_RING_SAMPLES    160
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ AUDIO INTERFACES AND EP ************************* */
+/* ************************************************************************** */
+
+#define AUDIO_AC_INT 0
+#define AUDIO_AS_INT 1
+#define AUDIO_EP     EP1
+#define AUDIO_BD_IN  BD1_IN_EVEN
+
+/* ************************************************************************** */
+
+#endif /* USB_AUDIO_CONFIG_H */
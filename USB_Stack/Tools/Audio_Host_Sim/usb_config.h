@@ -0,0 +1,46 @@
+/**
+ * @file usb_config.h
+ * @brief USB settings for the audio host simulation (PIC18F45K50 layout).
+ */
+
+#ifndef USB_CONFIG_H
+#define USB_CONFIG_H
+
+/* ************************************************************************** */
+/* **************************** USB SETTINGS ******************************** */
+/* ************************************************************************** */
+
+#define BUS_POWERED  0
+#define SELF_POWERED 1
+#define POWERED_TYPE BUS_POWERED
+
+#define LOW_SPEED  0
+#define FULL_SPEED (1 << 2)
+#define USB_SPEED  FULL_SPEED
+
+#define SPEED_PULLUP_OFF 0
+#define SPEED_PULLUP_ON  (1 << 4)
+#define SPEED_PULLUP     SPEED_PULLUP_ON
+
+#define REMOTE_WAKEUP_OFF 0
+#define REMOTE_WAKEUP_ON  1
+#define REMOTE_WAKEUP     REMOTE_WAKEUP_OFF
+
+#define PINGPONG_DIS      0
+#define PINGPONG_0_OUT    1
+#define PINGPONG_ALL_EP   2
+#define PINGPONG_1_15     3
+#define PINGPONG_MODE     PINGPONG_1_15
+
+#define NUM_CONFIGURATIONS 1
+#define NUM_INTERFACES     2
+#define NUM_ALT_INTERFACES 2
+#define NUM_ENDPOINTS      2
+#define EP0_SIZE           8
+
+#define NUM_ISO_ENDPOINTS  1
+#define USE_SOF
+
+/* ************************************************************************** */
+
+#endif /* USB_CONFIG_H */
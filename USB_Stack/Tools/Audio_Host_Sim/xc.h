@@ -0,0 +1,17 @@
+/**
+ * @file xc.h
+ * @brief Stand-in for the XC8 device header so usb_audio.c builds on a PC.
+ *
+ * Nothing in usb_audio.c touches an SFR, absolute addresses are ignored.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include <stdint.h>
+
+#define __at(address)
+#define _PIC18
+#define _18F45K50
+
+#endif /* XC_H */
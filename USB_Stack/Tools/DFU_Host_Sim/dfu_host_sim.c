@@ -0,0 +1,380 @@
+/**
+ * @file dfu_host_sim.c
+ * @brief Runs usb_dfu.c on a PC against a model of a DFU host (dfu-util).
+ *
+ * The real usb_dfu.c is built with the template's PIC18 settings (see
+ * usb_dfu_config.h here). Flash is modelled as it behaves on the part: an
+ * erase sets a row to 0xFF, a write can only clear bits, and both take time
+ * on the USB frame counter usb_dfu.c reads. The device's main loop calls
+ * dfu_tasks() whenever the host isn't in a request, which takes 1 ms.
+ *
+ * The host follows dfu-util: DNLOAD a block, GETSTATUS and wait bwPollTimeout
+ * while dfuDNBUSY, a zero length DNLOAD, then GETSTATUS through dfuMANIFEST
+ * until dfuIDLE. It checks:
+ *  - The image lands at DFU_APP_START, the rest of its last row reads 0xFF,
+ *    and nothing below DFU_APP_START or past the image's rows is touched.
+ *  - Every row is erased before it's written, and only once per download.
+ *  - bwPollTimeout is long enough once the first erase and write are timed,
+ *    so the host never gets dfuDNBUSY twice in a row.
+ *  - UPLOAD reads the image back and ends with a short block.
+ *  - An image past DFU_APP_END fails with errADDRESS, CLRSTATUS recovers,
+ *    and ABORT part way through still leaves a download that can follow.
+ *
+ * Build and run (from this folder), the second has J part rows:
+ *     gcc -std=gnu99 -Wall -I. -I../../USB -o dfu_host_sim dfu_host_sim.c ../../USB/usb_dfu.c
+ *     ./dfu_host_sim
+ *     gcc -std=gnu99 -Wall -D_FLASH_ERASE_SIZE=1024 -I. -I../../USB -o dfu_host_sim dfu_host_sim.c ../../USB/usb_dfu.c
+ *     ./dfu_host_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "usb.h"
+#include "usb_ch9.h"
+#include "usb_dfu.h"
+
+/* ************************************************************************** */
+/* ****************************** SIM DEFINES ******************************* */
+/* ************************************************************************** */
+
+#define SIM_ERASE_MS 4  // Longer than DFU_ERASE_MS, so the first estimates are short.
+#define SIM_WRITE_MS 2
+#define SIM_FILL     0xA5 // Old application left in flash.
+#define SIM_BOOT     0x5A // The DFU firmware below DFU_APP_START.
+#define SIM_ROWS     (DFU_APP_END / _FLASH_ERASE_SIZE)
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** DEVICE SIDE STUBS ***************************** */
+/* ************************************************************************** */
+
+ch9_setup_t      g_usb_setup;
+pie_bits_t       PIE3bits;
+volatile uint8_t UFRML;
+volatile uint8_t UFRMH;
+
+static uint8_t*  m_ctrl_ptr;
+static uint16_t  m_ctrl_in_bytes;
+static uint16_t  m_ctrl_out_bytes;
+static uint8_t   m_ctrl_stage;
+static uint32_t  m_now_ms;
+static uint8_t   m_flash[DFU_APP_END];
+static uint8_t   m_erases[SIM_ROWS]; // Erases of each row this download.
+static bool      m_written[SIM_ROWS]; // Written since its last erase.
+static int       m_errors;
+
+void usb_set_ram_ptr(uint8_t* data){ m_ctrl_ptr = data; }
+void usb_in_control_transfer(void){}
+void usb_arm_in_status(void){}
+void usb_set_control_stage(uint8_t control_stage){ m_ctrl_stage = control_stage; }
+void usb_set_num_out_control_bytes(uint16_t bytes){ m_ctrl_out_bytes = bytes; }
+
+void usb_setup_in_control_transfer(uint8_t ram_rom, uint16_t bytes_available, uint16_t requested_length)
+{
+    m_ctrl_in_bytes = bytes_available < requested_length ? bytes_available : requested_length;
+}
+
+static void fail(const char* format, ...);
+
+static void advance(uint32_t ms)
+{
+    m_now_ms += ms;
+    UFRML = (uint8_t)m_now_ms;
+    UFRMH = (uint8_t)(m_now_ms >> 8) & 7;
+}
+
+void dfu_read(dfu_addr_t addr, uint16_t bytes, uint8_t* p_data)
+{
+    memcpy(p_data, &m_flash[addr], bytes);
+}
+
+void dfu_erase(dfu_addr_t addr)
+{
+    uint32_t row = addr / _FLASH_ERASE_SIZE;
+
+    if(addr < DFU_APP_START || addr >= DFU_APP_END || addr % _FLASH_ERASE_SIZE) fail("erase at 0x%05lX", (unsigned long)addr);
+    else
+    {
+        if(m_erases[row]++) fail("row 0x%05lX erased twice", (unsigned long)addr);
+        memset(&m_flash[addr], 0xFF, _FLASH_ERASE_SIZE);
+        m_written[row] = false;
+    }
+    advance(SIM_ERASE_MS);
+}
+
+void dfu_write_block(dfu_addr_t addr, uint8_t* p_data)
+{
+    uint16_t i;
+    uint32_t row = addr / _FLASH_ERASE_SIZE;
+
+    if(addr < DFU_APP_START || addr + _FLASH_WRITE_SIZE > DFU_APP_END || addr % _FLASH_WRITE_SIZE)
+    {
+        fail("write at 0x%05lX", (unsigned long)addr);
+    }
+    else
+    {
+        if(!m_erases[row]) fail("row 0x%05lX written before it was erased", (unsigned long)addr);
+        for(i = 0; i < _FLASH_WRITE_SIZE; i++) m_flash[addr + i] &= p_data[i]; // Only clears bits.
+        m_written[row] = true;
+    }
+    advance(SIM_WRITE_MS);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* HELPERS ********************************** */
+/* ************************************************************************** */
+
+static void fail(const char* format, ...)
+{
+    va_list args;
+
+    if(m_errors++ >= 20) return;
+    va_start(args, format);
+    printf("FAIL: ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+// The device's main loop for a while, dfu_tasks() moves the clock on itself 
+// while it has flash to program.
+static void device_run(uint32_t ms)
+{
+    uint32_t end = m_now_ms + ms;
+    uint32_t before;
+
+    while(m_now_ms < end)
+    {
+        before = m_now_ms;
+        dfu_tasks();
+        if(m_now_ms == before) advance(1);
+    }
+}
+
+static bool request(uint8_t request, uint16_t length)
+{
+    bool handled;
+
+    memset(&g_usb_setup, 0, sizeof(g_usb_setup));
+    g_usb_setup.bmRequestType_bits.Recipient = INTERFACE;
+    g_usb_setup.bmRequestType_bits.Type = CLASS;
+    g_usb_setup.bmRequestType_bits.DataTransferDirection = 
+        (request == DFU_UPLOAD || request == DFU_GETSTATUS || request == DFU_GETSTATE) ? DEVICE_TO_HOST : HOST_TO_DEVICE;
+    g_usb_setup.bRequest = request;
+    g_usb_setup.wIndex   = DFU_INT;
+    g_usb_setup.wLength  = length;
+    m_ctrl_stage    = 0;
+    m_ctrl_in_bytes = 0;
+    handled = dfu_class_request();
+    advance(1);
+    return handled;
+}
+
+static bool dnload(const uint8_t* p_data, uint16_t length)
+{
+    if(!request(DFU_DNLOAD, length)) return false;
+    if(length == 0) return true;
+    if(m_ctrl_stage != DATA_OUT_STAGE || m_ctrl_out_bytes != length)
+    {
+        fail("DNLOAD of %u bytes had no data stage", length);
+        return false;
+    }
+    memcpy(m_ctrl_ptr, p_data, length);
+    return dfu_out_control_tasks(); // usb_out_control_finished(), false stalls the status stage.
+}
+
+static uint8_t get_status(uint8_t* p_status, uint32_t* p_poll_ms)
+{
+    if(!request(DFU_GETSTATUS, 6) || m_ctrl_in_bytes != 6)
+    {
+        fail("GETSTATUS not answered");
+        return 0xFF;
+    }
+    *p_status  = m_ctrl_ptr[0];
+    *p_poll_ms = m_ctrl_ptr[1] | ((uint32_t)m_ctrl_ptr[2] << 8) | ((uint32_t)m_ctrl_ptr[3] << 16);
+    return m_ctrl_ptr[4];
+}
+
+static void reset_flash(void)
+{
+    memset(m_flash, SIM_BOOT, DFU_APP_START);
+    memset(&m_flash[DFU_APP_START], SIM_FILL, DFU_APP_END - DFU_APP_START);
+    memset(m_erases, 0, sizeof(m_erases));
+    memset(m_written, 0, sizeof(m_written));
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ****************************** HOST CHECKS ******************************* */
+/* ************************************************************************** */
+
+// Downloads an image the way dfu-util does. Returns false if the device 
+// reported an error, which is then left for the caller to check.
+static bool download(const uint8_t* p_image, uint32_t size, uint32_t* p_busy, uint32_t* p_repeat_busy)
+{
+    uint32_t sent = 0;
+    uint32_t poll_ms;
+    uint16_t length;
+    uint8_t  status, state;
+    bool     last_busy;
+
+    *p_busy = 0;
+    *p_repeat_busy = 0;
+    while(1)
+    {
+        length = size - sent < DFU_TRANSFER_SIZE ? (uint16_t)(size - sent) : DFU_TRANSFER_SIZE;
+        if(!dnload(p_image + sent, length)) return false;
+        sent += length;
+
+        last_busy = false;
+        while(1)
+        {
+            state = get_status(&status, &poll_ms);
+            if(status != DFU_STATUS_OK) return false;
+            if(state == DFU_STATE_DNBUSY || state == DFU_STATE_MANIFEST)
+            {
+                if(state == DFU_STATE_DNBUSY)
+                {
+                    (*p_busy)++;
+                    if(last_busy) (*p_repeat_busy)++;
+                    last_busy = true;
+                }
+                device_run(poll_ms ? poll_ms : 1);
+                continue;
+            }
+            if(length && state == DFU_STATE_DNLOAD_IDLE) break;
+            if(!length && state == DFU_STATE_IDLE) return true; // Manifested.
+            fail("state %u after a %u byte DNLOAD", state, length);
+            return false;
+        }
+    }
+}
+
+static void check_download(uint32_t size)
+{
+    uint8_t* p_image = malloc(size);
+    uint32_t start_ms, busy, repeat_busy, i;
+    uint32_t end = DFU_APP_START + size;
+    uint32_t padded = DFU_APP_START + (((size + _FLASH_WRITE_SIZE - 1) / _FLASH_WRITE_SIZE) * _FLASH_WRITE_SIZE);
+    uint32_t erased = DFU_APP_START + (((size + _FLASH_ERASE_SIZE - 1) / _FLASH_ERASE_SIZE) * _FLASH_ERASE_SIZE);
+
+    for(i = 0; i < size; i++) p_image[i] = (uint8_t)rand();
+    reset_flash();
+    start_ms = m_now_ms;
+    if(!download(p_image, size, &busy, &repeat_busy)) fail("%lu byte download failed", (unsigned long)size);
+
+    for(i = 0; i < DFU_APP_START; i++) if(m_flash[i] != SIM_BOOT){ fail("DFU firmware changed at 0x%05lX", (unsigned long)i); break; }
+    if(memcmp(&m_flash[DFU_APP_START], p_image, size)) fail("%lu byte image doesn't match", (unsigned long)size);
+    for(i = end; i < erased; i++)
+    {
+        if(m_flash[i] != 0xFF){ fail("0x%05lX after the image isn't 0xFF", (unsigned long)i); break; }
+    }
+    for(i = erased; i < DFU_APP_END; i++) if(m_flash[i] != SIM_FILL){ fail("0x%05lX past the image changed", (unsigned long)i); break; }
+    for(i = DFU_APP_START / _FLASH_ERASE_SIZE; i < erased / _FLASH_ERASE_SIZE; i++)
+    {
+        if(!m_erases[i] || !m_written[i]) fail("row 0x%05lX not programmed", (unsigned long)(i * _FLASH_ERASE_SIZE));
+    }
+    if(repeat_busy > 1) fail("%lu byte download: dfuDNBUSY twice in a row %lu times", (unsigned long)size, (unsigned long)repeat_busy);
+    printf("%6lu bytes: %5lu ms, %4lu dfuDNBUSY, %lu repeated, padded to 0x%05lX\n", (unsigned long)size,
+           (unsigned long)(m_now_ms - start_ms), (unsigned long)busy, (unsigned long)repeat_busy, (unsigned long)padded);
+    free(p_image);
+}
+
+static void check_upload(uint32_t size)
+{
+    static uint8_t image[DFU_APP_END];
+    uint32_t got = 0;
+    uint8_t  state;
+
+    while(1)
+    {
+        if(!request(DFU_UPLOAD, DFU_TRANSFER_SIZE) || m_ctrl_stage != DATA_IN_STAGE)
+        {
+            fail("UPLOAD not answered");
+            return;
+        }
+        memcpy(&image[got], m_ctrl_ptr, m_ctrl_in_bytes);
+        got += m_ctrl_in_bytes;
+        if(m_ctrl_in_bytes < DFU_TRANSFER_SIZE) break;
+    }
+    if(got != DFU_APP_END - DFU_APP_START) fail("UPLOAD gave %lu bytes", (unsigned long)got);
+    if(memcmp(image, &m_flash[DFU_APP_START], got)) fail("UPLOAD doesn't match flash");
+    if(memcmp(image, &m_flash[DFU_APP_START], size)) fail("UPLOAD doesn't match the image");
+    request(DFU_GETSTATE, 1);
+    state = m_ctrl_ptr[0];
+    if(state != DFU_STATE_IDLE) fail("state %u after the short UPLOAD block", state);
+    printf("UPLOAD: %lu bytes read back\n", (unsigned long)got);
+}
+
+static void check_errors(void)
+{
+    uint8_t  block[DFU_TRANSFER_SIZE];
+    uint8_t  status, state;
+    uint32_t poll_ms, busy, repeat_busy;
+    uint32_t size = DFU_APP_END - DFU_APP_START + DFU_TRANSFER_SIZE;
+    uint8_t* p_image = malloc(size);
+
+    // Too big, the block past DFU_APP_END is refused.
+    memset(p_image, 0x11, size);
+    reset_flash();
+    if(download(p_image, size, &busy, &repeat_busy)) fail("image past DFU_APP_END was taken");
+    state = get_status(&status, &poll_ms);
+    if(state != DFU_STATE_ERROR || status != DFU_STATUS_ERR_ADDRESS) fail("state %u status %u past DFU_APP_END", state, status);
+    if(request(DFU_DNLOAD, DFU_TRANSFER_SIZE)) fail("DNLOAD taken in dfuERROR");
+    if(!request(DFU_CLRSTATUS, 0)) fail("CLRSTATUS refused");
+    device_run(500); // Blocks queued before the error are still programmed.
+    state = get_status(&status, &poll_ms);
+    if(state != DFU_STATE_IDLE || status != DFU_STATUS_OK) fail("state %u status %u after CLRSTATUS", state, status);
+
+    // A zero length DNLOAD can't start a download.
+    if(request(DFU_DNLOAD, 0)) fail("zero length DNLOAD taken in dfuIDLE");
+    request(DFU_CLRSTATUS, 0);
+
+    // ABORT part way through, then a whole download.
+    memset(block, 0x22, sizeof(block));
+    reset_flash();
+    if(!dnload(block, sizeof(block))) fail("DNLOAD before ABORT refused");
+    get_status(&status, &poll_ms);
+    if(!request(DFU_ABORT, 0)) fail("ABORT refused in dfuDNLOAD-IDLE");
+    device_run(100);
+    if(memcmp(&m_flash[DFU_APP_START], block, sizeof(block))) fail("block before ABORT not programmed");
+    state = get_status(&status, &poll_ms);
+    if(state != DFU_STATE_IDLE) fail("state %u after ABORT", state);
+    free(p_image);
+    printf("Errors: errADDRESS, CLRSTATUS and ABORT checked\n");
+}
+
+/* ************************************************************************** */
+
+
+int main(void)
+{
+    static const uint32_t sizes[] = {1, DFU_TRANSFER_SIZE, (DFU_TRANSFER_SIZE * 3) + 100, 0x3000, DFU_APP_END - DFU_APP_START};
+    uint8_t i;
+
+    printf("%u byte blocks, %u byte erase rows, %u byte write rows, app 0x%05X-0x%05X\n", DFU_TRANSFER_SIZE,
+           _FLASH_ERASE_SIZE, _FLASH_WRITE_SIZE, DFU_APP_START, DFU_APP_END);
+    srand(1);
+    dfu_init();
+    for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) check_download(sizes[i]);
+    check_upload(sizes[i - 1]);
+    check_errors();
+    check_download(0x1000);
+
+    if(m_errors)
+    {
+        printf("%d errors\n", m_errors);
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
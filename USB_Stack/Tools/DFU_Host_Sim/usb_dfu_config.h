@@ -0,0 +1,39 @@
+/**
+ * @file usb_dfu_config.h
+ * @brief DFU settings for the DFU host simulation.
+ *
+ * The template's PIC18 values, which can be overridden with -D to try others.
+ */
+
+#ifndef USB_DFU_CONFIG_H
+#define USB_DFU_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* ***************************** DFU INTERFACE ****************************** */
+/* ************************************************************************** */
+
+#define DFU_INT 0
+
+#ifndef DFU_TRANSFER_SIZE
+#define DFU_TRANSFER_SIZE 256
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* FLASH SPACE ****************************** */
+/* ************************************************************************** */
+
+#define DFU_APP_START 0x2000
+#define DFU_APP_END   _ROMSIZE
+
+#define DFU_ERASE_MS 3
+#define DFU_WRITE_MS 3
+
+/* ************************************************************************** */
+
+#endif /* USB_DFU_CONFIG_H */
@@ -0,0 +1,40 @@
+/**
+ * @file xc.h
+ * @brief Stand-in for the XC8 device header so usb_dfu.c builds on a PC.
+ *
+ * The flash geometry is the PIC18F45K50's unless given with -D. The frame number and USB interrupt
+ * enable are plain variables defined in dfu_host_sim.c, absolute addresses 
+ * are ignored.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include <stdint.h>
+
+#define __at(address)
+#define _PIC18
+#define _18F45K50
+
+#define _ROMSIZE          0x8000
+#ifndef _FLASH_ERASE_SIZE
+#define _FLASH_ERASE_SIZE 64
+#endif
+#ifndef _FLASH_WRITE_SIZE
+#define _FLASH_WRITE_SIZE 64
+#endif
+
+typedef uint32_t uint24_t;
+
+typedef struct
+{
+    unsigned       :2;
+    unsigned USBIE :1;
+    unsigned       :5;
+}pie_bits_t;
+
+extern pie_bits_t       PIE3bits;
+extern volatile uint8_t UFRML;
+extern volatile uint8_t UFRMH;
+
+#endif /* XC_H */
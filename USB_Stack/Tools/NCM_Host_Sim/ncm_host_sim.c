@@ -0,0 +1,712 @@
+/**
+ * @file ncm_host_sim.c
+ * @brief Runs usb_cdc_ncm.c on a PC against a model of the Linux cdc_ncm host.
+ *
+ * The real usb_cdc_ncm.c is built with the usb_cdc_ncm_config.h template. The
+ * SIE is emulated by following the DATA EP's BDs through the NTB buffers, and
+ * the host side follows drivers/net/usb/cdc_ncm.c:
+ *  - Setup: GET_NTB_PARAMETERS, the sizes Linux derives from them (rx_max is
+ *    never below 2048, tx_max is dwNtbOutMaxSize), SET_NTB_INPUT_SIZE, alt 0
+ *    then alt 1, and the two notifications. max_datagram_size is clamped to
+ *    at least 1514, so the MTU stays 1500 whatever wMaxSegmentSize says.
+ *  - TX: NTBs built like cdc_ncm_fill_tx_frame(), a whole NDP of
+ *    wNtbOutMaxDatagrams entries reserved after the NTH, datagrams 4 byte
+ *    aligned, a zero byte to force a short packet, no ZLP. Frames that can't
+ *    fit next to the NDP are dropped (tx_dropped), the rest are sent even if
+ *    they're over wMaxSegmentSize.
+ *  - RX: a bulk IN transfer of rx_max bytes that ends on a short packet or
+ *    when full, checked like cdc_ncm_rx_verify_nth16()/ndp16() and
+ *    cdc_ncm_rx_fixup(), with each transfer holding exactly one NTB.
+ * The device application echoes every frame back, aggregating what it can,
+ * and drops those too big for an IN NTB. The host checks that every frame it 
+ * sent up to wMaxSegmentSize comes back unchanged.
+ *
+ * Build and run (from this folder):
+ *     gcc -std=gnu99 -Wall -I. -I../../USB -I../../USB/templates -o ncm_host_sim ncm_host_sim.c ../../USB/usb_cdc_ncm.c
+ *     ./ncm_host_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "usb.h"
+#include "usb_cdc_ncm.h"
+
+/* ************************************************************************** */
+/* ****************************** HOST DEFINES ****************************** */
+/* ************************************************************************** */
+
+// From drivers/net/usb/cdc_ncm.c and include/linux/usb/cdc_ncm.h.
+#define LINUX_NTB_MIN_IN_SIZE   2048  // USB_CDC_NCM_NTB_MIN_IN_SIZE
+#define LINUX_NTB_MAX_SIZE_RX   32768 // CDC_NCM_NTB_MAX_SIZE_RX
+#define LINUX_NTB_MAX_SIZE_TX   32768 // CDC_NCM_NTB_MAX_SIZE_TX
+#define LINUX_DPT_DATAGRAMS_MAX 40    // CDC_NCM_DPT_DATAGRAMS_MAX
+#define LINUX_MIN_TX_PKT        512   // CDC_NCM_MIN_TX_PKT
+#define LINUX_NDP16_LENGTH_MIN  0x10  // USB_CDC_NCM_NDP16_LENGTH_MIN
+#define LINUX_MIN_DATAGRAM_SIZE 1514  // CDC_NCM_MIN_DATAGRAM_SIZE
+#define LINUX_MAX_DATAGRAM_SIZE 8192  // CDC_NCM_MAX_DATAGRAM_SIZE
+#define ETH_DATA_LEN 1500
+#define ETH_HLEN 14
+
+#define MAX_FRAMES 2000
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** DEVICE SIDE STUBS ***************************** */
+/* ************************************************************************** */
+
+bd_t          g_usb_bd_table[NUM_BD];
+usb_ep_stat_t g_usb_ep_stat[NUM_ENDPOINTS][2];
+ch9_setup_t   g_usb_setup;
+usb_ustat_t   g_usb_last_USTAT;
+uep_bits_t    UEP1bits;
+uep_bits_t    UEP2bits;
+pie_bits_t    PIE3bits;
+
+static const uint8_t* m_ctrl_ptr;
+static uint16_t m_ctrl_in_bytes;
+static uint16_t m_ctrl_out_bytes;
+static uint8_t  m_ctrl_stage;
+static bool     m_ctrl_status;
+
+void usb_set_rom_ptr(const uint8_t* data){ m_ctrl_ptr = data; }
+void usb_set_ram_ptr(uint8_t* data){ m_ctrl_ptr = data; }
+void usb_in_control_transfer(void){}
+void usb_set_control_stage(uint8_t control_stage){ m_ctrl_stage = control_stage; }
+void usb_arm_in_status(void){ m_ctrl_status = true; }
+void usb_set_num_out_control_bytes(uint16_t bytes){ m_ctrl_out_bytes = bytes; }
+
+void usb_setup_in_control_transfer(uint8_t ram_rom, uint16_t bytes_available, uint16_t requested_length)
+{
+    m_ctrl_in_bytes = bytes_available < requested_length ? bytes_available : requested_length;
+}
+
+void usb_arm_endpoint(bd_t* p_bd, usb_ep_stat_t* p_ep_stat, uint8_t cnt)
+{
+    p_bd->CNT  = cnt;
+    p_bd->STAT = _UOWN | _DTSEN | (p_ep_stat->Data_Toggle_Val ? _DTS : 0);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ****************************** HOST STATE ******************************** */
+/* ************************************************************************** */
+
+typedef struct
+{
+    uint16_t len;
+    uint8_t  data[LINUX_MIN_DATAGRAM_SIZE];
+}frame_t;
+
+static frame_t  m_sent[MAX_FRAMES];
+static uint16_t m_num_sent;
+static uint16_t m_num_echoed;
+
+static uint32_t m_rx_max;             // Host's IN transfer size.
+static uint32_t m_tx_max;             // Largest NTB the host sends.
+static uint16_t m_tx_max_datagrams;
+static uint16_t m_max_ndp_size;
+static uint16_t m_min_tx_pkt;
+static uint16_t m_max_datagram_size;
+static uint16_t m_mtu;
+static uint16_t m_tx_seq;
+static uint16_t m_rx_seq;
+static bool     m_rx_seq_valid;
+
+static uint8_t  m_urb[LINUX_NTB_MAX_SIZE_RX]; // IN transfer being filled.
+static uint32_t m_urb_len;
+static uint8_t  m_toggle[NUM_ENDPOINTS][2];
+static bool     m_link_up;
+static uint32_t m_link_speed;
+
+static uint16_t m_ntbs_out;
+static uint16_t m_ntbs_in;
+static uint16_t m_in_datagrams_max;
+static uint16_t m_out_exact;          // OUT NTBs that ended on a full packet at tx_max.
+static uint16_t m_in_zlps;
+static uint16_t m_tx_dropped;         // Frames the host couldn't fit in an NTB.
+static uint16_t m_oversize_out;       // Frames sent over wMaxSegmentSize.
+static uint16_t m_device_dropped;     // Frames the device couldn't send back.
+static int      m_errors;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* HELPERS ********************************** */
+/* ************************************************************************** */
+
+static void fail(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    printf("FAIL: ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    m_errors++;
+}
+
+static uint16_t get16(const uint8_t* p){ return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get32(const uint8_t* p){ return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+static void put16(uint8_t* p, uint16_t v){ p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t* p, uint32_t v){ put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+
+static uint32_t align(uint32_t value, uint32_t modulus){ return (value + modulus - 1) & ~(modulus - 1); }
+
+static void transaction(uint8_t ep, uint8_t dir)
+{
+    g_usb_last_USTAT.ENDP = ep;
+    g_usb_last_USTAT.DIR  = dir;
+    ncm_tasks();
+}
+
+static bool check_toggle(uint8_t bd, uint8_t ep, uint8_t dir)
+{
+    uint8_t data1 = (g_usb_bd_table[bd].STAT & _DTS) ? 1 : 0;
+
+    if(data1 != m_toggle[ep][dir])
+    {
+        fail("EP%u %s armed with DATA%u, host expects DATA%u", ep, dir == IN ? "IN" : "OUT", data1, m_toggle[ep][dir]);
+        return false;
+    }
+    m_toggle[ep][dir] ^= 1;
+    return true;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** CONTROL TRANSFERS **************************** */
+/* ************************************************************************** */
+
+static void setup(uint8_t request, uint16_t value, uint16_t length)
+{
+    memset(&g_usb_setup, 0, sizeof(g_usb_setup));
+    g_usb_setup.bmRequestType = 0x21;
+    g_usb_setup.bRequest      = request;
+    g_usb_setup.wValue        = value;
+    g_usb_setup.wIndex        = NCM_COM_INT;
+    g_usb_setup.wLength       = length;
+    m_ctrl_ptr = NULL;
+    m_ctrl_in_bytes  = 0;
+    m_ctrl_out_bytes = 0;
+    m_ctrl_stage  = 0;
+    m_ctrl_status = false;
+}
+
+static int control_in(uint8_t request, uint8_t* data, uint16_t length)
+{
+    setup(request, 0, length);
+    g_usb_setup.bmRequestType = 0xA1;
+    if(!ncm_class_request() || m_ctrl_stage != DATA_IN_STAGE) return -1; // STALL
+    memcpy(data, m_ctrl_ptr, m_ctrl_in_bytes);
+    return m_ctrl_in_bytes;
+}
+
+static bool control_out(uint8_t request, const uint8_t* data, uint16_t length)
+{
+    setup(request, 0, length);
+    if(!ncm_class_request() || m_ctrl_stage != DATA_OUT_STAGE || m_ctrl_out_bytes != length) return false;
+    memcpy((uint8_t*)m_ctrl_ptr, data, length);
+    return ncm_out_control_tasks();
+}
+
+static bool set_interface(uint8_t alternate_setting)
+{
+    m_toggle[NCM_DAT_EP][OUT] = 0;
+    m_toggle[NCM_DAT_EP][IN]  = 0;
+    m_urb_len = 0;
+    m_rx_seq_valid = false;
+    return ncm_set_interface(alternate_setting, NCM_DAT_INT);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* HOST RX ********************************** */
+/* ************************************************************************** */
+
+static void rx_frame(const uint8_t* data, uint16_t len)
+{
+    if(m_num_echoed >= m_num_sent) fail("frame %u was never sent", m_num_echoed);
+    else if(m_sent[m_num_echoed].len != len || memcmp(m_sent[m_num_echoed].data, data, len))
+        fail("frame %u came back as %u bytes instead of %u, or changed", m_num_echoed, len, m_sent[m_num_echoed].len);
+    m_num_echoed++;
+}
+
+// cdc_ncm_rx_verify_nth16(), cdc_ncm_rx_verify_ndp16() and cdc_ncm_rx_fixup().
+static void rx_ntb(const uint8_t* ntb, uint32_t len)
+{
+    uint16_t block_length, ndp_index, ndp_length, sequence, index, length;
+    uint16_t datagrams, i, loops = 0;
+
+    m_ntbs_in++;
+    if(len < NTH16_SIZE + NDP16_HEADER_SIZE){ fail("IN NTB of %u bytes is too short", len); return; }
+    if(get32(ntb) != NTH16_SIGNATURE){ fail("IN NTB has no NTH16 signature"); return; }
+    if(get16(ntb + 4) != NTH16_SIZE) fail("IN NTB wHeaderLength %u", get16(ntb + 4));
+    block_length = get16(ntb + 8);
+    if(block_length > m_rx_max){ fail("IN NTB wBlockLength %u is over rx_max %u", block_length, m_rx_max); return; }
+    if(block_length != len) fail("IN transfer of %u bytes holds an NTB of %u (NTBs merged, missing ZLP?)", len, block_length);
+
+    sequence = get16(ntb + 6);
+    if(m_rx_seq_valid && sequence != (uint16_t)(m_rx_seq + 1)) fail("IN NTB wSequence %u after %u", sequence, m_rx_seq);
+    m_rx_seq = sequence;
+    m_rx_seq_valid = true;
+
+    ndp_index = get16(ntb + 10);
+    while(ndp_index)
+    {
+        if(loops++ == 10){ fail("IN NTB NDP chain loops"); return; }
+        if(ndp_index & (NCM_NDP_ALIGNMENT - 1)) fail("IN NDP at %u breaks wNdpInAlignment", ndp_index);
+        if((uint32_t)ndp_index + NDP16_HEADER_SIZE > len){ fail("IN NDP at %u is past the NTB", ndp_index); return; }
+        if(get32(ntb + ndp_index) != NDP16_SIGNATURE){ fail("IN NDP has no NCM0 signature"); return; }
+        ndp_length = get16(ntb + ndp_index + 4);
+        if(ndp_length < LINUX_NDP16_LENGTH_MIN){ fail("IN NDP wLength %u is too short", ndp_length); return; }
+        if((uint32_t)ndp_index + ndp_length > len){ fail("IN NDP wLength %u runs past the NTB", ndp_length); return; }
+
+        datagrams = ((ndp_length - NDP16_HEADER_SIZE) / 4) - 1; // The last entry is always the null one.
+        for(i = 0; i < datagrams; i++)
+        {
+            index  = get16(ntb + ndp_index + NDP16_HEADER_SIZE + (i * 4));
+            length = get16(ntb + ndp_index + NDP16_HEADER_SIZE + (i * 4) + 2);
+            if(index == 0 || length == 0)
+            {
+                if(i == 0) fail("IN NTB is empty");
+                break;
+            }
+            if((uint32_t)index + length > len || length > m_rx_max || length < ETH_HLEN)
+            {
+                fail("IN datagram %u (%u bytes at %u) is invalid", i, length, index);
+                continue;
+            }
+            if(index < ndp_index + ndp_length && index + length > ndp_index) fail("IN datagram %u overlaps its NDP", i);
+            rx_frame(ntb + index, length);
+        }
+        if(i > m_in_datagrams_max) m_in_datagrams_max = i;
+        ndp_index = get16(ntb + ndp_index + 6);
+    }
+}
+
+// One poll of the bulk IN pipe, Linux always has an IN transfer queued.
+static bool host_in_poll(void)
+{
+    bd_t*    p_bd = &g_usb_bd_table[NCM_DAT_BD_IN];
+    uint16_t offset;
+    uint8_t  cnt;
+
+    if(!(p_bd->STAT & _UOWN)) return false; // NAK
+
+    offset = p_bd->ADR - NCM_NTB_IN_BUFFER_BASE_ADDR;
+    cnt    = p_bd->CNT;
+    check_toggle(NCM_DAT_BD_IN, NCM_DAT_EP, IN);
+    if(cnt > NCM_DAT_EP_SIZE || offset + cnt > NCM_NTB_IN_MAX_SIZE) fail("IN BD (%u bytes at %u) is outside the NTB buffer", cnt, offset);
+    else if(m_urb_len + cnt > m_rx_max) fail("IN transfer overflows rx_max %u (babble)", m_rx_max);
+    else
+    {
+        memcpy(&m_urb[m_urb_len], &g_ncm_ntb_in[offset], cnt);
+        m_urb_len += cnt;
+    }
+    p_bd->STAT = 0;
+    transaction(NCM_DAT_EP, IN);
+
+    if(cnt < NCM_DAT_EP_SIZE || m_urb_len == m_rx_max)
+    {
+        if(cnt == 0) m_in_zlps++;
+        if(m_urb_len) rx_ntb(m_urb, m_urb_len);
+        else if(cnt == 0) fail("ZLP without an NTB in front of it");
+        m_urb_len = 0;
+    }
+    return true;
+}
+
+static bool host_notification_poll(void)
+{
+    bd_t*    p_bd = &g_usb_bd_table[NCM_COM_BD_IN];
+    uint8_t* p    = g_ncm_com_ep_in;
+
+    if(!(p_bd->STAT & _UOWN)) return false;
+    check_toggle(NCM_COM_BD_IN, NCM_COM_EP, IN);
+    if(p[0] != 0xA1 || get16(p + 4) != NCM_COM_INT) fail("notification header %02X, interface %u", p[0], get16(p + 4));
+    if(p[1] == NCM_CONNECTION_SPEED_CHANGE)
+    {
+        if(p_bd->CNT != 16 || get16(p + 6) != 8) fail("CONNECTION_SPEED_CHANGE is %u bytes", p_bd->CNT);
+        m_link_speed = get32(p + 8);
+    }
+    else if(p[1] == NCM_NETWORK_CONNECTION)
+    {
+        if(p_bd->CNT != 8 || get16(p + 6) != 0) fail("NETWORK_CONNECTION is %u bytes", p_bd->CNT);
+        m_link_up = get16(p + 2) != 0;
+    }
+    else fail("unknown notification %02X", p[1]);
+    p_bd->STAT = 0;
+    transaction(NCM_COM_EP, IN);
+    return true;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** DEVICE MAIN LOOP **************************** */
+/* ************************************************************************** */
+
+// What an application's main loop does: hand every frame back, aggregating
+// them while the IN NTB has room, then let ncm_flush_tasks() send it.
+static void device_main(void)
+{
+    uint8_t* frame;
+    uint16_t len;
+    int      tries;
+
+    while(ncm_receive_frame(&frame, &len))
+    {
+        if(len > NCM_IN_MAX_DATAGRAM_SIZE) // Would never fit an IN NTB.
+        {
+            m_device_dropped++;
+            continue;
+        }
+        tries = 0;
+        while(!ncm_send_frame(frame, len))
+        {
+            ncm_flush_tasks();
+            host_in_poll();
+            if(++tries == 1000)
+            {
+                fail("device couldn't send a frame of %u bytes", len);
+                break;
+            }
+        }
+    }
+    ncm_flush_tasks();
+}
+
+// Runs the bus and the device until nothing moves.
+static void run_idle(void)
+{
+    int i;
+
+    for(i = 0; i < 1000; i++)
+    {
+        device_main();
+        if(!host_in_poll() && !host_notification_poll() && !(g_usb_bd_table[NCM_DAT_BD_IN].STAT & _UOWN)) break;
+    }
+    if(m_urb_len) fail("IN transfer left open with %u bytes (missing ZLP?)", m_urb_len);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* HOST TX ********************************** */
+/* ************************************************************************** */
+
+// usbnet bulk OUT, one transfer split into packets, the device NAKs while busy.
+static void host_bulk_out(const uint8_t* data, uint32_t len)
+{
+    bd_t*    p_bd = &g_usb_bd_table[NCM_DAT_BD_OUT];
+    uint32_t sent = 0;
+    uint16_t offset;
+    uint8_t  cnt;
+    int      naks = 0;
+
+    while(sent < len)
+    {
+        if(!(p_bd->STAT & _UOWN))
+        {
+            if(++naks == 1000){ fail("OUT NAKed for good"); return; }
+            device_main();
+            host_in_poll();
+            continue;
+        }
+        cnt = (len - sent) < NCM_DAT_EP_SIZE ? (uint8_t)(len - sent) : NCM_DAT_EP_SIZE;
+        offset = p_bd->ADR - NCM_NTB_OUT_BUFFER_BASE_ADDR;
+        check_toggle(NCM_DAT_BD_OUT, NCM_DAT_EP, OUT);
+        if(cnt > p_bd->CNT){ fail("OUT packet of %u bytes into a BD armed for %u", cnt, p_bd->CNT); return; }
+        if(offset + p_bd->CNT > NCM_NTB_OUT_MAX_SIZE){ fail("OUT BD at %u runs past the NTB buffer", offset); return; }
+        memcpy(&g_ncm_ntb_out[offset], &data[sent], cnt);
+        sent += cnt;
+        p_bd->CNT  = cnt;
+        p_bd->STAT = 0;
+        transaction(NCM_DAT_EP, OUT);
+    }
+    if((len & (NCM_DAT_EP_SIZE - 1)) == 0)
+    {
+        if(len != m_tx_max) fail("host NTB of %u bytes would need a ZLP", len);
+        else m_out_exact++;
+    }
+}
+
+// The end of cdc_ncm_fill_tx_frame(): pad, or force a short packet, and send.
+static void host_send_ntb(uint8_t* ntb, uint32_t len)
+{
+    if(len > m_min_tx_pkt)
+    {
+        memset(&ntb[len], 0, m_tx_max - len);
+        len = m_tx_max;
+    }
+    else if(len < m_tx_max && (len % NCM_DAT_EP_SIZE) == 0) ntb[len++] = 0;
+    put16(ntb + 8, (uint16_t)len);
+    host_bulk_out(ntb, len);
+    m_ntbs_out++;
+}
+
+// cdc_ncm_fill_tx_frame(), called with the frames queued when the TX timer runs out.
+static void host_tx(const uint16_t* lengths, uint16_t count)
+{
+    static uint8_t ntb[LINUX_NTB_MAX_SIZE_TX];
+    uint32_t len = 0, ndp = 0;
+    uint16_t n = 0, i, j, ndp_length, index;
+    frame_t* p_frame;
+    bool     dropped;
+
+    for(i = 0; i < count; i++)
+    {
+        p_frame = &m_sent[m_num_sent];
+        p_frame->len = lengths[i];
+        for(j = 0; j < p_frame->len; j++) p_frame->data[j] = (uint8_t)rand();
+
+        dropped = false;
+        while(1)
+        {
+            if(len == 0) // New NTB.
+            {
+                memset(ntb, 0, sizeof(ntb));
+                put32(ntb, NTH16_SIGNATURE);
+                put16(ntb + 4, NTH16_SIZE);
+                put16(ntb + 6, m_tx_seq++);
+                len = NTH16_SIZE;
+                ndp = 0;
+                n   = 0;
+            }
+            if(ndp == 0) // cdc_ncm_ndp16(), reserves an NDP for tx_max_datagrams.
+            {
+                len = align(len, NCM_NDP_ALIGNMENT);
+                if(len + p_frame->len + NCM_NDP_ALIGNMENT + m_max_ndp_size > m_tx_max)
+                {
+                    dropped = true; // No room next to the NDP.
+                    break;
+                }
+                ndp = len;
+                put16(ntb + 10, (uint16_t)ndp);
+                put32(ntb + ndp, NDP16_SIGNATURE);
+                put16(ntb + ndp + 4, NDP16_HEADER_SIZE + 4);
+                len += m_max_ndp_size;
+            }
+            len = align(len, NCM_NDP_ALIGNMENT); // cdc_ncm_align_tail()
+            if(len + p_frame->len <= m_tx_max) break;
+            if(n == 0)
+            {
+                dropped = true; // "won't fit, MTU problem?"
+                break;
+            }
+            host_send_ntb(ntb, len); // This frame goes in the next NTB.
+            len = 0;
+        }
+        if(dropped)
+        {
+            if(p_frame->len <= NCM_MAX_SEGMENT_SIZE) fail("%u byte frame dropped by the host", p_frame->len);
+            m_tx_dropped++;
+            if(len == NTH16_SIZE) len = 0; // Nothing in it yet.
+            continue;
+        }
+
+        ndp_length = get16(ntb + ndp + 4);
+        index = ((ndp_length - NDP16_HEADER_SIZE) / 4) - 1;
+        put16(ntb + ndp + NDP16_HEADER_SIZE + (index * 4), (uint16_t)len);
+        put16(ntb + ndp + NDP16_HEADER_SIZE + (index * 4) + 2, p_frame->len);
+        put16(ntb + ndp + 4, ndp_length + 4);
+        memcpy(&ntb[len], p_frame->data, p_frame->len);
+        len += p_frame->len;
+        if(p_frame->len <= NCM_MAX_SEGMENT_SIZE) m_num_sent++; // Expected back.
+        else m_oversize_out++;
+        if(++n == m_tx_max_datagrams)
+        {
+            host_send_ntb(ntb, len);
+            len = 0;
+        }
+    }
+    if(len) host_send_ntb(ntb, len); // The timer ran out.
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TESTS ********************************** */
+/* ************************************************************************** */
+
+// cdc_ncm_bind_common(), cdc_ncm_setup() and cdc_ncm_update_rxtx_max().
+static void test_bind(void)
+{
+    uint8_t  p[28];
+    uint32_t in_max, out_max, rx;
+    uint8_t  size[4];
+
+    ncm_init();
+    if(control_in(GET_NTB_PARAMETERS, p, sizeof(p)) != sizeof(p)){ fail("GET_NTB_PARAMETERS"); return; }
+    if(get16(p) != 28 || !(get16(p + 2) & 1)) fail("NTB parameters wLength %u, formats %04X", get16(p), get16(p + 2));
+    in_max  = get32(p + 4);
+    out_max = get32(p + 16);
+    if(get16(p + 8) < 4 || get16(p + 12) < 4 || get16(p + 20) < 4 || get16(p + 24) < 4) fail("NTB divisor or alignment too small");
+
+    // cdc_ncm_check_rx_max(), Linux never asks for less than 2048.
+    rx = in_max < LINUX_NTB_MAX_SIZE_RX ? in_max : LINUX_NTB_MAX_SIZE_RX;
+    if(rx < LINUX_NTB_MIN_IN_SIZE) rx = LINUX_NTB_MIN_IN_SIZE;
+    m_rx_max = rx;
+    if(m_rx_max != in_max)
+    {
+        put32(size, m_rx_max);
+        if(!control_out(SET_NTB_INPUT_SIZE, size, 4)) fail("SET_NTB_INPUT_SIZE %u stalled", m_rx_max);
+    }
+    if(control_in(GET_NTB_INPUT_SIZE, size, 4) != 4 || get32(size) != m_rx_max) fail("GET_NTB_INPUT_SIZE is %u, not %u", get32(size), m_rx_max);
+
+    // cdc_ncm_check_tx_max() and the NDP every NTB reserves.
+    m_tx_max = out_max < LINUX_NTB_MAX_SIZE_TX ? out_max : LINUX_NTB_MAX_SIZE_TX;
+    m_tx_max_datagrams = get16(p + 26);
+    if(m_tx_max_datagrams == 0 || m_tx_max_datagrams > LINUX_DPT_DATAGRAMS_MAX) m_tx_max_datagrams = LINUX_DPT_DATAGRAMS_MAX;
+    m_max_ndp_size = NDP16_HEADER_SIZE + ((m_tx_max_datagrams + 1) * 4);
+    m_min_tx_pkt = (m_tx_max > 3 * NCM_DAT_EP_SIZE) ? (uint16_t)(m_tx_max - (3 * NCM_DAT_EP_SIZE)) : 0;
+    if(m_min_tx_pkt < LINUX_MIN_TX_PKT) m_min_tx_pkt = LINUX_MIN_TX_PKT;
+    if(m_min_tx_pkt > m_tx_max) m_min_tx_pkt = (uint16_t)m_tx_max;
+
+    // cdc_ncm_set_dgram_size(), without NCM_CAP_MAX_DATAGRAM the device isn't asked.
+    m_max_datagram_size = NCM_MAX_SEGMENT_SIZE;
+    if(m_max_datagram_size < LINUX_MIN_DATAGRAM_SIZE) m_max_datagram_size = LINUX_MIN_DATAGRAM_SIZE;
+    if(m_max_datagram_size > LINUX_MAX_DATAGRAM_SIZE) m_max_datagram_size = LINUX_MAX_DATAGRAM_SIZE;
+    m_mtu = m_max_datagram_size - ETH_HLEN < ETH_DATA_LEN ? m_max_datagram_size - ETH_HLEN : ETH_DATA_LEN;
+
+    printf("dwNtbInMaxSize %u (rx_max %u), dwNtbOutMaxSize %u (tx_max %u), NDP %u bytes, wMaxSegmentSize %u\n",
+           in_max, m_rx_max, out_max, m_tx_max, m_max_ndp_size, NCM_MAX_SEGMENT_SIZE);
+    printf("max_datagram_size %u, MTU %u (needs setting to %u on the host)\n", m_max_datagram_size, m_mtu, NCM_MAX_SEGMENT_SIZE - ETH_HLEN);
+    if(NTH16_SIZE + m_max_ndp_size + (uint32_t)NCM_MAX_SEGMENT_SIZE > m_tx_max)
+        fail("a %u byte frame doesn't fit an OUT NTB next to Linux's %u byte NDP", NCM_MAX_SEGMENT_SIZE, m_max_ndp_size);
+
+    if(!set_interface(0) || !set_interface(1)) fail("SET_INTERFACE");
+
+    // usbnet_cdc_update_filter(), directed, broadcast and all multicast.
+    setup(SET_ETHERNET_PACKET_FILTER, 0x000E, 0);
+    if(!ncm_class_request() || !m_ctrl_status || g_ncm_packet_filter != 0x000E) fail("SET_ETHERNET_PACKET_FILTER");
+
+    ncm_set_connection(true);
+    run_idle();
+    if(!m_link_up || m_link_speed != NCM_LINK_SPEED) fail("link is %s at %u b/s", m_link_up ? "up" : "down", m_link_speed);
+}
+
+static void test_echo(const char* name, const uint16_t* lengths, uint16_t count)
+{
+    uint16_t echoed = m_num_echoed;
+
+    host_tx(lengths, count);
+    run_idle();
+    if(m_num_echoed != m_num_sent) fail("%s: %u of %u frames came back", name, m_num_echoed - echoed, count);
+    else printf("%-40s %3u frames ok\n", name, count);
+    m_num_echoed = m_num_sent; // Don't carry a loss into the next test.
+}
+
+// Linux's MTU of 1500 lets through frames over wMaxSegmentSize. The host drops
+// the ones that don't fit an OUT NTB, the device drops the rest, and the
+// frames in between must still come back.
+static void test_linux_mtu(void)
+{
+    static uint16_t lengths[200];
+    uint16_t i, host_dropped = m_tx_dropped, device_dropped = m_device_dropped, oversize = m_oversize_out;
+
+    for(i = 0; i < 200; i++) lengths[i] = (i & 1) ? 60 : ETH_HLEN + (rand() % (m_mtu + 1));
+    test_echo("frames up to the Linux MTU", lengths, 200);
+    host_dropped   = m_tx_dropped - host_dropped;
+    device_dropped = m_device_dropped - device_dropped;
+    oversize       = m_oversize_out - oversize;
+    if(device_dropped != oversize) fail("%u frames over wMaxSegmentSize sent, the device dropped %u", oversize, device_dropped);
+    if(host_dropped == 0 || oversize == 0) fail("frames over wMaxSegmentSize weren't dropped at both ends");
+    printf("%-40s %3u dropped by the host, %u by the device\n", "", host_dropped, device_dropped);
+}
+
+// A host that sets a smaller NTB input size than a frame needs (Linux won't).
+static void test_small_input_size(void)
+{
+    static uint8_t frame[NCM_MAX_SEGMENT_SIZE];
+    uint8_t  size[4];
+    uint16_t ntbs = m_ntbs_in;
+
+    put32(size, 256);
+    if(!control_out(SET_NTB_INPUT_SIZE, size, 4)){ fail("SET_NTB_INPUT_SIZE 256 stalled"); return; }
+    put32(size, 16);
+    if(control_out(SET_NTB_INPUT_SIZE, size, 4)) fail("SET_NTB_INPUT_SIZE 16 accepted");
+    m_rx_max = 256;
+    if(!set_interface(0) || !set_interface(1)) fail("SET_INTERFACE");
+    run_idle();
+
+    memset(frame, 0x55, sizeof(frame));
+    if(ncm_send_frame(frame, 300)) fail("first frame of 300 bytes accepted into a 256 byte NTB");
+    run_idle();
+    if(m_ntbs_in != ntbs) fail("an NTB was sent for a frame that doesn't fit");
+
+    m_sent[m_num_sent].len = 200;
+    memset(m_sent[m_num_sent++].data, 0x55, 200);
+    if(!ncm_send_frame(frame, 200)) fail("200 byte frame refused");
+    run_idle();
+    if(m_num_echoed != m_num_sent) fail("200 byte frame not received");
+    else printf("%-40s ok\n", "256 byte NTB input size");
+    m_num_echoed = m_num_sent;
+}
+
+/* ************************************************************************** */
+
+
+int main(void)
+{
+    static uint16_t lengths[MAX_FRAMES];
+    const uint16_t max = NCM_MAX_SEGMENT_SIZE;
+    const uint16_t fill_in = NCM_NTB_IN_MAX_SIZE - NTH16_SIZE - NDP16_SIZE(NCM_NTB_IN_MAX_DATAGRAMS);
+    uint16_t i, n;
+
+    srand(1);
+    test_bind();
+
+    lengths[0] = 60;
+    test_echo("one small frame", lengths, 1);
+
+    lengths[0] = max;
+    test_echo("one max size frame", lengths, 1);
+
+    lengths[0] = fill_in; // IN NTB of exactly NCM_NTB_IN_MAX_SIZE, below rx_max so it needs a ZLP.
+    test_echo("IN NTB ending on a full packet", lengths, 1);
+
+    lengths[0] = 128 - NTH16_SIZE - NDP16_SIZE(NCM_NTB_IN_MAX_DATAGRAMS);
+    test_echo("IN NTB of two full packets", lengths, 1);
+
+    lengths[0] = 64 - NTH16_SIZE - (NDP16_HEADER_SIZE + ((m_tx_max_datagrams + 1) * 4)); // Host pads a byte.
+    if((int16_t)lengths[0] >= ETH_HLEN) test_echo("OUT NTB ending on a full packet", lengths, 1);
+
+    n = 0; // Two frames that end an OUT NTB exactly at tx_max.
+    lengths[n] = 200;
+    lengths[n + 1] = (uint16_t)(m_tx_max - align(NTH16_SIZE + m_max_ndp_size + 200, NCM_NDP_ALIGNMENT));
+    if(lengths[n + 1] >= ETH_HLEN && lengths[n + 1] <= max) test_echo("OUT NTB of exactly dwNtbOutMaxSize", lengths, 2);
+
+    for(i = 0; i < 40; i++) lengths[i] = 60 + (i & 3);
+    test_echo("40 small frames, aggregated", lengths, 40);
+
+    for(i = 0; i < 300; i++) lengths[i] = ETH_HLEN + (rand() % (max - ETH_HLEN + 1));
+    test_echo("300 random frames", lengths, 300);
+
+    for(i = ETH_HLEN, n = 0; i <= max; i++) lengths[n++] = i;
+    test_echo("every frame length", lengths, n);
+
+    test_linux_mtu();
+
+    test_small_input_size();
+
+    printf("\nOUT NTBs %u (%u ended exactly at tx_max), IN NTBs %u (%u ended with a ZLP), most IN datagrams %u\n",
+           m_ntbs_out, m_out_exact, m_ntbs_in, m_in_zlps, m_in_datagrams_max);
+    if(m_out_exact == 0 || m_in_zlps == 0) fail("the full packet cases weren't reached");
+    printf(m_errors ? "%d FAILED\n" : "PASSED\n", m_errors);
+    return m_errors ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file xc.h
+ * @brief Stand-in for the XC8 device header so usb_cdc_ncm.c builds on a PC.
+ *
+ * Only what usb_hal.h and usb_cdc_ncm.c touch is declared. The SFRs are plain
+ * variables defined in ncm_host_sim.c, absolute addresses are ignored.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include <stdint.h>
+
+#define __at(address)
+#define _PIC18
+#define _18F45K50
+
+typedef struct
+{
+    unsigned EPSTALL  :1;
+    unsigned EPINEN   :1;
+    unsigned EPOUTEN  :1;
+    unsigned EPCONDIS :1;
+    unsigned EPHSHK   :1;
+    unsigned          :3;
+}uep_bits_t;
+
+typedef struct
+{
+    unsigned       :2;
+    unsigned USBIE :1;
+    unsigned       :5;
+}pie_bits_t;
+
+extern uep_bits_t  UEP1bits;
+extern uep_bits_t  UEP2bits;
+extern pie_bits_t  PIE3bits;
+
+#endif /* XC_H */
@@ -0,0 +1,492 @@
+#!/usr/bin/env python3
+"""
+Generates an example's usb_hid_reports.h and usb_hid_reports.c from a report
+spec, so the report descriptor, report structs and report tables can't drift
+apart.
+
+The spec is a list of HID items, one per line, '#' starts a comment:
+
+    usage_page <page>               Sets the Usage Page for the next items.
+    usage <usage>                   Local Usage, used by the next collection.
+    collection <type>               APPLICATION, PHYSICAL, LOGICAL...
+    end                             End_Collection.
+    report_id <id>                  Following fields belong to this report.
+    interface                       Following items are the next interface's
+                                    report descriptor.
+    <input|output|feature> <name> [key=value...]
+
+A field's keys are:
+
+    usage_page=<page>               Global, kept for later fields.
+    usage=<u1>,<u2>...              Usages, one per element.
+    usage=<min>..<max>              Usage range.
+    logical=<min>..<max>            Global, kept for later fields.
+    physical=<min>..<max>           Global, kept for later fields.
+    size=<bits>                     Report Size, global, kept for later fields.
+    count=<n>                       Report Count (default 1).
+    flags=<A|B|C>                   Main item flags (default DATA|VARIABLE|ABSOLUTE).
+    bits=<n1>,<n2>...               Names for each element of a bit field.
+
+A name of "-" is padding. Names are C identifiers, page and usage names are
+the defines in USB/usb_hid_pages.h (numbers work too). Global items are only
+written when they change, and each item gets the smallest encoding that holds
+its value.
+
+Reports are numbered by Report ID (or 1 without IDs), so g_hid_in_reports[],
+g_hid_out_reports[] and g_hid_feature_reports[] can be indexed with
+Report_ID - 1 by usb_hid.c. IDs a type doesn't use are left as size 0 entries.
+
+Each interface after the first gets its own report descriptor
+(g_hid1_report_descriptor...), Report IDs starting again from 1 and counts
+(HID1_NUM_IN_REPORTS...) for usb_hid.h. Its reports follow the previous
+interface's in the report tables, so report numbers run on across interfaces.
+HID_NUM_INTERFACES in usb_hid_config.h must match the spec.
+
+Usage:
+    python3 gen_hid_reports.py <spec file> <output dir>
+
+Example:
+    python3 gen_hid_reports.py ../Examples/HID_Examples/HID_Keyboard_Examples/Shared_Files/usb_hid_reports.spec ../Examples/HID_Examples/HID_Keyboard_Examples/Shared_Files
+"""
+
+import os
+import re
+import sys
+
+PAGES_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "USB", "usb_hid_pages.h")
+
+MAIN_TYPES = {"input": "in", "output": "out", "feature": "feature"}
+MAIN_MACROS = {"input": "Input", "output": "Output", "feature": "Feature"}
+FLAG_VALUES = {"DATA": 0x00, "CONSTANT": 0x01, "ARRAY": 0x00, "VARIABLE": 0x02,
+               "ABSOLUTE": 0x00, "RELATIVE": 0x04, "NO_WRAP": 0x00, "WRAP": 0x08,
+               "LINEAR": 0x00, "NONLINEAR": 0x10, "PREFERRED_STATE": 0x00,
+               "NO_PREFERRED": 0x20, "NO_NULL_POSITION": 0x00, "NULL_STATE": 0x40,
+               "BIT_FIELD": 0x00, "BUFFERED_BYTES": 0x80}
+COLLECTION_TYPES = {"PHYSICAL": 0x00, "APPLICATION": 0x01, "LOGICAL": 0x02, "REPORT": 0x03,
+                    "NAMED_ARRAY": 0x04, "USAGE_SWITCH": 0x05, "USAGE_MOD": 0x06}
+IDENTIFIER = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+LICENSE = """/**
+ * @file {name}
+ * @brief {brief}
+ * @author John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_hid_reports.py from {spec},
+ * do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+"""
+
+
+class SpecError(Exception):
+    pass
+
+
+def load_page_values():
+    """Returns {name: value} for the defines in usb_hid_pages.h."""
+    values = {}
+    with open(PAGES_PATH, encoding="utf-8") as f:
+        for line in f:
+            m = re.match(r"\s*#define\s+(\w+)\s+(0[xX][0-9A-Fa-f]+|\d+)", line)
+            if m:
+                values[m.group(1)] = int(m.group(2), 0)
+    return values
+
+
+class Field:
+    def __init__(self, kind, name, size, count, flags, signed, bits):
+        self.kind = kind      # "in", "out" or "feature"
+        self.name = name      # None for padding
+        self.size = size
+        self.count = count
+        self.flags = flags
+        self.signed = signed
+        self.bits = bits      # Element names of a bit field, or None
+
+
+class Compiler:
+    def __init__(self, page_values):
+        self.values = page_values
+        self.items = []       # (indent, macro text, byte count)
+        self.indent = 0
+        self.globals = {}     # Last written value of each global item
+        self.report_id = 0
+        self.reports = {}     # (kind, id) -> [Field]
+        self.logical = None
+        self.size = None
+
+    def value(self, text, line_num):
+        if text in self.values:
+            return self.values[text]
+        try:
+            return int(text, 0)
+        except ValueError:
+            raise SpecError(f"line {line_num}: unknown name '{text}'")
+
+    def emit(self, macro, arg, size_bytes):
+        self.items.append((self.indent, f"{macro}({arg})" if arg is not None else f"{macro}()", size_bytes))
+
+    def emit_unsigned(self, macro, text, line_num):
+        v = self.value(text, line_num)
+        if v < 0 or v > 0xFFFFFFFF:
+            raise SpecError(f"line {line_num}: {text} out of range")
+        if v <= 0xFF:
+            self.emit(macro, text, 2)
+        elif v <= 0xFFFF:
+            self.emit(macro + "2", text, 3)
+        else:
+            self.emit(macro + "4", text, 5)
+
+    def emit_signed(self, macro, v):
+        if -128 <= v <= 127:
+            self.emit(macro, str(v), 2)
+        elif -32768 <= v <= 32767:
+            self.emit(macro + "2", str(v), 3)
+        else:
+            self.emit(macro + "4", str(v), 5)
+
+    def set_global(self, key, macro, v, signed=True, text=None, line_num=0):
+        if self.globals.get(key) == v:
+            return
+        self.globals[key] = v
+        if signed:
+            self.emit_signed(macro, v)
+        else:
+            self.emit_unsigned(macro, text, line_num)
+
+    def parse_range(self, text, line_num):
+        parts = text.split("..")
+        if len(parts) != 2:
+            raise SpecError(f"line {line_num}: expected <min>..<max>, got '{text}'")
+        return self.value(parts[0], line_num), self.value(parts[1], line_num)
+
+    def field(self, word, args, line_num):
+        if not args:
+            raise SpecError(f"line {line_num}: {word} needs a name")
+        name = args[0]
+        if name != "-" and not IDENTIFIER.match(name):
+            raise SpecError(f"line {line_num}: bad name '{name}'")
+        opts = {}
+        for arg in args[1:]:
+            if "=" not in arg:
+                raise SpecError(f"line {line_num}: expected key=value, got '{arg}'")
+            k, v = arg.split("=", 1)
+            opts[k] = v
+        unknown = set(opts) - {"usage_page", "usage", "logical", "physical", "size", "count", "flags", "bits"}
+        if unknown:
+            raise SpecError(f"line {line_num}: unknown key '{sorted(unknown)[0]}'")
+
+        count = int(opts.get("count", "1"), 0)
+        if "size" in opts:
+            self.size = int(opts["size"], 0)
+        if self.size is None:
+            raise SpecError(f"line {line_num}: size not set")
+        flags = opts.get("flags", "CONSTANT" if name == "-" else "DATA|VARIABLE|ABSOLUTE")
+        for flag in flags.split("|"):
+            if flag not in FLAG_VALUES:
+                raise SpecError(f"line {line_num}: unknown flag '{flag}'")
+        bits = opts["bits"].split(",") if "bits" in opts else None
+        if bits is not None and len(bits) != count:
+            raise SpecError(f"line {line_num}: {len(bits)} bit names for a count of {count}")
+
+        if "usage_page" in opts:
+            self.set_global("page", "Usage_Page", self.value(opts["usage_page"], line_num),
+                            False, opts["usage_page"], line_num)
+        if "usage" in opts:
+            if ".." in opts["usage"]:
+                lo, hi = opts["usage"].split("..")
+                self.emit_unsigned("Usage_Minimum", lo, line_num)
+                self.emit_unsigned("Usage_Maximum", hi, line_num)
+            else:
+                for usage in opts["usage"].split(","):
+                    self.emit_unsigned("Usage", usage, line_num)
+        if "logical" in opts:
+            self.logical = self.parse_range(opts["logical"], line_num)
+        if name != "-" and self.logical is None:
+            raise SpecError(f"line {line_num}: logical not set")
+        if "logical" in opts:
+            self.set_global("lmin", "Logic_Minimum", self.logical[0])
+            self.set_global("lmax", "Logic_Maximum", self.logical[1])
+        if "physical" in opts:
+            pmin, pmax = self.parse_range(opts["physical"], line_num)
+            self.set_global("pmin", "Physical_Minimum", pmin)
+            self.set_global("pmax", "Physical_Maximum", pmax)
+        self.set_global("size", "Report_Size", self.size)
+        self.set_global("count", "Report_Count", count)
+        self.emit(MAIN_MACROS[word], flags, 2)
+
+        signed = self.logical is not None and self.logical[0] < 0
+        kind = MAIN_TYPES[word]
+        self.reports.setdefault((kind, self.report_id), []).append(
+            Field(kind, None if name == "-" else name, self.size, count, flags, signed, bits))
+
+    def line(self, word, args, line_num):
+        if word == "usage_page":
+            self.set_global("page", "Usage_Page", self.value(args[0], line_num), False, args[0], line_num)
+        elif word == "usage":
+            self.emit_unsigned("Usage", args[0], line_num)
+        elif word == "collection":
+            if args[0] not in COLLECTION_TYPES:
+                raise SpecError(f"line {line_num}: unknown collection '{args[0]}'")
+            self.emit("Collection", args[0], 2)
+            self.indent += 1
+        elif word == "end":
+            if self.indent == 0:
+                raise SpecError(f"line {line_num}: end without collection")
+            self.indent -= 1
+            self.emit("End_Collection", None, 1)
+        elif word == "report_id":
+            self.report_id = self.value(args[0], line_num)
+            if not 1 <= self.report_id <= 255:
+                raise SpecError(f"line {line_num}: Report IDs are 1 to 255")
+            self.emit("Report_ID", args[0], 2)
+        elif word in MAIN_TYPES:
+            self.field(word, args, line_num)
+        else:
+            raise SpecError(f"line {line_num}: unknown item '{word}'")
+
+    def finish(self, line_num):
+        if self.indent != 0:
+            raise SpecError(f"line {line_num}: collection not ended")
+        if not self.items:
+            raise SpecError(f"line {line_num}: interface has no items")
+        if self.report_id and any(rid == 0 for _, rid in self.reports):
+            raise SpecError(f"line {line_num}: fields before the first report_id")
+
+
+def compile_spec(path):
+    """Returns a Compiler for each interface in the spec."""
+    values = load_page_values()
+    compilers = [Compiler(values)]
+    line_num = 0
+    with open(path, encoding="utf-8") as f:
+        for line_num, line in enumerate(f, 1):
+            words = line.split("#", 1)[0].split()
+            if not words:
+                continue
+            if words[0] == "interface":
+                compilers[-1].finish(line_num)
+                compilers.append(Compiler(values))
+            else:
+                compilers[-1].line(words[0], words[1:], line_num)
+    compilers[-1].finish(line_num)
+    return compilers
+
+
+def c_type(size, signed):
+    return ("int" if signed else "uint") + f"{size}_t"
+
+
+def struct_members(fields, use_ids):
+    """Returns the C member lines of a report struct and its size in bytes."""
+    lines = []
+    if use_ids:
+        lines.append("uint8_t Report_ID;")
+    run = []       # Bit field members waiting for a byte boundary: (name, width)
+    run_names = [] # Named fields in the current run
+    bit_pos = 0
+
+    def flush_run():
+        nonlocal run, run_names
+        pad = max(len(n) for n, _ in run if n) if run_names else 0
+        members = [f"    unsigned {(n or '').ljust(pad)} :{w};" for n, w in run]
+        width = sum(w for _, w in run)
+        if len(run_names) == 1 and width in (8, 16):
+            lines.append("union")
+            lines.append("{")
+            lines.append(f"    {c_type(width, False)} {run_names[0]};")
+            lines.append("    struct")
+            lines.append("    {")
+            lines.extend("    " + m for m in members)
+            lines.append("    };")
+            lines.append("};")
+        else:
+            lines.append("struct")
+            lines.append("{")
+            lines.extend(members)
+            lines.append("};")
+        run, run_names = [], []
+
+    for field in fields:
+        total = field.size * field.count
+        whole_bytes = field.size in (8, 16, 32) and bit_pos % 8 == 0 and field.bits is None
+        if whole_bytes and field.name is not None:
+            t = c_type(field.size, field.signed)
+            lines.append(f"{t} {field.name};" if field.count == 1 else f"{t} {field.name}[{field.count}];")
+        else:
+            if field.name is None:
+                pos = bit_pos
+                while pos < bit_pos + total: # Unnamed members can't cross a byte.
+                    w = min(bit_pos + total - pos, 8 - pos % 8)
+                    run.append((None, w))
+                    pos += w
+            elif field.bits is not None:
+                run.extend((b, field.size) for b in field.bits)
+                run_names.append(field.name)
+            elif field.count == 1:
+                run.append((field.name, field.size))
+                run_names.append(field.name)
+            else:
+                run.extend((f"{field.name}_{i}", field.size) for i in range(field.count))
+                run_names.append(field.name)
+        bit_pos += total
+        if run and bit_pos % 8 == 0:
+            flush_run()
+    if bit_pos % 8:
+        raise SpecError(f"{fields[0].kind} report is {bit_pos} bits, pad it to a whole byte")
+    return lines, bit_pos // 8 + (1 if use_ids else 0)
+
+
+def report_tables(compiler):
+    """Returns an interface's reports by type, indexed by Report_ID - 1."""
+    tables = {}
+    use_ids = compiler.report_id != 0
+    for kind in ("in", "out", "feature"):
+        ids = [rid for k, rid in compiler.reports if k == kind]
+        if not ids:
+            tables[kind] = []
+        elif use_ids:
+            tables[kind] = [compiler.reports.get((kind, rid)) for rid in range(1, max(ids) + 1)]
+        else:
+            tables[kind] = [compiler.reports[(kind, 0)]]
+    return tables
+
+
+def generate(spec_path, out_dir):
+    compilers = compile_spec(spec_path)
+    spec_name = os.path.basename(spec_path)
+    interfaces = []
+    for i, compiler in enumerate(compilers):
+        use_ids = compiler.report_id != 0
+        interfaces.append({
+            "prefix": "HID" if i == 0 else f"HID{i}",
+            "var": "g_hid" if i == 0 else f"g_hid{i}",
+            "compiler": compiler,
+            "use_ids": use_ids,
+            "tables": report_tables(compiler),
+            "num_ids": max((rid for _, rid in compiler.reports), default=0) if use_ids else 0,
+            "desc_size": sum(item[2] for item in compiler.items),
+        })
+
+    h = [LICENSE.format(name="usb_hid_reports.h", brief="HID report structs, made from " + spec_name + ".", spec=spec_name)]
+    c = [LICENSE.format(name="usb_hid_reports.c", brief="HID report descriptor and report tables, made from " + spec_name + ".", spec=spec_name)]
+    h.append(" \n#ifndef USB_HID_REPORTS_H\n#define USB_HID_REPORTS_H\n\n#include <stdint.h>\n\n")
+    h.append("/* NUMBER OF REPORTS */\n")
+    width = len(f"#define {interfaces[-1]['prefix']}_NUM_FEATURE_REPORTS ")
+    for kind, name in (("in", "IN"), ("out", "OUT"), ("feature", "FEATURE")):
+        total = sum(len(itf["tables"][kind]) for itf in interfaces)
+        h.append(f"#define HID_NUM_{name}_REPORTS".ljust(width) + f"{total}\n")
+    for itf in interfaces[1:]:
+        for kind, name in (("in", "IN"), ("out", "OUT"), ("feature", "FEATURE")):
+            h.append(f"#define {itf['prefix']}_NUM_{name}_REPORTS".ljust(width) + f"{len(itf['tables'][kind])}\n")
+    h.append("\n/* REPORT STRUCTURES/VARS/DEFINES */\n")
+    h.append("#define HID_USE_REPORT_IDS 0\n")
+    for itf in interfaces:
+        h.append(f"#define {itf['prefix']}_NUM_REPORT_IDS {itf['num_ids']}\n")
+    h.append("\n")
+
+    # Report numbers run on across interfaces, the struct names use them.
+    largest_in = 0
+    types = []
+    first = {"in": 0, "out": 0, "feature": 0}
+    for kind in ("in", "out", "feature"):
+        for itf in interfaces:
+            for rid, fields in enumerate(itf["tables"][kind], 1):
+                num = first[kind] + rid
+                if fields is None:
+                    continue
+                members, size = struct_members(fields, itf["use_ids"])
+                if kind == "in":
+                    largest_in = max(largest_in, size)
+                body = "\n".join("    " + m for m in members)
+                h.append(f"typedef struct\n{{\n{body}\n}}hid_{kind}_report{num}_t; // {size} bytes\n\n")
+                types.append((kind, num, size, rid if itf["use_ids"] else 0))
+            first[kind] += len(itf["tables"][kind])
+
+    for itf in interfaces:
+        h.append(f"#define {itf['prefix']}_REPORT_DESC_SIZE".ljust(30) + f"{itf['desc_size']} // Size of {itf['var']}_report_descriptor.\n")
+    h.append(f"#define HID_LARGEST_IN_REPORT {largest_in} // For HID_IN_QUEUE_REPORT_SIZE.\n\n")
+    for itf in interfaces:
+        h.append(f"extern const uint8_t  {itf['var']}_report_descriptor[{itf['prefix']}_REPORT_DESC_SIZE];\n")
+        h.append(f"extern const uint16_t {itf['var']}_report_descriptor_size;\n\n")
+    for kind, num, _, _ in types:
+        h.append(f"extern volatile hid_{kind}_report{num}_t g_hid_{kind}_report{num};\n")
+    for kind in ("in", "out", "feature"):
+        if first[kind]:
+            h.append(f"extern const uint16_t g_hid_{kind}_reports[];\n")
+            h.append(f"extern const uint8_t  g_hid_{kind}_report_size[];\n")
+    h.append("\n#endif /* USB_HID_REPORTS_H */\n")
+
+    c.append(" \n#include <stdint.h>\n#include \"usb_hid_report_defines.h\"\n#include \"usb_hid_pages.h\"\n#include \"usb_hid_reports.h\"\n\n")
+    for itf in interfaces:
+        items = itf["compiler"].items
+        c.append(f"const uint8_t {itf['var']}_report_descriptor[{itf['prefix']}_REPORT_DESC_SIZE] =\n{{\n")
+        for i, (indent, text, _) in enumerate(items):
+            comma = "," if i != len(items) - 1 else ""
+            c.append("    " * (indent + 1) + text + comma + "\n")
+        c.append(f"}};\n\nconst uint16_t {itf['var']}_report_descriptor_size = {itf['prefix']}_REPORT_DESC_SIZE;\n\n")
+    for kind, num, _, rid in types:
+        init = f" = {{{rid}}}" if rid else ""
+        c.append(f"volatile hid_{kind}_report{num}_t g_hid_{kind}_report{num}{init};\n")
+    for kind in ("in", "out", "feature"):
+        if not first[kind]:
+            continue
+        ptrs, sizes = [], []
+        num = 0
+        for itf in interfaces:
+            for fields in itf["tables"][kind]:
+                num += 1
+                if fields is None:
+                    ptrs.append("    0, // No report with this ID.")
+                    sizes.append("    0,")
+                else:
+                    ptrs.append(f"    (uint16_t)&g_hid_{kind}_report{num},")
+                    sizes.append(f"    sizeof(g_hid_{kind}_report{num}),")
+        c.append(f"\nconst uint16_t g_hid_{kind}_reports[] =\n{{\n" + "\n".join(ptrs) + "\n};\n")
+        c.append(f"\nconst uint8_t g_hid_{kind}_report_size[] =\n{{\n" + "\n".join(sizes) + "\n};\n")
+
+    with open(os.path.join(out_dir, "usb_hid_reports.h"), "w", encoding="utf-8") as f:
+        f.write("".join(h))
+    with open(os.path.join(out_dir, "usb_hid_reports.c"), "w", encoding="utf-8") as f:
+        f.write("".join(c))
+    return [itf["desc_size"] for itf in interfaces], [t[:3] for t in types]
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+    try:
+        desc_sizes, types = generate(sys.argv[1], sys.argv[2])
+    except SpecError as e:
+        print(f"{sys.argv[1]}: {e}", file=sys.stderr)
+        return 1
+    for i, desc_size in enumerate(desc_sizes):
+        print(f"Report descriptor {i}: {desc_size} bytes" if len(desc_sizes) > 1 else f"Report descriptor: {desc_size} bytes")
+    for kind, num, size in types:
+        print(f"hid_{kind}_report{num}_t: {size} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""
+Generates the keyboard layout tables used by ascii_2_key.c.
+
+Each *.layout file describes one host keyboard layout. An "id N" line gives
+its LAYOUT_ ID, so the output doesn't depend on the order the files are
+passed in. The other lines are one physical key each: the key's KEY_ name
+(without the prefix) followed by the character it types with no modifier,
+Shift, AltGr and Shift+AltGr. "none" leaves a slot empty and "dead:X" marks a
+dead key, typed as X by following it with a space.
+
+The output is key_layouts.h (layout IDs and table types) and key_layouts.c (a
+128 entry ASCII table and a sorted table of the other characters for every
+layout, selected with KEYBOARD_LAYOUT in ascii_2_key.h).
+
+Usage:
+    python3 gen_key_layouts.py <output dir> <layout files...>
+
+Example:
+    python3 gen_key_layouts.py ../Examples/HID_Examples/HID_Keyboard_Examples/Shared_Files Keyboard_Layouts/*.layout
+"""
+
+import os
+import sys
+
+MODIFIERS = ["0",
+             "MOD_KEY_LEFTSHIFT",
+             "MOD_KEY_RIGHTALT",
+             "MOD_KEY_LEFTSHIFT | MOD_KEY_RIGHTALT"]
+
+# Characters typed the same way on every layout.
+FIXED_KEYS = {
+    0x08: "BACKSPACE",
+    0x09: "TAB",
+    0x0A: "ENTER",
+    0x0D: "ENTER",
+    0x1B: "ESC",
+    0x20: "SPACE",
+    0x7F: "DELETE",
+}
+
+CONTROL_NAMES = {0x00: "NUL", 0x08: "\\b", 0x09: "\\t", 0x0A: "\\n", 0x0D: "\\r", 0x1B: "ESC", 0x20: "' '", 0x7F: "DEL"}
+
+LICENSE = """/**
+ * @file {name}
+ * @brief {brief}
+ * @author John Izzard
+ *
+ * Generated by USB_Stack/Tools/gen_key_layouts.py from the layouts in
+ * USB_Stack/Tools/Keyboard_Layouts, do not edit.
+ *
+ * USB uC - HID Examples.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+"""
+
+
+def parse_layout(path):
+    """Returns the layout ID and {codepoint: (dead, modifier index, key name)}, best mapping per character."""
+    layout_id = None
+    mappings = {}
+    with open(path, encoding="utf-8") as f:
+        for line_num, line in enumerate(f, 1):
+            if not line.strip() or line.startswith("#"):
+                continue
+            fields = line.split()
+            key = fields[0]
+            if key == "id":
+                if len(fields) != 2 or not fields[1].isdigit():
+                    sys.exit(f"{path}:{line_num}: expected 'id N'")
+                layout_id = int(fields[1])
+                continue
+            if len(fields) > 5:
+                sys.exit(f"{path}:{line_num}: too many columns")
+            for mod, token in enumerate(fields[1:]):
+                if token == "none":
+                    continue
+                dead = token.startswith("dead:")
+                if dead:
+                    token = token[5:]
+                if len(token) != 1 or ord(token) > 0xFFFF:
+                    sys.exit(f"{path}:{line_num}: '{token}' isn't a single BMP character")
+                candidate = (dead, mod, key)
+                codepoint = ord(token)
+                # Prefer a plain key over a dead key, then fewer modifiers, then the first listed.
+                if codepoint not in mappings or candidate[:2] < mappings[codepoint][:2]:
+                    mappings[codepoint] = candidate
+    if layout_id is None:
+        sys.exit(f"{path}: no 'id N' line")
+    for codepoint, key in FIXED_KEYS.items():
+        mappings[codepoint] = (False, 0, key)
+    return layout_id, mappings
+
+
+def char_comment(codepoint):
+    if codepoint in CONTROL_NAMES:
+        return CONTROL_NAMES[codepoint]
+    if codepoint < 0x20:
+        return f"0x{codepoint:02X}"
+    if codepoint == ord("\\"):
+        return "'\\\\'"
+    if codepoint == ord("'"):
+        return "'\\''"
+    return f"'{chr(codepoint)}'"
+
+
+def entry(mapping):
+    dead, mod, key = mapping
+    keycode = f"KEY_DEAD | KEY_{key}" if dead else f"KEY_{key}"
+    return f"{MODIFIERS[mod]}, {keycode}"
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    out_dir = sys.argv[1]
+    parsed = []
+    for path in sys.argv[2:]:
+        layout_id, mappings = parse_layout(path)
+        parsed.append((layout_id, os.path.splitext(os.path.basename(path))[0].upper(), mappings))
+    parsed.sort(key=lambda layout: layout[0])
+    ids = [layout[0] for layout in parsed]
+    if ids != list(range(len(ids))):
+        sys.exit(f"layout IDs {ids} must be 0 to {len(ids) - 1}, each used once")
+    names = [layout[1] for layout in parsed]
+    layouts = [layout[2] for layout in parsed]
+
+    with open(os.path.join(out_dir, "key_layouts.h"), "w", encoding="utf-8", newline="\n") as h:
+        h.write(LICENSE.format(name="key_layouts.h", brief="Keyboard layout IDs and table types."))
+        h.write("\n#ifndef KEY_LAYOUTS_H\n#define KEY_LAYOUTS_H\n\n#include <stdint.h>\n\n")
+        h.write("// Layout IDs for KEYBOARD_LAYOUT.\n")
+        width = max(len(n) for n in names) + len("LAYOUT_")
+        for layout_id, name in zip(ids, names):
+            h.write(f"#define {'LAYOUT_' + name:<{width}} {layout_id}\n")
+        h.write("\n// KeyCode flag for a dead key, it is typed by following it with a space.\n")
+        h.write("#define KEY_DEAD 0x80\n\n")
+        h.write("typedef struct\n{\n    uint8_t Modifier;\n    uint8_t KeyCode;\n}key_entry_t;\n\n")
+        h.write("typedef struct\n{\n    uint16_t Codepoint;\n    uint8_t  Modifier;\n    uint8_t  KeyCode;\n}key_ext_entry_t;\n\n")
+        h.write("extern const key_entry_t     g_ascii_keys[128]; // Indexed by ASCII value.\n")
+        h.write("extern const key_ext_entry_t g_ext_keys[];      // Other characters, sorted by codepoint.\n")
+        h.write("extern const uint8_t         g_num_ext_keys;\n\n")
+        h.write("#endif /* KEY_LAYOUTS_H */\n")
+
+    with open(os.path.join(out_dir, "key_layouts.c"), "w", encoding="utf-8", newline="\n") as c:
+        c.write(LICENSE.format(name="key_layouts.c", brief="Keyboard layout tables."))
+        c.write("\n#include <stdint.h>\n#include \"ascii_2_key.h\"\n#include \"key_layouts.h\"\n\n")
+        for i, (name, mappings) in enumerate(zip(names, layouts)):
+            c.write(f"#{'if' if i == 0 else 'elif'} KEYBOARD_LAYOUT == LAYOUT_{name}\n")
+            c.write("const key_entry_t g_ascii_keys[128] =\n{\n")
+            for codepoint in range(128):
+                text = entry(mappings[codepoint]) if codepoint in mappings else "0, KEY_NULL"
+                sep = "," if codepoint != 127 else " "
+                c.write(f"    {{{text}}}{sep}".ljust(60) + f"// {char_comment(codepoint)}\n")
+            c.write("};\n\n")
+            ext = sorted(cp for cp in mappings if cp >= 128)
+            if len(ext) > 255:
+                sys.exit(f"{name}: too many non-ASCII characters")
+            c.write("const key_ext_entry_t g_ext_keys[] =\n{\n")
+            if not ext:
+                c.write("    {0xFFFF, 0, KEY_NULL}\n")
+            for n, codepoint in enumerate(ext):
+                sep = "," if n != len(ext) - 1 else " "
+                c.write(f"    {{0x{codepoint:04X}, {entry(mappings[codepoint])}}}{sep}".ljust(60) + f"// {char_comment(codepoint)}\n")
+            c.write("};\n\n")
+            c.write(f"const uint8_t g_num_ext_keys = {len(ext)};\n\n")
+        c.write("#else\n#error \"Unknown KEYBOARD_LAYOUT.\"\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Measures how long a device using the mass storage class (usb_msd.c) takes to
+mount, from a Linux usbmon capture of it being plugged in.
+
+The time runs from SET_CONFIGURATION completing to the last CSW of the burst of
+SCSI commands the host sends before the volume is usable, which is taken to end
+at the first gap in the device's bulk traffic of --idle milliseconds. It is
+reported in full speed frames (1 ms), along with every command the host sent,
+the bytes it read and what went wrong: failed CSWs, STALLed endpoints and the
+REQUEST_SENSEs they cost. Giving two captures prints them side by side, e.g.
+the firmware before and after a change.
+
+Capturing (bus number from lsusb, plug the device in after starting cat and
+stop it once the drive has appeared):
+    sudo modprobe usbmon
+    sudo cat /sys/kernel/debug/usb/usbmon/1u > after.txt
+
+Usage:
+    python3 msd_mount_bench.py <capture> [capture] [--device N] [--idle MS]
+
+Example:
+    python3 msd_mount_bench.py before.txt after.txt
+"""
+
+import argparse
+import collections
+import sys
+
+SCSI_NAMES = {
+    0x00: "TEST_UNIT_READY",
+    0x03: "REQUEST_SENSE",
+    0x12: "INQUIRY",
+    0x1A: "MODE_SENSE_6",
+    0x1B: "START_STOP_UNIT",
+    0x1E: "PREVENT_ALLOW_MEDIUM_REMOVAL",
+    0x23: "READ_FORMAT_CAPACITIES",
+    0x25: "READ_CAPACITY",
+    0x28: "READ_10",
+    0x2A: "WRITE_10",
+    0x2F: "VERIFY_10",
+    0x35: "SYNCHRONIZE_CACHE_10",
+    0x5A: "MODE_SENSE_10",
+    0x88: "READ_16",
+    0x8A: "WRITE_16",
+    0x9E: "SERVICE_ACTION_IN_16",
+    0xA0: "REPORT_LUNS",
+}
+
+CBW_SIGNATURE = bytes.fromhex("55534243")
+CSW_SIGNATURE = bytes.fromhex("55534253")
+EPIPE = -32  # usbmon status of a STALLed transfer
+
+
+class Event:
+    """One line of a usbmon text capture."""
+
+    def __init__(self, line):
+        words = line.split()
+        self.time_us = int(words[1])
+        self.kind = words[2]  # S(ubmit), C(allback) or E(rror)
+        addr = words[3].split(":")
+        self.xfer = addr[0]  # Ci, Co, Bi, Bo, Ii, Io, Zi, Zo
+        self.device = int(addr[-2])
+        self.ep = int(addr[-1])
+        self.setup = None
+        self.status = None
+        self.data = b""
+        rest = words[4:]
+        if rest and rest[0] == "s":
+            self.setup = [int(w, 16) for w in rest[1:6]]
+            rest = rest[6:]
+        elif rest:
+            self.status = int(rest[0].split(":")[0])
+            rest = rest[1:]
+        if "=" in rest:
+            self.data = bytes.fromhex("".join(rest[rest.index("=") + 1:]))
+
+
+def read_events(path):
+    """Returns the events of a capture, skipping anything that doesn't parse."""
+    events = []
+    with open(path) as f:
+        for line in f:
+            try:
+                events.append(Event(line))
+            except (IndexError, ValueError):
+                pass
+    return events
+
+
+def analyse(events, device, idle_ms):
+    """Returns the mount statistics of one device in a capture."""
+    start = None
+    set_config = False
+    for ev in events:
+        if ev.xfer != "Co" or (device is not None and ev.device != device):
+            continue
+        if ev.kind == "S" and ev.setup and ev.setup[0] == 0x00 and ev.setup[1] == 0x09:
+            device = ev.device  # SET_CONFIGURATION
+            set_config = True
+        elif ev.kind == "C" and set_config:
+            start = ev.time_us
+            break
+    if start is None:
+        raise SystemExit("No SET_CONFIGURATION found in the capture.")
+
+    stats = {
+        "device": device,
+        "commands": collections.Counter(),
+        "failed": collections.Counter(),
+        "stalls": 0,
+        "cbws": 0,
+        "in_bytes": 0,
+        "end": start,
+    }
+    last = start
+    opcode = None
+    for ev in events:
+        if ev.device != device or ev.time_us < start or ev.xfer[0] != "B":
+            continue
+        if (ev.time_us - last) >= idle_ms * 1000 and stats["cbws"]:
+            break
+        last = ev.time_us
+        if ev.kind == "S" and ev.xfer == "Bo" and ev.data[:4] == CBW_SIGNATURE and len(ev.data) >= 16:
+            opcode = ev.data[15]
+            stats["commands"][opcode] += 1
+            stats["cbws"] += 1
+        elif ev.kind == "C":
+            if ev.status == EPIPE:
+                stats["stalls"] += 1
+            elif ev.xfer == "Bi" and ev.data[:4] == CSW_SIGNATURE and len(ev.data) >= 13:
+                if ev.data[12] != 0 and opcode is not None:
+                    stats["failed"][opcode] += 1
+                stats["end"] = ev.time_us
+            elif ev.xfer == "Bi" and ev.status == 0:
+                stats["in_bytes"] += len(ev.data)
+    stats["frames"] = (stats["end"] - start) // 1000
+    return stats
+
+
+def report(names, results):
+    """Prints the statistics of each capture in a column."""
+    rows = [
+        ("Device address", [r["device"] for r in results]),
+        ("Frames to mount", [r["frames"] for r in results]),
+        ("SCSI commands", [r["cbws"] for r in results]),
+        ("Bytes read", [r["in_bytes"] for r in results]),
+        ("Failed commands", [sum(r["failed"].values()) for r in results]),
+        ("STALLs", [r["stalls"] for r in results]),
+    ]
+    opcodes = sorted(set().union(*(r["commands"] for r in results)))
+    for op in opcodes:
+        name = SCSI_NAMES.get(op, "0x%02X" % op)
+        rows.append(("  " + name, ["%d (%d failed)" % (r["commands"][op], r["failed"][op])
+                                   if r["failed"][op] else r["commands"][op] for r in results]))
+
+    width = max(len(label) for label, _ in rows) + 2
+    print("".ljust(width) + "".join(n.ljust(24) for n in names))
+    for label, values in rows:
+        print(label.ljust(width) + "".join(str(v).ljust(24) for v in values))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("captures", nargs="+")
+    parser.add_argument("--device", type=int, help="USB address, the first configured device by default")
+    parser.add_argument("--idle", type=int, default=1000, help="gap in ms that ends the mount")
+    args = parser.parse_args()
+    if len(args.captures) > 2:
+        parser.error("at most two captures")
+
+    results = [analyse(read_events(path), args.device, args.idle) for path in args.captures]
+    report(args.captures, results)
+    if len(results) == 2 and results[0]["frames"]:
+        saved = results[0]["frames"] - results[1]["frames"]
+        print("\n%d frames (%.0f%%) %s" % (abs(saved), 100.0 * abs(saved) / results[0]["frames"],
+                                          "saved" if saved >= 0 else "lost"))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Packs a disk image into a C file for the compressed read-only volume
+(usb_lzvol.c), so a mass storage device can show a volume several times larger
+than the flash holding it.
+
+Every 512 byte sector is compressed on its own with copies reaching at most 256
+bytes back, which lets the device decode any sector in order a packet at a time
+through a 256 byte window. Sectors with the same contents are stored once. The
+packed result is decoded again and compared with the image before it's written.
+
+Making an image (FAT12 suits small volumes, the size is in KB):
+    mkfs.fat -C -n DOCS docs.img 1024
+    mcopy -i docs.img manual.pdf settings.cfg ::
+
+Usage:
+    python3 msd_pack_image.py <image> [-o lzvol_image.c]
+
+Example:
+    python3 msd_pack_image.py docs.img -o ../Examples/MSD_Examples/MSD_Internal_Example.X/lzvol_image.c
+"""
+
+import argparse
+import os
+import sys
+
+SECTOR_SIZE = 512
+WINDOW = 256
+MIN_MATCH = 3
+MAX_MATCH = 127 + MIN_MATCH
+MAX_LITERALS = 128
+MATCH = 0x80
+MAX_DATA = 0xFFFF  # g_lzvol_index holds 16 bit offsets
+
+
+def longest_match(sector, pos, candidates):
+    """Returns the (length, distance) of the longest copy available at pos."""
+    best_len, best_dist = 0, 0
+    limit = min(MAX_MATCH, len(sector) - pos)
+    for start in reversed(candidates):
+        dist = pos - start
+        if dist > WINDOW:
+            break
+        length = 0
+        while length < limit and sector[start + length] == sector[pos + length]:
+            length += 1  # May run into bytes being copied, like any LZ77.
+        if length > best_len:
+            best_len, best_dist = length, dist
+            if length == limit:
+                break
+    return best_len, best_dist
+
+
+def compress(sector):
+    """Returns the tokens of one sector."""
+    out = bytearray()
+    literals = bytearray()
+    heads = {}  # 3 byte prefix -> positions it was seen at
+
+    def flush():
+        for i in range(0, len(literals), MAX_LITERALS):
+            run = literals[i:i + MAX_LITERALS]
+            out.append(len(run) - 1)
+            out.extend(run)
+        literals.clear()
+
+    def remember(pos):
+        if pos + MIN_MATCH <= len(sector):
+            heads.setdefault(bytes(sector[pos:pos + MIN_MATCH]), []).append(pos)
+
+    pos = 0
+    while pos < len(sector):
+        length, dist = longest_match(sector, pos, heads.get(bytes(sector[pos:pos + MIN_MATCH]), []))
+        if length >= MIN_MATCH:
+            flush()
+            out.append(MATCH | (length - MIN_MATCH))
+            out.append(dist - 1)
+            for p in range(pos, pos + length):
+                remember(p)
+            pos += length
+        else:
+            literals.append(sector[pos])
+            remember(pos)
+            pos += 1
+    flush()
+    return bytes(out)
+
+
+def decompress(data, start):
+    """Decodes one sector the way lzvol_read() does."""
+    out = bytearray()
+    pos = start
+    while len(out) < SECTOR_SIZE:
+        token = data[pos]
+        pos += 1
+        if token & MATCH:
+            dist = data[pos] + 1
+            pos += 1
+            for _ in range((token & ~MATCH) + MIN_MATCH):
+                out.append(out[-dist])
+        else:
+            out.extend(data[pos:pos + token + 1])
+            pos += token + 1
+    return bytes(out[:SECTOR_SIZE])
+
+
+def pack(image):
+    """Returns the index and token data of an image."""
+    index = []
+    data = bytearray()
+    stored = {}  # sector contents -> offset of its tokens
+    for lba in range(len(image) // SECTOR_SIZE):
+        sector = image[lba * SECTOR_SIZE:(lba + 1) * SECTOR_SIZE]
+        if sector not in stored:
+            stored[sector] = len(data)
+            data.extend(compress(sector))
+        index.append(stored[sector])
+    return index, bytes(data), len(stored)
+
+
+def c_array(values, per_line, fmt):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ",".join(fmt % v for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def write_c(path, source, index, data):
+    with open(path, "w") as f:
+        f.write("/* Generated by Tools/msd_pack_image.py from %s, do not edit.\n" % os.path.basename(source))
+        f.write(" * %d sectors (%d bytes) packed into %d bytes. */\n\n" %
+                (len(index), len(index) * SECTOR_SIZE, len(index) * 2 + len(data)))
+        f.write("#include <stdint.h>\n#include \"usb_lzvol.h\"\n\n")
+        f.write("const uint16_t g_lzvol_sectors = %d;\n\n" % len(index))
+        f.write("const uint16_t g_lzvol_index[%d] =\n{\n%s\n};\n\n" % (len(index), c_array(index, 8, "0x%04X")))
+        f.write("const uint8_t g_lzvol_data[%d] =\n{\n%s\n};\n" % (len(data), c_array(data, 16, "0x%02X")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("image")
+    parser.add_argument("-o", "--output", default="lzvol_image.c")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    if len(image) % SECTOR_SIZE:
+        image += bytes(SECTOR_SIZE - len(image) % SECTOR_SIZE)
+    sectors = len(image) // SECTOR_SIZE
+    if not sectors or sectors > 0xFFFF:
+        parser.error("the image must be 1 to 65535 sectors")
+
+    index, data, unique = pack(image)
+    if len(data) > MAX_DATA:
+        print("%d bytes of packed data, the index only reaches %d." % (len(data), MAX_DATA))
+        return 1
+    for lba in range(sectors):
+        if decompress(data, index[lba]) != image[lba * SECTOR_SIZE:(lba + 1) * SECTOR_SIZE]:
+            print("Sector %d doesn't decode back to the image." % lba)
+            return 1
+
+    write_c(args.output, args.image, index, data)
+    flash = sectors * 2 + len(data)
+    print("%d sectors, %d unique, %d bytes -> %d bytes of flash (%.1fx)" %
+          (sectors, unique, len(image), flash, float(len(image)) / flash))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
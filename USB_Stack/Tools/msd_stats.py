@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Prints the statistics kept by a mass storage device built with USE_MSD_STATS
+(usb_msd.c): how long each SCSI command took from CBW to CSW as a histogram,
+where that time went (waiting for the first data packet, moving the data and
+sending the CSW), how long msd_rx_sector()/msd_tx_sector() calls took and how
+often the device failed commands, was reset or reported phase errors.
+
+The statistics are read from the device with a vendor request (needs pyusb and
+access to the device) or from a copy of g_msd_stats, such as STATS.BIN on the
+Simple example's volume. Hosts cache files, so read it past the cache:
+    dd if=/media/user/MSD/STATS.BIN of=stats.bin iflag=direct
+
+Times are in ticks of MSD_STATS_TIME(), 1 ms frames unless a timer was given.
+A histogram bin holds times of 0, 1, 2-3, 4-7 ... ticks.
+
+Usage:
+    python3 msd_stats.py [file] [--vid VID] [--pid PID] [--request N] [--clear]
+
+Example:
+    python3 msd_stats.py --vid 0x04D8 --pid 0x0009
+    python3 msd_stats.py stats.bin
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct("<BBBBI5H8H8HHHI")
+ROW = "<BH%dHIII"
+VERSION = 1
+OTHER = 0xFF
+
+SCSI_NAMES = {
+    0x00: "TEST_UNIT_READY",
+    0x03: "REQUEST_SENSE",
+    0x12: "INQUIRY",
+    0x1A: "MODE_SENSE_6",
+    0x1B: "START_STOP_UNIT",
+    0x1E: "PREVENT_ALLOW_MEDIUM_REMOVAL",
+    0x23: "READ_FORMAT_CAPACITIES",
+    0x25: "READ_CAPACITY",
+    0x28: "READ_10",
+    0x2A: "WRITE_10",
+    0x2F: "VERIFY_10",
+    0x35: "SYNCHRONIZE_CACHE_10",
+    0x5A: "MODE_SENSE_10",
+    0x88: "READ_16",
+    0x8A: "WRITE_16",
+    0x9E: "SERVICE_ACTION_IN_16",
+    OTHER: "(others)",
+}
+
+
+def read_device(vid, pid, request, clear):
+    """Returns g_msd_stats read with a vendor request, clearing it after if asked."""
+    try:
+        import usb.core
+    except ImportError:
+        raise SystemExit("Reading the device needs pyusb (pip install pyusb).")
+    dev = usb.core.find(idVendor=vid, idProduct=pid)
+    if dev is None:
+        raise SystemExit("No device %04X:%04X found." % (vid, pid))
+    data = bytes(dev.ctrl_transfer(0xC1, request, 0, 0, 1024))  # Vendor, interface, IN
+    if clear:
+        dev.ctrl_transfer(0x41, request, 0, 0, None)  # Vendor, interface, OUT
+    return data
+
+
+def parse(data):
+    """Returns g_msd_stats as a dict."""
+    if len(data) < HEADER.size:
+        raise SystemExit("%d bytes is too short for the statistics." % len(data))
+    fields = HEADER.unpack_from(data)
+    version, rows, bins, _, tick_ns = fields[:5]
+    if version != VERSION or bins != 8:
+        raise SystemExit("Unknown statistics version %d (%d bins)." % (version, bins))
+    stats = {
+        "tick_ns": tick_ns,
+        "bomsrs": fields[5],
+        "phase_errors": fields[6],
+        "invalid_cbws": fields[7],
+        "failed": fields[8],
+        "retries": fields[9],
+        "rx_sector": list(fields[10:18]),
+        "tx_sector": list(fields[18:26]),
+        "rx_sector_max": fields[26],
+        "tx_sector_max": fields[27],
+        "busy_ticks": fields[28],
+        "cmds": [],
+    }
+    row = struct.Struct(ROW % bins)
+    if len(data) < HEADER.size + rows * row.size:
+        raise SystemExit("%d bytes is too short for %d rows." % (len(data), rows))
+    for i in range(rows):
+        values = row.unpack_from(data, HEADER.size + i * row.size)
+        stats["cmds"].append({
+            "opcode": values[0],
+            "count": values[1],
+            "latency": list(values[2:2 + bins]),
+            "setup": values[2 + bins],
+            "data": values[3 + bins],
+            "status": values[4 + bins],
+        })
+    return stats
+
+
+def bin_label(i):
+    if i < 2:
+        return str(i)
+    if i == 7:
+        return "64+"
+    return "%d-%d" % (1 << (i - 1), (1 << i) - 1)
+
+
+def report(stats):
+    tick_ms = stats["tick_ns"] / 1e6
+    print("Tick %g ms" % tick_ms)
+    print("Resets %d, phase errors %d, invalid CBWs %d, failed %d (%d sent again)" %
+          (stats["bomsrs"], stats["phase_errors"], stats["invalid_cbws"], stats["failed"], stats["retries"]))
+    print("Media busy %.1f ms" % (stats["busy_ticks"] * tick_ms))
+
+    labels = [bin_label(i) for i in range(8)]
+    print("\n%-30s" % "Ticks" + "".join(l.rjust(7) for l in labels) + "   setup    data  status (mean ms)")
+    for name in ("rx_sector", "tx_sector"):
+        print("%-30s" % ("msd_" + name) + "".join(str(v).rjust(7) for v in stats[name]) +
+              "   max %d" % stats[name + "_max"])
+    for cmd in stats["cmds"]:
+        if not cmd["count"]:
+            continue
+        name = SCSI_NAMES.get(cmd["opcode"], "0x%02X" % cmd["opcode"])
+        n = float(cmd["count"])
+        print("%-30s" % ("%s x%d" % (name, cmd["count"])) +
+              "".join(str(v).rjust(7) for v in cmd["latency"]) +
+              "".join(("%.2f" % (cmd[stage] * tick_ms / n)).rjust(8) for stage in ("setup", "data", "status")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("file", nargs="?", help="copy of g_msd_stats, the device is read without it")
+    parser.add_argument("--vid", type=lambda s: int(s, 0), default=0x04D8)
+    parser.add_argument("--pid", type=lambda s: int(s, 0), default=0x0009)
+    parser.add_argument("--request", type=lambda s: int(s, 0), default=0x5A, help="MSD_STATS_REQUEST")
+    parser.add_argument("--clear", action="store_true", help="clear the device's statistics after reading them")
+    args = parser.parse_args()
+    if args.file and args.clear:
+        parser.error("--clear needs the device, not a file")
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        data = read_device(args.vid, args.pid, args.request, args.clear)
+    report(parse(data))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+Records from a device using the audio class (usb_audio.c) on Linux and checks
+the stream the host received.
+
+The capture is taken with arecord (ALSA), which drives the isochronous IN EP
+the same way any recording application would. The script reports the measured
+sample rate against the wall clock, which shows how well the asynchronous
+packet sizing follows the device's ADC clock.
+
+With --ramp the firmware is expected to feed a counter instead of the ADC
+(audio_put(n++), the same value on both channels for stereo). Every sample must
+then be one more than the last, so a dropped or repeated packet shows up as a
+discontinuity at a known position.
+
+Usage:
+    python3 uac_capture_check.py <alsa device> [seconds] [--rate R] [--channels C] [--ramp]
+
+Example:
+    python3 uac_capture_check.py hw:CARD=Microphone 10 --ramp
+"""
+
+import argparse
+import array
+import subprocess
+import sys
+import time
+import wave
+
+
+def record(device, seconds, rate, channels, path):
+    """Records with arecord and returns the wall clock time it took."""
+    cmd = ["arecord", "-q", "-D", device, "-f", "S16_LE", "-r", str(rate),
+           "-c", str(channels), "-d", str(seconds), path]
+    start = time.monotonic()
+    subprocess.run(cmd, check=True)
+    return time.monotonic() - start
+
+
+def check_ramp(samples, channels):
+    """Returns the sample positions where the ramp doesn't step by one."""
+    errors = []
+    prev = None
+    for i in range(0, len(samples), channels):
+        value = samples[i]
+        for c in range(1, channels):
+            if samples[i + c] != value:
+                errors.append(i // channels)
+        if prev is not None and value != ((prev + 1 + 32768) & 0xFFFF) - 32768:
+            errors.append(i // channels)
+        prev = value
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("device")
+    parser.add_argument("seconds", type=int, nargs="?", default=5)
+    parser.add_argument("--rate", type=int, default=48000)
+    parser.add_argument("--channels", type=int, default=1)
+    parser.add_argument("--ramp", action="store_true")
+    parser.add_argument("--keep", metavar="WAV", help="keep the recording")
+    args = parser.parse_args()
+
+    path = args.keep or "/tmp/uac_capture_check.wav"
+    wall = record(args.device, args.seconds, args.rate, args.channels, path)
+
+    with wave.open(path, "rb") as wav:
+        frames = wav.getnframes()
+        samples = array.array("h", wav.readframes(frames))
+    if sys.byteorder != "little":
+        samples.byteswap()
+
+    # arecord stops after a sample count, so the time taken follows the device's clock.
+    print("%d samples in %.3f s, %.1f Hz measured (%d Hz requested)" % (frames, wall, frames / wall, args.rate))
+    if args.ramp:
+        errors = check_ramp(samples, args.channels)
+        if errors:
+            print("%d discontinuities, first at samples %s" % (len(errors), errors[:8]))
+            sys.exit(1)
+        print("ramp continuous")
+
+
+if __name__ == "__main__":
+    main()
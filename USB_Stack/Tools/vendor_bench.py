@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Measures bulk throughput of a device using the vendor class (usb_vendor.c).
+
+The device is expected to keep the streaming API busy in the direction being
+measured: a vendor_read() reissued from vendor_read_done() for "out", and a
+vendor_write() reissued from vendor_write_done() for "in". "loop" expects each
+buffer read to be written back, and checks the data that returns.
+
+Examples/Vendor_Examples/Vendor_Bench_Example does this, built with the
+BENCH_MODE that matches the mode run here (0x04D8 0x000B). The host writes a
+whole transfer before reading it back in "loop", so the transfer size must be
+the example's BENCH_BUFFER_SIZE: 256, the default here, or 128 on PIC16.
+
+Uses pyusb, which talks to the device through libusb (WinUSB on Windows, bound
+automatically by the MS OS 2.0 descriptors when USE_MS_OS_20 is defined).
+
+Usage:
+    python3 vendor_bench.py <vid> <pid> <out|in|loop> [megabytes] [transfer size]
+
+Example:
+    python3 vendor_bench.py 0x04D8 0x000B in 4 4096
+    python3 vendor_bench.py 0x04D8 0x000B loop 1
+"""
+
+import sys
+import time
+
+import usb.core
+import usb.util
+
+TIMEOUT_MS = 2000
+
+
+def find_endpoints(dev):
+    """Returns the bulk OUT and IN endpoints of the first vendor interface."""
+    cfg = dev.get_active_configuration()
+    for intf in cfg:
+        if intf.bInterfaceClass != 0xFF:
+            continue
+        ep_out = ep_in = None
+        for ep in intf:
+            if usb.util.endpoint_type(ep.bmAttributes) != usb.util.ENDPOINT_TYPE_BULK:
+                continue
+            if usb.util.endpoint_direction(ep.bEndpointAddress) == usb.util.ENDPOINT_OUT:
+                ep_out = ep
+            else:
+                ep_in = ep
+        if ep_out is not None and ep_in is not None:
+            return intf, ep_out, ep_in
+    sys.exit("No vendor interface with bulk OUT and IN endpoints found.")
+
+
+def run(mode, ep_out, ep_in, total, size):
+    data = bytes(i & 0xFF for i in range(size))
+    done = 0
+    start = time.perf_counter()
+    while done < total:
+        if mode in ("out", "loop"):
+            ep_out.write(data, TIMEOUT_MS)
+        if mode in ("in", "loop"):
+            got = ep_in.read(size, TIMEOUT_MS)
+            if mode == "loop" and bytes(got) != data:
+                sys.exit("Loopback data mismatch after %d bytes." % done)
+        done += size
+    return done, time.perf_counter() - start
+
+
+def main():
+    if len(sys.argv) < 4 or sys.argv[3] not in ("out", "in", "loop"):
+        sys.exit(__doc__)
+    vid = int(sys.argv[1], 0)
+    pid = int(sys.argv[2], 0)
+    mode = sys.argv[3]
+    total = int(float(sys.argv[4]) * 1024 * 1024) if len(sys.argv) > 4 else 1024 * 1024
+    size = int(sys.argv[5], 0) if len(sys.argv) > 5 else (256 if mode == "loop" else 4096)
+
+    dev = usb.core.find(idVendor=vid, idProduct=pid)
+    if dev is None:
+        sys.exit("Device %04X:%04X not found." % (vid, pid))
+    intf, ep_out, ep_in = find_endpoints(dev)
+    usb.util.claim_interface(dev, intf)
+    try:
+        done, secs = run(mode, ep_out, ep_in, total, size)
+    finally:
+        usb.util.release_interface(dev, intf)
+        usb.util.dispose_resources(dev)
+
+    print("%s: %d bytes in %.3f s, %.1f KB/s" % (mode, done, secs, done / secs / 1024))
+
+
+if __name__ == "__main__":
+    main()
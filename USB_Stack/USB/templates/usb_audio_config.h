@@ -0,0 +1,96 @@
+/**
+ * @file usb_audio_config.h
+ * @brief <i>Audio Class</i> 1.0 settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Audio Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_AUDIO_CONFIG_H
+#define USB_AUDIO_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* **************************** CAPTURE FORMAT ****************************** */
+/* ************************************************************************** */
+
+#define AUDIO_CHANNELS 1 // 1 (mono) or 2 (stereo), 16-bit PCM samples.
+
+// Sample rate after configuration, and the range the host may select with 
+// SET_CUR SAMPLING_FREQ_CONTROL (continuous range in the format descriptor).
+// Ring buffer length in samples (per channel, up to 255). It lives in USB RAM
+// and packets are sent straight from it, so it needs a max packet of extra 
+// room after it. Streaming starts once it is half full, setting the latency.
+// It must be at least 4 max packets plus 5 samples, and with the mirror it must
+// fit the USB RAM left after the BDT and EP0 (984 bytes on a PIC18F45K50 with
+// two EPs).
+#if AUDIO_CHANNELS == 1
+#define AUDIO_SAMPLE_RATE     48000UL
+#define AUDIO_MIN_SAMPLE_RATE 8000UL
+#define AUDIO_MAX_SAMPLE_RATE 48000UL
+#define AUDIO_RING_SAMPLES    240 // (240 + 49) * 2 = 578 bytes.
+#else
+#define AUDIO_SAMPLE_RATE     32000UL
+#define AUDIO_MIN_SAMPLE_RATE 8000UL
+#define AUDIO_MAX_SAMPLE_RATE 32000UL // 48 kHz stereo needs 1000 bytes.
+#define AUDIO_RING_SAMPLES    160     // (160 + 33) * 4 = 772 bytes.
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** AUDIO INTERFACES **************************** */
+/* ************************************************************************** */
+
+// AudioControl Interface Number
+#define AUDIO_AC_INT 0
+
+// AudioStreaming Interface Number (alt 0 has no EPs, alt 1 has the iso EP)
+#define AUDIO_AS_INT 1
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** AUDIO ENDPOINTS ***************************** */
+/* ************************************************************************** */
+
+// Audio Endpoint HAL (isochronous IN, serviced by the core every frame)
+#define AUDIO_EP EP1
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** AUDIO BD LOCATIONS **************************** */
+/* ************************************************************************** */
+
+#define AUDIO_BD_IN BD1_IN_EVEN // EVEN BD with PINGPONG_1_15/PINGPONG_ALL_EP.
+
+/* ************************************************************************** */
+
+#endif /* USB_AUDIO_CONFIG_H */
@@ -74,6 +74,11 @@
 #define DSR        PORTBbits.RB2
 #define DTR_TRIS   TRISBbits.TRISB1
 
+// Minimum frames (ms) between two SERIAL_STATE notifications of a port, needs
+// USE_SOF and cdc_sof() called from usb_sof(). Line changes in between are
+// merged, only the latest state is sent.
+#define CDC_NOTIFICATION_INTERVAL 16
+
 //#define USE_RTS
 #define RTS_ACTIVE 0
 #define CTS_ACTIVE 0
@@ -84,12 +89,36 @@
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* ******************************* CDC PORTS ******************************** */
+/* ************************************************************************** */
+
+// Number of virtual COM ports (1 to 3). Each port uses two interfaces and two
+// endpoints, so set NUM_INTERFACES and NUM_ENDPOINTS in usb_config.h to match.
+// Use an Interface Association Descriptor for each port when more than one.
+// The 13K50/14K50 and 2450/4450 only have 256 bytes of USB RAM, enough for 
+// one port with 64 byte DAT EPs (usb_cdc.h errors if the buffers don't fit).
+#define CDC_NUM_PORTS 1
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* ***************************** CDC INTERFACE ****************************** */
 /* ************************************************************************** */
 
 // Communication Class Interface Number
 #define CDC_COM_INT 0
+#define CDC_DAT_INT 1
+
+#if CDC_NUM_PORTS > 1
+#define CDC1_COM_INT 2
+#define CDC1_DAT_INT 3
+#endif
+#if CDC_NUM_PORTS > 2
+#define CDC2_COM_INT 4
+#define CDC2_DAT_INT 5
+#endif
 
 /* ************************************************************************** */
 
@@ -104,6 +133,16 @@
 #define CDC_COM_EP_SIZE EP1_SIZE
 #define CDC_DAT_EP_SIZE EP2_SIZE
 
+// Extra ports use the same EP sizes as port 0.
+#if CDC_NUM_PORTS > 1
+#define CDC1_COM_EP EP3
+#define CDC1_DAT_EP EP4
+#endif
+#if CDC_NUM_PORTS > 2
+#define CDC2_COM_EP EP5
+#define CDC2_DAT_EP EP6
+#endif
+
 /* ************************************************************************** */
 
 
@@ -115,6 +154,17 @@
 #define CDC_DAT_BD_OUT BD2_OUT
 #define CDC_DAT_BD_IN  BD2_IN
 
+#if CDC_NUM_PORTS > 1
+#define CDC1_COM_BD_IN  BD3_IN
+#define CDC1_DAT_BD_OUT BD4_OUT
+#define CDC1_DAT_BD_IN  BD4_IN
+#endif
+#if CDC_NUM_PORTS > 2
+#define CDC2_COM_BD_IN  BD5_IN
+#define CDC2_DAT_BD_OUT BD6_OUT
+#define CDC2_DAT_BD_IN  BD6_IN
+#endif
+
 /* ************************************************************************** */
 
 
@@ -125,6 +175,15 @@
 #define CDC_COM_UEPbits UEP1bits
 #define CDC_DAT_UEPbits UEP2bits
 
+#if CDC_NUM_PORTS > 1
+#define CDC1_COM_UEPbits UEP3bits
+#define CDC1_DAT_UEPbits UEP4bits
+#endif
+#if CDC_NUM_PORTS > 2
+#define CDC2_COM_UEPbits UEP5bits
+#define CDC2_DAT_UEPbits UEP6bits
+#endif
+
 /* ************************************************************************** */
 
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+/**
+ * @file usb_cdc_ncm_config.h
+ * @brief <i>Communications Device Class</i> NCM settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - CDC Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef USB_CDC_NCM_CONFIG_H
+#define USB_CDC_NCM_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* ***************************** NTB SETTINGS ******************************* */
+/* ************************************************************************** */
+
+// NTBs are received and built directly in USB RAM, so both buffers plus the
+// BDT and the other EP buffers must fit in the device's USB RAM. They limit
+// frames to NCM_MAX_SEGMENT_SIZE (344 bytes here), see usb_cdc_ncm.h for the
+// host's MTU.
+#define NCM_NTB_OUT_MAX_SIZE  512 // Largest NTB the host may send (dwNtbOutMaxSize).
+#define NCM_NTB_IN_MAX_SIZE   384 // Largest NTB the device will send (dwNtbInMaxSize).
+#define NCM_NTB_IN_MAX_DATAGRAMS 4 // Datagram pointers reserved in each IN NDP.
+
+// Most datagrams the host may put in an OUT NTB (wNtbOutMaxDatagrams). Linux
+// reserves an NDP this size in every NTB it sends (41 entries if it were 0,
+// no limit), which must leave room for a frame of NCM_MAX_SEGMENT_SIZE.
+#define NCM_NTB_OUT_MAX_DATAGRAMS 4
+
+// Frames to wait for more datagrams before an IN NTB is sent (needs USE_SOF
+// and ncm_sof() called from usb_sof()). Without USE_SOF, ncm_flush_tasks()
+// sends whatever has been queued every time it is called while EP IN is idle.
+#define NCM_IN_AGGREGATION_FRAMES 1
+
+// Link speed reported to the host in CONNECTION_SPEED_CHANGE (bits/s).
+#define NCM_LINK_SPEED 12000000UL
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** NCM INTERFACE ****************************** */
+/* ************************************************************************** */
+
+// Communication Class Interface Number
+#define NCM_COM_INT 0
+
+// Data Class Interface Number (alt 0 has no EPs, alt 1 has the bulk EPs)
+#define NCM_DAT_INT 1
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** NCM ENDPOINTS ****************************** */
+/* ************************************************************************** */
+
+// NCM Endpoint HAL
+#define NCM_COM_EP EP1
+#define NCM_DAT_EP EP2
+#define NCM_COM_EP_SIZE EP1_SIZE // 16 for CONNECTION_SPEED_CHANGE.
+#define NCM_DAT_EP_SIZE EP2_SIZE
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** NCM BD LOCATIONS ***************************** */
+/* ************************************************************************** */
+
+#define NCM_COM_BD_IN  BD1_IN
+#define NCM_DAT_BD_OUT BD2_OUT
+#define NCM_DAT_BD_IN  BD2_IN
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* UEPn HAL ********************************* */
+/* ************************************************************************** */
+
+#define NCM_COM_UEPbits UEP1bits
+#define NCM_DAT_UEPbits UEP2bits
+
+/* ************************************************************************** */
+
+#endif /* USB_CDC_NCM_CONFIG_H */
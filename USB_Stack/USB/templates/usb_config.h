@@ -157,4 +157,18 @@
 
 /* ************************************************************************** */
 
+
+/* ************************************************************************** */
+/* ************************** ISOCHRONOUS SETTINGS ************************** */
+/* ************************************************************************** */
+
+/*
+ * NUM_ISO_ENDPOINTS - Isochronous endpoints (one direction each) the core can
+ * service at the start of each frame, see usb_iso_start(). Needs USE_SOF and
+ * _SOFIE, and PINGPONG_1_15 or PINGPONG_ALL_EP to queue a packet ahead.
+ */
+//#define NUM_ISO_ENDPOINTS 1
+
+/* ************************************************************************** */
+
 #endif /* USB_CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ * @file usb_dfu_config.h
+ * @brief <i>DFU</i> settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - DFU Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#ifndef USB_DFU_CONFIG_H
+#define USB_DFU_CONFIG_H
+
+#include "usb_config.h"
+#include <xc.h>
+
+/* ************************************************************************** */
+/* ***************************** DFU INTERFACE ****************************** */
+/* ************************************************************************** */
+
+// DFU Interface Number
+#define DFU_INT 0
+
+// Bytes per DNLOAD/UPLOAD block (wTransferSize), a multiple of the flash 
+// write row. Two blocks of RAM are used, one filling while one is programmed.
+#if defined(_PIC14E)
+#define DFU_TRANSFER_SIZE 64
+#else
+#define DFU_TRANSFER_SIZE 256
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* FLASH SPACE ****************************** */
+/* ************************************************************************** */
+
+// Flash is read and programmed through dfu_read(), dfu_erase() and 
+// dfu_write_block() in main (see DFU_Bootloader_Example for them on flash.c).
+
+// Flash programmed by the download, in flash addresses (words on PIC16). 
+// DFU_APP_START must be at the start of an erase row, everything below it 
+// (the DFU firmware) is never touched.
+#if defined(_PIC14E)
+#define DFU_APP_START 0x1000
+#define DFU_APP_END   _ROMSIZE
+#elif defined(__J_PART)
+#define DFU_APP_START 0x2000
+#define DFU_APP_END   (_ROMSIZE - 0x400) // Last page holds the config words.
+#else
+#define DFU_APP_START 0x2000
+#define DFU_APP_END   _ROMSIZE
+#endif
+
+// Datasheet erase and row write times (ms). Only used until the first erase
+// and write have been timed, bwPollTimeout then follows the measured times.
+#define DFU_ERASE_MS 3
+#define DFU_WRITE_MS 3
+
+/* ************************************************************************** */
+
+#endif /* USB_DFU_CONFIG_H */
@@ -50,6 +50,10 @@
 // Idle_Settings
 #define DEFAULT_IDLE 500 // in mS
 
+// IN Report Queue
+#define HID_IN_QUEUE_SIZE        4 // Reports waiting to be sent, power of 2.
+#define HID_IN_QUEUE_REPORT_SIZE 9 // Largest IN report in bytes, including Report ID.
+
 // HID Endpoint HAL
 #define HID_EP      EP1
 #define HID_EP_SIZE EP1_SIZE
@@ -67,6 +71,48 @@
 
 #define HID_UEPbits UEP1bits
 
+// HID Interfaces (1 to 3). Each has its own interrupt EP, report descriptor and
+// reports, so set NUM_INTERFACES and NUM_ENDPOINTS in usb_config.h to match.
+// Extra interfaces use the same EP size as interface 0. Reports are numbered
+// across all interfaces, interface 0's first, so HID_NUM_*_REPORTS are totals.
+// usb_descriptors.c defines g_hid1_descriptor/g_hid2_descriptor, and the
+// report descriptors come with the reports. Tools/gen_hid_reports.py makes
+// them and the HIDn_NUM_* counts from a spec with "interface" lines, leave the
+// counts out here when it's used (see HID_Keyboard_Examples).
+#define HID_NUM_INTERFACES 1
+#define HID_INT            0
+
+#if HID_NUM_INTERFACES > 1
+#define HID1_INT                 1
+#define HID1_EP                  EP2
+#define HID1_BD_OUT              BD2_OUT
+#define HID1_BD_OUT_EVEN         BD2_OUT_EVEN
+#define HID1_BD_OUT_ODD          BD2_OUT_ODD
+#define HID1_BD_IN               BD2_IN
+#define HID1_BD_IN_EVEN          BD2_IN_EVEN
+#define HID1_BD_IN_ODD           BD2_IN_ODD
+#define HID1_UEPbits             UEP2bits
+#define HID1_NUM_IN_REPORTS      1
+#define HID1_NUM_OUT_REPORTS     0
+#define HID1_NUM_FEATURE_REPORTS 0
+#define HID1_NUM_REPORT_IDS      0
+#endif
+#if HID_NUM_INTERFACES > 2
+#define HID2_INT                 2
+#define HID2_EP                  EP3
+#define HID2_BD_OUT              BD3_OUT
+#define HID2_BD_OUT_EVEN         BD3_OUT_EVEN
+#define HID2_BD_OUT_ODD          BD3_OUT_ODD
+#define HID2_BD_IN               BD3_IN
+#define HID2_BD_IN_EVEN          BD3_IN_EVEN
+#define HID2_BD_IN_ODD           BD3_IN_ODD
+#define HID2_UEPbits             UEP3bits
+#define HID2_NUM_IN_REPORTS      1
+#define HID2_NUM_OUT_REPORTS     0
+#define HID2_NUM_FEATURE_REPORTS 0
+#define HID2_NUM_REPORT_IDS      0
+#endif
+
 #if defined(HID_KEYBOARD_EXAMPLE)
 #define HID_NUM_IN_REPORTS       2
 #define HID_NUM_OUT_REPORTS      1
@@ -95,7 +141,8 @@
 #define HID_NUM_REPORT_IDS 0
 
 #else
-// MAKE YOUR OWN
+// MAKE YOUR OWN, or include the usb_hid_reports.h made by 
+// Tools/gen_hid_reports.py, which defines these from a report spec.
 #endif
 
 // KEY MODIFIERS
@@ -0,0 +1,59 @@
+/**
+ * @file usb_vfat_config.h
+ * @brief <i>Virtual FAT volume</i> settings.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MSD Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_VFAT_CONFIG_H
+#define USB_VFAT_CONFIG_H
+
+#include "usb_config.h"
+
+/* ************************************************************************** */
+/* **************************** VFAT SETTINGS ******************************* */
+/* ************************************************************************** */
+
+// Files in g_vfat_files[], listed in the root directory in table order.
+#define VFAT_NUM_FILES 2
+
+// Cluster size. Power of 2, VOL_CAPACITY_IN_BLOCKS / VFAT_SECTORS_PER_CLUSTER 
+// must land between 4085 and 65524 clusters (the volume is always FAT16).
+#define VFAT_SECTORS_PER_CLUSTER 1
+
+// Root directory entries, multiple of 16. Needs one for the volume label plus 
+// one per file.
+#define VFAT_ROOT_ENTRIES 16
+
+#define VFAT_VOLUME_LABEL 'U','S','B',' ','D','R','I','V','E',' ',' '
+#define VFAT_VOLUME_ID    0x56A3E886UL
+
+// Time stamp given to every file.
+#define VFAT_DATE (((2026 - 1980) << 9) | (10 << 5) | 18) // Year since 1980, month, day.
+#define VFAT_TIME ((12 << 11) | (0 << 5) | (0 / 2))         // Hours, minutes, seconds / 2.
+
+/* ************************************************************************** */
+
+#endif /* USB_VFAT_CONFIG_H */
@@ -134,6 +134,11 @@ static bool                m_send_short;
 static uint16_t            m_bytes_2_recv;
 static uint16_t            m_bytes_2_send;
 
+#ifdef NUM_ISO_ENDPOINTS
+static usb_iso_ep_t*       m_iso_eps[NUM_ISO_ENDPOINTS];
+static uint16_t            m_sync_frame;
+#endif
+
 /* ************************************************************************** */
 
 
@@ -256,6 +261,39 @@ static void set_interface(void);
  */
 static void sync_frame(void);
 
+#ifdef NUM_ISO_ENDPOINTS
+/**
+ * @fn uint8_t iso_find(uint8_t ep, uint8_t dir)
+ * 
+ * @brief Finds a started isochronous endpoint.
+ * 
+ * @param[in] ep Endpoint number.
+ * @param[in] dir Direction.
+ * 
+ * @return Index in m_iso_eps, or NUM_ISO_ENDPOINTS if there isn't one.
+ */
+static uint8_t iso_find(uint8_t ep, uint8_t dir);
+
+/**
+ * @fn void iso_frame(void)
+ * 
+ * @brief Services the isochronous endpoints at the start of each frame.
+ * 
+ * Free IN BDs are filled and armed in ping-pong order, received OUT BDs are 
+ * handed to the application and re-armed. Last_PPB holds the last BD serviced.
+ */
+static void iso_frame(void);
+
+/**
+ * @fn void iso_service(usb_iso_ep_t* p_iso)
+ * 
+ * @brief Services the BDs of one isochronous endpoint the SIE has finished with.
+ * 
+ * @param[in] p_iso Isochronous endpoint.
+ */
+static void iso_service(usb_iso_ep_t* p_iso);
+#endif
+
 /* ************************************************************************** */
 
 
@@ -374,6 +412,9 @@ void usb_tasks(void)
     #ifdef USE_SOF
     if(SOF_FLAG)
     {
+        #ifdef NUM_ISO_ENDPOINTS
+        if(m_usb_state == STATE_CONFIGURED) iso_frame();
+        #endif
         usb_sof();
         SOF_FLAG = 0;
     }
@@ -398,6 +439,9 @@ void usb_tasks(void)
         
         if(TRANSACTION_EP != EP0)
         {
+            #ifdef NUM_ISO_ENDPOINTS
+            if(iso_find(TRANSACTION_EP, TRANSACTION_DIR) != NUM_ISO_ENDPOINTS) return; // Serviced by iso_frame().
+            #endif
             usb_app_tasks();
             return;
         }
@@ -467,6 +511,66 @@ void usb_arm_ep0_in(uint8_t cnt)
 }
 #endif
 
+#ifdef NUM_ISO_ENDPOINTS
+void usb_arm_iso_endpoint(bd_t* p_bd, uint16_t cnt)
+{
+    p_bd->STAT  = (uint8_t)(cnt >> 8); // BC9:BC8, DATA0 without DTSEN.
+    p_bd->CNT   = (uint8_t)cnt;
+    p_bd->STAT |= _UOWN;
+}
+
+bool usb_iso_start(usb_iso_ep_t* p_iso)
+{
+    volatile uint8_t* p_uep = &USB_EP0_CONTROL_REGISTER + p_iso->EP; // UEPn registers are consecutive.
+    uint8_t i;
+    uint8_t slot = NUM_ISO_ENDPOINTS;
+    
+    if(p_iso->Size > ISO_MAX_SIZE) return false;
+    
+    for(i = 0; i < NUM_ISO_ENDPOINTS; i++)
+    {
+        if(m_iso_eps[i] == p_iso) break;
+        if(m_iso_eps[i] == 0 && slot == NUM_ISO_ENDPOINTS) slot = i;
+    }
+    if(i == NUM_ISO_ENDPOINTS)
+    {
+        if(slot == NUM_ISO_ENDPOINTS) return false;
+        m_iso_eps[slot] = p_iso;
+    }
+    
+    for(i = 0; i < ISO_NUM_BD; i++)
+    {
+        g_usb_bd_table[p_iso->BD + i].STAT = 0;
+        g_usb_bd_table[p_iso->BD + i].ADR  = (uint16_t)p_iso->Buffers[i];
+    }
+    
+    // No handshake, the host doesn't retry isochronous transactions.
+    *p_uep = (uint8_t)((*p_uep & ~_EPHSHK) | _EPCONDIS | (p_iso->Dir == IN ? _EPINEN : _EPOUTEN));
+    
+    p_iso->Underruns = 0;
+    p_iso->Overruns  = 0;
+    p_iso->Running   = true;
+    iso_service(p_iso);
+    return true;
+}
+
+void usb_iso_stop(usb_iso_ep_t* p_iso)
+{
+    bd_t* p_bd = &g_usb_bd_table[p_iso->BD];
+    
+    if(!p_iso->Running) return;
+    p_iso->Running = false;
+    
+    #if ISO_NUM_BD == 2
+    // The SIE's ping-pong pointer is on the oldest BD it still owns. Step 
+    // Last_PPB back once for each BD taken off it, so the next start agrees.
+    if(p_bd[EVEN].STATbits.UOWN ^ p_bd[ODD].STATbits.UOWN) g_usb_ep_stat[p_iso->EP][p_iso->Dir].Last_PPB ^= 1;
+    p_bd[ODD].STAT = 0;
+    #endif
+    p_bd[EVEN].STAT = 0;
+}
+#endif
+
 void usb_arm_status(bd_t* p_bd)
 {
     p_bd->CNT   = 0;
@@ -707,6 +811,10 @@ static void usb_restart(void)
     // Clear EP statuses
     usb_ram_set(0, (uint8_t*)g_usb_ep_stat, EP_STAT_SIZE);
     
+    #ifdef NUM_ISO_ENDPOINTS
+    usb_ram_set(0, (uint8_t*)m_iso_eps, sizeof(m_iso_eps));
+    #endif
+    
     #if PINGPONG_MODE != PINGPONG_DIS
     // Last_PPB starts on ODD
     for(uint8_t i = 0; i < NUM_ENDPOINTS; i++)
@@ -1128,6 +1236,9 @@ static void set_configuration(void)
             g_usb_ep_stat[i][1].Last_PPB = ODD;
         }
         #endif
+        #ifdef NUM_ISO_ENDPOINTS
+        usb_ram_set(0, (uint8_t*)m_iso_eps, sizeof(m_iso_eps));
+        #endif
         usb_arm_in_status();
         m_control_stage = STATUS_IN_STAGE;
         
@@ -1183,7 +1294,7 @@ static void get_interface(void)
         }
         #else
         m_ep0_in[0] = get_interface_return;
-        usb_arm_ep0_in(BD0_IN, 1);
+        usb_arm_ep0_in(1);
         #endif
     #endif
         m_control_stage = DATA_IN_STAGE;
@@ -1206,7 +1317,98 @@ static void set_interface(void)
 
 static void sync_frame(void)
 {
+    #ifdef NUM_ISO_ENDPOINTS
+    // Reports the current frame number for an isochronous endpoint.
+    if(m_usb_state == STATE_CONFIGURED && iso_find(g_usb_setup.wIndex & 0x0F, (g_usb_setup.wIndex >> 7) & 1) != NUM_ISO_ENDPOINTS)
+    {
+        m_sync_frame = ((uint16_t)UFRMH << 8) | UFRML;
+        usb_set_ram_ptr((uint8_t*)&m_sync_frame);
+        usb_setup_in_control_transfer(RAM, 2, g_usb_setup.wLength);
+        usb_in_control_transfer();
+        m_control_stage = DATA_IN_STAGE;
+        return;
+    }
+    #endif
     usb_request_error();
 }
 
+#ifdef NUM_ISO_ENDPOINTS
+static uint8_t iso_find(uint8_t ep, uint8_t dir)
+{
+    uint8_t i;
+    
+    for(i = 0; i < NUM_ISO_ENDPOINTS; i++)
+    {
+        if(m_iso_eps[i] != 0 && m_iso_eps[i]->EP == ep && m_iso_eps[i]->Dir == dir) break;
+    }
+    return i;
+}
+
+static void iso_frame(void)
+{
+    usb_iso_ep_t* p_iso;
+    #if ISO_NUM_BD == 2
+    bd_t*         p_bd;
+    #endif
+    uint8_t       i;
+    
+    for(i = 0; i < NUM_ISO_ENDPOINTS; i++)
+    {
+        p_iso = m_iso_eps[i];
+        if(p_iso == 0 || !p_iso->Running) continue;
+        
+        #if ISO_NUM_BD == 2
+        // One BD is used per frame. Both done with means a frame went by 
+        // without one armed for it.
+        p_bd = &g_usb_bd_table[p_iso->BD];
+        if(!p_bd[EVEN].STATbits.UOWN && !p_bd[ODD].STATbits.UOWN)
+        {
+            if(p_iso->Dir == IN) p_iso->Underruns++;
+            else p_iso->Overruns++;
+        }
+        #endif
+        iso_service(p_iso);
+    }
+}
+
+static void iso_service(usb_iso_ep_t* p_iso)
+{
+    usb_ep_stat_t* p_ep_stat = &g_usb_ep_stat[p_iso->EP][p_iso->Dir];
+    bd_t*          p_bd;
+    uint8_t*       p_data;
+    uint8_t        ppb;
+    uint16_t       cnt;
+    
+    while(1)
+    {
+        #if ISO_NUM_BD == 2
+        ppb = p_ep_stat->Last_PPB ^ 1;
+        #else
+        ppb = 0;
+        #endif
+        p_bd = &g_usb_bd_table[p_iso->BD + ppb];
+        if(p_bd->STATbits.UOWN) return;
+        
+        if(p_iso->Dir == IN)
+        {
+            p_data = p_iso->Buffers[ppb];
+            cnt = usb_iso_in(p_iso->EP, &p_data);
+            if(cnt > p_iso->Size) cnt = p_iso->Size;
+            p_bd->ADR = (uint16_t)p_data;
+        }
+        else
+        {
+            // BDs are armed without data in usb_iso_start().
+            if(p_bd->STAT != 0) usb_iso_out(p_iso->EP, p_iso->Buffers[ppb], ((uint16_t)(p_bd->STAT & 0x03) << 8) | p_bd->CNT);
+            cnt = p_iso->Size;
+        }
+        usb_arm_iso_endpoint(p_bd, cnt);
+        p_ep_stat->Last_PPB = ppb;
+        #if ISO_NUM_BD == 1
+        return; // Armed for this frame.
+        #endif
+    }
+}
+#endif
+
 /* ************************************************************************** */
\ No newline at end of file
@@ -222,6 +222,27 @@
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* ************************ ISOCHRONOUS ENDPOINTS *************************** */
+/* ************************************************************************** */
+
+#ifdef NUM_ISO_ENDPOINTS
+#ifndef USE_SOF
+#error "Isochronous endpoints are serviced each frame, define USE_SOF and add _SOFIE to INTERRUPTS_MASK."
+#endif
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define ISO_NUM_BD 2 // EVEN and ODD, one packet is queued ahead of the host.
+#else
+#warning "Without ping-pong buffering for EP1-15, each isochronous packet is armed in the frame it is sent."
+#define ISO_NUM_BD 1
+#endif
+#endif
+
+#define ISO_MAX_SIZE 1023 // Full-speed maximum packet size.
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* **************************** EP STATUS SIZE ****************************** */
 /* ************************************************************************** */
@@ -272,6 +293,22 @@ typedef struct
     unsigned      :1;
 }usb_ustat_t;
 
+
+#ifdef NUM_ISO_ENDPOINTS
+/** Isochronous Endpoint Type */
+typedef struct
+{
+    uint8_t  EP;
+    uint8_t  Dir;
+    uint8_t  BD;                       // BD index, the EVEN BD with ping-pong.
+    uint16_t Size;                     // Max packet size (up to ISO_MAX_SIZE).
+    uint8_t* Buffers[ISO_NUM_BD];      // EVEN then ODD.
+    bool     Running;
+    uint16_t Underruns;                // Frames the IN BDs were found empty (ping-pong only).
+    uint16_t Overruns;                 // Frames the OUT BDs were found full (ping-pong only).
+}usb_iso_ep_t;
+#endif
+
 /* ************************************************************************** */
 
 
@@ -580,6 +617,88 @@ void usb_set_ram_ptr(uint8_t* data);
  */
 void usb_set_rom_ptr(const uint8_t* data);
 
+#ifdef NUM_ISO_ENDPOINTS
+/**
+ * @fn void usb_arm_iso_endpoint(bd_t* p_bd, uint16_t cnt)
+ * 
+ * @brief Arms an isochronous OUT/IN Endpoint for a transaction.
+ * 
+ * Isochronous data is always DATA0 and has no data toggle synchronization. 
+ * Counts above 255 use the BC9:BC8 bits of the BD.
+ * 
+ * @param[in] p_bd Buffer Descriptor pointer.
+ * @param[in] cnt Amount of data being transfered (up to ISO_MAX_SIZE).
+ */
+void usb_arm_iso_endpoint(bd_t* p_bd, uint16_t cnt);
+
+/**
+ * @fn bool usb_iso_start(usb_iso_ep_t* p_iso)
+ * 
+ * @brief Starts servicing an isochronous endpoint every frame.
+ * 
+ * The endpoint is set up without handshaking, so the other direction of the 
+ * same endpoint number must also be isochronous or unused. IN buffers are 
+ * filled straight away through usb_iso_in() and OUT buffers are armed. 
+ * Normally called from usb_app_set_interface() when an alternate setting with 
+ * bandwidth is selected. Endpoints are forgotten on reset and SET_CONFIGURATION.
+ * 
+ * @param[in] p_iso Isochronous endpoint, kept by the caller.
+ * 
+ * @return Returns false if the size is too large or NUM_ISO_ENDPOINTS are in use.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * static usb_iso_ep_t m_audio_in = {EP1, IN, BD1_IN_EVEN, 48, {m_audio_even, m_audio_odd}};
+ * 
+ * if(alternate_setting == 1) usb_iso_start(&m_audio_in);
+ * else usb_iso_stop(&m_audio_in);
+ * @endcode
+ * </li></ul>
+ */
+bool usb_iso_start(usb_iso_ep_t* p_iso);
+
+/**
+ * @fn void usb_iso_stop(usb_iso_ep_t* p_iso)
+ * 
+ * @brief Stops servicing an isochronous endpoint and takes its BDs back.
+ * 
+ * Packets still armed are dropped.
+ * 
+ * @param[in] p_iso Isochronous endpoint.
+ */
+void usb_iso_stop(usb_iso_ep_t* p_iso);
+
+/**
+ * @fn uint16_t usb_iso_in(uint8_t ep, uint8_t** p_buffer)
+ * 
+ * @brief Is called when an isochronous IN buffer is free, to fill it.
+ * 
+ * Runs from the SOF handler (and usb_iso_start()), so it should only copy 
+ * data that is ready. Returning 0 sends a zero-length packet.
+ * 
+ * @param[in] ep Endpoint number.
+ * @param[in,out] p_buffer Points to the endpoint's buffer to fill. It can 
+ * instead be pointed at data already in USB RAM, which is then sent in place.
+ * 
+ * @return Amount of bytes in the packet.
+ */
+uint16_t usb_iso_in(uint8_t ep, uint8_t** p_buffer);
+
+/**
+ * @fn void usb_iso_out(uint8_t ep, uint8_t* buffer, uint16_t cnt)
+ * 
+ * @brief Is called from the SOF handler for each isochronous OUT packet received.
+ * 
+ * The buffer is re-armed when the function returns.
+ * 
+ * @param[in] ep Endpoint number.
+ * @param[in] buffer Received data.
+ * @param[in] cnt Amount of bytes received.
+ */
+void usb_iso_out(uint8_t ep, uint8_t* buffer, uint16_t cnt);
+#endif
+
 // TODO: descriptions for these
 // USER FUNCTIONS TO PLACE IN MAIN
 void usb_reset(void);
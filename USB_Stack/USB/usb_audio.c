@@ -0,0 +1,332 @@
+/**
+ * @file usb_audio.c
+ * @brief <i>Audio Class</i> 1.0 capture function core.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Audio Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_audio.h"
+#include "usb_ch9.h"
+
+/* ************************************************************************** */
+/* ***************************** RING SETTINGS ****************************** */
+/* ************************************************************************** */
+
+// Samples the producer may hold. Up to two packets are still armed behind the
+// tail, so they are kept out of its reach.
+#define AUDIO_RING_USABLE (AUDIO_RING_SAMPLES - 1 - (AUDIO_MAX_PACKET_SAMPLES * 2))
+#define AUDIO_RING_TARGET (AUDIO_RING_USABLE / 2)
+#define AUDIO_RING_SLACK  2 // Samples either side of the target before a packet is resized.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** GLOBAL VARIABLES ***************************** */
+/* ************************************************************************** */
+
+volatile uint16_t g_audio_underruns;
+volatile uint16_t g_audio_overruns;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+static int16_t m_ring[(AUDIO_RING_SAMPLES + AUDIO_MAX_PACKET_SAMPLES) * AUDIO_CHANNELS] __at(AUDIO_RING_BASE_ADDR);
+static volatile uint8_t m_head; // Next sample written, moved by audio_put() only.
+static volatile uint8_t m_tail; // Next sample sent, moved by audio_iso_in() only.
+static volatile bool    m_streaming;
+static bool             m_primed;
+
+static usb_iso_ep_t m_iso_in;
+
+static uint32_t m_rate;
+static uint8_t  m_rate_int;  // Whole samples per frame.
+static uint16_t m_rate_rem;  // Remaining thousandths of a sample per frame.
+static uint16_t m_rate_acc;
+static uint8_t  m_rate_request[3];
+static bool     m_rate_wait;
+static uint8_t  m_alt_setting;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************* LOCAL FUNCTION DECLARATIONS ************************ */
+/* ************************************************************************** */
+
+/**
+ * @fn uint8_t ring_used(void)
+ * 
+ * @brief Returns the amount of samples in the ring buffer waiting to be sent.
+ */
+static uint8_t ring_used(void);
+
+/**
+ * @fn void set_rate(uint32_t rate)
+ * 
+ * @brief Sets the sample rate and the packet size it needs each frame.
+ * 
+ * @param[in] rate Sample rate in Hz.
+ */
+static void set_rate(uint32_t rate);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** AUDIO FUNCTIONS ***************************** */
+/* ************************************************************************** */
+
+bool audio_class_request(void)
+{
+    uint32_t rate;
+    
+    if(g_usb_setup.bmRequestType_bits.Recipient != ENDPOINT) return false;
+    if((uint8_t)g_usb_setup.wIndex != (AUDIO_EP | 0x80)) return false;
+    if((g_usb_setup.wValue >> 8) != AUDIO_SAMPLING_FREQ_CONTROL) return false;
+    
+    switch(g_usb_setup.bRequest)
+    {
+        case AUDIO_SET_CUR:
+            if(g_usb_setup.wLength != 3) return false;
+            usb_set_ram_ptr(m_rate_request);
+            usb_set_num_out_control_bytes(3);
+            m_rate_wait = true;
+            usb_set_control_stage(DATA_OUT_STAGE);
+            return true;
+        case AUDIO_GET_CUR:
+            rate = m_rate;
+            break;
+        case AUDIO_GET_MIN:
+            rate = AUDIO_MIN_SAMPLE_RATE;
+            break;
+        case AUDIO_GET_MAX:
+            rate = AUDIO_MAX_SAMPLE_RATE;
+            break;
+        case AUDIO_GET_RES:
+            rate = 1;
+            break;
+        default:
+            return false;
+    }
+    m_rate_request[0] = (uint8_t)rate;
+    m_rate_request[1] = (uint8_t)(rate >> 8);
+    m_rate_request[2] = (uint8_t)(rate >> 16);
+    usb_set_ram_ptr(m_rate_request);
+    usb_setup_in_control_transfer(RAM, 3, g_usb_setup.wLength);
+    usb_in_control_transfer();
+    usb_set_control_stage(DATA_IN_STAGE);
+    return true;
+}
+
+bool audio_out_control_tasks(void)
+{
+    uint32_t rate;
+    
+    if(!m_rate_wait) return false;
+    m_rate_wait = false;
+    
+    rate = ((uint32_t)m_rate_request[2] << 16) | ((uint16_t)m_rate_request[1] << 8) | m_rate_request[0];
+    if(rate < AUDIO_MIN_SAMPLE_RATE || rate > AUDIO_MAX_SAMPLE_RATE) return false;
+    if(!audio_sample_rate_changed(rate)) return false;
+    set_rate(rate);
+    return true;
+}
+
+void audio_init(void)
+{
+    m_streaming   = false;
+    m_alt_setting = 0;
+    m_rate_wait   = false;
+    
+    // Packets are sent straight from the ring, usb_iso_in() gives the address.
+    m_iso_in.EP         = AUDIO_EP;
+    m_iso_in.Dir        = IN;
+    m_iso_in.BD         = AUDIO_BD_IN;
+    m_iso_in.Size       = AUDIO_EP_SIZE;
+    m_iso_in.Buffers[0] = (uint8_t*)m_ring; // EVEN
+    m_iso_in.Buffers[1] = (uint8_t*)m_ring; // ODD
+    m_iso_in.Running    = false; // The core forgets iso EPs on SET_CONFIGURATION.
+    
+    g_audio_underruns = 0;
+    g_audio_overruns  = 0;
+    
+    if(m_rate != AUDIO_SAMPLE_RATE) audio_sample_rate_changed(AUDIO_SAMPLE_RATE);
+    set_rate(AUDIO_SAMPLE_RATE);
+}
+
+bool audio_set_interface(uint8_t alternate_setting, uint8_t interface)
+{
+    if(interface == AUDIO_AC_INT) return alternate_setting == 0;
+    if(interface != AUDIO_AS_INT || alternate_setting > 1) return false;
+    
+    m_streaming = false;
+    usb_iso_stop(&m_iso_in);
+    m_alt_setting = alternate_setting;
+    if(alternate_setting == 0) return true;
+    
+    // Empty ring, ZLPs are sent until it is half full.
+    m_head     = 0;
+    m_tail     = 0;
+    m_primed   = false;
+    m_rate_acc = 0;
+    m_streaming = true;
+    return usb_iso_start(&m_iso_in);
+}
+
+bool audio_get_interface(uint8_t* alternate_setting_result, uint8_t interface)
+{
+    if(interface == AUDIO_AC_INT) *alternate_setting_result = 0;
+    else if(interface == AUDIO_AS_INT) *alternate_setting_result = m_alt_setting;
+    else return false;
+    return true;
+}
+
+uint16_t audio_iso_in(uint8_t** p_buffer)
+{
+    uint8_t used = ring_used();
+    uint8_t samples = m_rate_int;
+    uint16_t tail;
+    
+    m_rate_acc += m_rate_rem;
+    if(m_rate_acc >= 1000)
+    {
+        m_rate_acc -= 1000;
+        samples++;
+    }
+    
+    if(!m_primed)
+    {
+        if(used < AUDIO_RING_TARGET) return 0;
+        m_primed = true;
+    }
+    
+    // Follow the ADC's clock by holding the ring around its target.
+    if(used > AUDIO_RING_TARGET + AUDIO_RING_SLACK && samples < AUDIO_MAX_PACKET_SAMPLES) samples++;
+    else if(used < AUDIO_RING_TARGET - AUDIO_RING_SLACK && samples > 1) samples--;
+    
+    if(samples > used)
+    {
+        samples = used;
+        g_audio_underruns++;
+    }
+    
+    // Sent in place, the mirror after the ring keeps the packet contiguous.
+    *p_buffer = (uint8_t*)&m_ring[m_tail * AUDIO_CHANNELS];
+    tail = (uint16_t)m_tail + samples;
+    if(tail >= AUDIO_RING_SAMPLES) tail -= AUDIO_RING_SAMPLES;
+    m_tail = (uint8_t)tail;
+    return (uint16_t)samples * AUDIO_SAMPLE_BYTES;
+}
+
+bool audio_streaming(void)
+{
+    return m_streaming;
+}
+
+uint32_t audio_get_sample_rate(void)
+{
+    return m_rate;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+static uint8_t ring_used(void)
+{
+    uint8_t head = m_head;
+    
+    if(head >= m_tail) return head - m_tail;
+    return (uint8_t)(head + (AUDIO_RING_SAMPLES - m_tail));
+}
+
+static void set_rate(uint32_t rate)
+{
+    m_rate     = rate;
+    m_rate_int = (uint8_t)(rate / 1000);
+    m_rate_rem = (uint16_t)(rate % 1000);
+    m_rate_acc = 0;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+#if AUDIO_CHANNELS == 1
+bool audio_put(int16_t sample)
+{
+    uint8_t head = m_head;
+    
+    if(!m_streaming) return false;
+    if(ring_used() >= AUDIO_RING_USABLE)
+    {
+        g_audio_overruns++;
+        return false;
+    }
+    
+    m_ring[head] = sample;
+    if(head < AUDIO_MAX_PACKET_SAMPLES) m_ring[AUDIO_RING_SAMPLES + head] = sample;
+    m_head = (head == AUDIO_RING_SAMPLES - 1) ? 0 : head + 1;
+    return true;
+}
+#else
+bool audio_put_stereo(int16_t left, int16_t right)
+{
+    uint8_t head = m_head;
+    
+    if(!m_streaming) return false;
+    if(ring_used() >= AUDIO_RING_USABLE)
+    {
+        g_audio_overruns++;
+        return false;
+    }
+    
+    m_ring[head * 2]     = left;
+    m_ring[head * 2 + 1] = right;
+    if(head < AUDIO_MAX_PACKET_SAMPLES)
+    {
+        m_ring[(AUDIO_RING_SAMPLES + head) * 2]     = left;
+        m_ring[(AUDIO_RING_SAMPLES + head) * 2 + 1] = right;
+    }
+    m_head = (head == AUDIO_RING_SAMPLES - 1) ? 0 : head + 1;
+    return true;
+}
+#endif
+
+/* ************************************************************************** */
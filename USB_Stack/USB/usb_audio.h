@@ -0,0 +1,432 @@
+/**
+ * @file usb_audio.h
+ * @brief <i>Audio Class</i> 1.0 capture function definitions, structures, and functions.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Audio Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_AUDIO_H
+#define USB_AUDIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_config.h"
+#include "usb_audio_config.h"
+#include "usb_hal.h"
+
+/* ************************************************************************** */
+/* ************************* RAM AND MODE CHECKS **************************** */
+/* ************************************************************************** */
+
+#ifdef _PIC14E
+#error "The audio ring buffer needs more USB RAM than PIC16F145X devices have."
+#endif
+
+#ifndef NUM_ISO_ENDPOINTS
+#error "Audio streams on an isochronous EP, define NUM_ISO_ENDPOINTS in usb_config.h."
+#endif
+
+#if PINGPONG_MODE == PINGPONG_1_15
+#define AUDIO_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*2))
+#elif PINGPONG_MODE == PINGPONG_ALL_EP
+#define AUDIO_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*4))
+#else
+#error "Audio packets are queued a frame ahead, use PINGPONG_1_15 or PINGPONG_ALL_EP."
+#endif
+
+#if AUDIO_CHANNELS != 1 && AUDIO_CHANNELS != 2
+#error "AUDIO_CHANNELS must be 1 or 2."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** AUDIO PACKET SIZES **************************** */
+/* ************************************************************************** */
+
+#define AUDIO_SAMPLE_BYTES (AUDIO_CHANNELS * 2)
+
+// Samples in a frame at the max rate, plus one for rate matching.
+#define AUDIO_MAX_PACKET_SAMPLES (((AUDIO_MAX_SAMPLE_RATE + 999) / 1000) + 1)
+#define AUDIO_EP_SIZE            (AUDIO_MAX_PACKET_SAMPLES * AUDIO_SAMPLE_BYTES) // wMaxPacketSize
+
+#if AUDIO_RING_SAMPLES > 255
+#error "AUDIO_RING_SAMPLES must fit an 8 bit index (up to 255)."
+#endif
+
+// Two packets stay armed behind the tail and the ring is held around half of 
+// the rest, which has to cover a max packet and the 2 samples of slack either 
+// side of it, or every packet would come up short.
+#if AUDIO_RING_SAMPLES < ((AUDIO_MAX_PACKET_SAMPLES * 4) + 5)
+#error "AUDIO_RING_SAMPLES must be at least 4 max packets plus 5 samples."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************* AUDIO BUFFER ADDRESSES ************************* */
+/* ************************************************************************** */
+
+// The audio EP has no buffers of its own, its BDs point into the ring buffer.
+// The first max packet of the ring is mirrored after its end, so a packet 
+// starting near the end is still contiguous.
+#define AUDIO_RING_BASE_ADDR AUDIO_EP_BUFFERS_STARTING_ADDR
+#define AUDIO_RING_BYTES    ((AUDIO_RING_SAMPLES + AUDIO_MAX_PACKET_SAMPLES) * AUDIO_SAMPLE_BYTES)
+
+#if (AUDIO_RING_BASE_ADDR + AUDIO_RING_BYTES) > USB_RAM_END_ADDR
+#error "The audio ring buffer runs past USB RAM, lower AUDIO_RING_SAMPLES, AUDIO_MAX_SAMPLE_RATE or AUDIO_CHANNELS."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** AUDIO CLASS CODES ***************************** */
+/* ************************************************************************** */
+
+// Audio Interface Subclass Codes
+#define AUDIO_SUBCLASS_CONTROL   0x01
+#define AUDIO_SUBCLASS_STREAMING 0x02
+
+// Class-Specific Descriptor Types
+#define AUDIO_CS_INTERFACE 0x24
+#define AUDIO_CS_ENDPOINT  0x25
+
+// AudioControl Interface Descriptor Subtypes
+#define AUDIO_AC_HEADER          0x01
+#define AUDIO_AC_INPUT_TERMINAL  0x02
+#define AUDIO_AC_OUTPUT_TERMINAL 0x03
+
+// AudioStreaming Interface Descriptor Subtypes
+#define AUDIO_AS_GENERAL     0x01
+#define AUDIO_AS_FORMAT_TYPE 0x02
+
+// Class-Specific Endpoint Descriptor Subtype
+#define AUDIO_EP_GENERAL 0x01
+
+// Terminal Types
+#define AUDIO_TERMINAL_USB_STREAMING 0x0101
+#define AUDIO_TERMINAL_MICROPHONE    0x0201
+
+// Format
+#define AUDIO_FORMAT_TYPE_I 0x01
+#define AUDIO_FORMAT_PCM    0x0001
+
+// Isochronous EP bmAttributes (asynchronous, the device's sample clock sets the pace)
+#define AUDIO_EP_ATTRIBUTES 0x05
+
+// Class-Specific EP bmAttributes
+#define AUDIO_EP_SAMPLING_FREQ_CONTROL 0x01
+
+// 3 byte sample rate for descriptors.
+#define AUDIO_RATE_BYTES(rate) (uint8_t)(rate), (uint8_t)((rate) >> 8), (uint8_t)((rate) >> 16)
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** AUDIO REQUESTS ***************************** */
+/* ************************************************************************** */
+
+#define AUDIO_SET_CUR 0x01
+#define AUDIO_GET_CUR 0x81
+#define AUDIO_GET_MIN 0x82
+#define AUDIO_GET_MAX 0x83
+#define AUDIO_GET_RES 0x84
+
+// Endpoint Control Selectors
+#define AUDIO_SAMPLING_FREQ_CONTROL 0x01
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TYPES ********************************** */
+/* ************************************************************************** */
+
+// Class-Specific AC Interface Header Descriptor (one streaming interface)
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint16_t bcdADC;
+    uint16_t wTotalLength;
+    uint8_t  bInCollection;
+    uint8_t  baInterfaceNr;
+}audio_ac_header_descriptor_t;
+
+// Input Terminal Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bTerminalID;
+    uint16_t wTerminalType;
+    uint8_t  bAssocTerminal;
+    uint8_t  bNrChannels;
+    uint16_t wChannelConfig;
+    uint8_t  iChannelNames;
+    uint8_t  iTerminal;
+}audio_input_terminal_descriptor_t;
+
+// Output Terminal Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bTerminalID;
+    uint16_t wTerminalType;
+    uint8_t  bAssocTerminal;
+    uint8_t  bSourceID;
+    uint8_t  iTerminal;
+}audio_output_terminal_descriptor_t;
+
+// Class-Specific AS Interface Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bTerminalLink;
+    uint8_t  bDelay;
+    uint16_t wFormatTag;
+}audio_as_general_descriptor_t;
+
+// Type I Format Type Descriptor (continuous sample rate range)
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bFormatType;
+    uint8_t  bNrChannels;
+    uint8_t  bSubframeSize;
+    uint8_t  bBitResolution;
+    uint8_t  bSamFreqType;
+    uint8_t  tLowerSamFreq[3];
+    uint8_t  tUpperSamFreq[3];
+}audio_format_type_i_descriptor_t;
+
+// Standard AS Isochronous Endpoint Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bEndpointAddress;
+    uint8_t  bmAttributes;
+    uint16_t wMaxPacketSize;
+    uint8_t  bInterval;
+    uint8_t  bRefresh;
+    uint8_t  bSynchAddress;
+}audio_iso_endpoint_descriptor_t;
+
+// Class-Specific AS Isochronous Endpoint Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bmAttributes;
+    uint8_t  bLockDelayUnits;
+    uint16_t wLockDelay;
+}audio_cs_iso_endpoint_descriptor_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ VARS FROM: usb_audio.c ************************** */
+/* ************************************************************************** */
+
+extern volatile uint16_t g_audio_underruns; // Packets sent short because the ring ran low.
+extern volatile uint16_t g_audio_overruns;  // Samples dropped because the ring was full.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** AUDIO FUNCTIONS ***************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool audio_class_request(void)
+ * 
+ * @brief Used to service Audio Class Requests.
+ * 
+ * Handles SET_CUR/GET_CUR/GET_MIN/GET_MAX/GET_RES of the audio EP's 
+ * SAMPLING_FREQ_CONTROL.
+ * 
+ * @return Returns true if the request was handled.
+ */
+bool audio_class_request(void);
+
+/**
+ * @fn bool audio_out_control_tasks(void)
+ * 
+ * @brief Applies a sample rate received by SET_CUR, called from usb_out_control_finished().
+ * 
+ * @return Returns false if the rate was rejected.
+ */
+bool audio_out_control_tasks(void);
+
+/**
+ * @fn void audio_init(void)
+ * 
+ * @brief Sets up the audio function, called from usb_app_init().
+ * 
+ * Streaming stops and the sample rate returns to AUDIO_SAMPLE_RATE.
+ */
+void audio_init(void);
+
+/**
+ * @fn bool audio_set_interface(uint8_t alternate_setting, uint8_t interface)
+ * 
+ * @brief Starts streaming on alt setting 1 of AUDIO_AS_INT, stops it on alt setting 0.
+ * 
+ * @param[in] alternate_setting Alternate setting requested.
+ * @param[in] interface Interface number.
+ * 
+ * @return Returns false if the interface or setting isn't the audio function's.
+ */
+bool audio_set_interface(uint8_t alternate_setting, uint8_t interface);
+
+/**
+ * @fn bool audio_get_interface(uint8_t* alternate_setting_result, uint8_t interface)
+ * 
+ * @brief Returns the alternate setting of the audio interfaces.
+ * 
+ * @param[out] alternate_setting_result Current alternate setting.
+ * @param[in] interface Interface number.
+ * 
+ * @return Returns false if the interface isn't the audio function's.
+ */
+bool audio_get_interface(uint8_t* alternate_setting_result, uint8_t interface);
+
+/**
+ * @fn uint16_t audio_iso_in(uint8_t** p_buffer)
+ * 
+ * @brief Points the next audio packet at the ring buffer, called from usb_iso_in().
+ * 
+ * The packet holds the sample rate's share of this frame, plus or minus one 
+ * sample to keep the ring at half full. So the host follows the ADC's clock 
+ * (asynchronous mode) and no feedback EP is needed for capture.
+ * 
+ * @param[out] p_buffer Set to the packet's start in the ring buffer.
+ * 
+ * @return Amount of bytes in the packet.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * uint16_t usb_iso_in(uint8_t ep, uint8_t** p_buffer)
+ * {
+ *     if(ep == AUDIO_EP) return audio_iso_in(p_buffer);
+ *     return 0;
+ * }
+ * @endcode
+ * </li></ul>
+ */
+uint16_t audio_iso_in(uint8_t** p_buffer);
+
+/**
+ * @fn bool audio_streaming(void)
+ * 
+ * @brief Tells if the host has the stream open (alt setting 1).
+ * 
+ * @return Returns true while streaming.
+ */
+bool audio_streaming(void);
+
+/**
+ * @fn uint32_t audio_get_sample_rate(void)
+ * 
+ * @brief Returns the sample rate selected by the host.
+ * 
+ * @return Sample rate in Hz.
+ */
+uint32_t audio_get_sample_rate(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+#if AUDIO_CHANNELS == 1
+/**
+ * @fn bool audio_put(int16_t sample)
+ * 
+ * @brief Writes a sample into the ring buffer, e.g. from the ADC ISR.
+ * 
+ * Lock-free against the USB ISR, only this function moves the ring's head.
+ * 
+ * @param[in] sample Signed 16-bit sample.
+ * 
+ * @return Returns false if the sample was dropped (not streaming or ring full).
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * audio_put((int16_t)((ADRES << 6) - 32768)); // 10-bit ADC to signed 16-bit.
+ * @endcode
+ * </li></ul>
+ */
+bool audio_put(int16_t sample);
+#else
+/**
+ * @fn bool audio_put_stereo(int16_t left, int16_t right)
+ * 
+ * @brief Writes a stereo sample into the ring buffer, e.g. from the ADC ISR.
+ * 
+ * Lock-free against the USB ISR, only this function moves the ring's head.
+ * 
+ * @param[in] left Signed 16-bit left sample.
+ * @param[in] right Signed 16-bit right sample.
+ * 
+ * @return Returns false if the sample was dropped (not streaming or ring full).
+ */
+bool audio_put_stereo(int16_t left, int16_t right);
+#endif
+
+/**
+ * @fn bool audio_sample_rate_changed(uint32_t rate)
+ * 
+ * @brief Is called when the host selects a sample rate, to retime the ADC.
+ * 
+ * @param[in] rate Sample rate in Hz (AUDIO_MIN_SAMPLE_RATE to AUDIO_MAX_SAMPLE_RATE).
+ * 
+ * @return Return false if the rate can't be used, the request is stalled.
+ */
+bool audio_sample_rate_changed(uint32_t rate);
+
+/* ************************************************************************** */
+
+#endif /* USB_AUDIO_H */
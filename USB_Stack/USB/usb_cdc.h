@@ -50,6 +50,32 @@
 
 /* ************************************************************************** */
 
+/* ************************************************************************** */
+/* ******************************* CDC PORTS ******************************** */
+/* ************************************************************************** */
+
+#ifndef CDC_NUM_PORTS
+#define CDC_NUM_PORTS 1
+#endif
+
+#if (CDC_NUM_PORTS < 1) || (CDC_NUM_PORTS > 3)
+#error "CDC_NUM_PORTS must be 1 to 3. Each port needs a COM EP and a DAT EP, and only EP1 to EP7 exist."
+#endif
+
+#if NUM_INTERFACES < (CDC_NUM_PORTS * 2)
+#error "Each CDC port needs two interfaces, increase NUM_INTERFACES."
+#endif
+
+#if NUM_ENDPOINTS < ((CDC_NUM_PORTS * 2) + 1)
+#error "Each CDC port needs two endpoints, increase NUM_ENDPOINTS."
+#endif
+
+#ifndef CDC_NOTIFICATION_INTERVAL
+#define CDC_NOTIFICATION_INTERVAL 16
+#endif
+
+/* ************************************************************************** */
+
 /* ************************************************************************** */
 /* ************************** WARNING FOR PIC16 ***************************** */
 /* ************************************************************************** */
@@ -82,10 +108,34 @@
 #define CDC_COM_EP_IN_BUFFER_BASE_ADDR  0x2050
 #define CDC_DAT_EP_OUT_BUFFER_BASE_ADDR 0x20A0
 #define CDC_DAT_EP_IN_BUFFER_BASE_ADDR  0x20F0
+#define CDC_PORT_BUFFERS_SIZE           0xF0 // Each buffer gets its own 80 byte bank.
 #else
 #define CDC_COM_EP_IN_BUFFER_BASE_ADDR   CDC_EP_BUFFERS_STARTING_ADDR
 #define CDC_DAT_EP_OUT_BUFFER_BASE_ADDR (CDC_EP_BUFFERS_STARTING_ADDR + CDC_COM_EP_SIZE)
 #define CDC_DAT_EP_IN_BUFFER_BASE_ADDR  (CDC_EP_BUFFERS_STARTING_ADDR + CDC_COM_EP_SIZE + CDC_DAT_EP_SIZE)
+#define CDC_PORT_BUFFERS_SIZE           (CDC_COM_EP_SIZE + CDC_DAT_EP_SIZE + CDC_DAT_EP_SIZE)
+#endif
+
+#if CDC_NUM_PORTS > 1
+#define CDC1_COM_EP_IN_BUFFER_BASE_ADDR  (CDC_COM_EP_IN_BUFFER_BASE_ADDR + CDC_PORT_BUFFERS_SIZE)
+#define CDC1_DAT_EP_OUT_BUFFER_BASE_ADDR (CDC_DAT_EP_OUT_BUFFER_BASE_ADDR + CDC_PORT_BUFFERS_SIZE)
+#define CDC1_DAT_EP_IN_BUFFER_BASE_ADDR  (CDC_DAT_EP_IN_BUFFER_BASE_ADDR + CDC_PORT_BUFFERS_SIZE)
+#endif
+#if CDC_NUM_PORTS > 2
+#define CDC2_COM_EP_IN_BUFFER_BASE_ADDR  (CDC_COM_EP_IN_BUFFER_BASE_ADDR + (CDC_PORT_BUFFERS_SIZE * 2))
+#define CDC2_DAT_EP_OUT_BUFFER_BASE_ADDR (CDC_DAT_EP_OUT_BUFFER_BASE_ADDR + (CDC_PORT_BUFFERS_SIZE * 2))
+#define CDC2_DAT_EP_IN_BUFFER_BASE_ADDR  (CDC_DAT_EP_IN_BUFFER_BASE_ADDR + (CDC_PORT_BUFFERS_SIZE * 2))
+#endif
+
+// The last port's DAT IN buffer is the highest, it must still be in USB RAM.
+#ifdef USB_RAM_END_ADDR
+#if CDC_NUM_PORTS == 1 && (CDC_DAT_EP_IN_BUFFER_BASE_ADDR + CDC_DAT_EP_SIZE) > USB_RAM_END_ADDR
+#error "CDC EP buffers run past USB RAM, lower CDC_DAT_EP_SIZE."
+#elif CDC_NUM_PORTS == 2 && (CDC1_DAT_EP_IN_BUFFER_BASE_ADDR + CDC_DAT_EP_SIZE) > USB_RAM_END_ADDR
+#error "CDC EP buffers of port 1 run past USB RAM, lower CDC_NUM_PORTS or CDC_DAT_EP_SIZE."
+#elif CDC_NUM_PORTS == 3 && (CDC2_DAT_EP_IN_BUFFER_BASE_ADDR + CDC_DAT_EP_SIZE) > USB_RAM_END_ADDR
+#error "CDC EP buffers of port 2 run past USB RAM, lower CDC_NUM_PORTS or CDC_DAT_EP_SIZE."
+#endif
 #endif
 
 /* ************************************************************************** */
@@ -99,6 +149,10 @@
 #define CDC_DAT_EP_OUT_DATA_TOGGLE_VAL g_usb_ep_stat[CDC_DAT_EP][OUT].Data_Toggle_Val
 #define CDC_DAT_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[CDC_DAT_EP][IN].Data_Toggle_Val
 
+#define CDC_PORT_COM_EP_IN_DATA_TOGGLE_VAL(port)  g_usb_ep_stat[g_cdc_ports[port].Com_EP][IN].Data_Toggle_Val
+#define CDC_PORT_DAT_EP_OUT_DATA_TOGGLE_VAL(port) g_usb_ep_stat[g_cdc_ports[port].Dat_EP][OUT].Data_Toggle_Val
+#define CDC_PORT_DAT_EP_IN_DATA_TOGGLE_VAL(port)  g_usb_ep_stat[g_cdc_ports[port].Dat_EP][IN].Data_Toggle_Val
+
 /* ************************************************************************** */
 
 
@@ -235,6 +289,17 @@
 #define LINE_STATE_CHANGE       0x29
 #define CONNECTION_SPEED_CHANGE 0x2A
 
+// SERIAL_STATE Bitmap
+#define CDC_STATE_RX_CARRIER  0x01 // DCD
+#define CDC_STATE_TX_CARRIER  0x02 // DSR
+#define CDC_STATE_BREAK       0x04
+#define CDC_STATE_RING_SIGNAL 0x08
+#define CDC_STATE_FRAMING     0x10
+#define CDC_STATE_PARITY      0x20
+#define CDC_STATE_OVERRUN     0x40
+#define CDC_STATE_CONSISTENT  (CDC_STATE_RX_CARRIER | CDC_STATE_TX_CARRIER)
+#define CDC_STATE_EVENTS      (CDC_STATE_BREAK | CDC_STATE_RING_SIGNAL | CDC_STATE_FRAMING | CDC_STATE_PARITY | CDC_STATE_OVERRUN)
+
 /* ************************************************************************** */
 
 
@@ -486,6 +551,24 @@ typedef union
     };
 }cdc_serial_state_t;
 
+// CDC-ACM Port (one COM interface and one DAT interface)
+typedef struct
+{
+    uint8_t  Com_Int;
+    uint8_t  Dat_Int;
+    uint8_t  Com_EP;
+    uint8_t  Dat_EP;
+    uint8_t  Com_BD_In;
+    uint8_t  Dat_BD_Out;
+    uint8_t  Dat_BD_In;
+    uint8_t* Com_EP_In;
+    uint8_t* Dat_EP_Out;
+    uint8_t* Dat_EP_In;
+}cdc_port_t;
+
+// The SERIAL_STATE notification of a port lives in its COM EP IN buffer.
+#define CDC_SERIAL_STATE(port) (*(cdc_serial_state_t*)g_cdc_ports[port].Com_EP_In)
+
 /* ************************************************************************** */
 
 
@@ -497,22 +580,28 @@ typedef union
 extern uint8_t g_cdc_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC_COM_EP_IN_BUFFER_BASE_ADDR);
 extern uint8_t g_cdc_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC_DAT_EP_OUT_BUFFER_BASE_ADDR);
 extern uint8_t g_cdc_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC_DAT_EP_IN_BUFFER_BASE_ADDR);
+#if CDC_NUM_PORTS > 1
+extern uint8_t g_cdc1_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC1_COM_EP_IN_BUFFER_BASE_ADDR);
+extern uint8_t g_cdc1_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC1_DAT_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_cdc1_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC1_DAT_EP_IN_BUFFER_BASE_ADDR);
+#endif
+#if CDC_NUM_PORTS > 2
+extern uint8_t g_cdc2_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC2_COM_EP_IN_BUFFER_BASE_ADDR);
+extern uint8_t g_cdc2_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC2_DAT_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_cdc2_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC2_DAT_EP_IN_BUFFER_BASE_ADDR);
+#endif
+
+extern const cdc_port_t g_cdc_ports[CDC_NUM_PORTS];
 
 extern cdc_set_get_line_coding_t    g_cdc_set_get_line_coding       __at(SETUP_DATA_ADDR);
 extern cdc_set_control_line_state_t g_cdc_set_control_line_state    __at(SETUP_DATA_ADDR);
-extern cdc_get_line_coding_return_t g_cdc_get_line_coding_return;
+extern cdc_get_line_coding_return_t g_cdc_get_line_coding_return[CDC_NUM_PORTS];
 extern cdc_set_line_coding_t        g_cdc_set_line_coding;
-#if defined(USE_DTR)||defined(USE_RTS)
-extern cdc_serial_state_t           g_cdc_serial_state              __at(CDC_COM_EP_IN_BUFFER_BASE_ADDR);
-#endif
 
 extern volatile bool    g_cdc_set_line_coding_wait;
 extern volatile uint8_t g_cdc_num_data_out;
+extern volatile uint8_t g_cdc_port; // Port the current callback was made for, also passed to it.
 
-#if defined(USE_DTR)||defined(USE_DCD)
-extern bool g_cdc_sent_last_notification;
-extern bool g_cdc_send_notification;
-#endif
 #ifdef USE_RTS
 extern bool g_cdc_has_set_rts;
 #endif
@@ -525,7 +614,54 @@ extern bool g_cdc_has_set_rts;
 /* ************************************************************************** */
 
 #if defined(USE_DTR)||defined(USE_DCD)
+/**
+ * @fn void cdc_set_serial_state(uint8_t port, uint8_t state)
+ * 
+ * @brief Updates the line state reported by a port's SERIAL_STATE notification.
+ * 
+ * DCD and DSR (CDC_STATE_CONSISTENT) are replaced by the new value, event bits
+ * (CDC_STATE_EVENTS) are latched until they have been sent once. Nothing is
+ * sent here, cdc_notification_tasks() sends the latest state when the COM EP
+ * is free, so it can be called as often as the lines are polled.
+ * 
+ * @param[in] port CDC port number (0 to CDC_NUM_PORTS - 1).
+ * @param[in] state CDC_STATE_* bits.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * cdc_set_serial_state(0, DSR == DSR_ACTIVE ? CDC_STATE_TX_CARRIER : 0);
+ * @endcode
+ * </li></ul>
+ */
+void cdc_set_serial_state(uint8_t port, uint8_t state);
+
+/**
+ * @fn void cdc_notification_tasks(void)
+ * 
+ * @brief Sends SERIAL_STATE notifications for ports whose line state changed.
+ * 
+ * Call from the main loop. A port sends only when its previous notification
+ * has finished and, with USE_SOF, CDC_NOTIFICATION_INTERVAL frames have
+ * passed since it. Changes made in between are merged into one notification.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * cdc_notification_tasks();
+ * @endcode
+ * </li></ul>
+ */
 void cdc_notification_tasks(void);
+
+#ifdef USE_SOF
+/**
+ * @fn void cdc_sof(void)
+ * 
+ * @brief Runs the SERIAL_STATE notification interval timer, call from usb_sof().
+ */
+void cdc_sof(void);
+#endif
 #endif
 
 /* ************************************************************************** */
@@ -538,38 +674,96 @@ void cdc_notification_tasks(void);
 bool cdc_class_request(void);
 void cdc_init(void);
 void cdc_clear_ep_toggle(void);
+bool cdc_set_interface(uint8_t alternate_setting, uint8_t interface);
 bool cdc_out_control_tasks(void);
-void cdc_set_line_coding(void);
-void cdc_set_control_line_state(void);
 void cdc_tasks(void);
-void cdc_data_out(void);
-void cdc_data_in(void);
-void cdc_notification(void);
+
+// USER CALLBACKS TO PLACE IN MAIN
+// port is the CDC port (0 to CDC_NUM_PORTS - 1) the request or transaction was for.
+void cdc_set_line_coding(uint8_t port);
+void cdc_set_control_line_state(uint8_t port);
+void cdc_data_out(uint8_t port);
+void cdc_data_in(uint8_t port);
+void cdc_notification(uint8_t port);
 
 /**
- * @fn void cdc_arm_com_ep_in(void)
+ * @fn void cdc_port_arm_com_ep_in(uint8_t port)
  * 
- * @brief Arms CDC COM Endpoint for a transaction.
+ * @brief Arms a CDC port's COM Endpoint for a transaction.
+ * 
+ * The function is used to arm the COM EP of the given port, sending its
+ * SERIAL_STATE notification.
+ * 
+ * @param[in] port CDC port number (0 to CDC_NUM_PORTS - 1).
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * cdc_port_arm_com_ep_in(1);
+ * @endcode
+ * </li></ul>
+ */
+void cdc_port_arm_com_ep_in(uint8_t port);
+
+/**
+ * @fn void cdc_port_arm_data_ep_out(uint8_t port)
+ * 
+ * @brief Arms a CDC port's DAT EP OUT Endpoint for a transaction.
  * 
- * The function is used to arm CDC COM EP for a transaction.
+ * The function is used to arm the DAT EP OUT of the given port.
  * 
+ * @param[in] port CDC port number (0 to CDC_NUM_PORTS - 1).
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * cdc_port_arm_data_ep_out(port);
+ * @endcode
+ * </li></ul>
+ */
+void cdc_port_arm_data_ep_out(uint8_t port);
+
+/**
+ * @fn void cdc_port_arm_data_ep_in(uint8_t port, uint8_t cnt)
+ * 
+ * @brief Arms a CDC port's DAT EP IN Endpoint for a transaction.
+ * 
+ * The function is used to arm the DAT EP IN of the given port.
+ * 
+ * @param[in] port CDC port number (0 to CDC_NUM_PORTS - 1).
  * @param[in] cnt Amount of bytes being transfered.
  * 
  * <b>Code Example:</b>
  * <ul style="list-style-type:none"><li>
  * @code
+ * cdc_port_arm_data_ep_in(1, CDC_DAT_EP_SIZE);
+ * @endcode
+ * </li></ul>
+ */
+void cdc_port_arm_data_ep_in(uint8_t port, uint8_t cnt);
+
+/**
+ * @fn void cdc_arm_com_ep_in(void)
+ * 
+ * @brief Arms CDC COM Endpoint for a transaction.
+ * 
+ * The function is used to arm CDC COM EP of port 0 for a transaction.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
  * cdc_arm_com_ep_in();
  * @endcode
  * </li></ul>
  */
-void cdc_arm_com_ep_in(void);
+#define cdc_arm_com_ep_in() cdc_port_arm_com_ep_in(0)
 
 /**
  * @fn cdc_arm_data_ep_out(void)
  * 
  * @brief Arms CDC DAT EP OUT Endpoint for a transaction.
  * 
- * The function is used to arm CDC DAT EP OUT for a transaction.
+ * The function is used to arm CDC DAT EP OUT of port 0 for a transaction.
  * 
  * 
  * <b>Code Example:</b>
@@ -579,14 +773,14 @@ void cdc_arm_com_ep_in(void);
  * @endcode
  * </li></ul>
  */
-void cdc_arm_data_ep_out(void);
+#define cdc_arm_data_ep_out() cdc_port_arm_data_ep_out(0)
 
 /**
  * @fn void cdc_arm_data_ep_in(uint8_t cnt)
  * 
  * @brief Arms CDC DAT EP IN Endpoint for a transaction.
  * 
- * The function is used to arm CDC DAT EP IN for a transaction.
+ * The function is used to arm CDC DAT EP IN of port 0 for a transaction.
  * 
  * @param[in] cnt Amount of bytes being transfered.
  * 
@@ -597,7 +791,7 @@ void cdc_arm_data_ep_out(void);
  * @endcode
  * </li></ul>
  */
-void cdc_arm_data_ep_in(uint8_t cnt);
+#define cdc_arm_data_ep_in(cnt) cdc_port_arm_data_ep_in(0, cnt)
 
 /* ************************************************************************** */
 
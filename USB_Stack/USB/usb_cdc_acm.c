@@ -38,6 +38,46 @@
 uint8_t g_cdc_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC_COM_EP_IN_BUFFER_BASE_ADDR);
 uint8_t g_cdc_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC_DAT_EP_OUT_BUFFER_BASE_ADDR);
 uint8_t g_cdc_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC_DAT_EP_IN_BUFFER_BASE_ADDR);
+#if CDC_NUM_PORTS > 1
+uint8_t g_cdc1_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC1_COM_EP_IN_BUFFER_BASE_ADDR);
+uint8_t g_cdc1_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC1_DAT_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_cdc1_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC1_DAT_EP_IN_BUFFER_BASE_ADDR);
+#endif
+#if CDC_NUM_PORTS > 2
+uint8_t g_cdc2_com_ep_in[CDC_COM_EP_SIZE]  __at(CDC2_COM_EP_IN_BUFFER_BASE_ADDR);
+uint8_t g_cdc2_dat_ep_out[CDC_DAT_EP_SIZE] __at(CDC2_DAT_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_cdc2_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC2_DAT_EP_IN_BUFFER_BASE_ADDR);
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* CDC PORTS ******************************** */
+/* ************************************************************************** */
+
+const cdc_port_t g_cdc_ports[CDC_NUM_PORTS] =
+{
+    {
+        CDC_COM_INT, CDC_DAT_INT, CDC_COM_EP, CDC_DAT_EP,
+        CDC_COM_BD_IN, CDC_DAT_BD_OUT, CDC_DAT_BD_IN,
+        g_cdc_com_ep_in, g_cdc_dat_ep_out, g_cdc_dat_ep_in
+    },
+    #if CDC_NUM_PORTS > 1
+    {
+        CDC1_COM_INT, CDC1_DAT_INT, CDC1_COM_EP, CDC1_DAT_EP,
+        CDC1_COM_BD_IN, CDC1_DAT_BD_OUT, CDC1_DAT_BD_IN,
+        g_cdc1_com_ep_in, g_cdc1_dat_ep_out, g_cdc1_dat_ep_in
+    },
+    #endif
+    #if CDC_NUM_PORTS > 2
+    {
+        CDC2_COM_INT, CDC2_DAT_INT, CDC2_COM_EP, CDC2_DAT_EP,
+        CDC2_COM_BD_IN, CDC2_DAT_BD_OUT, CDC2_DAT_BD_IN,
+        g_cdc2_com_ep_in, g_cdc2_dat_ep_out, g_cdc2_dat_ep_in
+    },
+    #endif
+};
 
 /* ************************************************************************** */
 
@@ -48,20 +88,13 @@ uint8_t g_cdc_dat_ep_in[CDC_DAT_EP_SIZE]  __at(CDC_DAT_EP_IN_BUFFER_BASE_ADDR);
 
 cdc_set_get_line_coding_t    g_cdc_set_get_line_coding     __at(SETUP_DATA_ADDR);
 cdc_set_control_line_state_t g_cdc_set_control_line_state  __at(SETUP_DATA_ADDR);
-cdc_get_line_coding_return_t g_cdc_get_line_coding_return;
+cdc_get_line_coding_return_t g_cdc_get_line_coding_return[CDC_NUM_PORTS];
 cdc_set_line_coding_t        g_cdc_set_line_coding;
 
-#if defined(USE_DTR) || defined(USE_RTS)
-cdc_serial_state_t           g_cdc_serial_state            __at(CDC_COM_EP_IN_BUFFER_BASE_ADDR);
-#endif
-
 volatile bool    g_cdc_set_line_coding_wait;
 volatile uint8_t g_cdc_num_data_out;
+volatile uint8_t g_cdc_port;
 
-#if defined(USE_DTR) || defined(USE_DCD)
-bool g_cdc_sent_last_notification = true;
-bool g_cdc_send_notification      = false;
-#endif
 #ifdef USE_RTS
 bool g_cdc_has_set_rts = false;
 #endif
@@ -69,37 +102,75 @@ bool g_cdc_has_set_rts = false;
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* **************************** LOCAL VARIABLES ***************************** */
+/* ************************************************************************** */
+
+static uint8_t m_line_coding_port; // Port the pending SET_LINE_CODING data stage is for.
+
+#if defined(USE_DTR) || defined(USE_DCD)
+static uint8_t m_serial_state[CDC_NUM_PORTS];             // Latest line state, events latched until sent.
+static uint8_t m_sent_serial_state[CDC_NUM_PORTS];        // Line state the host last saw.
+static volatile bool m_notification_busy[CDC_NUM_PORTS];  // SERIAL_STATE in flight.
+#ifdef USE_SOF
+static volatile uint8_t m_notification_frames[CDC_NUM_PORTS]; // SOFs since the last SERIAL_STATE.
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************** LOCAL FUNCTION DECLARATIONS *********************** */
+/* ************************************************************************** */
+
+static uint8_t port_from_interface(uint8_t interface);
+#if defined(USE_DTR) || defined(USE_DCD)
+static void send_serial_state(uint8_t port);
+#endif
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* *************************** CDC FUNCTIONS ******************************** */
 /* ************************************************************************** */
 
-void cdc_arm_com_ep_in(void)
+void cdc_port_arm_com_ep_in(uint8_t port)
 {
-    usb_arm_endpoint(&g_usb_bd_table[CDC_COM_BD_IN], &g_usb_ep_stat[CDC_COM_EP][IN], 10);
+    const cdc_port_t *p_port = &g_cdc_ports[port];
+    usb_arm_endpoint(&g_usb_bd_table[p_port->Com_BD_In], &g_usb_ep_stat[p_port->Com_EP][IN], 10);
 }
 
 
-void cdc_arm_data_ep_out(void)
+void cdc_port_arm_data_ep_out(uint8_t port)
 {
-    usb_arm_endpoint(&g_usb_bd_table[CDC_DAT_BD_OUT], &g_usb_ep_stat[CDC_DAT_EP][OUT], CDC_DAT_EP_SIZE);
+    const cdc_port_t *p_port = &g_cdc_ports[port];
+    usb_arm_endpoint(&g_usb_bd_table[p_port->Dat_BD_Out], &g_usb_ep_stat[p_port->Dat_EP][OUT], CDC_DAT_EP_SIZE);
 }
 
 
-void cdc_arm_data_ep_in(uint8_t cnt)
+void cdc_port_arm_data_ep_in(uint8_t port, uint8_t cnt)
 {
-    usb_arm_endpoint(&g_usb_bd_table[CDC_DAT_BD_IN], &g_usb_ep_stat[CDC_DAT_EP][IN], cnt);
+    const cdc_port_t *p_port = &g_cdc_ports[port];
+    usb_arm_endpoint(&g_usb_bd_table[p_port->Dat_BD_In], &g_usb_ep_stat[p_port->Dat_EP][IN], cnt);
 }
 
 bool cdc_class_request(void)
 {
     static uint8_t dummy_buffer[8] = {0};
-    uint16_t bytes_available;
+    uint8_t port;
+    
+    // Class requests are sent to the COM interface of the port they are meant for.
+    port = port_from_interface((uint8_t)g_usb_setup.wIndex);
+    if(port == CDC_NUM_PORTS) return false;
+    g_cdc_port = port;
     
     switch(g_usb_setup.bRequest)
     {
         #ifdef USE_GET_LINE_CODING
         case GET_LINE_CODING:
-            usb_set_ram_ptr((uint8_t*)&g_cdc_get_line_coding_return);
+            usb_set_ram_ptr((uint8_t*)&g_cdc_get_line_coding_return[port]);
             usb_setup_in_control_transfer(RAM, 7, g_cdc_set_get_line_coding.Size_of_Structure);
             usb_in_control_transfer();
             usb_set_control_stage(DATA_IN_STAGE);
@@ -110,14 +181,14 @@ bool cdc_class_request(void)
             usb_set_ram_ptr((uint8_t*)&g_cdc_set_line_coding);
             if(g_cdc_set_get_line_coding.Size_of_Structure > 7) return false;
             usb_set_num_out_control_bytes(g_cdc_set_get_line_coding.Size_of_Structure);
+            m_line_coding_port = port;
             g_cdc_set_line_coding_wait = true;
             usb_set_control_stage(DATA_OUT_STAGE);
             return true;
         #endif
         #ifdef USE_SET_CONTROL_LINE_STATE
         case SET_CONTROL_LINE_STATE:
-            if(g_usb_setup.wIndex != CDC_COM_INT) return false;
-            cdc_set_control_line_state();
+            cdc_set_control_line_state(port);
             usb_arm_in_status();
             return true;
         #endif
@@ -140,12 +211,8 @@ bool cdc_class_request(void)
 
 void cdc_init(void)
 {
-    #ifdef USE_GET_LINE_CODING
-    g_cdc_get_line_coding_return.dwDTERate   = STARTING_BAUD;
-    g_cdc_get_line_coding_return.bCharFormat = STARTING_STOP_BITS;
-    g_cdc_get_line_coding_return.bParityType = PARITY_NONE;
-    g_cdc_get_line_coding_return.bDataBits   = STARTING_DATA_BITS;
-    #endif
+    uint8_t port;
+    const cdc_port_t *p_port;
     
     #ifdef USE_RTS
     RTS = RTS_ACTIVE ^ 1;
@@ -156,32 +223,47 @@ void cdc_init(void)
     DTR_TRIS = 0;
     #endif
     
-    #if defined(USE_DTR) || defined(USE_DCD)
-    usb_ram_set(0, g_cdc_serial_state.array, 10);
-    g_cdc_serial_state.header.bmRequestType = 0xA1;
-    g_cdc_serial_state.header.bNotification = SERIAL_STATE;
-    g_cdc_serial_state.header.wValue  = 0;
-    g_cdc_serial_stateg_serial_state.header.wIndex  = 1;
-    g_cdc_serial_state.header.wLength = 2;
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        p_port = &g_cdc_ports[port];
+        
+        #ifdef USE_GET_LINE_CODING
+        g_cdc_get_line_coding_return[port].dwDTERate   = STARTING_BAUD;
+        g_cdc_get_line_coding_return[port].bCharFormat = STARTING_STOP_BITS;
+        g_cdc_get_line_coding_return[port].bParityType = PARITY_NONE;
+        g_cdc_get_line_coding_return[port].bDataBits   = STARTING_DATA_BITS;
+        #endif
+        
+        #if defined(USE_DTR) || defined(USE_DCD)
+        usb_ram_set(0, p_port->Com_EP_In, 10);
+        CDC_SERIAL_STATE(port).header.bmRequestType = 0xA1;
+        CDC_SERIAL_STATE(port).header.bNotification = SERIAL_STATE;
+        CDC_SERIAL_STATE(port).header.wValue  = 0;
+        CDC_SERIAL_STATE(port).header.wIndex  = p_port->Com_Int;
+        CDC_SERIAL_STATE(port).header.wLength = 2;
+        m_serial_state[port] = CDC_STATE_RX_CARRIER | CDC_STATE_TX_CARRIER; // DCD, DSR
+        #endif
+        
+        // BD settings
+        g_usb_bd_table[p_port->Com_BD_In].STAT  = 0;
+        g_usb_bd_table[p_port->Com_BD_In].ADR   = (uint16_t)p_port->Com_EP_In;
+        g_usb_bd_table[p_port->Dat_BD_Out].STAT = 0;
+        g_usb_bd_table[p_port->Dat_BD_Out].ADR  = (uint16_t)p_port->Dat_EP_Out;
+        g_usb_bd_table[p_port->Dat_BD_In].STAT  = 0;
+        g_usb_bd_table[p_port->Dat_BD_In].ADR   = (uint16_t)p_port->Dat_EP_In;
+        
+        g_usb_ep_stat[p_port->Com_EP][IN].Halt  = 0;
+        g_usb_ep_stat[p_port->Dat_EP][OUT].Halt = 0;
+        g_usb_ep_stat[p_port->Dat_EP][IN].Halt  = 0;
+    }
+    
+    // Only port 0 has hardware handshake lines.
     #ifdef USE_DCD
-    g_cdc_serial_state.bRxCarrier = (DCD ^ DCD_ACTIVE) ^ 1; // DCD
-    #else
-    g_cdc_serial_stateg_serial_state.bRxCarrier = 1; // DCD
+    if(DCD != DCD_ACTIVE) m_serial_state[0] &= ~CDC_STATE_RX_CARRIER;
     #endif
     #ifdef USE_DTR
-    g_cdc_serial_state.bTxCarrier = (DSR ^ DSR_ACTIVE) ^ 1; // DSR
-    #else
-    g_cdc_serial_state.bTxCarrier = 1; // DSR
-    #endif
+    if(DSR != DSR_ACTIVE) m_serial_state[0] &= ~CDC_STATE_TX_CARRIER;
     #endif
-
-    // BD settings
-    g_usb_bd_table[CDC_COM_BD_IN].STAT  = 0;
-    g_usb_bd_table[CDC_COM_BD_IN].ADR   = CDC_COM_EP_IN_BUFFER_BASE_ADDR;
-    g_usb_bd_table[CDC_DAT_BD_OUT].STAT = 0;
-    g_usb_bd_table[CDC_DAT_BD_OUT].ADR  = CDC_DAT_EP_OUT_BUFFER_BASE_ADDR;
-    g_usb_bd_table[CDC_DAT_BD_IN].STAT  = 0;
-    g_usb_bd_table[CDC_DAT_BD_IN].ADR   = CDC_DAT_EP_IN_BUFFER_BASE_ADDR;
     
     // EP Settings
     CDC_COM_UEPbits.EPHSHK   = 1; // Handshaking enabled 
@@ -190,47 +272,102 @@ void cdc_init(void)
     CDC_DAT_UEPbits.EPCONDIS = 0; // Don't allow SETUP
     CDC_DAT_UEPbits.EPOUTEN  = 1; // EP output enabled
     CDC_DAT_UEPbits.EPINEN   = 1; // EP input enabled
+    #if CDC_NUM_PORTS > 1
+    CDC1_COM_UEPbits.EPHSHK   = 1;
+    CDC1_COM_UEPbits.EPINEN   = 1;
+    CDC1_DAT_UEPbits.EPHSHK   = 1;
+    CDC1_DAT_UEPbits.EPCONDIS = 0;
+    CDC1_DAT_UEPbits.EPOUTEN  = 1;
+    CDC1_DAT_UEPbits.EPINEN   = 1;
+    #endif
+    #if CDC_NUM_PORTS > 2
+    CDC2_COM_UEPbits.EPHSHK   = 1;
+    CDC2_COM_UEPbits.EPINEN   = 1;
+    CDC2_DAT_UEPbits.EPHSHK   = 1;
+    CDC2_DAT_UEPbits.EPCONDIS = 0;
+    CDC2_DAT_UEPbits.EPOUTEN  = 1;
+    CDC2_DAT_UEPbits.EPINEN   = 1;
+    #endif
     
-    g_usb_ep_stat[CDC_COM_EP][IN].Halt  = 0;
-    g_usb_ep_stat[CDC_DAT_EP][OUT].Halt = 0;
-    g_usb_ep_stat[CDC_DAT_EP][IN].Halt  = 0;
     cdc_clear_ep_toggle();
-    cdc_arm_data_ep_out();
-    
-    #if defined(USE_DTR) || defined(USE_DCD)
-    cdc_arm_com_ep_in();
-    #endif
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        cdc_port_arm_data_ep_out(port);
+        #if defined(USE_DTR) || defined(USE_DCD)
+        send_serial_state(port);
+        #endif
+    }
     g_cdc_set_line_coding_wait = false;
 }
 
 void cdc_clear_ep_toggle(void)
 {
-    CDC_COM_EP_IN_DATA_TOGGLE_VAL  = 0;
-    CDC_DAT_EP_OUT_DATA_TOGGLE_VAL = 0;
-    CDC_DAT_EP_IN_DATA_TOGGLE_VAL  = 0;
+    uint8_t port;
+    
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        CDC_PORT_COM_EP_IN_DATA_TOGGLE_VAL(port)  = 0;
+        CDC_PORT_DAT_EP_OUT_DATA_TOGGLE_VAL(port) = 0;
+        CDC_PORT_DAT_EP_IN_DATA_TOGGLE_VAL(port)  = 0;
+    }
+}
+
+bool cdc_set_interface(uint8_t alternate_setting, uint8_t interface)
+{
+    uint8_t port;
+    
+    if(alternate_setting != 0) return false;
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        if(interface == g_cdc_ports[port].Com_Int)
+        {
+            CDC_PORT_COM_EP_IN_DATA_TOGGLE_VAL(port) = 0;
+            return true;
+        }
+        if(interface == g_cdc_ports[port].Dat_Int)
+        {
+            CDC_PORT_DAT_EP_OUT_DATA_TOGGLE_VAL(port) = 0;
+            CDC_PORT_DAT_EP_IN_DATA_TOGGLE_VAL(port)  = 0;
+            return true;
+        }
+    }
+    return false;
 }
 
 void cdc_tasks(void)
 {
-    switch(TRANSACTION_EP)
+    uint8_t port;
+    const cdc_port_t *p_port;
+    
+    for(port = 0; port < CDC_NUM_PORTS; port++)
     {
-        case CDC_COM_EP:
-            CDC_COM_EP_IN_DATA_TOGGLE_VAL ^= 1;
-            cdc_notification();
-            break;
-        case CDC_DAT_EP:
+        p_port = &g_cdc_ports[port];
+        if(TRANSACTION_EP == p_port->Com_EP)
+        {
+            g_cdc_port = port;
+            CDC_PORT_COM_EP_IN_DATA_TOGGLE_VAL(port) ^= 1;
+            #if defined(USE_DTR) || defined(USE_DCD)
+            m_notification_busy[port] = false;
+            #endif
+            cdc_notification(port);
+            return;
+        }
+        if(TRANSACTION_EP == p_port->Dat_EP)
+        {
+            g_cdc_port = port;
             if(TRANSACTION_DIR == OUT)
             {
-                CDC_DAT_EP_OUT_DATA_TOGGLE_VAL ^= 1;
-                g_cdc_num_data_out = g_usb_bd_table[CDC_DAT_BD_OUT].CNT;
-                cdc_data_out();
+                CDC_PORT_DAT_EP_OUT_DATA_TOGGLE_VAL(port) ^= 1;
+                g_cdc_num_data_out = g_usb_bd_table[p_port->Dat_BD_Out].CNT;
+                cdc_data_out(port);
             }
             else
             {
-                CDC_DAT_EP_IN_DATA_TOGGLE_VAL ^= 1;
-                cdc_data_in();
+                CDC_PORT_DAT_EP_IN_DATA_TOGGLE_VAL(port) ^= 1;
+                cdc_data_in(port);
             }
-            break;
+            return;
+        }
     }
 }
 
@@ -244,12 +381,13 @@ bool cdc_out_control_tasks(void)
             || (g_cdc_set_line_coding.bParityType != 0)
             || (g_cdc_set_line_coding.bDataBits   != 8)) return false;
         
-        g_cdc_get_line_coding_return.dwDTERate   = g_cdc_set_line_coding.dwDTERate;
-        g_cdc_get_line_coding_return.bCharFormat = g_cdc_set_line_coding.bCharFormat;
-        g_cdc_get_line_coding_return.bParityType = g_cdc_set_line_coding.bParityType;
-        g_cdc_get_line_coding_return.bDataBits   = g_cdc_set_line_coding.bDataBits;
+        g_cdc_get_line_coding_return[m_line_coding_port].dwDTERate   = g_cdc_set_line_coding.dwDTERate;
+        g_cdc_get_line_coding_return[m_line_coding_port].bCharFormat = g_cdc_set_line_coding.bCharFormat;
+        g_cdc_get_line_coding_return[m_line_coding_port].bParityType = g_cdc_set_line_coding.bParityType;
+        g_cdc_get_line_coding_return[m_line_coding_port].bDataBits   = g_cdc_set_line_coding.bDataBits;
         
-        cdc_set_line_coding();
+        g_cdc_port = m_line_coding_port;
+        cdc_set_line_coding(m_line_coding_port);
         return true;
     }
     #endif
@@ -257,14 +395,69 @@ bool cdc_out_control_tasks(void)
 }
 
 #if defined(USE_DTR) || defined(USE_DCD)
+void cdc_set_serial_state(uint8_t port, uint8_t state)
+{
+    m_serial_state[port] = (m_serial_state[port] & CDC_STATE_EVENTS) | state;
+}
+
 void cdc_notification_tasks(void)
 {
-    if(g_cdc_sent_last_notification && g_cdc_send_notification)
+    uint8_t port;
+    
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        if(m_notification_busy[port]) continue; // Changes are merged until the last one is done.
+        #ifdef USE_SOF
+        if(m_notification_frames[port] < CDC_NOTIFICATION_INTERVAL) continue;
+        #endif
+        if(m_serial_state[port] != m_sent_serial_state[port]) send_serial_state(port);
+    }
+}
+
+#ifdef USE_SOF
+void cdc_sof(void)
+{
+    uint8_t port;
+    
+    for(port = 0; port < CDC_NUM_PORTS; port++)
+    {
+        if(m_notification_frames[port] != 0xFF) m_notification_frames[port]++;
+    }
+}
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** LOCAL FUNCTIONS **************************** */
+/* ************************************************************************** */
+
+static uint8_t port_from_interface(uint8_t interface)
+{
+    uint8_t port;
+    
+    for(port = 0; port < CDC_NUM_PORTS; port++)
     {
-        g_cdc_send_notification      = false;
-        g_cdc_sent_last_notification = false;
-        cdc_arm_com_ep_in();
+        if(g_cdc_ports[port].Com_Int == interface) break;
     }
+    return port;
+}
+
+#if defined(USE_DTR) || defined(USE_DCD)
+static void send_serial_state(uint8_t port)
+{
+    uint8_t state = m_serial_state[port];
+    
+    m_serial_state[port]      = state & CDC_STATE_CONSISTENT; // Events are only sent once.
+    m_sent_serial_state[port] = state & CDC_STATE_CONSISTENT;
+    CDC_SERIAL_STATE(port).array[8] = state;
+    m_notification_busy[port] = true;
+    #ifdef USE_SOF
+    m_notification_frames[port] = 0;
+    #endif
+    cdc_port_arm_com_ep_in(port);
 }
 #endif
 
@@ -0,0 +1,557 @@
+/**
+ * @file usb_cdc_ncm.c
+ * @brief <i>Communications Device Class</i> NCM (Network Control Model) core.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - CDC Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "usb.h"
+#include "usb_cdc_ncm.h"
+#include "usb_hal.h"
+#include "usb_ch9.h"
+
+/* ************************************************************************** */
+/* **************************** NCM ENDPOINTS ******************************* */
+/* ************************************************************************** */
+
+uint8_t g_ncm_com_ep_in[NCM_COM_EP_SIZE]   __at(NCM_COM_EP_IN_BUFFER_BASE_ADDR);
+uint8_t g_ncm_ntb_out[NCM_NTB_OUT_MAX_SIZE] __at(NCM_NTB_OUT_BUFFER_BASE_ADDR);
+uint8_t g_ncm_ntb_in[NCM_NTB_IN_MAX_SIZE]   __at(NCM_NTB_IN_BUFFER_BASE_ADDR);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** GLOBAL VARS ******************************** */
+/* ************************************************************************** */
+
+volatile uint16_t g_ncm_packet_filter;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** LOCAL DEFINES ******************************* */
+/* ************************************************************************** */
+
+// IN NTB States
+#define NTB_IN_EMPTY   0
+#define NTB_IN_FILLING 1
+#define NTB_IN_SENDING 2
+
+// OUT NTB States
+#define NTB_OUT_RECEIVING 0
+#define NTB_OUT_READY     1
+
+// Notification States
+#define NOTIFY_NONE       0
+#define NOTIFY_SPEED      1
+#define NOTIFY_CONNECTION 2
+
+#define NTH16_IN  (*(ncm_nth16_t*)g_ncm_ntb_in)
+#define NDP16_IN  (*(ncm_ndp16_t*)&g_ncm_ntb_in[NTH16_SIZE])
+#define NTH16_OUT (*(ncm_nth16_t*)g_ncm_ntb_out)
+
+// First datagram offset in an IN NTB (NTH16 then NDP16, both 4 byte aligned).
+#define NTB_IN_PAYLOAD_START (NTH16_SIZE + NDP16_SIZE(NCM_NTB_IN_MAX_DATAGRAMS))
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+static const ncm_ntb_parameters_t m_ntb_parameters =
+{
+    sizeof(ncm_ntb_parameters_t), // wLength
+    0x0001,                       // bmNtbFormatsSupported - NTB-16 only
+    NCM_NTB_IN_MAX_SIZE,          // dwNtbInMaxSize
+    NCM_NDP_ALIGNMENT,            // wNdpInDivisor
+    0,                            // wNdpInPayloadRemainder
+    NCM_NDP_ALIGNMENT,            // wNdpInAlignment
+    0,                            // wReserved
+    NCM_NTB_OUT_MAX_SIZE,         // dwNtbOutMaxSize
+    NCM_NDP_ALIGNMENT,            // wNdpOutDivisor
+    0,                            // wNdpOutPayloadRemainder
+    NCM_NDP_ALIGNMENT,            // wNdpOutAlignment
+    NCM_NTB_OUT_MAX_DATAGRAMS     // wNtbOutMaxDatagrams
+};
+
+static uint8_t  m_data_alt_setting;
+static uint32_t m_host_ntb_in_size;     // SET_NTB_INPUT_SIZE control OUT buffer.
+static uint32_t m_ntb_in_size;          // Host's NTB input size, its IN transfers are this long.
+static uint16_t m_ntb_in_limit;         // Smallest of ours and the host's NTB input size.
+static uint16_t m_ntb_format;           // Only NTB-16 (0) is supported.
+static bool     m_ntb_in_size_wait;
+
+static uint16_t m_in_sequence;
+static volatile uint8_t  m_in_state;
+static uint16_t m_in_length;            // Bytes used in the IN NTB.
+static uint8_t  m_in_datagrams;         // Datagrams in the IN NTB.
+static volatile uint16_t m_in_sent;     // Bytes of the IN NTB handed to the SIE.
+static volatile bool     m_in_zlp;      // Terminate the IN NTB with a ZLP.
+static volatile bool     m_flush;
+#ifdef USE_SOF
+static volatile uint8_t  m_in_frames;   // SOFs since the first datagram was added.
+#endif
+
+static volatile uint8_t  m_out_state;
+static volatile uint16_t m_out_received; // Bytes of the OUT NTB received so far.
+static uint16_t m_out_ndp_index;         // NDP being read by ncm_receive_frame().
+static uint16_t m_out_datagram;          // Next datagram pointer entry in that NDP.
+
+static bool    m_connected;
+static uint8_t m_notify_state;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************* LOCAL FUNCTION DECLARATIONS ************************ */
+/* ************************************************************************** */
+
+static void arm_ntb_out(void);
+static void arm_ntb_in(void);
+static bool ntb_out_valid(void);
+static void send_notification(void);
+static void reset_ntbs(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** NCM FUNCTIONS ******************************** */
+/* ************************************************************************** */
+
+bool ncm_class_request(void)
+{
+    if(g_usb_setup.wIndex != NCM_COM_INT) return false;
+    
+    switch(g_usb_setup.bRequest)
+    {
+        case GET_NTB_PARAMETERS:
+            usb_set_rom_ptr((const uint8_t*)&m_ntb_parameters);
+            usb_setup_in_control_transfer(ROM, sizeof(ncm_ntb_parameters_t), g_usb_setup.wLength);
+            usb_in_control_transfer();
+            usb_set_control_stage(DATA_IN_STAGE);
+            return true;
+        case GET_NTB_FORMAT:
+            usb_set_ram_ptr((uint8_t*)&m_ntb_format);
+            usb_setup_in_control_transfer(RAM, 2, g_usb_setup.wLength);
+            usb_in_control_transfer();
+            usb_set_control_stage(DATA_IN_STAGE);
+            return true;
+        case SET_NTB_FORMAT:
+            if(g_usb_setup.wValue != 0 || m_data_alt_setting != 0) return false; // NTB-16 only, and only while idle.
+            m_ntb_format = 0;
+            usb_arm_in_status();
+            return true;
+        case GET_NTB_INPUT_SIZE:
+            usb_set_ram_ptr((uint8_t*)&m_ntb_in_size);
+            usb_setup_in_control_transfer(RAM, 4, g_usb_setup.wLength);
+            usb_in_control_transfer();
+            usb_set_control_stage(DATA_IN_STAGE);
+            return true;
+        case SET_NTB_INPUT_SIZE:
+            if(g_usb_setup.wLength != 4) return false;
+            usb_set_ram_ptr((uint8_t*)&m_host_ntb_in_size);
+            usb_set_num_out_control_bytes(4);
+            m_ntb_in_size_wait = true;
+            usb_set_control_stage(DATA_OUT_STAGE);
+            return true;
+        case SET_ETHERNET_PACKET_FILTER:
+            g_ncm_packet_filter = g_usb_setup.wValue;
+            usb_arm_in_status();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool ncm_out_control_tasks(void)
+{
+    if(m_ntb_in_size_wait)
+    {
+        m_ntb_in_size_wait = false;
+        if(m_host_ntb_in_size < (NTB_IN_PAYLOAD_START + 14)) return false; // Couldn't fit a single frame.
+        
+        // The host may offer more than we have, only ever send what both sides can take.
+        m_ntb_in_size  = m_host_ntb_in_size;
+        m_ntb_in_limit = m_host_ntb_in_size < NCM_NTB_IN_MAX_SIZE ? (uint16_t)m_host_ntb_in_size : NCM_NTB_IN_MAX_SIZE;
+        return true;
+    }
+    return false;
+}
+
+void ncm_init(void)
+{
+    g_ncm_packet_filter = 0;
+    m_ntb_in_size       = NCM_NTB_IN_MAX_SIZE;
+    m_ntb_in_limit      = NCM_NTB_IN_MAX_SIZE;
+    m_ntb_format        = 0;
+    m_ntb_in_size_wait  = false;
+    m_data_alt_setting  = 0;
+    m_notify_state      = NOTIFY_NONE;
+    
+    // BD settings (DATA EP addresses are set each time it is armed).
+    g_usb_bd_table[NCM_COM_BD_IN].STAT  = 0;
+    g_usb_bd_table[NCM_COM_BD_IN].ADR   = NCM_COM_EP_IN_BUFFER_BASE_ADDR;
+    g_usb_bd_table[NCM_DAT_BD_OUT].STAT = 0;
+    g_usb_bd_table[NCM_DAT_BD_IN].STAT  = 0;
+    
+    // EP Settings
+    NCM_COM_UEPbits.EPHSHK   = 1; // Handshaking enabled 
+    NCM_COM_UEPbits.EPINEN   = 1; // EP input enabled
+    NCM_DAT_UEPbits.EPHSHK   = 1; // Handshaking enabled 
+    NCM_DAT_UEPbits.EPCONDIS = 0; // Don't allow SETUP
+    NCM_DAT_UEPbits.EPOUTEN  = 1; // EP output enabled
+    NCM_DAT_UEPbits.EPINEN   = 1; // EP input enabled
+    
+    g_usb_ep_stat[NCM_COM_EP][IN].Halt  = 0;
+    g_usb_ep_stat[NCM_DAT_EP][OUT].Halt = 0;
+    g_usb_ep_stat[NCM_DAT_EP][IN].Halt  = 0;
+    NCM_COM_EP_IN_DATA_TOGGLE_VAL  = 0;
+    NCM_DAT_EP_OUT_DATA_TOGGLE_VAL = 0;
+    NCM_DAT_EP_IN_DATA_TOGGLE_VAL  = 0;
+    
+    reset_ntbs(); // Nothing is armed on the DATA EP until alt setting 1 is selected.
+}
+
+bool ncm_set_interface(uint8_t alternate_setting, uint8_t interface)
+{
+    if(interface == NCM_COM_INT && alternate_setting == 0)
+    {
+        NCM_COM_EP_IN_DATA_TOGGLE_VAL = 0;
+        return true;
+    }
+    if(interface != NCM_DAT_INT || alternate_setting > 1) return false;
+    
+    // Selecting either setting resets the function, alt 1 starts it.
+    g_usb_bd_table[NCM_DAT_BD_OUT].STAT = 0;
+    g_usb_bd_table[NCM_DAT_BD_IN].STAT  = 0;
+    NCM_DAT_EP_OUT_DATA_TOGGLE_VAL = 0;
+    NCM_DAT_EP_IN_DATA_TOGGLE_VAL  = 0;
+    reset_ntbs();
+    m_in_sequence = 0;
+    m_data_alt_setting = alternate_setting;
+    
+    if(alternate_setting == 1)
+    {
+        arm_ntb_out();
+        m_notify_state = NOTIFY_SPEED;
+        send_notification();
+    }
+    return true;
+}
+
+bool ncm_get_interface(uint8_t* alternate_setting_result, uint8_t interface)
+{
+    if(interface == NCM_COM_INT) *alternate_setting_result = 0;
+    else if(interface == NCM_DAT_INT) *alternate_setting_result = m_data_alt_setting;
+    else return false;
+    return true;
+}
+
+void ncm_clear_halt(uint8_t bd_table_index, uint8_t ep, uint8_t dir)
+{
+    g_usb_ep_stat[ep][dir].Data_Toggle_Val = 0;
+    g_usb_ep_stat[ep][dir].Halt = 0;
+    g_usb_bd_table[bd_table_index].STAT = 0;
+    
+    if(ep != NCM_DAT_EP || m_data_alt_setting == 0) return;
+    if(dir == OUT)
+    {
+        m_out_state = NTB_OUT_RECEIVING;
+        m_out_received = 0;
+        arm_ntb_out();
+    }
+    else if(m_in_state == NTB_IN_SENDING) m_in_state = NTB_IN_EMPTY; // NTB is lost.
+}
+
+void ncm_tasks(void)
+{
+    uint8_t cnt;
+    
+    switch(TRANSACTION_EP)
+    {
+        case NCM_COM_EP:
+            NCM_COM_EP_IN_DATA_TOGGLE_VAL ^= 1;
+            if(m_notify_state == NOTIFY_SPEED) m_notify_state = NOTIFY_CONNECTION;
+            else m_notify_state = NOTIFY_NONE;
+            send_notification();
+            break;
+        case NCM_DAT_EP:
+            if(TRANSACTION_DIR == OUT)
+            {
+                NCM_DAT_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+                cnt = g_usb_bd_table[NCM_DAT_BD_OUT].CNT;
+                m_out_received += cnt;
+                
+                // A short packet, or a full buffer, ends the NTB.
+                if(cnt < NCM_DAT_EP_SIZE || m_out_received >= NCM_NTB_OUT_MAX_SIZE)
+                {
+                    if(ntb_out_valid())
+                    {
+                        m_out_ndp_index = NTH16_OUT.wNdpIndex;
+                        m_out_datagram  = 0;
+                        m_out_state     = NTB_OUT_READY; // ncm_receive_frame() re-arms when done.
+                        break;
+                    }
+                    m_out_received = 0; // Drop it.
+                }
+                arm_ntb_out();
+            }
+            else
+            {
+                NCM_DAT_EP_IN_DATA_TOGGLE_VAL ^= 1;
+                if(m_in_sent < m_in_length || m_in_zlp) arm_ntb_in();
+                else m_in_state = NTB_IN_EMPTY;
+            }
+            break;
+    }
+}
+
+bool ncm_send_frame(const uint8_t* frame, uint16_t len)
+{
+    uint16_t offset;
+    uint8_t* p_dst;
+    
+    if(m_data_alt_setting == 0 || len < 14 || len > NCM_IN_MAX_DATAGRAM_SIZE) return false;
+    if(m_in_state == NTB_IN_SENDING) return false;
+    
+    if(m_in_state == NTB_IN_EMPTY)
+    {
+        offset = NTB_IN_PAYLOAD_START;
+        m_in_datagrams = 0;
+    }
+    else offset = (m_in_length + (NCM_NDP_ALIGNMENT - 1)) & ~(uint16_t)(NCM_NDP_ALIGNMENT - 1);
+    
+    if(m_in_datagrams == NCM_NTB_IN_MAX_DATAGRAMS || (offset + len) > m_ntb_in_limit)
+    {
+        if(m_in_state == NTB_IN_EMPTY) return false; // Longer than the host's NTB input size allows.
+        m_flush = true; // Full, send it and let the caller try again.
+        return false;
+    }
+    
+    p_dst = &g_ncm_ntb_in[offset];
+    m_in_length = offset + len;
+    while(len--) *p_dst++ = *frame++;
+    
+    NDP16_IN.Datagram[m_in_datagrams].wDatagramIndex  = offset;
+    NDP16_IN.Datagram[m_in_datagrams].wDatagramLength = m_in_length - offset;
+    m_in_datagrams++;
+    
+    if(m_in_state == NTB_IN_EMPTY)
+    {
+        #ifdef USE_SOF
+        m_in_frames = 0;
+        #endif
+        m_in_state  = NTB_IN_FILLING;
+    }
+    return true;
+}
+
+void ncm_flush(void)
+{
+    m_flush = true;
+}
+
+void ncm_flush_tasks(void)
+{
+    uint8_t i;
+    
+    if(m_in_state != NTB_IN_FILLING) return;
+    #ifdef USE_SOF
+    if(!m_flush && m_in_datagrams < NCM_NTB_IN_MAX_DATAGRAMS && m_in_frames < NCM_IN_AGGREGATION_FRAMES) return;
+    #endif
+    m_flush = false;
+    
+    NTH16_IN.dwSignature   = NTH16_SIGNATURE;
+    NTH16_IN.wHeaderLength = NTH16_SIZE;
+    NTH16_IN.wSequence     = m_in_sequence++;
+    NTH16_IN.wBlockLength  = m_in_length;
+    NTH16_IN.wNdpIndex     = NTH16_SIZE;
+    NDP16_IN.dwSignature   = NDP16_SIGNATURE;
+    NDP16_IN.wLength       = NDP16_SIZE(NCM_NTB_IN_MAX_DATAGRAMS);
+    NDP16_IN.wNextNdpIndex = 0;
+    for(i = m_in_datagrams; i <= NCM_NTB_IN_MAX_DATAGRAMS; i++) // Null entries end the table.
+    {
+        NDP16_IN.Datagram[i].wDatagramIndex  = 0;
+        NDP16_IN.Datagram[i].wDatagramLength = 0;
+    }
+    
+    // A transfer that ends on a full packet needs a ZLP, unless it fills the host's NTB input size.
+    // Comparing with m_ntb_in_limit would miss this when the host takes more than we send.
+    m_in_zlp  = ((m_in_length & (NCM_DAT_EP_SIZE - 1)) == 0) && (m_in_length != m_ntb_in_size);
+    m_in_sent = 0;
+    
+    USB_INTERRUPT_ENABLE = 0;
+    m_in_state = NTB_IN_SENDING;
+    arm_ntb_in();
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+bool ncm_receive_frame(uint8_t** frame, uint16_t* len)
+{
+    ncm_ndp16_t* p_ndp;
+    ncm_dpe16_t* p_dpe;
+    uint16_t block_length;
+    
+    if(m_out_state != NTB_OUT_READY) return false;
+    block_length = NTH16_OUT.wBlockLength;
+    
+    while(m_out_ndp_index != 0)
+    {
+        p_ndp = (ncm_ndp16_t*)&g_ncm_ntb_out[m_out_ndp_index];
+        
+        // Entries start after the 8 byte NDP header, the table ends at a null entry or wLength.
+        if(NDP16_HEADER_SIZE + ((m_out_datagram + 1) * 4) <= p_ndp->wLength
+            && (m_out_ndp_index + NDP16_HEADER_SIZE + ((m_out_datagram + 1) * 4)) <= block_length)
+        {
+            p_dpe = &p_ndp->Datagram[m_out_datagram++];
+            if(p_dpe->wDatagramIndex != 0 && p_dpe->wDatagramLength != 0)
+            {
+                if((p_dpe->wDatagramIndex + p_dpe->wDatagramLength) > block_length) continue; // Skip bad pointers.
+                *frame = &g_ncm_ntb_out[p_dpe->wDatagramIndex];
+                *len   = p_dpe->wDatagramLength;
+                return true;
+            }
+        }
+        
+        // Next NDP in the chain.
+        m_out_ndp_index = p_ndp->wNextNdpIndex;
+        m_out_datagram  = 0;
+        if(m_out_ndp_index != 0)
+        {
+            if((m_out_ndp_index & (NCM_NDP_ALIGNMENT - 1)) || (m_out_ndp_index + NDP16_SIZE(0)) > block_length) break;
+            if(((ncm_ndp16_t*)&g_ncm_ntb_out[m_out_ndp_index])->dwSignature != NDP16_SIGNATURE) break;
+        }
+    }
+    
+    // NTB used up, receive the next one.
+    USB_INTERRUPT_ENABLE = 0;
+    m_out_received = 0;
+    m_out_state = NTB_OUT_RECEIVING;
+    arm_ntb_out();
+    USB_INTERRUPT_ENABLE = 1;
+    return false;
+}
+
+void ncm_set_connection(bool connected)
+{
+    USB_INTERRUPT_ENABLE = 0;
+    m_connected = connected;
+    if(m_data_alt_setting == 1 && m_notify_state == NOTIFY_NONE)
+    {
+        m_notify_state = NOTIFY_SPEED;
+        send_notification();
+    }
+    else if(m_data_alt_setting == 1) m_notify_state = NOTIFY_SPEED; // Resend both once the current one is done.
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+#ifdef USE_SOF
+void ncm_sof(void)
+{
+    if(m_in_state == NTB_IN_FILLING && m_in_frames != 0xFF) m_in_frames++;
+}
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *********************** LOCAL FUNCTIONS ********************************** */
+/* ************************************************************************** */
+
+static void arm_ntb_out(void)
+{
+    uint16_t remaining = NCM_NTB_OUT_MAX_SIZE - m_out_received;
+    
+    g_usb_bd_table[NCM_DAT_BD_OUT].ADR = NCM_NTB_OUT_BUFFER_BASE_ADDR + m_out_received;
+    usb_arm_endpoint(&g_usb_bd_table[NCM_DAT_BD_OUT], &g_usb_ep_stat[NCM_DAT_EP][OUT],
+                     remaining < NCM_DAT_EP_SIZE ? (uint8_t)remaining : NCM_DAT_EP_SIZE);
+}
+
+static void arm_ntb_in(void)
+{
+    uint16_t remaining = m_in_length - m_in_sent;
+    uint8_t  cnt = remaining < NCM_DAT_EP_SIZE ? (uint8_t)remaining : NCM_DAT_EP_SIZE;
+    
+    if(cnt == 0) m_in_zlp = false; // This is the ZLP.
+    g_usb_bd_table[NCM_DAT_BD_IN].ADR = NCM_NTB_IN_BUFFER_BASE_ADDR + m_in_sent;
+    m_in_sent += cnt;
+    usb_arm_endpoint(&g_usb_bd_table[NCM_DAT_BD_IN], &g_usb_ep_stat[NCM_DAT_EP][IN], cnt);
+}
+
+static bool ntb_out_valid(void)
+{
+    if(m_out_received < (NTH16_SIZE + NDP16_SIZE(0))) return false;
+    if(NTH16_OUT.dwSignature != NTH16_SIGNATURE || NTH16_OUT.wHeaderLength != NTH16_SIZE) return false;
+    if(NTH16_OUT.wBlockLength > m_out_received) return false;
+    if(NTH16_OUT.wNdpIndex < NTH16_SIZE || (NTH16_OUT.wNdpIndex & (NCM_NDP_ALIGNMENT - 1))) return false;
+    if((NTH16_OUT.wNdpIndex + NDP16_SIZE(0)) > NTH16_OUT.wBlockLength) return false;
+    return ((ncm_ndp16_t*)&g_ncm_ntb_out[NTH16_OUT.wNdpIndex])->dwSignature == NDP16_SIGNATURE;
+}
+
+static void send_notification(void)
+{
+    ncm_notification_t* p_notification = (ncm_notification_t*)g_ncm_com_ep_in;
+    
+    if(m_notify_state == NOTIFY_NONE) return;
+    
+    p_notification->bmRequestType = 0xA1;
+    p_notification->wIndex = NCM_COM_INT;
+    if(m_notify_state == NOTIFY_SPEED)
+    {
+        p_notification->bNotification = NCM_CONNECTION_SPEED_CHANGE;
+        p_notification->wValue    = 0;
+        p_notification->wLength   = 8;
+        p_notification->DLBitRate = NCM_LINK_SPEED;
+        p_notification->ULBitRate = NCM_LINK_SPEED;
+        usb_arm_endpoint(&g_usb_bd_table[NCM_COM_BD_IN], &g_usb_ep_stat[NCM_COM_EP][IN], 16);
+    }
+    else
+    {
+        p_notification->bNotification = NCM_NETWORK_CONNECTION;
+        p_notification->wValue  = m_connected ? 1 : 0;
+        p_notification->wLength = 0;
+        usb_arm_endpoint(&g_usb_bd_table[NCM_COM_BD_IN], &g_usb_ep_stat[NCM_COM_EP][IN], 8);
+    }
+}
+
+static void reset_ntbs(void)
+{
+    m_in_state     = NTB_IN_EMPTY;
+    m_in_length    = 0;
+    m_in_datagrams = 0;
+    m_in_sent      = 0;
+    m_in_zlp       = false;
+    m_flush        = false;
+    m_out_state    = NTB_OUT_RECEIVING;
+    m_out_received = 0;
+}
+
+/* ************************************************************************** */
@@ -0,0 +1,370 @@
+/**
+ * @file usb_cdc_ncm.h
+ * @brief <i>Communications Device Class</i> NCM (Network Control Model) header file.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - CDC Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CDC_NCM_H
+#define CDC_NCM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_config.h"
+#include "usb_cdc_ncm_config.h"
+#include "usb_hal.h"
+
+/* ************************************************************************** */
+/* ************************* RAM AND MODE CHECKS **************************** */
+/* ************************************************************************** */
+
+#ifdef _PIC14E
+#error "CDC-NCM needs more USB RAM than PIC16F145X devices have."
+#endif
+
+#if PINGPONG_MODE == PINGPONG_DIS
+#define NCM_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*2))
+#elif PINGPONG_MODE == PINGPONG_0_OUT
+#define NCM_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*3))
+#else
+#error "NTBs are received and sent in place, pingpong buffering NCM's DATA EP isn't supported. PINGPONG_0_OUT is recommended."
+#endif
+
+#if NCM_DAT_EP_SIZE != 64
+#error "NCM DATA EP must be 64 bytes."
+#endif
+
+#if NCM_COM_EP_SIZE < 16
+#error "NCM COM EP must fit a 16 byte CONNECTION_SPEED_CHANGE notification."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** NCM BUFFER ADDRESSES ************************** */
+/* ************************************************************************** */
+
+// The DATA EP has no buffers of its own, its BDs point into the NTB buffers.
+#define NCM_COM_EP_IN_BUFFER_BASE_ADDR  NCM_EP_BUFFERS_STARTING_ADDR
+#define NCM_NTB_OUT_BUFFER_BASE_ADDR   (NCM_EP_BUFFERS_STARTING_ADDR + NCM_COM_EP_SIZE)
+#define NCM_NTB_IN_BUFFER_BASE_ADDR    (NCM_NTB_OUT_BUFFER_BASE_ADDR + NCM_NTB_OUT_MAX_SIZE)
+
+// The IN NTB is the highest buffer, it must still be in USB RAM.
+#if defined(USB_RAM_END_ADDR) && (NCM_NTB_IN_BUFFER_BASE_ADDR + NCM_NTB_IN_MAX_SIZE) > USB_RAM_END_ADDR
+#error "NTB buffers run past USB RAM, lower NCM_NTB_OUT_MAX_SIZE or NCM_NTB_IN_MAX_SIZE."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *********************** EP STAT TOGGLE VAL HAL *************************** */
+/* ************************************************************************** */
+
+#define NCM_COM_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[NCM_COM_EP][IN].Data_Toggle_Val
+#define NCM_DAT_EP_OUT_DATA_TOGGLE_VAL g_usb_ep_stat[NCM_DAT_EP][OUT].Data_Toggle_Val
+#define NCM_DAT_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[NCM_DAT_EP][IN].Data_Toggle_Val
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** NCM CLASS CODES ****************************** */
+/* ************************************************************************** */
+
+// Communication Interface Class SubClass Code
+#define CIC_NCM 0x0D
+
+// Data Interface Class Protocol Code
+#define DIC_NCM_NTB 0x01
+
+// bDescriptor SubType in Functional Descriptors
+#define DESC_SUB_NCM 0x1A
+
+// bmNetworkCapabilities
+#define NCM_CAP_PACKET_FILTER    0x01
+#define NCM_CAP_NET_ADDRESS      0x02
+#define NCM_CAP_ENCAPSULATED     0x04
+#define NCM_CAP_MAX_DATAGRAM     0x08
+#define NCM_CAP_CRC_MODE         0x10
+#define NCM_CAP_NTB_INPUT_SIZE_8 0x20
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** NCM REQUESTS ******************************** */
+/* ************************************************************************** */
+
+#define SET_ETHERNET_PACKET_FILTER 0x43
+#define GET_NTB_PARAMETERS         0x80
+#define GET_NET_ADDRESS            0x81
+#define SET_NET_ADDRESS            0x82
+#define GET_NTB_FORMAT             0x83
+#define SET_NTB_FORMAT             0x84
+#define GET_NTB_INPUT_SIZE         0x85
+#define SET_NTB_INPUT_SIZE         0x86
+#define GET_MAX_DATAGRAM_SIZE      0x87
+#define SET_MAX_DATAGRAM_SIZE      0x88
+#define GET_CRC_MODE               0x89
+#define SET_CRC_MODE               0x8A
+
+// Notifications
+#define NCM_NETWORK_CONNECTION      0x00
+#define NCM_CONNECTION_SPEED_CHANGE 0x2A
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ****************************** NTB DEFINES ******************************* */
+/* ************************************************************************** */
+
+#define NTH16_SIGNATURE   0x484D434EUL // "NCMH"
+#define NDP16_SIGNATURE   0x304D434EUL // "NCM0" (no CRC)
+#define NTH16_SIZE        12
+#define NDP16_HEADER_SIZE 8
+#define NDP16_SIZE(datagrams) (NDP16_HEADER_SIZE + (((datagrams) + 1) * 4)) // Includes null entry.
+
+#define NCM_NDP_ALIGNMENT 4 // wNdpInAlignment, wNdpInDivisor and wNdpOutAlignment.
+
+// Largest Ethernet frame (with header, no FCS) that fits in one NTB either way.
+// A 1514 byte frame needs NTBs of over 1.5KB each way, more USB RAM than any
+// supported part has. Linux raises its max datagram size to 1514 whatever
+// wMaxSegmentSize says, so its MTU stays 1500 and bigger frames are lost: the
+// host drops those that don't fit an OUT NTB, ncm_send_frame() refuses the 
+// rest. Set the host's MTU to NCM_MAX_SEGMENT_SIZE - 14, e.g.
+// ip link set usb0 mtu 330
+#define NCM_IN_MAX_DATAGRAM_SIZE  (NCM_NTB_IN_MAX_SIZE - NTH16_SIZE - NDP16_SIZE(NCM_NTB_IN_MAX_DATAGRAMS))
+#define NCM_OUT_MAX_DATAGRAM_SIZE (NCM_NTB_OUT_MAX_SIZE - NTH16_SIZE - NDP16_SIZE(NCM_NTB_OUT_MAX_DATAGRAMS))
+#if NCM_IN_MAX_DATAGRAM_SIZE < NCM_OUT_MAX_DATAGRAM_SIZE
+#define NCM_MAX_SEGMENT_SIZE NCM_IN_MAX_DATAGRAM_SIZE // Use for wMaxSegmentSize.
+#else
+#define NCM_MAX_SEGMENT_SIZE NCM_OUT_MAX_DATAGRAM_SIZE // Use for wMaxSegmentSize.
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TYPES ********************************** */
+/* ************************************************************************** */
+
+// NCM Functional Descriptor
+typedef struct
+{
+    uint8_t  bFunctionLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint16_t bcdNcmVersion;
+    uint8_t  bmNetworkCapabilities;
+}cdc_ncm_functional_descriptor_t;
+
+// NTB Parameter Structure (GET_NTB_PARAMETERS)
+typedef struct
+{
+    uint16_t wLength;
+    uint16_t bmNtbFormatsSupported;
+    uint32_t dwNtbInMaxSize;
+    uint16_t wNdpInDivisor;
+    uint16_t wNdpInPayloadRemainder;
+    uint16_t wNdpInAlignment;
+    uint16_t wReserved;
+    uint32_t dwNtbOutMaxSize;
+    uint16_t wNdpOutDivisor;
+    uint16_t wNdpOutPayloadRemainder;
+    uint16_t wNdpOutAlignment;
+    uint16_t wNtbOutMaxDatagrams;
+}ncm_ntb_parameters_t;
+
+// NTB Header (16-bit)
+typedef struct
+{
+    uint32_t dwSignature;
+    uint16_t wHeaderLength;
+    uint16_t wSequence;
+    uint16_t wBlockLength;
+    uint16_t wNdpIndex;
+}ncm_nth16_t;
+
+// Datagram Pointer Entry (16-bit)
+typedef struct
+{
+    uint16_t wDatagramIndex;
+    uint16_t wDatagramLength;
+}ncm_dpe16_t;
+
+// NTB Datagram Pointer Table (16-bit)
+typedef struct
+{
+    uint32_t    dwSignature;
+    uint16_t    wLength;
+    uint16_t    wNextNdpIndex;
+    ncm_dpe16_t Datagram[1];
+}ncm_ndp16_t;
+
+// NETWORK_CONNECTION and CONNECTION_SPEED_CHANGE Notification
+typedef union
+{
+    uint8_t array[16];
+    struct
+    {
+        uint8_t  bmRequestType;
+        uint8_t  bNotification;
+        uint16_t wValue;
+        uint16_t wIndex;
+        uint16_t wLength;
+        uint32_t DLBitRate;
+        uint32_t ULBitRate;
+    };
+}ncm_notification_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************** VARIABLES FROM: usb_cdc_ncm.c *********************** */
+/* ************************************************************************** */
+
+extern uint8_t g_ncm_com_ep_in[NCM_COM_EP_SIZE]   __at(NCM_COM_EP_IN_BUFFER_BASE_ADDR);
+extern uint8_t g_ncm_ntb_out[NCM_NTB_OUT_MAX_SIZE] __at(NCM_NTB_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_ncm_ntb_in[NCM_NTB_IN_MAX_SIZE]   __at(NCM_NTB_IN_BUFFER_BASE_ADDR);
+
+extern volatile uint16_t g_ncm_packet_filter; // Last SET_ETHERNET_PACKET_FILTER bitmap.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** NCM FUNCTIONS ******************************** */
+/* ************************************************************************** */
+
+bool ncm_class_request(void);
+void ncm_init(void);
+void ncm_tasks(void);
+bool ncm_out_control_tasks(void);
+bool ncm_set_interface(uint8_t alternate_setting, uint8_t interface);
+bool ncm_get_interface(uint8_t* alternate_setting_result, uint8_t interface);
+void ncm_clear_halt(uint8_t bd_table_index, uint8_t ep, uint8_t dir);
+
+/**
+ * @fn bool ncm_send_frame(const uint8_t* frame, uint16_t len)
+ * 
+ * @brief Adds an Ethernet frame to the IN NTB being built.
+ * 
+ * The frame is copied into the NTB, so the caller's buffer is free once this
+ * returns true. Frames are aggregated until the NTB is full, the aggregation
+ * time runs out, or ncm_flush() is called. Call from main context only.
+ * 
+ * @param[in] frame Ethernet frame, starting with the destination MAC.
+ * @param[in] len Frame length (14 to NCM_IN_MAX_DATAGRAM_SIZE, less if the
+ * host set an NTB input size below NCM_NTB_IN_MAX_SIZE).
+ * 
+ * @return Returns false if the link is down, the frame is too long, or the NTB
+ * is in flight or full. Try again after calling ncm_flush_tasks().
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * while(!ncm_send_frame(frame, frame_len)) ncm_flush_tasks();
+ * @endcode
+ * </li></ul>
+ */
+bool ncm_send_frame(const uint8_t* frame, uint16_t len);
+
+/**
+ * @fn bool ncm_receive_frame(uint8_t** frame, uint16_t* len)
+ * 
+ * @brief Gets the next Ethernet frame received from the host.
+ * 
+ * Frames are returned in place inside the received NTB. The pointer stays
+ * valid until the next call, which moves to the next datagram. Once the
+ * last datagram of the NTB has been returned, the next call re-arms the
+ * DATA EP for a new NTB. Call from main context only.
+ * 
+ * @param[out] frame Set to the start of the frame.
+ * @param[out] len Set to the frame length.
+ * 
+ * @return Returns true if a frame was returned.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * uint8_t* frame;
+ * uint16_t len;
+ * while(ncm_receive_frame(&frame, &len)) net_input(frame, len);
+ * @endcode
+ * </li></ul>
+ */
+bool ncm_receive_frame(uint8_t** frame, uint16_t* len);
+
+/**
+ * @fn void ncm_flush(void)
+ * 
+ * @brief Sends the IN NTB being built on the next ncm_flush_tasks().
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * ncm_flush();
+ * ncm_flush_tasks();
+ * @endcode
+ * </li></ul>
+ */
+void ncm_flush(void);
+
+/**
+ * @fn void ncm_flush_tasks(void)
+ * 
+ * @brief Starts sending the IN NTB when it is due.
+ * 
+ * Call from the main loop. An NTB is due when it is full, ncm_flush() was
+ * called, or NCM_IN_AGGREGATION_FRAMES have passed since its first datagram.
+ */
+void ncm_flush_tasks(void);
+
+/**
+ * @fn void ncm_set_connection(bool connected)
+ * 
+ * @brief Reports the network link state to the host.
+ * 
+ * Queues CONNECTION_SPEED_CHANGE and NETWORK_CONNECTION notifications.
+ * 
+ * @param[in] connected true if the network link is up.
+ */
+void ncm_set_connection(bool connected);
+
+#ifdef USE_SOF
+/**
+ * @fn void ncm_sof(void)
+ * 
+ * @brief Runs the IN NTB aggregation timer, call from usb_sof().
+ */
+void ncm_sof(void);
+#endif
+
+/* ************************************************************************** */
+
+#endif /* CDC_NCM_H */
@@ -99,6 +99,9 @@
 #define DEVICE_QUALIFIER_DESC          6
 #define OTHER_SPEED_CONFIGURATION_DESC 7
 #define INTERFACE_POWER_DESC           8
+#define INTERFACE_ASSOCIATION_DESC     11
+#define BOS_DESC                       15
+#define DEVICE_CAPABILITY_DESC         16
 
 /* ************************************************************************** */
 
@@ -109,9 +112,17 @@
 
 /// Class Codes
 #define NA  0
+#define AUDIO 1
 #define CDC 2
 #define HID 3
 #define MSC 8
+#define APP_SPECIFIC 0xFE
+#define MISC 0xEF
+#define VENDOR_CLASS 0xFF
+
+/// Miscellaneous Device Class SubClass and Protocol (Interface Association Descriptor)
+#define MISC_SUBCLASS_COMMON 0x02
+#define MISC_PROTOCOL_IAD    0x01
 
 /* ************************************************************************** */
 
@@ -396,6 +407,19 @@ typedef struct
     uint8_t  bInterval;
 }ch9_standard_endpoint_descriptor_t;
 
+/// Interface Association Descriptor Structure
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bFirstInterface;
+    uint8_t  bInterfaceCount;
+    uint8_t  bFunctionClass;
+    uint8_t  bFunctionSubClass;
+    uint8_t  bFunctionProtocol;
+    uint8_t  iFunction;
+}ch9_interface_association_descriptor_t;
+
 /* ************************************************************************** */
 
 #endif /* USB_CH9_H */
\ No newline at end of file
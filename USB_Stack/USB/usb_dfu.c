@@ -0,0 +1,391 @@
+/**
+ * @file usb_dfu.c
+ * @brief <i>DFU</i> 1.1 class core.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - DFU Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+#include "usb.h"
+#include "usb_dfu.h"
+#include "usb_ch9.h"
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+static uint8_t          m_state;
+static uint8_t          m_status;
+static uint8_t          m_reply[6];      // GETSTATUS/GETSTATE data.
+
+// Two blocks, one is filled by DNLOAD while the other is programmed.
+static uint8_t          m_blocks[2][DFU_TRANSFER_SIZE];
+static dfu_addr_t       m_block_addr[2];
+static uint8_t          m_block_rows[2];
+static uint8_t          m_block_erases[2];
+static volatile uint8_t m_queued;        // Blocks received and not yet programmed.
+static uint8_t          m_prog;          // Block being programmed.
+static uint8_t          m_fill;          // Block the DNLOAD data stage fills.
+static uint16_t         m_dnload_length;
+static bool             m_dnload_wait;
+static dfu_addr_t       m_next_addr;     // Where the next DNLOAD/UPLOAD block goes.
+
+// Progress through m_blocks[m_prog], only moved by dfu_tasks() once loaded.
+static dfu_addr_t       m_prog_addr;
+static uint8_t*         m_prog_data;
+static volatile uint8_t m_prog_rows;     // Row writes left.
+static volatile uint8_t m_prog_erases;   // Erases left.
+static bool             m_row_erased;
+
+// Erase and row write times (ms), measured by dfu_tasks().
+static uint8_t          m_erase_ms = DFU_ERASE_MS;
+static uint8_t          m_write_ms = DFU_WRITE_MS;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************* LOCAL FUNCTION DECLARATIONS ************************ */
+/* ************************************************************************** */
+
+/**
+ * @fn bool request_error(uint8_t status)
+ * 
+ * @brief Enters dfuERROR with the status given.
+ * 
+ * @param[in] status DFU_STATUS_ERR_ value reported by GETSTATUS.
+ * 
+ * @return Returns false, so the request is stalled.
+ */
+static bool request_error(uint8_t status);
+
+/**
+ * @fn void load_block(uint8_t block)
+ * 
+ * @brief Points the programming progress at a received block.
+ * 
+ * @param[in] block Block index.
+ */
+static void load_block(uint8_t block);
+
+/**
+ * @fn uint32_t busy_ms(bool all_blocks)
+ * 
+ * @brief Works out how long programming has left to run.
+ * 
+ * @param[in] all_blocks Include the block waiting behind the one being programmed.
+ * 
+ * @return Milliseconds left.
+ */
+static uint32_t busy_ms(bool all_blocks);
+
+/**
+ * @fn uint8_t elapsed_ms(uint16_t start_frame)
+ * 
+ * @brief Milliseconds since a frame number, rounded up.
+ * 
+ * @param[in] start_frame USB frame number at the start.
+ * 
+ * @return Milliseconds, at least 1.
+ */
+static uint8_t elapsed_ms(uint16_t start_frame);
+
+/**
+ * @fn uint16_t frame_number(void)
+ * 
+ * @brief Reads the 11-bit USB frame number.
+ * 
+ * @return Frame number.
+ */
+static uint16_t frame_number(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** DFU FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+bool dfu_class_request(void)
+{
+    uint16_t length;
+    uint32_t poll_ms;
+    
+    if(g_usb_setup.bmRequestType_bits.Recipient != INTERFACE) return false;
+    if((uint8_t)g_usb_setup.wIndex != DFU_INT) return false;
+    
+    switch(g_usb_setup.bRequest)
+    {
+        case DFU_DNLOAD:
+            if(m_state == DFU_STATE_IDLE)
+            {
+                if(g_usb_setup.wLength == 0) return request_error(DFU_STATUS_ERR_STALLEDPKT);
+                m_next_addr = DFU_APP_START;
+            }
+            else if(m_state != DFU_STATE_DNLOAD_IDLE) return request_error(DFU_STATUS_ERR_STALLEDPKT);
+            
+            if(g_usb_setup.wLength == 0) // End of the image.
+            {
+                m_state = DFU_STATE_MANIFEST_SYNC;
+                usb_set_control_stage(STATUS_IN_STAGE);
+                usb_arm_in_status();
+                return true;
+            }
+            if(g_usb_setup.wLength > DFU_TRANSFER_SIZE || m_queued == 2) return request_error(DFU_STATUS_ERR_STALLEDPKT);
+            
+            // Received into the free block while the other is programmed.
+            m_fill = (m_prog + m_queued) & 1;
+            usb_set_ram_ptr(m_blocks[m_fill]);
+            usb_set_num_out_control_bytes(g_usb_setup.wLength);
+            m_dnload_length = g_usb_setup.wLength;
+            m_dnload_wait = true;
+            usb_set_control_stage(DATA_OUT_STAGE);
+            return true;
+            
+        case DFU_UPLOAD:
+            if(m_state == DFU_STATE_IDLE)
+            {
+                if(m_queued) return request_error(DFU_STATUS_ERR_NOTDONE); // Flash is still being programmed.
+                m_next_addr = DFU_APP_START;
+            }
+            else if(m_state != DFU_STATE_UPLOAD_IDLE) return request_error(DFU_STATUS_ERR_STALLEDPKT);
+            
+            length = g_usb_setup.wLength < DFU_TRANSFER_SIZE ? g_usb_setup.wLength : DFU_TRANSFER_SIZE;
+            if(((uint32_t)(DFU_APP_END - m_next_addr) * DFU_BYTES_PER_ADDR) < length)
+            {
+                length = (uint16_t)((DFU_APP_END - m_next_addr) * DFU_BYTES_PER_ADDR);
+            }
+            dfu_read(m_next_addr, length, m_blocks[0]);
+            m_next_addr += (dfu_addr_t)(length / DFU_BYTES_PER_ADDR);
+            m_state = length < g_usb_setup.wLength ? DFU_STATE_IDLE : DFU_STATE_UPLOAD_IDLE; // Short block ends it.
+            usb_set_ram_ptr(m_blocks[0]);
+            usb_setup_in_control_transfer(RAM, length, g_usb_setup.wLength);
+            usb_in_control_transfer();
+            usb_set_control_stage(DATA_IN_STAGE);
+            return true;
+            
+        case DFU_GETSTATUS:
+            poll_ms = 0;
+            switch(m_state)
+            {
+                case DFU_STATE_DNLOAD_SYNC:
+                case DFU_STATE_DNBUSY:
+                    if(m_queued < 2) m_state = DFU_STATE_DNLOAD_IDLE; // A block is free for the next DNLOAD.
+                    else
+                    {
+                        m_state = DFU_STATE_DNBUSY;
+                        poll_ms = busy_ms(false);
+                    }
+                    break;
+                case DFU_STATE_MANIFEST_SYNC:
+                case DFU_STATE_MANIFEST:
+                    if(m_queued)
+                    {
+                        m_state = DFU_STATE_MANIFEST;
+                        poll_ms = busy_ms(true);
+                    }
+                    else m_state = DFU_STATE_IDLE; // Manifestation tolerant.
+                    break;
+            }
+            m_reply[0] = m_status;
+            m_reply[1] = (uint8_t)poll_ms;
+            m_reply[2] = (uint8_t)(poll_ms >> 8);
+            m_reply[3] = (uint8_t)(poll_ms >> 16);
+            m_reply[4] = m_state;
+            m_reply[5] = 0;
+            length = 6;
+            break;
+            
+        case DFU_GETSTATE:
+            m_reply[0] = m_state;
+            length = 1;
+            break;
+            
+        case DFU_CLRSTATUS:
+            if(m_state != DFU_STATE_ERROR) return request_error(DFU_STATUS_ERR_STALLEDPKT);
+            m_status = DFU_STATUS_OK;
+            m_state = DFU_STATE_IDLE;
+            usb_set_control_stage(STATUS_IN_STAGE);
+            usb_arm_in_status();
+            return true;
+            
+        case DFU_ABORT:
+            // A block already received is still programmed.
+            if(m_state != DFU_STATE_IDLE && m_state != DFU_STATE_DNLOAD_IDLE && m_state != DFU_STATE_UPLOAD_IDLE)
+            {
+                return request_error(DFU_STATUS_ERR_STALLEDPKT);
+            }
+            m_state = DFU_STATE_IDLE;
+            usb_set_control_stage(STATUS_IN_STAGE);
+            usb_arm_in_status();
+            return true;
+            
+        default: // DETACH is for run-time mode.
+            return request_error(DFU_STATUS_ERR_STALLEDPKT);
+    }
+    usb_set_ram_ptr(m_reply);
+    usb_setup_in_control_transfer(RAM, length, g_usb_setup.wLength);
+    usb_in_control_transfer();
+    usb_set_control_stage(DATA_IN_STAGE);
+    return true;
+}
+
+bool dfu_out_control_tasks(void)
+{
+    uint8_t    block;
+    uint8_t    rows;
+    uint8_t    erases;
+    uint16_t   i;
+    dfu_addr_t addr;
+    
+    if(!m_dnload_wait) return false;
+    m_dnload_wait = false;
+    
+    block = m_fill; // m_prog may have moved on since the SETUP.
+    rows  = (uint8_t)((m_dnload_length + (DFU_ROW_BYTES - 1)) / DFU_ROW_BYTES);
+    if(((uint32_t)(DFU_APP_END - m_next_addr) / _FLASH_WRITE_SIZE) < rows) return request_error(DFU_STATUS_ERR_ADDRESS);
+    
+    for(i = m_dnload_length; i < ((uint16_t)rows * DFU_ROW_BYTES); i++) m_blocks[block][i] = 0xFF; // Pad the last row.
+    
+    erases = 0;
+    for(i = 0, addr = m_next_addr; i < rows; i++, addr += _FLASH_WRITE_SIZE)
+    {
+        if((addr & (_FLASH_ERASE_SIZE - 1)) == 0) erases++;
+    }
+    
+    m_block_addr[block]   = m_next_addr;
+    m_block_rows[block]   = rows;
+    m_block_erases[block] = erases;
+    m_next_addr += (dfu_addr_t)rows * _FLASH_WRITE_SIZE;
+    
+    if(m_queued == 0) load_block(block);
+    m_queued++;
+    m_state = DFU_STATE_DNLOAD_SYNC;
+    return true;
+}
+
+void dfu_init(void)
+{
+    m_state       = DFU_STATE_IDLE;
+    m_status      = DFU_STATUS_OK;
+    m_dnload_wait = false;
+}
+
+uint8_t dfu_get_state(void)
+{
+    return m_state;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+static bool request_error(uint8_t status)
+{
+    m_status = status;
+    m_state  = DFU_STATE_ERROR;
+    return false;
+}
+
+static void load_block(uint8_t block)
+{
+    m_prog        = block;
+    m_prog_addr   = m_block_addr[block];
+    m_prog_data   = m_blocks[block];
+    m_prog_erases = m_block_erases[block];
+    m_prog_rows   = m_block_rows[block];
+    m_row_erased  = false;
+}
+
+static uint32_t busy_ms(bool all_blocks)
+{
+    uint32_t ms;
+    
+    ms = ((uint32_t)m_prog_rows * m_write_ms) + ((uint32_t)m_prog_erases * m_erase_ms);
+    if(all_blocks && m_queued == 2)
+    {
+        ms += ((uint32_t)m_block_rows[m_prog ^ 1] * m_write_ms) + ((uint32_t)m_block_erases[m_prog ^ 1] * m_erase_ms);
+    }
+    return ms;
+}
+
+static uint8_t elapsed_ms(uint16_t start_frame)
+{
+    uint16_t frames = (frame_number() - start_frame) & 0x7FF;
+    
+    return frames < 255 ? (uint8_t)(frames + 1) : 255; // Started part way through a frame.
+}
+
+static uint16_t frame_number(void)
+{
+    return ((uint16_t)UFRMH << 8) | UFRML;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+void dfu_tasks(void)
+{
+    uint16_t start_frame;
+    
+    if(m_queued == 0) return;
+    
+    if(!m_row_erased && (m_prog_addr & (_FLASH_ERASE_SIZE - 1)) == 0)
+    {
+        start_frame = frame_number();
+        dfu_erase(m_prog_addr);
+        m_erase_ms = elapsed_ms(start_frame);
+        m_row_erased = true;
+        m_prog_erases--;
+        return;
+    }
+    
+    start_frame = frame_number();
+    dfu_write_block(m_prog_addr, m_prog_data);
+    m_write_ms = elapsed_ms(start_frame);
+    m_row_erased = false;
+    m_prog_addr += _FLASH_WRITE_SIZE;
+    m_prog_data += DFU_ROW_BYTES;
+    m_prog_rows--;
+    
+    if(m_prog_rows == 0)
+    {
+        USB_INTERRUPT_ENABLE = 0;
+        m_queued--;
+        if(m_queued) load_block(m_prog ^ 1);
+        USB_INTERRUPT_ENABLE = 1;
+    }
+}
+
+/* ************************************************************************** */
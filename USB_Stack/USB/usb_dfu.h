@@ -0,0 +1,268 @@
+/**
+ * @file usb_dfu.h
+ * @brief <i>DFU</i> 1.1 class core header.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - DFU Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+#ifndef USB_DFU_H
+#define USB_DFU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_config.h"
+#include "usb_dfu_config.h"
+
+/* ************************************************************************** */
+/* ***************************** SETTING CHECKS ***************************** */
+/* ************************************************************************** */
+
+#if defined(_PIC14E)
+#define DFU_BYTES_PER_ADDR 2 // Flash words are sent low byte first.
+#else
+#define DFU_BYTES_PER_ADDR 1
+#endif
+
+#define DFU_ROW_BYTES (_FLASH_WRITE_SIZE * DFU_BYTES_PER_ADDR)
+
+#if (DFU_TRANSFER_SIZE % DFU_ROW_BYTES) || (DFU_TRANSFER_SIZE / DFU_ROW_BYTES) > 255
+#error "DFU_TRANSFER_SIZE must be a multiple of the flash write row, up to 255 rows."
+#endif
+
+#if DFU_APP_START & (_FLASH_ERASE_SIZE - 1)
+#error "DFU_APP_START must be at the start of an erase row."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** DFU CLASS CODES ****************************** */
+/* ************************************************************************** */
+
+// Interface Subclass and Protocol (class is APP_SPECIFIC)
+#define DFU_SUBCLASS      0x01
+#define DFU_PROTOCOL_MODE 0x02
+
+// DFU Functional Descriptor
+#define DFU_FUNCTIONAL_DESC 0x21
+
+// bmAttributes
+#define DFU_CAN_DNLOAD              0x01
+#define DFU_CAN_UPLOAD              0x02
+#define DFU_MANIFESTATION_TOLERANT  0x04
+#define DFU_WILL_DETACH             0x08
+#define DFU_ATTRIBUTES (DFU_CAN_DNLOAD | DFU_CAN_UPLOAD | DFU_MANIFESTATION_TOLERANT)
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ****************************** DFU REQUESTS ****************************** */
+/* ************************************************************************** */
+
+#define DFU_DETACH    0
+#define DFU_DNLOAD    1
+#define DFU_UPLOAD    2
+#define DFU_GETSTATUS 3
+#define DFU_CLRSTATUS 4
+#define DFU_GETSTATE  5
+#define DFU_ABORT     6
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** DFU STATES AND STATUS ************************* */
+/* ************************************************************************** */
+
+// bState
+#define DFU_STATE_APP_IDLE                0
+#define DFU_STATE_APP_DETACH              1
+#define DFU_STATE_IDLE                    2
+#define DFU_STATE_DNLOAD_SYNC             3
+#define DFU_STATE_DNBUSY                  4
+#define DFU_STATE_DNLOAD_IDLE             5
+#define DFU_STATE_MANIFEST_SYNC           6
+#define DFU_STATE_MANIFEST                7
+#define DFU_STATE_MANIFEST_WAIT_RESET     8
+#define DFU_STATE_UPLOAD_IDLE             9
+#define DFU_STATE_ERROR                   10
+
+// bStatus
+#define DFU_STATUS_OK                     0x00
+#define DFU_STATUS_ERR_TARGET             0x01
+#define DFU_STATUS_ERR_FILE               0x02
+#define DFU_STATUS_ERR_WRITE              0x03
+#define DFU_STATUS_ERR_ERASE              0x04
+#define DFU_STATUS_ERR_CHECK_ERASED       0x05
+#define DFU_STATUS_ERR_PROG               0x06
+#define DFU_STATUS_ERR_VERIFY             0x07
+#define DFU_STATUS_ERR_ADDRESS            0x08
+#define DFU_STATUS_ERR_NOTDONE            0x09
+#define DFU_STATUS_ERR_FIRMWARE           0x0A
+#define DFU_STATUS_ERR_VENDOR             0x0B
+#define DFU_STATUS_ERR_USBR               0x0C
+#define DFU_STATUS_ERR_POR                0x0D
+#define DFU_STATUS_ERR_UNKNOWN            0x0E
+#define DFU_STATUS_ERR_STALLEDPKT         0x0F
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TYPES ********************************** */
+/* ************************************************************************** */
+
+// Flash address (words on PIC16).
+#ifndef _PIC18
+typedef uint16_t dfu_addr_t;
+#else
+typedef uint24_t dfu_addr_t;
+#endif
+
+// DFU Functional Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bmAttributes;
+    uint16_t wDetachTimeOut;
+    uint16_t wTransferSize;
+    uint16_t bcdDFUVersion;
+}dfu_functional_descriptor_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** DFU FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool dfu_class_request(void)
+ * 
+ * @brief Used to service DFU Class Requests.
+ * 
+ * Only DFU mode is supported (protocol 2), so DETACH is stalled.
+ * 
+ * @return Returns true if the request was handled.
+ */
+bool dfu_class_request(void);
+
+/**
+ * @fn bool dfu_out_control_tasks(void)
+ * 
+ * @brief Queues a block received by DNLOAD for programming, called from usb_out_control_finished().
+ * 
+ * @return Returns false if the block falls outside of DFU_APP_START to DFU_APP_END.
+ */
+bool dfu_out_control_tasks(void);
+
+/**
+ * @fn void dfu_init(void)
+ * 
+ * @brief Returns the DFU function to dfuIDLE, called from usb_app_init().
+ */
+void dfu_init(void);
+
+/**
+ * @fn uint8_t dfu_get_state(void)
+ * 
+ * @brief Returns the DFU state (bState).
+ * 
+ * @return DFU_STATE_ value.
+ */
+uint8_t dfu_get_state(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn void dfu_tasks(void)
+ * 
+ * @brief Programs queued blocks one erase or row write per call.
+ * 
+ * The CPU stalls during each erase and write, so keeping them apart lets the
+ * USB interrupt receive the next block in between. Each erase and write is 
+ * timed with the USB frame counter, giving the times bwPollTimeout is 
+ * worked out from.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * while(1)
+ * {
+ *     dfu_tasks();
+ * }
+ * @endcode
+ * </li></ul>
+ */
+void dfu_tasks(void);
+
+/**
+ * @fn void dfu_read(dfu_addr_t addr, uint16_t bytes, uint8_t* p_data)
+ * 
+ * @brief Reads the image back for UPLOAD.
+ * 
+ * @param[in] addr Flash address.
+ * @param[in] bytes Bytes to read (two per word on PIC16, low byte first).
+ * @param[out] p_data Where the bytes go.
+ */
+void dfu_read(dfu_addr_t addr, uint16_t bytes, uint8_t* p_data);
+
+/**
+ * @fn void dfu_erase(dfu_addr_t addr)
+ * 
+ * @brief Erases the _FLASH_ERASE_SIZE row starting at addr.
+ * 
+ * Called by dfu_tasks() with the USB interrupt still enabled, so interrupts 
+ * must be held off around the unlock sequence.
+ * 
+ * @param[in] addr Flash address of the row.
+ */
+void dfu_erase(dfu_addr_t addr);
+
+/**
+ * @fn void dfu_write_block(dfu_addr_t addr, uint8_t* p_data)
+ * 
+ * @brief Programs the _FLASH_WRITE_SIZE row starting at addr, already erased.
+ * 
+ * Called by dfu_tasks() like dfu_erase(), interrupts must be held off around 
+ * the latch loads and unlock sequence.
+ * 
+ * @param[in] addr Flash address of the row.
+ * @param[in] p_data DFU_ROW_BYTES of image (two per word on PIC16, low byte first).
+ */
+void dfu_write_block(dfu_addr_t addr, uint8_t* p_data);
+
+/* ************************************************************************** */
+
+#endif /* USB_DFU_H */
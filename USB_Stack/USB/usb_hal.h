@@ -149,6 +149,22 @@
 #define BD3_OUT   6u
 #define BD3_IN    7u
 #endif
+#if NUM_ENDPOINTS > 4
+#define BD4_OUT   8u
+#define BD4_IN    9u
+#endif
+#if NUM_ENDPOINTS > 5
+#define BD5_OUT   10u
+#define BD5_IN    11u
+#endif
+#if NUM_ENDPOINTS > 6
+#define BD6_OUT   12u
+#define BD6_IN    13u
+#endif
+#if NUM_ENDPOINTS > 7
+#define BD7_OUT   14u
+#define BD7_IN    15u
+#endif
 #elif (PINGPONG_MODE == PINGPONG_0_OUT)
 #define BD0_OUT_EVEN  0u
 #define BD0_OUT_ODD   1u
@@ -163,6 +179,22 @@
 #define BD3_OUT       7u
 #define BD3_IN        8u
 #endif
+#if NUM_ENDPOINTS > 4
+#define BD4_OUT       9u
+#define BD4_IN        10u
+#endif
+#if NUM_ENDPOINTS > 5
+#define BD5_OUT       11u
+#define BD5_IN        12u
+#endif
+#if NUM_ENDPOINTS > 6
+#define BD6_OUT       13u
+#define BD6_IN        14u
+#endif
+#if NUM_ENDPOINTS > 7
+#define BD7_OUT       15u
+#define BD7_IN        16u
+#endif
 #elif (PINGPONG_MODE == PINGPONG_1_15)
 #define BD0_OUT      0u
 #define BD0_IN       1u
@@ -182,6 +214,30 @@
 #define BD3_IN_EVEN  12u
 #define BD3_IN_ODD   13u
 #endif
+#if NUM_ENDPOINTS > 4
+#define BD4_OUT_EVEN 14u
+#define BD4_OUT_ODD  15u
+#define BD4_IN_EVEN  16u
+#define BD4_IN_ODD   17u
+#endif
+#if NUM_ENDPOINTS > 5
+#define BD5_OUT_EVEN 18u
+#define BD5_OUT_ODD  19u
+#define BD5_IN_EVEN  20u
+#define BD5_IN_ODD   21u
+#endif
+#if NUM_ENDPOINTS > 6
+#define BD6_OUT_EVEN 22u
+#define BD6_OUT_ODD  23u
+#define BD6_IN_EVEN  24u
+#define BD6_IN_ODD   25u
+#endif
+#if NUM_ENDPOINTS > 7
+#define BD7_OUT_EVEN 26u
+#define BD7_OUT_ODD  27u
+#define BD7_IN_EVEN  28u
+#define BD7_IN_ODD   29u
+#endif
 #elif (PINGPONG_MODE == PINGPONG_ALL_EP)
 #define BD0_OUT_EVEN  0u
 #define BD0_OUT_ODD   1u
@@ -203,6 +259,30 @@
 #define BD3_IN_EVEN   14u
 #define BD3_IN_ODD    15u
 #endif
+#if NUM_ENDPOINTS > 4
+#define BD4_OUT_EVEN  16u
+#define BD4_OUT_ODD   17u
+#define BD4_IN_EVEN   18u
+#define BD4_IN_ODD    19u
+#endif
+#if NUM_ENDPOINTS > 5
+#define BD5_OUT_EVEN  20u
+#define BD5_OUT_ODD   21u
+#define BD5_IN_EVEN   22u
+#define BD5_IN_ODD    23u
+#endif
+#if NUM_ENDPOINTS > 6
+#define BD6_OUT_EVEN  24u
+#define BD6_OUT_ODD   25u
+#define BD6_IN_EVEN   26u
+#define BD6_IN_ODD    27u
+#endif
+#if NUM_ENDPOINTS > 7
+#define BD7_OUT_EVEN  28u
+#define BD7_OUT_ODD   29u
+#define BD7_IN_EVEN   30u
+#define BD7_IN_ODD    31u
+#endif
 #endif
 
 /* ************************************************************************** */
@@ -237,14 +317,22 @@
 #define BDT_BASE_ADDR   0x200
 #define SETUP_DATA_ADDR 0x60
 #define EP_BUFFERS_STARTING_ADDR (BDT_BASE_ADDR + BDT_SIZE)
+#define USB_RAM_END_ADDR 0x300 // First address past USB RAM.
 #elif defined(_18F26J53) || defined(_18F46J53) || defined(_18F27J53) || defined(_18F47J53)
 #define BDT_BASE_ADDR   0xD00
 #define SETUP_DATA_ADDR 0x60
 #define EP_BUFFERS_STARTING_ADDR (BDT_BASE_ADDR + BDT_SIZE)
+#define USB_RAM_END_ADDR 0xEC0 // SFRs start here.
+#elif defined(_18F2450) || defined(_18F4450)
+#define BDT_BASE_ADDR   0x400
+#define SETUP_DATA_ADDR 0x60
+#define EP_BUFFERS_STARTING_ADDR (BDT_BASE_ADDR + BDT_SIZE)
+#define USB_RAM_END_ADDR 0x500
 #else
 #define BDT_BASE_ADDR   0x400
 #define SETUP_DATA_ADDR 0x60
 #define EP_BUFFERS_STARTING_ADDR (BDT_BASE_ADDR + BDT_SIZE)
+#define USB_RAM_END_ADDR 0x800
 #endif
 
 #if defined(_18F24K50)||defined(_18F25K50)||defined(_18F45K50)
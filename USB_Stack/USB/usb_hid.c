@@ -92,6 +92,16 @@ typedef struct
     uint16_t Interface;
 }hid_set_idle_t;
 
+typedef struct
+{
+    uint8_t Report_Num;
+    uint8_t Size;
+    uint8_t Data[HID_IN_QUEUE_REPORT_SIZE];
+}hid_queued_report_t;
+
+
+#define NO_REPORT 0xFF // Report ID doesn't belong to one of the interface's reports.
+
 /* ************************************************************************** */
 
 
@@ -102,14 +112,81 @@ typedef struct
 #if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
 uint8_t g_hid_ep_out[HID_EP_SIZE] __at(HID_EP_OUT_BUFFER_BASE_ADDR);
 uint8_t g_hid_ep_in[HID_EP_SIZE]  __at(HID_EP_IN_BUFFER_BASE_ADDR);
+#if HID_NUM_INTERFACES > 1
+uint8_t g_hid1_ep_out[HID_EP_SIZE] __at(HID1_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_hid1_ep_in[HID_EP_SIZE]  __at(HID1_EP_IN_BUFFER_BASE_ADDR);
+#endif
+#if HID_NUM_INTERFACES > 2
+uint8_t g_hid2_ep_out[HID_EP_SIZE] __at(HID2_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_hid2_ep_in[HID_EP_SIZE]  __at(HID2_EP_IN_BUFFER_BASE_ADDR);
+#endif
 
 #else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
 uint8_t g_hid_ep_out_even[HID_EP_SIZE]  __at(HID_EP_OUT_EVEN_BUFFER_BASE_ADDR);
 uint8_t g_hid_ep_out_odd[HID_EP_SIZE]   __at(HID_EP_OUT_ODD_BUFFER_BASE_ADDR);
 uint8_t g_hid_ep_in_even[HID_EP_SIZE]   __at(HID_EP_IN_EVEN_BUFFER_BASE_ADDR);
 uint8_t g_hid_ep_in_odd[HID_EP_SIZE]    __at(HID_EP_IN_ODD_BUFFER_BASE_ADDR);
+#if HID_NUM_INTERFACES > 1
+uint8_t g_hid1_ep_out_even[HID_EP_SIZE] __at(HID1_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_hid1_ep_out_odd[HID_EP_SIZE]  __at(HID1_EP_OUT_ODD_BUFFER_BASE_ADDR);
+uint8_t g_hid1_ep_in_even[HID_EP_SIZE]  __at(HID1_EP_IN_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_hid1_ep_in_odd[HID_EP_SIZE]   __at(HID1_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
+#if HID_NUM_INTERFACES > 2
+uint8_t g_hid2_ep_out_even[HID_EP_SIZE] __at(HID2_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_hid2_ep_out_odd[HID_EP_SIZE]  __at(HID2_EP_OUT_ODD_BUFFER_BASE_ADDR);
+uint8_t g_hid2_ep_in_even[HID_EP_SIZE]  __at(HID2_EP_IN_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_hid2_ep_in_odd[HID_EP_SIZE]   __at(HID2_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** HID INTERFACES ***************************** */
+/* ************************************************************************** */
+
+// BDs and buffers, EVEN then ODD when pingpong is used.
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+#define HID0_ENDPOINT HID_EP, HID_BD_OUT, HID_BD_IN, g_hid_ep_out, g_hid_ep_in
+#define HID1_ENDPOINT HID1_EP, HID1_BD_OUT, HID1_BD_IN, g_hid1_ep_out, g_hid1_ep_in
+#define HID2_ENDPOINT HID2_EP, HID2_BD_OUT, HID2_BD_IN, g_hid2_ep_out, g_hid2_ep_in
+#else
+#define HID0_ENDPOINT HID_EP, HID_BD_OUT_EVEN, HID_BD_IN_EVEN, g_hid_ep_out_even, g_hid_ep_in_even, g_hid_ep_out_odd, g_hid_ep_in_odd
+#define HID1_ENDPOINT HID1_EP, HID1_BD_OUT_EVEN, HID1_BD_IN_EVEN, g_hid1_ep_out_even, g_hid1_ep_in_even, g_hid1_ep_out_odd, g_hid1_ep_in_odd
+#define HID2_ENDPOINT HID2_EP, HID2_BD_OUT_EVEN, HID2_BD_IN_EVEN, g_hid2_ep_out_even, g_hid2_ep_in_even, g_hid2_ep_out_odd, g_hid2_ep_in_odd
 #endif
 
+const hid_interface_t g_hid_interfaces[HID_NUM_INTERFACES] =
+{
+    {
+        HID_INT, HID0_ENDPOINT,
+        0, HID0_NUM_IN_REPORTS,
+        0, HID0_NUM_OUT_REPORTS,
+        0, HID0_NUM_FEATURE_REPORTS,
+        HID_NUM_REPORT_IDS != 0
+    },
+    #if HID_NUM_INTERFACES > 1
+    {
+        HID1_INT, HID1_ENDPOINT,
+        HID0_NUM_IN_REPORTS, HID1_NUM_IN_REPORTS,
+        HID0_NUM_OUT_REPORTS, HID1_NUM_OUT_REPORTS,
+        HID0_NUM_FEATURE_REPORTS, HID1_NUM_FEATURE_REPORTS,
+        HID1_NUM_REPORT_IDS != 0
+    },
+    #endif
+    #if HID_NUM_INTERFACES > 2
+    {
+        HID2_INT, HID2_ENDPOINT,
+        HID0_NUM_IN_REPORTS + HID1_NUM_IN_REPORTS, HID2_NUM_IN_REPORTS,
+        HID0_NUM_OUT_REPORTS + HID1_NUM_OUT_REPORTS, HID2_NUM_OUT_REPORTS,
+        HID0_NUM_FEATURE_REPORTS + HID1_NUM_FEATURE_REPORTS, HID2_NUM_FEATURE_REPORTS,
+        HID2_NUM_REPORT_IDS != 0
+    },
+    #endif
+};
+
 /* ************************************************************************** */
 
 
@@ -117,8 +194,9 @@ uint8_t g_hid_ep_in_odd[HID_EP_SIZE]    __at(HID_EP_IN_ODD_BUFFER_BASE_ADDR);
 /* ****************************** GLOBAL VARS ******************************* */
 /* ************************************************************************** */
 
+volatile uint8_t                 g_hid_interface;
+volatile bool                    g_hid_interface_report_sent[HID_NUM_INTERFACES];
 volatile bool                    g_hid_report_sent = true;
-volatile uint8_t                 g_hid_report_num_sent;
 volatile bool                    g_hid_sent_report[HID_NUM_IN_REPORTS] = {true};
 volatile hid_in_report_setting_t g_hid_in_report_settings[HID_NUM_IN_REPORTS];
 
@@ -133,6 +211,17 @@ extern const uint8_t* g_hid_descriptor;
 extern const uint8_t  g_hid_report_descriptor[];
 extern const uint16_t g_hid_report_descriptor_size;
 
+#if HID_NUM_INTERFACES > 1
+extern const uint8_t* g_hid1_descriptor;
+extern const uint8_t  g_hid1_report_descriptor[];
+extern const uint16_t g_hid1_report_descriptor_size;
+#endif
+#if HID_NUM_INTERFACES > 2
+extern const uint8_t* g_hid2_descriptor;
+extern const uint8_t  g_hid2_report_descriptor[];
+extern const uint16_t g_hid2_report_descriptor_size;
+#endif
+
 /* ************************************************************************** */
 
 
@@ -144,6 +233,10 @@ extern const uint16_t g_hid_in_reports[];
 extern const uint8_t  g_hid_in_report_size[];
 extern const uint16_t g_hid_out_reports[];
 extern const uint8_t  g_hid_out_report_size[];
+#if HID_NUM_FEATURE_REPORTS != 0
+extern const uint16_t g_hid_feature_reports[];
+extern const uint8_t  g_hid_feature_report_size[];
+#endif
 
 /* ************************************************************************** */
 
@@ -156,6 +249,31 @@ static hid_get_set_report_t m_get_set_report __at(SETUP_DATA_ADDR);
 static hid_get_idle_t       m_get_idle       __at(SETUP_DATA_ADDR);
 static hid_set_idle_t       m_set_idle       __at(SETUP_DATA_ADDR);
 
+#if HID_NUM_IN_REPORTS != 0
+// Each interface has its own IN queue, as each has its own IN EP.
+static hid_queued_report_t m_in_queue[HID_NUM_INTERFACES][HID_IN_QUEUE_SIZE];
+static volatile uint8_t    m_in_queue_head[HID_NUM_INTERFACES];  // Next report to arm, moved by the ISR.
+static volatile uint8_t    m_in_queue_tail[HID_NUM_INTERFACES];  // Next free entry, moved by main.
+static volatile uint8_t    m_in_pending[HID_NUM_INTERFACES];     // IN BDs armed and not yet sent.
+static uint8_t             m_in_flight[HID_NUM_INTERFACES][HID_IN_NUM_BD]; // Report number in each IN BD.
+static uint8_t             m_in_outstanding[HID_NUM_IN_REPORTS];           // Copies of each report queued or in flight.
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+static uint8_t             m_in_arm_ppb[HID_NUM_INTERFACES];     // IN BD to arm next.
+#endif
+
+// Idle scheduler, reports are linked through m_idle_next into one of two lists.
+#define IDLE_OFF   0 // Infinite idle, or due and taken by hid_idle_report().
+#define IDLE_TIMED 1 // In m_idle_head list, earliest deadline first.
+#define IDLE_DUE   2 // In m_idle_due_head list, oldest first.
+
+static volatile uint16_t   m_idle_time;      // SOFs counted while configured.
+static volatile uint8_t    m_idle_head;
+static volatile uint8_t    m_idle_due_head;
+static uint8_t             m_idle_due_tail;
+static uint8_t             m_idle_next[HID_NUM_IN_REPORTS];
+static uint8_t             m_idle_state[HID_NUM_IN_REPORTS];
+#endif
+
 /* ************************************************************************** */
 
 
@@ -164,50 +282,155 @@ static hid_set_idle_t       m_set_idle       __at(SETUP_DATA_ADDR);
 /* ************************************************************************** */
 
 /**
- * @fn bool get_report(void)
+ * @fn bool get_report(const hid_interface_t* p_interface)
  * 
  * @brief Returns Report on EP0.
  * 
  * The Get_Report request allows the host to receive a report via the Control pipe
  * 
+ * @param[in] p_interface Interface the request is for.
+ * 
  * @return Returns success (true) or failure (false) to execute the Request.
  */
-static bool get_report(void);
+static bool get_report(const hid_interface_t* p_interface);
 
 /**
- * @fn bool set_report(void)
+ * @fn bool set_report(const hid_interface_t* p_interface)
  * 
  * @brief Modifies Report on EP0.
  * 
  * The Set_Report request allows the host to send a report to the device, 
  * possibly setting the state of input, output, or feature controls.
  * 
+ * @param[in] p_interface Interface the request is for.
+ * 
  * @return Returns success (true) or failure (false) to execute the Request.
  */
-static bool set_report(void);
+static bool set_report(const hid_interface_t* p_interface);
 
 /**
- * @fn bool get_idle(void)
+ * @fn bool get_idle(const hid_interface_t* p_interface)
  * 
  * @brief Returns the Idle Duration and Idle Count.
  * 
  * The Get_Idle request reads the current idle rate for a particular Input report
  * 
+ * @param[in] p_interface Interface the request is for.
+ * 
  * @return Returns success (true) or failure (false) to execute the Request.
  */
-static bool get_idle(void);
+static bool get_idle(const hid_interface_t* p_interface);
 
 /**
- * @fn bool set_idle(void)
+ * @fn bool set_idle(const hid_interface_t* p_interface)
  * 
  * @brief Modifies the Idle Duration and Idle Count.
  * 
  * The Set_Idle request silences a particular report on the Interrupt In pipe 
  * until a new event occurs or the specified amount of time passes.
  * 
+ * @param[in] p_interface Interface the request is for.
+ * 
  * @return Returns success (true) or failure (false) to execute the Request.
  */
-static bool set_idle(void);
+static bool set_idle(const hid_interface_t* p_interface);
+
+/**
+ * @fn uint8_t interface_from_num(uint8_t interface_num)
+ * 
+ * @brief Finds the HID interface with a bInterfaceNumber (wIndex of a request).
+ * 
+ * @return Index into g_hid_interfaces, or HID_NUM_INTERFACES if not a HID interface.
+ */
+static uint8_t interface_from_num(uint8_t interface_num);
+
+/**
+ * @fn uint8_t interface_from_ep(uint8_t ep)
+ * 
+ * @brief Finds the HID interface that uses an endpoint.
+ * 
+ * @return Index into g_hid_interfaces, or HID_NUM_INTERFACES if not a HID EP.
+ */
+static uint8_t interface_from_ep(uint8_t ep);
+
+/**
+ * @fn uint8_t report_from_id(const uint8_t* p_sizes, uint8_t first, uint8_t num, bool report_ids, uint8_t report_id)
+ * 
+ * @brief Maps a Report ID onto a report number.
+ * 
+ * @param[in] p_sizes Report size table of the report type.
+ * @param[in] first First report number of the type on the interface.
+ * @param[in] num Number of reports of the type on the interface.
+ * @param[in] report_ids The interface's reports start with a Report ID.
+ * @param[in] report_id Report ID from the request (0 if the interface doesn't use them).
+ * 
+ * @return Report number, or NO_REPORT if the interface has no such report.
+ */
+static uint8_t report_from_id(const uint8_t* p_sizes, uint8_t first, uint8_t num, bool report_ids, uint8_t report_id);
+
+#if HID_NUM_IN_REPORTS != 0
+/**
+ * @fn uint8_t interface_from_in_report(uint8_t report_num)
+ * 
+ * @brief Finds the HID interface an IN Report is sent on.
+ */
+static uint8_t interface_from_in_report(uint8_t report_num);
+
+/**
+ * @fn void arm_queued_reports(uint8_t interface)
+ * 
+ * @brief Moves an interface's queued IN Reports into its free IN BDs and arms them.
+ * 
+ * Run from the ISR, or with the USB interrupt disabled.
+ */
+static void arm_queued_reports(uint8_t interface);
+
+/**
+ * @fn void in_report_done(uint8_t interface, uint8_t bd)
+ * 
+ * @brief Retires the IN Report held in an IN BD (EVEN/ODD, or 0 without pingpong).
+ */
+static void in_report_done(uint8_t interface, uint8_t bd);
+
+/**
+ * @fn void idle_insert(uint8_t report_num, uint16_t deadline)
+ * 
+ * @brief Adds a report to the timed idle list, in deadline order.
+ * 
+ * The deadline must be 1 to 65535 SOFs ahead of m_idle_time.
+ */
+static void idle_insert(uint8_t report_num, uint16_t deadline);
+
+/**
+ * @fn void idle_unlink(uint8_t report_num)
+ * 
+ * @brief Removes a report from whichever idle list it is in.
+ */
+static void idle_unlink(uint8_t report_num);
+
+/**
+ * @fn void idle_set_due(uint8_t report_num)
+ * 
+ * @brief Flags a report's idle period as ended and adds it to the due list.
+ */
+static void idle_set_due(uint8_t report_num);
+
+/**
+ * @fn void idle_restart(uint8_t report_num)
+ * 
+ * @brief Starts a new idle period for a report that has just been queued.
+ */
+static void idle_restart(uint8_t report_num);
+
+#ifdef USE_SET_IDLE
+/**
+ * @fn void idle_set_duration(uint8_t report_num, uint8_t duration)
+ * 
+ * @brief Applies a Set_Idle duration (4ms units) to a report.
+ */
+static void idle_set_duration(uint8_t report_num, uint8_t duration);
+#endif
+#endif
 
 /* ************************************************************************** */
 
@@ -241,23 +464,39 @@ void hid_arm_ep_in(uint8_t cnt)
 }
 #endif
 
+void hid_interface_arm_ep_out(uint8_t interface)
+{
+    const hid_interface_t* p_interface = &g_hid_interfaces[interface];
+    
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    usb_arm_endpoint(&g_usb_bd_table[p_interface->BD_Out + (HID_INTERFACE_EP_OUT_LAST_PPB(interface) ^ 1u)], 
+                     &g_usb_ep_stat[p_interface->EP][OUT], HID_EP_SIZE);
+    #else
+    usb_arm_endpoint(&g_usb_bd_table[p_interface->BD_Out], &g_usb_ep_stat[p_interface->EP][OUT], HID_EP_SIZE);
+    #endif
+}
+
 bool hid_class_request(void)
 {
+    uint8_t interface = interface_from_num((uint8_t)g_usb_setup.wIndex);
+    
+    if(interface == HID_NUM_INTERFACES) return false;
+    
     switch(g_usb_setup.bRequest)
     {
         case GET_REPORT:
-            return get_report();
+            return get_report(&g_hid_interfaces[interface]);
         #ifdef USE_SET_REPORT
         case SET_REPORT:
+            return set_report(&g_hid_interfaces[interface]);
         #endif
-            return set_report();
         #ifdef USE_GET_IDLE
         case GET_IDLE:
-            return get_idle();
+            return get_idle(&g_hid_interfaces[interface]);
         #endif
         #ifdef USE_SET_IDLE
         case SET_IDLE:
-            return set_idle();
+            return set_idle(&g_hid_interfaces[interface]);
         #endif
         #ifdef USE_GET_PROTOCOL
         case GET_PROTOCOL:
@@ -273,21 +512,44 @@ bool hid_class_request(void)
 bool hid_get_class_descriptor(const uint8_t** descriptor, uint16_t* size)
 {
     // Stupid compiler cuts off address at 8 bits!
-    uint32_t address;
+    uint32_t hid_address;
+    uint32_t report_address;
+    uint16_t report_size;
+    
+    switch(interface_from_num((uint8_t)g_usb_setup.wIndex))
+    {
+        case 0:
+            hid_address    = (uint32_t)g_hid_descriptor;
+            report_address = (uint32_t)g_hid_report_descriptor;
+            report_size    = g_hid_report_descriptor_size;
+            break;
+        #if HID_NUM_INTERFACES > 1
+        case 1:
+            hid_address    = (uint32_t)g_hid1_descriptor;
+            report_address = (uint32_t)g_hid1_report_descriptor;
+            report_size    = g_hid1_report_descriptor_size;
+            break;
+        #endif
+        #if HID_NUM_INTERFACES > 2
+        case 2:
+            hid_address    = (uint32_t)g_hid2_descriptor;
+            report_address = (uint32_t)g_hid2_report_descriptor;
+            report_size    = g_hid2_report_descriptor_size;
+            break;
+        #endif
+        default:
+            return false;
+    }
     
     switch(g_usb_get_descriptor.DescriptorType)
     {
         case HID_DESC:
-            //*descriptor = g_hid_descriptor; <----
-            address = (uint32_t)g_hid_descriptor;
-            *descriptor = (const uint8_t*)address;
+            *descriptor = (const uint8_t*)hid_address;
             *size = 9;
             return true;
         case HID_REPORT_DESC:
-            //*descriptor = g_hid_report_descriptor; <----
-            address = (uint32_t)g_hid_report_descriptor;
-            *descriptor = (const uint8_t*)address;
-            *size = g_hid_report_descriptor_size;
+            *descriptor = (const uint8_t*)report_address;
+            *size = report_size;
             return true;
         default:
             return false;
@@ -296,139 +558,166 @@ bool hid_get_class_descriptor(const uint8_t** descriptor, uint16_t* size)
 
 void hid_init(void)
 {
-    #if HID_NUM_OUT_REPORTS != 0
-    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-    usb_ram_set(0, g_hid_ep_out_even, 8);
-    usb_ram_set(0, g_hid_ep_out_odd, 8);
-    
-    g_usb_bd_table[HID_BD_OUT_EVEN].STAT = 0;
-    g_usb_bd_table[HID_BD_OUT_EVEN].ADR = HID_EP_OUT_EVEN_BUFFER_BASE_ADDR;
-    g_usb_bd_table[HID_BD_OUT_ODD].STAT = 0;
-    g_usb_bd_table[HID_BD_OUT_ODD].ADR = HID_EP_OUT_ODD_BUFFER_BASE_ADDR;
-    #else
-    usb_ram_set(0, g_hid_ep_out, 8);
-    
-    g_usb_bd_table[HID_BD_OUT].STAT = 0;
-    g_usb_bd_table[HID_BD_OUT].ADR = HID_EP_OUT_BUFFER_BASE_ADDR;
-    #endif
-    #endif
-    #if HID_NUM_IN_REPORTS != 0
-    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-    usb_ram_set(0, g_hid_ep_in_even, 8);
-    usb_ram_set(0, g_hid_ep_in_odd, 8);
-    
+    uint8_t interface;
+    const hid_interface_t* p_interface;
     
-    g_usb_bd_table[HID_BD_IN_EVEN].STAT = 0;
-    g_usb_bd_table[HID_BD_IN_EVEN].ADR  = HID_EP_IN_EVEN_BUFFER_BASE_ADDR;
-    g_usb_bd_table[HID_BD_IN_ODD].STAT  = 0;
-    g_usb_bd_table[HID_BD_IN_ODD].ADR   = HID_EP_IN_ODD_BUFFER_BASE_ADDR;
-    #else
-    usb_ram_set(0, g_hid_ep_in, 8);
-    
-    g_usb_bd_table[HID_BD_IN].STAT = 0;
-    g_usb_bd_table[HID_BD_IN].ADR = HID_EP_IN_BUFFER_BASE_ADDR;
-    #endif
-    #endif
+    for(interface = 0; interface < HID_NUM_INTERFACES; interface++)
+    {
+        p_interface = &g_hid_interfaces[interface];
+        
+        #if HID_NUM_OUT_REPORTS != 0
+        if(p_interface->Num_Out_Reports)
+        {
+            usb_ram_set(0, p_interface->EP_Out, HID_EP_SIZE);
+            g_usb_bd_table[p_interface->BD_Out].STAT = 0;
+            g_usb_bd_table[p_interface->BD_Out].ADR  = (uint16_t)p_interface->EP_Out;
+            #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+            usb_ram_set(0, p_interface->EP_Out_Odd, HID_EP_SIZE);
+            g_usb_bd_table[p_interface->BD_Out + 1u].STAT = 0;
+            g_usb_bd_table[p_interface->BD_Out + 1u].ADR  = (uint16_t)p_interface->EP_Out_Odd;
+            #endif
+            g_usb_ep_stat[p_interface->EP][OUT].Halt = 0;
+        }
+        #endif
+        #if HID_NUM_IN_REPORTS != 0
+        if(p_interface->Num_In_Reports)
+        {
+            usb_ram_set(0, p_interface->EP_In, HID_EP_SIZE);
+            g_usb_bd_table[p_interface->BD_In].STAT = 0;
+            g_usb_bd_table[p_interface->BD_In].ADR  = (uint16_t)p_interface->EP_In;
+            #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+            usb_ram_set(0, p_interface->EP_In_Odd, HID_EP_SIZE);
+            g_usb_bd_table[p_interface->BD_In + 1u].STAT = 0;
+            g_usb_bd_table[p_interface->BD_In + 1u].ADR  = (uint16_t)p_interface->EP_In_Odd;
+            #endif
+            g_usb_ep_stat[p_interface->EP][IN].Halt = 0;
+        }
+        m_in_queue_head[interface] = 0;
+        m_in_queue_tail[interface] = 0;
+        m_in_pending[interface]    = 0;
+        #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+        m_in_arm_ppb[interface]    = HID_INTERFACE_EP_IN_LAST_PPB(interface) ^ 1;
+        #endif
+        #endif
+        g_hid_interface_report_sent[interface] = true;
+    }
     
     // EP Settings
     HID_UEPbits.EPHSHK   = 1;  // Handshaking enabled 
     HID_UEPbits.EPCONDIS = 0;  // Don't allow SETUP
-    #if HID_NUM_OUT_REPORTS != 0
+    #if HID0_NUM_OUT_REPORTS != 0
     HID_UEPbits.EPOUTEN  = 1;  // EP output enabled
-    g_usb_ep_stat[HID_EP][OUT].Halt = 0;
     #endif
+    #if HID0_NUM_IN_REPORTS != 0
+    HID_UEPbits.EPINEN   = 1;  // EP input enabled
+    #endif
+    #if HID_NUM_INTERFACES > 1
+    HID1_UEPbits.EPHSHK   = 1;
+    HID1_UEPbits.EPCONDIS = 0;
+    #if HID1_NUM_OUT_REPORTS != 0
+    HID1_UEPbits.EPOUTEN  = 1;
+    #endif
+    #if HID1_NUM_IN_REPORTS != 0
+    HID1_UEPbits.EPINEN   = 1;
+    #endif
+    #endif
+    #if HID_NUM_INTERFACES > 2
+    HID2_UEPbits.EPHSHK   = 1;
+    HID2_UEPbits.EPCONDIS = 0;
+    #if HID2_NUM_OUT_REPORTS != 0
+    HID2_UEPbits.EPOUTEN  = 1;
+    #endif
+    #if HID2_NUM_IN_REPORTS != 0
+    HID2_UEPbits.EPINEN   = 1;
+    #endif
+    #endif
+    
     #if HID_NUM_IN_REPORTS != 0
-    HID_UEPbits.EPINEN  = 1;   // EP input enabled
-    g_usb_ep_stat[HID_EP][IN].Halt = 0;
     #if HID_NUM_IN_REPORTS > 1
+    m_idle_time     = 0;
+    m_idle_head     = HID_IDLE_NONE;
+    m_idle_due_head = HID_IDLE_NONE;
     for(uint8_t i = 0; i < HID_NUM_IN_REPORTS; i++)
     {
 		g_hid_sent_report[i] = true;
-        g_hid_in_report_settings[i].Idle_Count_Overflow = false;
-        g_hid_in_report_settings[i].Idle_Count = 0;
+        m_in_outstanding[i]  = 0;
+        m_idle_state[i]      = IDLE_OFF;
         g_hid_in_report_settings[i].Idle_Duration_1ms = DEFAULT_IDLE;
         g_hid_in_report_settings[i].Idle_Duration_4ms = DEFAULT_IDLE / 4;
+        idle_restart(i);
     }
     #else
     g_hid_sent_report[0] = true;
-	g_hid_in_report_settings[0].Idle_Count_Overflow = false;
-    g_hid_in_report_settings[0].Idle_Count = 0;
+    m_in_outstanding[0]  = 0;
+    m_idle_time     = 0;
+    m_idle_head     = HID_IDLE_NONE;
+    m_idle_due_head = HID_IDLE_NONE;
+    m_idle_state[0] = IDLE_OFF;
     g_hid_in_report_settings[0].Idle_Duration_1ms = DEFAULT_IDLE;
     g_hid_in_report_settings[0].Idle_Duration_4ms = DEFAULT_IDLE / 4;
+    idle_restart(0);
     #endif
     #endif
     hid_clear_ep_toggle();
 
     #if HID_NUM_OUT_REPORTS != 0
-    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-    hid_arm_ep_out(HID_BD_OUT_EVEN);
-    #else
-    hid_arm_ep_out();
-    #endif
+    for(interface = 0; interface < HID_NUM_INTERFACES; interface++)
+    {
+        if(g_hid_interfaces[interface].Num_Out_Reports) hid_interface_arm_ep_out(interface); // EVEN, Last_PPB starts on ODD.
+    }
     #endif
     g_hid_report_sent = true;
 }
 
 void hid_tasks(void)
 {
+    uint8_t interface = interface_from_ep(TRANSACTION_EP);
+    
+    if(interface == HID_NUM_INTERFACES) return;
+    g_hid_interface = interface;
+    
     if(TRANSACTION_DIR == IN)
     {
         #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        HID_EP_IN_LAST_PPB = PINGPONG_PARITY;
+        HID_INTERFACE_EP_IN_LAST_PPB(interface) = PINGPONG_PARITY;
         #endif
-        HID_EP_IN_DATA_TOGGLE_VAL ^= 1;
         hid_set_sent_report_flag();
+        #if HID_NUM_IN_REPORTS != 0
+        arm_queued_reports(interface); // Data toggle was already moved on when the BD was armed.
+        #endif
     }
     else
     {
-        #if HID_NUM_OUT_REPORTS == 1
+        #if HID_NUM_OUT_REPORTS != 0
+        const hid_interface_t* p_interface = &g_hid_interfaces[interface];
+        uint8_t* p_buffer = p_interface->EP_Out;
+        uint8_t  report_num;
+        
         #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        HID_EP_OUT_LAST_PPB = PINGPONG_PARITY;
+        HID_INTERFACE_EP_OUT_LAST_PPB(interface) = PINGPONG_PARITY;
+        if(PINGPONG_PARITY == ODD) p_buffer = p_interface->EP_Out_Odd;
         #endif
-        HID_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+        HID_INTERFACE_EP_OUT_DATA_TOGGLE_VAL(interface) ^= 1;
         
-        #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        if(HID_EP_OUT_LAST_PPB == ODD)
-        {
-            usb_ram_copy((uint8_t*)HID_EP_OUT_ODD_BUFFER_BASE_ADDR, (uint8_t*)g_hid_out_reports[0], g_hid_out_report_size[0]);
-            hid_out(0);
-        }
-        else
+        report_num = report_from_id(g_hid_out_report_size, p_interface->First_Out_Report, p_interface->Num_Out_Reports,
+                                    p_interface->Report_IDs, p_interface->Report_IDs ? *p_buffer : 0);
+        if(report_num == NO_REPORT)
         {
-            usb_ram_copy((uint8_t*)HID_EP_OUT_EVEN_BUFFER_BASE_ADDR, (uint8_t*)g_hid_out_reports[0], g_hid_out_report_size[0]);
-            hid_out(0);
+            hid_interface_arm_ep_out(interface); // Not one of ours, dropped.
+            return;
         }
-        #else
-        usb_ram_copy((uint8_t*)HID_EP_OUT_BUFFER_BASE_ADDR, (uint8_t*)g_hid_out_reports[0], g_hid_out_report_size[0]);
-        hid_out(0);
-        #endif
-        #elif HID_NUM_OUT_REPORTS > 1
-        uint8_t report_num;
-        
-        #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        HID_EP_OUT_LAST_PPB = PINGPONG_PARITY;
-        #endif
-        HID_EP_OUT_DATA_TOGGLE_VAL ^= 1;
-        
-        #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        uint8_t* ep_buff_base_addr = (uint8_t*)HID_EP_OUT_EVEN_BUFFER_BASE_ADDR;
-
-        if(HID_EP_OUT_LAST_PPB == ODD) ep_buff_base_addr = (uint8_t*)HID_EP_OUT_ODD_BUFFER_BASE_ADDR;
-
-        report_num = *ep_buff_base_addr;
-        usb_ram_copy(ep_buff_base_addr, (uint8_t*)g_hid_out_reports[report_num], g_hid_out_report_size[report_num]);
-        hid_out(report_num);
-        #else
-        report_num = *(uint8_t*)HID_EP_OUT_BUFFER_BASE_ADDR;
-        usb_ram_copy((uint8_t*)HID_EP_OUT_BUFFER_BASE_ADDR, (uint8_t*)g_hid_out_reports[report_num], g_hid_out_report_size[report_num]);
+        usb_ram_copy(p_buffer, (uint8_t*)g_hid_out_reports[report_num], g_hid_out_report_size[report_num]);
         hid_out(report_num);
         #endif
-        #endif
     }
 }
 
 void hid_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
 {
+    uint8_t interface = interface_from_ep(ep);
+    
+    if(interface == HID_NUM_INTERFACES) return;
+    
     g_usb_ep_stat[ep][dir].Data_Toggle_Val = 0;
     
     if(g_usb_ep_stat[ep][dir].Halt)
@@ -438,20 +727,47 @@ void hid_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
         #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
         g_usb_bd_table[++bdt_index].STAT = 0;
         #endif
+        
+        #if HID_NUM_IN_REPORTS != 0
+        // Reports in the stalled BDs are dropped, newest first, leaving
+        // m_in_arm_ppb on the BD the SIE will use next.
+        if(dir == IN)
+        {
+            while(m_in_pending[interface])
+            {
+                #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+                m_in_arm_ppb[interface] ^= 1;
+                in_report_done(interface, m_in_arm_ppb[interface]);
+                #else
+                in_report_done(interface, 0);
+                #endif
+            }
+        }
+        #endif
     }
-    if(dir == IN) hid_set_sent_report_flag();
+    #if HID_NUM_IN_REPORTS != 0
+    if(dir == IN) arm_queued_reports(interface);
+    #endif
 }
 
 void hid_set_sent_report_flag(void)
 {
-    g_hid_report_sent = true;
-    g_hid_sent_report[g_hid_report_num_sent] = true;
+    #if HID_NUM_IN_REPORTS != 0
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    in_report_done(g_hid_interface, HID_INTERFACE_EP_IN_LAST_PPB(g_hid_interface));
+    #else
+    in_report_done(g_hid_interface, 0);
+    #endif
+    #endif
 }
 
 void hid_clear_ep_toggle(void)
 {
-    g_usb_ep_stat[HID_EP][OUT].Data_Toggle_Val = 0;
-    g_usb_ep_stat[HID_EP][IN].Data_Toggle_Val  = 0;
+    for(uint8_t interface = 0; interface < HID_NUM_INTERFACES; interface++)
+    {
+        HID_INTERFACE_EP_OUT_DATA_TOGGLE_VAL(interface) = 0;
+        HID_INTERFACE_EP_IN_DATA_TOGGLE_VAL(interface)  = 0;
+    }
 }
 
 /* ************************************************************************** */
@@ -461,25 +777,20 @@ void hid_clear_ep_toggle(void)
 /* **************************** LOCAL FUNCTIONS ***************************** */
 /* ************************************************************************** */
 
-static bool get_report(void)
+static bool get_report(const hid_interface_t* p_interface)
 {
-    uint16_t bytes_available = 0;
+    uint8_t report_num;
 
     if(m_get_set_report.Report_Type == REPORT_INPUT)
     {
         #if HID_NUM_IN_REPORTS == 0
         return false;
         #else
-        #if HID_NUM_REPORT_IDS == 0
-        if(m_get_set_report.Report_ID != 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_in_reports[0]);
-        bytes_available = g_hid_in_report_size[0];
-        #else
-        if(m_get_set_report.Report_ID > HID_NUM_REPORT_IDS) return false;
-        if(m_get_set_report.Report_ID == 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_in_reports[m_get_set_report.Report_ID - 1u]);
-        bytes_available = g_hid_in_report_size[m_get_set_report.Report_ID - 1u];
-        #endif
+        report_num = report_from_id(g_hid_in_report_size, p_interface->First_In_Report, p_interface->Num_In_Reports,
+                                    p_interface->Report_IDs, m_get_set_report.Report_ID);
+        if(report_num == NO_REPORT) return false;
+        usb_set_ram_ptr((uint8_t*)g_hid_in_reports[report_num]);
+        usb_setup_in_control_transfer(RAM, g_hid_in_report_size[report_num], m_get_set_report.Report_Length);
         #endif
     }
     else if(m_get_set_report.Report_Type == REPORT_FEATURE)
@@ -487,21 +798,15 @@ static bool get_report(void)
         #if HID_NUM_FEATURE_REPORTS == 0
         return false;
         #else
-        #if HID_NUM_REPORT_IDS == 0
-        if(m_get_set_report.Report_ID != 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[0]);
-        bytes_available = g_hid_feature_report_size[0];
-        #else
-        if(m_get_set_report.Report_ID > HID_NUM_REPORT_IDS) return false;
-        if(m_get_set_report.Report_ID == 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[m_get_set_report.Report_ID - 1u]);
-        bytes_available = g_hid_feature_report_size[m_get_set_report.Report_ID - 1u];
-        #endif
+        report_num = report_from_id(g_hid_feature_report_size, p_interface->First_Feature_Report, p_interface->Num_Feature_Reports,
+                                    p_interface->Report_IDs, m_get_set_report.Report_ID);
+        if(report_num == NO_REPORT) return false;
+        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[report_num]);
+        usb_setup_in_control_transfer(RAM, g_hid_feature_report_size[report_num], m_get_set_report.Report_Length);
         #endif
     }
     else return false;
     #if HID_NUM_IN_REPORTS != 0 || HID_NUM_FEATURE_REPORTS != 0
-    usb_setup_in_control_transfer(RAM, bytes_available, m_get_set_report.Report_Length);
     usb_in_control_transfer();
     usb_set_control_stage(DATA_IN_STAGE);
     return true;
@@ -509,8 +814,11 @@ static bool get_report(void)
 }
 
 #ifdef USE_SET_REPORT
-static bool set_report(void)
+static bool set_report(const hid_interface_t* p_interface)
 {
+    #if HID_NUM_OUT_REPORTS != 0 || HID_NUM_FEATURE_REPORTS != 0
+    uint8_t  report_num;
+    #endif
     uint16_t bytes_available = 0;
 
     if(m_get_set_report.Report_Type == REPORT_OUTPUT)
@@ -518,16 +826,11 @@ static bool set_report(void)
         #if HID_NUM_OUT_REPORTS == 0
         return false;
         #else
-        #if HID_NUM_REPORT_IDS == 0
-        if(m_get_set_report.Report_ID != 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_out_reports[0]);
-        bytes_available = g_hid_out_report_size[0];
-        #else
-        if(m_get_set_report.Report_ID > HID_NUM_REPORT_IDS) return false;
-        if(m_get_set_report.Report_ID == 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_out_reports[m_get_set_report.Report_ID - 1u]);
-        bytes_available = g_hid_out_report_size[m_get_set_report.Report_ID - 1u];
-        #endif
+        report_num = report_from_id(g_hid_out_report_size, p_interface->First_Out_Report, p_interface->Num_Out_Reports,
+                                    p_interface->Report_IDs, m_get_set_report.Report_ID);
+        if(report_num == NO_REPORT) return false;
+        usb_set_ram_ptr((uint8_t*)g_hid_out_reports[report_num]);
+        bytes_available = g_hid_out_report_size[report_num];
         #endif
     }
     else if(m_get_set_report.Report_Type == REPORT_FEATURE)
@@ -535,16 +838,11 @@ static bool set_report(void)
         #if HID_NUM_FEATURE_REPORTS == 0
         return false;
         #else
-        #if HID_NUM_REPORT_IDS == 0
-        if(m_get_set_report.Report_ID != 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[0]);
-        bytes_available = g_hid_feature_report_size[0];
-        #else
-        if(m_get_set_report.Report_ID > HID_NUM_REPORT_IDS) return false;
-        if(m_get_set_report.Report_ID == 0) return false;
-        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[m_get_set_report.Report_ID - 1u]);
-        bytes_available = g_hid_feature_report_size[m_get_set_report.Report_ID - 1u];
-        #endif
+        report_num = report_from_id(g_hid_feature_report_size, p_interface->First_Feature_Report, p_interface->Num_Feature_Reports,
+                                    p_interface->Report_IDs, m_get_set_report.Report_ID);
+        if(report_num == NO_REPORT) return false;
+        usb_set_ram_ptr((uint8_t*)g_hid_feature_reports[report_num]);
+        bytes_available = g_hid_feature_report_size[report_num];
         #endif
     }
     else return false;
@@ -558,20 +856,17 @@ static bool set_report(void)
 #endif
 
 #ifdef USE_GET_IDLE
-static bool get_idle(void)
+static bool get_idle(const hid_interface_t* p_interface)
 {
     #if HID_NUM_IN_REPORTS == 0
     return false;
     #else
-    #if HID_NUM_REPORT_IDS == 0
-    if(m_get_idle.Report_ID != 0) return false;
-    usb_set_ram_ptr((uint8_t*)&g_hid_in_report_settings[0].Idle_Duration_4ms);
-    #else
-    if(m_get_idle.Report_ID > HID_NUM_REPORT_IDS) return false;
-    if(m_get_idle.Report_ID == 0) return false;
-    usb_set_ram_ptr((uint8_t*)&g_hid_in_report_settings[m_get_idle.Report_ID-1u].Idle_Duration_4ms);
-    #endif
+    uint8_t report_num = report_from_id(g_hid_in_report_size, p_interface->First_In_Report, p_interface->Num_In_Reports,
+                                        p_interface->Report_IDs, m_get_idle.Report_ID);
+    
+    if(report_num == NO_REPORT) return false;
     if(m_get_idle.wLength != 1) return false;
+    usb_set_ram_ptr((uint8_t*)&g_hid_in_report_settings[report_num].Idle_Duration_4ms);
 
     usb_setup_in_control_transfer(RAM, 1, 1);
     
@@ -589,37 +884,28 @@ static bool get_idle(void)
 #endif
 
 #ifdef USE_SET_IDLE
-static bool set_idle(void)
+static bool set_idle(const hid_interface_t* p_interface)
 {
     #if HID_NUM_IN_REPORTS == 0
     return false;
     #else
-    #if HID_NUM_REPORT_IDS == 0
-    if(m_set_idle.Report_ID != 0) return false;
-	g_hid_in_report_settings[0].Idle_Count_Overflow = false;
-	g_hid_in_report_settings[0].Idle_Count = 0;
-    g_hid_in_report_settings[0].Idle_Duration_4ms = m_set_idle.Duration;
-    g_hid_in_report_settings[0].Idle_Duration_1ms = ((uint16_t)m_set_idle.Duration) << 2;
-    #else
-    if(m_set_idle.Report_ID > HID_NUM_REPORT_IDS) return false;
-    if(m_set_idle.Report_ID == 0) // All idles are set
+    uint8_t report_num;
+    
+    if(p_interface->Report_IDs && (m_set_idle.Report_ID == 0)) // All idles on the interface are set
     {
-        for(uint8_t i = 0; i < HID_NUM_IN_REPORTS; i++)
+        for(report_num = p_interface->First_In_Report; 
+            report_num < (uint8_t)(p_interface->First_In_Report + p_interface->Num_In_Reports); report_num++)
         {
-			g_hid_in_report_settings[i].Idle_Count_Overflow = false;
-			g_hid_in_report_settings[i].Idle_Count = 0;
-            g_hid_in_report_settings[i].Idle_Duration_4ms = m_set_idle.Duration;
-            g_hid_in_report_settings[i].Idle_Duration_1ms = ((uint16_t)m_set_idle.Duration) << 2;
+            if(g_hid_in_report_size[report_num] != 0) idle_set_duration(report_num, m_set_idle.Duration);
         }
     }
     else
     {
-		g_hid_in_report_settings[m_set_idle.Report_ID - 1u].Idle_Count_Overflow = false;
-		g_hid_in_report_settings[m_set_idle.Report_ID - 1u].Idle_Count = 0;
-        g_hid_in_report_settings[m_set_idle.Report_ID - 1u].Idle_Duration_4ms = m_set_idle.Duration;
-        g_hid_in_report_settings[m_set_idle.Report_ID - 1u].Idle_Duration_1ms = ((uint16_t)m_set_idle.Duration) << 2;
+        report_num = report_from_id(g_hid_in_report_size, p_interface->First_In_Report, p_interface->Num_In_Reports,
+                                    p_interface->Report_IDs, m_set_idle.Report_ID);
+        if(report_num == NO_REPORT) return false;
+        idle_set_duration(report_num, m_set_idle.Duration);
     }
-    #endif
     usb_set_control_stage(STATUS_IN_STAGE);
     usb_arm_in_status();
     return true;
@@ -627,69 +913,253 @@ static bool set_idle(void)
 }
 #endif
 
-/* ************************************************************************** */
+static uint8_t interface_from_num(uint8_t interface_num)
+{
+    uint8_t interface;
+    
+    for(interface = 0; interface < HID_NUM_INTERFACES; interface++)
+    {
+        if(g_hid_interfaces[interface].Interface_Num == interface_num) break;
+    }
+    return interface;
+}
 
+static uint8_t interface_from_ep(uint8_t ep)
+{
+    uint8_t interface;
+    
+    for(interface = 0; interface < HID_NUM_INTERFACES; interface++)
+    {
+        if(g_hid_interfaces[interface].EP == ep) break;
+    }
+    return interface;
+}
 
-/* ************************************************************************** */
-/* ************************** FUNCTIONS FOR MAIN **************************** */
-/* ************************************************************************** */
+static uint8_t report_from_id(const uint8_t* p_sizes, uint8_t first, uint8_t num, bool report_ids, uint8_t report_id)
+{
+    if(report_ids)
+    {
+        if((report_id == 0) || (report_id > num)) return NO_REPORT;
+        first += report_id - 1u;
+    }
+    else if((report_id != 0) || (num == 0)) return NO_REPORT;
+    
+    if(p_sizes[first] == 0) return NO_REPORT; // No report of this type has this ID.
+    return first;
+}
+
+#if HID_NUM_IN_REPORTS != 0
+static uint8_t interface_from_in_report(uint8_t report_num)
+{
+    uint8_t interface = HID_NUM_INTERFACES - 1u;
+    
+    // Interfaces with no IN Reports share First_In_Report with the next, so search from the top.
+    while(report_num < g_hid_interfaces[interface].First_In_Report) interface--;
+    return interface;
+}
 
-void hid_send_report(uint8_t report_num)
+static void arm_queued_reports(uint8_t interface)
 {
-    if(g_hid_report_sent)
+    const hid_interface_t* p_interface = &g_hid_interfaces[interface];
+    hid_queued_report_t*   p_report;
+    
+    if(g_usb_ep_stat[p_interface->EP][IN].Halt) return;
+    
+    while((m_in_pending[interface] < HID_IN_NUM_BD) && (m_in_queue_head[interface] != m_in_queue_tail[interface]))
     {
+        p_report = &m_in_queue[interface][m_in_queue_head[interface] & (HID_IN_QUEUE_SIZE - 1u)];
+        
         #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        uint8_t* ep_buffer_base_addr = (uint8_t*)HID_EP_IN_ODD_BUFFER_BASE_ADDR;
-        uint8_t bd_in = HID_BD_IN_ODD;
+        m_in_flight[interface][m_in_arm_ppb[interface]] = p_report->Report_Num;
+        if(m_in_arm_ppb[interface] == ODD) usb_ram_copy(p_report->Data, p_interface->EP_In_Odd, p_report->Size);
+        else usb_ram_copy(p_report->Data, p_interface->EP_In, p_report->Size);
+        usb_arm_endpoint(&g_usb_bd_table[p_interface->BD_In + m_in_arm_ppb[interface]], &g_usb_ep_stat[p_interface->EP][IN], p_report->Size);
+        m_in_arm_ppb[interface] ^= 1;
+        #else
+        m_in_flight[interface][0] = p_report->Report_Num;
+        usb_ram_copy(p_report->Data, p_interface->EP_In, p_report->Size);
+        usb_arm_endpoint(&g_usb_bd_table[p_interface->BD_In], &g_usb_ep_stat[p_interface->EP][IN], p_report->Size);
+        #endif
+        HID_INTERFACE_EP_IN_DATA_TOGGLE_VAL(interface) ^= 1; // The other BD may be armed before this one is sent.
+        m_in_pending[interface]++;
+        m_in_queue_head[interface]++;
+    }
+}
 
-        if(HID_EP_IN_LAST_PPB == ODD)
+static void in_report_done(uint8_t interface, uint8_t bd)
+{
+    uint8_t report_num = m_in_flight[interface][bd];
+    
+    if(m_in_pending[interface] == 0) return;
+    m_in_pending[interface]--;
+    if(--m_in_outstanding[report_num] == 0) g_hid_sent_report[report_num] = true;
+    if((m_in_pending[interface] == 0) && (m_in_queue_head[interface] == m_in_queue_tail[interface]))
+    {
+        g_hid_interface_report_sent[interface] = true;
+        #if HID_NUM_INTERFACES > 1
+        for(interface = 0; interface < HID_NUM_INTERFACES; interface++)
         {
-            ep_buffer_base_addr = (uint8_t*)HID_EP_IN_EVEN_BUFFER_BASE_ADDR;
-            bd_in = HID_BD_IN_EVEN;
+            if(!g_hid_interface_report_sent[interface]) return;
         }
+        #endif
+        g_hid_report_sent = true;
+    }
+}
 
-        usb_ram_copy((uint8_t*)g_hid_in_reports[report_num], ep_buffer_base_addr, g_hid_in_report_size[report_num]);
-        hid_arm_ep_in(bd_in, g_hid_in_report_size[report_num]);
+static void idle_insert(uint8_t report_num, uint16_t deadline)
+{
+    volatile uint8_t* p_link = &m_idle_head;
+    uint16_t remaining = deadline - m_idle_time;
+    
+    // Deadlines are compared as time left, so the SOF count can wrap.
+    while((*p_link != HID_IDLE_NONE) && 
+          ((uint16_t)(g_hid_in_report_settings[*p_link].Idle_Deadline - m_idle_time) <= remaining))
+    {
+        p_link = &m_idle_next[*p_link];
+    }
+    g_hid_in_report_settings[report_num].Idle_Deadline = deadline;
+    m_idle_next[report_num]  = *p_link;
+    *p_link                  = report_num;
+    m_idle_state[report_num] = IDLE_TIMED;
+}
 
-        #else
-        usb_ram_copy((uint8_t*)g_hid_in_reports[report_num], (uint8_t*)HID_EP_IN_BUFFER_BASE_ADDR, g_hid_in_report_size[report_num]);
-        hid_arm_ep_in(g_hid_in_report_size[report_num]);
-        #endif
-		USB_INTERRUPT_ENABLE = 0;
-        g_hid_in_report_settings[report_num].Idle_Count = 0;
-		USB_INTERRUPT_ENABLE = 1;
-		g_hid_sent_report[report_num] = false;
-		g_hid_report_num_sent = report_num;
-        g_hid_report_sent = false;
+static void idle_unlink(uint8_t report_num)
+{
+    volatile uint8_t* p_link;
+    uint8_t prev = HID_IDLE_NONE;
+    
+    if(m_idle_state[report_num] == IDLE_OFF) return;
+    
+    if(m_idle_state[report_num] == IDLE_TIMED) p_link = &m_idle_head;
+    else p_link = &m_idle_due_head;
+    while(*p_link != report_num)
+    {
+        prev = *p_link;
+        p_link = &m_idle_next[prev];
+    }
+    *p_link = m_idle_next[report_num];
+    if((m_idle_state[report_num] == IDLE_DUE) && (m_idle_due_tail == report_num)) m_idle_due_tail = prev;
+    m_idle_state[report_num] = IDLE_OFF;
+}
+
+static void idle_set_due(uint8_t report_num)
+{
+    m_idle_next[report_num] = HID_IDLE_NONE;
+    if(m_idle_due_head == HID_IDLE_NONE) m_idle_due_head = report_num;
+    else m_idle_next[m_idle_due_tail] = report_num;
+    m_idle_due_tail = report_num;
+    m_idle_state[report_num] = IDLE_DUE;
+    g_hid_in_report_settings[report_num].Idle_Count_Overflow = true;
+}
+
+static void idle_restart(uint8_t report_num)
+{
+    idle_unlink(report_num);
+    g_hid_in_report_settings[report_num].Idle_Count_Overflow = false;
+    g_hid_in_report_settings[report_num].Last_Report = m_idle_time;
+    if(g_hid_in_report_settings[report_num].Idle_Duration_1ms != 0)
+        idle_insert(report_num, m_idle_time + g_hid_in_report_settings[report_num].Idle_Duration_1ms);
+}
+
+#ifdef USE_SET_IDLE
+static void idle_set_duration(uint8_t report_num, uint8_t duration)
+{
+    uint16_t elapsed;
+    
+    g_hid_in_report_settings[report_num].Idle_Duration_4ms = duration;
+    g_hid_in_report_settings[report_num].Idle_Duration_1ms = ((uint16_t)duration) << 2;
+    
+    // A report already due still has to be sent, the new duration starts after it.
+    if(g_hid_in_report_settings[report_num].Idle_Count_Overflow) return;
+    
+    // Received within 4ms of the end of the current period, so it has no effect until after the report.
+    if((m_idle_state[report_num] == IDLE_TIMED) && 
+       ((uint16_t)(g_hid_in_report_settings[report_num].Idle_Deadline - m_idle_time) < 4u)) return;
+    
+    // Otherwise it acts as if it was received right after the last report.
+    idle_unlink(report_num);
+    if(duration == 0) return;
+    elapsed = m_idle_time - g_hid_in_report_settings[report_num].Last_Report;
+    if(elapsed >= g_hid_in_report_settings[report_num].Idle_Duration_1ms) idle_set_due(report_num);
+    else idle_insert(report_num, g_hid_in_report_settings[report_num].Last_Report + g_hid_in_report_settings[report_num].Idle_Duration_1ms);
+}
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+#if HID_NUM_IN_REPORTS != 0
+bool hid_send_report(uint8_t report_num)
+{
+    uint8_t interface = interface_from_in_report(report_num);
+    hid_queued_report_t* p_report;
+    
+    if((uint8_t)(m_in_queue_tail[interface] - m_in_queue_head[interface]) == HID_IN_QUEUE_SIZE) return false;
+    
+    // The entry isn't seen by the ISR until the tail moves past it.
+    p_report = &m_in_queue[interface][m_in_queue_tail[interface] & (HID_IN_QUEUE_SIZE - 1u)];
+    p_report->Report_Num = report_num;
+    p_report->Size       = g_hid_in_report_size[report_num];
+    usb_ram_copy((uint8_t*)g_hid_in_reports[report_num], p_report->Data, p_report->Size);
+    
+    USB_INTERRUPT_ENABLE = 0;
+    m_in_queue_tail[interface]++;
+    m_in_outstanding[report_num]++;
+    g_hid_sent_report[report_num] = false;
+    g_hid_interface_report_sent[interface] = false;
+    g_hid_report_sent = false;
+    idle_restart(report_num);
+    arm_queued_reports(interface);
+    USB_INTERRUPT_ENABLE = 1;
+    return true;
+}
+
+uint8_t hid_in_queue_space(uint8_t report_num)
+{
+    uint8_t interface = interface_from_in_report(report_num);
+    
+    return HID_IN_QUEUE_SIZE - (uint8_t)(m_in_queue_tail[interface] - m_in_queue_head[interface]);
+}
+
+uint8_t hid_idle_report(void)
+{
+    uint8_t report_num;
+    
+    USB_INTERRUPT_ENABLE = 0;
+    report_num = m_idle_due_head;
+    if(report_num != HID_IDLE_NONE)
+    {
+        m_idle_due_head = m_idle_next[report_num];
+        m_idle_state[report_num] = IDLE_OFF;
     }
+    USB_INTERRUPT_ENABLE = 1;
+    return report_num;
 }
+#endif
 
 void hid_service_sof(void)
 {
+    #if HID_NUM_IN_REPORTS != 0
+    uint8_t report_num;
+    
     if(usb_get_state() == STATE_CONFIGURED)
     {
-        #if HID_NUM_IN_REPORTS > 1
-        uint8_t i;
-        for(i = 0; i < HID_NUM_IN_REPORTS; i++)
-        {
-            if(g_hid_in_report_settings[i].Idle_Duration_1ms != 0) 
-                g_hid_in_report_settings[i].Idle_Count++; // If the Idle_Duration for a report is not infinite (0), increment their counter.
-        }
+        m_idle_time++;
         
-        for(i = 0; i < HID_NUM_IN_REPORTS; i++) // If an Idle_Counter is not infinite and goes past the Idle_Duration, send the report.
+        // Only the earliest deadline is checked, reports that end on the same SOF follow it.
+        while((m_idle_head != HID_IDLE_NONE) && (g_hid_in_report_settings[m_idle_head].Idle_Deadline == m_idle_time))
         {
-            if(g_hid_in_report_settings[i].Idle_Duration_1ms != 0 && g_hid_in_report_settings[i].Idle_Count > g_hid_in_report_settings[i].Idle_Duration_1ms - 1) 
-                g_hid_in_report_settings[i].Idle_Count_Overflow = true;
+            report_num  = m_idle_head;
+            m_idle_head = m_idle_next[report_num];
+            idle_set_due(report_num);
         }
-        #else
-		if(g_hid_in_report_settings[0].Idle_Duration_1ms != 0)
-        {
-			g_hid_in_report_settings[0].Idle_Count++; // If the Idle_Duration is not infinite (0), increment the counter.
-			if(g_hid_in_report_settings[0].Idle_Count > g_hid_in_report_settings[0].Idle_Duration_1ms - 1) 
-                g_hid_in_report_settings[0].Idle_Count_Overflow = true;
-        }
-        #endif
     }
+    #endif
 }
 
 /* ************************************************************************** */
\ No newline at end of file
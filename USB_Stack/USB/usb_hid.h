@@ -74,6 +74,111 @@
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* **************************** HID IN QUEUE ******************************** */
+/* ************************************************************************** */
+
+#ifndef HID_IN_QUEUE_SIZE
+#define HID_IN_QUEUE_SIZE 4
+#endif
+#ifndef HID_IN_QUEUE_REPORT_SIZE
+#define HID_IN_QUEUE_REPORT_SIZE HID_EP_SIZE
+#endif
+
+#if (HID_IN_QUEUE_SIZE == 0) || (HID_IN_QUEUE_SIZE & (HID_IN_QUEUE_SIZE - 1)) || (HID_IN_QUEUE_SIZE > 128)
+#error "HID_IN_QUEUE_SIZE must be a power of 2, up to 128."
+#endif
+
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define HID_IN_NUM_BD 2 // Both EVEN and ODD IN BDs are kept armed.
+#else
+#define HID_IN_NUM_BD 1
+#endif
+
+#define HID_IDLE_NONE 0xFF // No report's idle period has ended.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** HID INTERFACES ****************************** */
+/* ************************************************************************** */
+
+#ifndef HID_NUM_INTERFACES
+#define HID_NUM_INTERFACES 1
+#endif
+
+#if (HID_NUM_INTERFACES < 1) || (HID_NUM_INTERFACES > 3)
+#error "HID_NUM_INTERFACES must be 1 to 3."
+#endif
+
+#ifndef HID_INT
+#define HID_INT 0
+#endif
+
+// Reports are numbered across all interfaces, interface 0's first, so the
+// HID_NUM_*_REPORTS totals size the report tables and interfaces 1 and 2 say
+// how many of them are theirs.
+#if HID_NUM_INTERFACES < 2
+#define HID1_NUM_IN_REPORTS      0
+#define HID1_NUM_OUT_REPORTS     0
+#define HID1_NUM_FEATURE_REPORTS 0
+#endif
+#if HID_NUM_INTERFACES < 3
+#define HID2_NUM_IN_REPORTS      0
+#define HID2_NUM_OUT_REPORTS     0
+#define HID2_NUM_FEATURE_REPORTS 0
+#endif
+
+#define HID0_NUM_IN_REPORTS      (HID_NUM_IN_REPORTS - HID1_NUM_IN_REPORTS - HID2_NUM_IN_REPORTS)
+#define HID0_NUM_OUT_REPORTS     (HID_NUM_OUT_REPORTS - HID1_NUM_OUT_REPORTS - HID2_NUM_OUT_REPORTS)
+#define HID0_NUM_FEATURE_REPORTS (HID_NUM_FEATURE_REPORTS - HID1_NUM_FEATURE_REPORTS - HID2_NUM_FEATURE_REPORTS)
+
+#if (HID0_NUM_IN_REPORTS < 0) || (HID0_NUM_OUT_REPORTS < 0) || (HID0_NUM_FEATURE_REPORTS < 0)
+#error "HID1/HID2 report counts are more than the HID_NUM_*_REPORTS totals."
+#endif
+
+#ifdef _PIC14E
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define HID_INTERFACE_BUFFERS_SIZE 0x140 // Each buffer gets its own 80 byte bank.
+#else
+#define HID_INTERFACE_BUFFERS_SIZE 0xA0
+#endif
+#else
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define HID_INTERFACE_BUFFERS_SIZE (HID_EP_SIZE * 4)
+#else
+#define HID_INTERFACE_BUFFERS_SIZE (HID_EP_SIZE * 2)
+#endif
+#endif
+
+#if HID_NUM_INTERFACES > 1
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+#define HID1_EP_OUT_BUFFER_BASE_ADDR (HID_EP_OUT_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#define HID1_EP_IN_BUFFER_BASE_ADDR  (HID_EP_IN_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#else
+#define HID1_EP_OUT_EVEN_BUFFER_BASE_ADDR (HID_EP_OUT_EVEN_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#define HID1_EP_OUT_ODD_BUFFER_BASE_ADDR  (HID_EP_OUT_ODD_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#define HID1_EP_IN_EVEN_BUFFER_BASE_ADDR  (HID_EP_IN_EVEN_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#define HID1_EP_IN_ODD_BUFFER_BASE_ADDR   (HID_EP_IN_ODD_BUFFER_BASE_ADDR + HID_INTERFACE_BUFFERS_SIZE)
+#endif
+#endif
+
+#if HID_NUM_INTERFACES > 2
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+#define HID2_EP_OUT_BUFFER_BASE_ADDR (HID_EP_OUT_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#define HID2_EP_IN_BUFFER_BASE_ADDR  (HID_EP_IN_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#else
+#define HID2_EP_OUT_EVEN_BUFFER_BASE_ADDR (HID_EP_OUT_EVEN_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#define HID2_EP_OUT_ODD_BUFFER_BASE_ADDR  (HID_EP_OUT_ODD_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#define HID2_EP_IN_EVEN_BUFFER_BASE_ADDR  (HID_EP_IN_EVEN_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#define HID2_EP_IN_ODD_BUFFER_BASE_ADDR   (HID_EP_IN_ODD_BUFFER_BASE_ADDR + (HID_INTERFACE_BUFFERS_SIZE * 2))
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* ******************************* HID CODES ******************************** */
 /* ************************************************************************** */
@@ -100,7 +205,12 @@
 #define HID_EP_OUT_LAST_PPB        g_usb_ep_stat[HID_EP][OUT].Last_PPB
 #define HID_EP_IN_LAST_PPB         g_usb_ep_stat[HID_EP][IN].Last_PPB
 #define HID_EP_OUT_DATA_TOGGLE_VAL g_usb_ep_stat[HID_EP][OUT].Data_Toggle_Val
-#define HID_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[HID_EP][IN].Data_Toggle_Val
+#define HID_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[HID_EP][IN].Data_Toggle_Val // DATA PID of the next IN BD armed.
+
+#define HID_INTERFACE_EP_OUT_LAST_PPB(interface)        g_usb_ep_stat[g_hid_interfaces[interface].EP][OUT].Last_PPB
+#define HID_INTERFACE_EP_IN_LAST_PPB(interface)         g_usb_ep_stat[g_hid_interfaces[interface].EP][IN].Last_PPB
+#define HID_INTERFACE_EP_OUT_DATA_TOGGLE_VAL(interface) g_usb_ep_stat[g_hid_interfaces[interface].EP][OUT].Data_Toggle_Val
+#define HID_INTERFACE_EP_IN_DATA_TOGGLE_VAL(interface)  g_usb_ep_stat[g_hid_interfaces[interface].EP][IN].Data_Toggle_Val
 
 /* ************************************************************************** */
 
@@ -124,10 +234,33 @@ typedef struct
 {
     uint8_t  Idle_Duration_4ms;
     uint16_t Idle_Duration_1ms;
-    uint16_t Idle_Count;
+    uint16_t Idle_Deadline;       // SOF count the idle period ends on.
+    uint16_t Last_Report;         // SOF count the report was last queued on.
 	bool     Idle_Count_Overflow;
 }hid_in_report_setting_t;
 
+// HID Interface (one interrupt EP, its own report descriptor and reports)
+typedef struct
+{
+    uint8_t  Interface_Num;
+    uint8_t  EP;
+    uint8_t  BD_Out;                // EVEN BD when pingpong is used.
+    uint8_t  BD_In;                 // EVEN BD when pingpong is used.
+    uint8_t* EP_Out;                // EVEN buffer when pingpong is used.
+    uint8_t* EP_In;                 // EVEN buffer when pingpong is used.
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    uint8_t* EP_Out_Odd;
+    uint8_t* EP_In_Odd;
+    #endif
+    uint8_t  First_In_Report;       // Reports are numbered across all interfaces.
+    uint8_t  Num_In_Reports;
+    uint8_t  First_Out_Report;
+    uint8_t  Num_Out_Reports;
+    uint8_t  First_Feature_Report;
+    uint8_t  Num_Feature_Reports;
+    bool     Report_IDs;            // Reports start with a Report ID.
+}hid_interface_t;
+
 /* ************************************************************************** */
 
 
@@ -138,17 +271,39 @@ typedef struct
 #if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
 extern uint8_t g_hid_ep_out[HID_EP_SIZE] __at(HID_EP_OUT_BUFFER_BASE_ADDR);
 extern uint8_t g_hid_ep_in[HID_EP_SIZE]  __at(HID_EP_IN_BUFFER_BASE_ADDR);
+#if HID_NUM_INTERFACES > 1
+extern uint8_t g_hid1_ep_out[HID_EP_SIZE] __at(HID1_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_hid1_ep_in[HID_EP_SIZE]  __at(HID1_EP_IN_BUFFER_BASE_ADDR);
+#endif
+#if HID_NUM_INTERFACES > 2
+extern uint8_t g_hid2_ep_out[HID_EP_SIZE] __at(HID2_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_hid2_ep_in[HID_EP_SIZE]  __at(HID2_EP_IN_BUFFER_BASE_ADDR);
+#endif
 
 #else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
 extern uint8_t g_hid_ep_out_even[HID_EP_SIZE]  __at(HID_EP_OUT_EVEN_BUFFER_BASE_ADDR);
 extern uint8_t g_hid_ep_out_odd[HID_EP_SIZE]   __at(HID_EP_OUT_ODD_BUFFER_BASE_ADDR);
 extern uint8_t g_hid_ep_in_even[HID_EP_SIZE]   __at(HID_EP_IN_EVEN_BUFFER_BASE_ADDR);
 extern uint8_t g_hid_ep_in_odd[HID_EP_SIZE]    __at(HID_EP_IN_ODD_BUFFER_BASE_ADDR);
+#if HID_NUM_INTERFACES > 1
+extern uint8_t g_hid1_ep_out_even[HID_EP_SIZE] __at(HID1_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_hid1_ep_out_odd[HID_EP_SIZE]  __at(HID1_EP_OUT_ODD_BUFFER_BASE_ADDR);
+extern uint8_t g_hid1_ep_in_even[HID_EP_SIZE]  __at(HID1_EP_IN_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_hid1_ep_in_odd[HID_EP_SIZE]   __at(HID1_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
+#if HID_NUM_INTERFACES > 2
+extern uint8_t g_hid2_ep_out_even[HID_EP_SIZE] __at(HID2_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_hid2_ep_out_odd[HID_EP_SIZE]  __at(HID2_EP_OUT_ODD_BUFFER_BASE_ADDR);
+extern uint8_t g_hid2_ep_in_even[HID_EP_SIZE]  __at(HID2_EP_IN_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_hid2_ep_in_odd[HID_EP_SIZE]   __at(HID2_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
 #endif
 
-extern volatile bool                    g_hid_report_sent;
-extern volatile uint8_t                 g_hid_report_num_sent;
-extern volatile bool                    g_hid_sent_report[HID_NUM_IN_REPORTS];
+extern const hid_interface_t            g_hid_interfaces[HID_NUM_INTERFACES];
+extern volatile uint8_t                 g_hid_interface;                        // Interface the current hid_out() callback was made for.
+extern volatile bool                    g_hid_interface_report_sent[HID_NUM_INTERFACES]; // Nothing queued or in flight on the interface.
+extern volatile bool                    g_hid_report_sent;                      // Nothing queued or in flight.
+extern volatile bool                    g_hid_sent_report[HID_NUM_IN_REPORTS];  // No copy of the report queued or in flight.
 extern volatile hid_in_report_setting_t g_hid_in_report_settings[HID_NUM_IN_REPORTS];
 
 /* ************************************************************************** */
@@ -192,6 +347,8 @@ void hid_init(void);
  * @fn void hid_tasks(void)
  * 
  * @brief Services HID tasks.
+ * 
+ * Transactions on EPs that don't belong to a HID interface are ignored.
  */
 void hid_tasks(void);
 
@@ -213,9 +370,31 @@ void hid_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir);
  * @fn void hid_set_sent_report_flag(void)
  * 
  * @brief Lets the application know that a report has been sent.
+ * 
+ * Called from hid_tasks() when an IN BD of interface g_hid_interface completes.
+ * Updates g_hid_sent_report, g_hid_interface_report_sent and g_hid_report_sent
+ * for the report that was in it.
  */
 void hid_set_sent_report_flag(void);
 
+/**
+ * @fn void hid_interface_arm_ep_out(uint8_t interface)
+ * 
+ * @brief Arms an interface's EP OUT for the next OUT Report.
+ * 
+ * With pingpong the BD after the last one used is armed.
+ * 
+ * @param[in] interface Index into g_hid_interfaces.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * hid_interface_arm_ep_out(g_hid_interface);
+ * @endcode
+ * </li></ul>
+ */
+void hid_interface_arm_ep_out(uint8_t interface);
+
 /**
  * @fn void hid_clear_ep_toggle(void)
  * 
@@ -306,18 +485,70 @@ void hid_arm_ep_in(uint8_t cnt);
 /* ************************************************************************** */
 
 /**
- * @fn void hid_send_report(uint8_t report_num)
+ * @fn bool hid_send_report(uint8_t report_num)
  * 
- * @brief Sends OUT Report on HID EP.
+ * @brief Queues IN Report to send on HID EP.
+ * 
+ * A copy of the report is taken, so it can be changed straight away. Queued
+ * reports are armed from the ISR as IN BDs complete, one per bInterval.
+ * Reports must not be larger than HID_IN_QUEUE_REPORT_SIZE. Report numbers
+ * run across all interfaces, the report goes out on its own interface's EP.
  * 
  * @param report_num Report number to send.
+ * 
+ * @return Returns false if the queue is full, the report was not queued.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * g_hid_in_report1.Keycode = KEY_A;
+ * if(hid_send_report(0)) m_send_report0 = false;
+ * @endcode
+ * </li></ul>
+ */
+bool hid_send_report(uint8_t report_num);
+
+/**
+ * @fn uint8_t hid_in_queue_space(uint8_t report_num)
+ * 
+ * @brief Returns how many more IN Reports hid_send_report() can queue.
+ * 
+ * Each interface has its own IN queue, the one the report is sent on is used.
+ * 
+ * @param report_num Report number that would be sent.
+ * 
+ * @return Free IN queue entries.
+ */
+uint8_t hid_in_queue_space(uint8_t report_num);
+
+/**
+ * @fn uint8_t hid_idle_report(void)
+ * 
+ * @brief Returns the next IN Report whose idle period has ended.
+ * 
+ * Reports are returned in the order they became due. The report's 
+ * Idle_Count_Overflow flag stays set until it is sent with hid_send_report().
+ * 
+ * @return Report number, or HID_IDLE_NONE when no report is due.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * uint8_t report_num;
+ * while((report_num = hid_idle_report()) != HID_IDLE_NONE) hid_send_report(report_num);
+ * @endcode
+ * </li></ul>
  */
-void hid_send_report(uint8_t report_num);
+uint8_t hid_idle_report(void);
 
 /**
  * @fn void hid_service_sof(void)
  * 
- * @brief Sends OUT Report on HID EP regularly using SOF.
+ * @brief Counts idle periods, call from usb_sof().
+ * 
+ * Reports with a finite idle rate are kept in a list ordered by deadline, so
+ * only the head is checked each SOF. Reports that reach their deadline are
+ * flagged with Idle_Count_Overflow and returned by hid_idle_report().
  */
 void hid_service_sof(void);
 
@@ -326,6 +557,9 @@ void hid_service_sof(void);
  * @brief Function to run in main, so you can respond to reception of 
  * OUT Reports.
  * 
+ * g_hid_interface holds the interface it came in on, re-arm it with
+ * hid_interface_arm_ep_out(g_hid_interface).
+ * 
  * @param report_num Report number received.
  */
 void hid_out(uint8_t report_num);
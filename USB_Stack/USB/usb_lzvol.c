@@ -0,0 +1,135 @@
+/**
+ * @file usb_lzvol.c
+ * @brief <i>Compressed read-only volume</i> reader.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MSD Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_lzvol.h"
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+static uint8_t        m_window[256]; // Last 256 bytes of the sector, indexed by uint8_t so it wraps for free.
+static uint8_t        m_pos;         // Next slot of the window.
+static const uint8_t* m_p_src;       // Next token byte.
+static uint32_t       m_lba = 0xFFFFFFFF; // Sector being decoded, none until the first read.
+static uint16_t       m_offset;      // Bytes of it decoded so far.
+static uint8_t        m_literals;    // Literals left in the current token.
+static uint8_t        m_copy;        // Copy bytes left in the current token.
+static uint8_t        m_back;        // Copy distance, 256 wraps to 0 which is the right slot.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ LOCAL FUNCTION DECLARATIONS ********************* */
+/* ************************************************************************** */
+
+static void decode(uint8_t* p_buffer, uint16_t bytes);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* FUNCTIONS ******************************** */
+/* ************************************************************************** */
+
+void lzvol_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint16_t run;
+    
+    if(lba >= g_lzvol_sectors)
+    {
+        usb_ram_set(0, p_buffer, bytes);
+        return;
+    }
+    
+    if(offset == 0 || lba != m_lba || offset < m_offset) // Not following on, start the sector again.
+    {
+        m_lba      = lba;
+        m_p_src    = &g_lzvol_data[g_lzvol_index[(uint16_t)lba]];
+        m_offset   = 0;
+        m_literals = 0;
+        m_copy     = 0;
+    }
+    while(bytes && m_offset < offset) // Skipped bytes still have to pass through the window.
+    {
+        run = offset - m_offset;
+        if(run > bytes) run = bytes;
+        decode(p_buffer, run);
+    }
+    decode(p_buffer, bytes);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** LOCAL FUNCTIONS ***************************** */
+/* ************************************************************************** */
+
+static void decode(uint8_t* p_buffer, uint16_t bytes)
+{
+    uint8_t token;
+    uint8_t byte;
+    
+    m_offset += bytes;
+    while(bytes--)
+    {
+        if(m_literals)
+        {
+            m_literals--;
+            byte = *m_p_src++;
+        }
+        else if(m_copy)
+        {
+            m_copy--;
+            byte = m_window[(uint8_t)(m_pos - m_back)];
+        }
+        else // Next token.
+        {
+            token = *m_p_src++;
+            if(token & LZVOL_MATCH)
+            {
+                m_copy = (token & ~LZVOL_MATCH) + (LZVOL_MIN_MATCH - 1);
+                m_back = *m_p_src++ + 1;
+                byte = m_window[(uint8_t)(m_pos - m_back)];
+            }
+            else
+            {
+                m_literals = token;
+                byte = *m_p_src++;
+            }
+        }
+        m_window[m_pos++] = byte;
+        *p_buffer++ = byte;
+    }
+}
+
+/* ************************************************************************** */
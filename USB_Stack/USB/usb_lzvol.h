@@ -0,0 +1,105 @@
+/**
+ * @file usb_lzvol.h
+ * @brief <i>Compressed read-only volume</i> reader.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MSD Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_LZVOL_H
+#define USB_LZVOL_H
+
+#include <stdint.h>
+
+/* ************************************************************************** */
+/* ***************************** IMAGE FORMAT ******************************* */
+/* ************************************************************************** */
+
+/*
+ * A disk image is packed by Tools/msd_pack_image.py into a C file that's added 
+ * to the project. Every 512 byte sector is compressed on its own, so any sector 
+ * can be read without the ones before it, and sectors with the same contents 
+ * (e.g. all the empty ones) share one copy.
+ * 
+ *  g_lzvol_index[lba]   Offset of the sector's tokens in g_lzvol_data.
+ *  g_lzvol_data         Tokens:
+ *    0LLLLLLL            L + 1 literal bytes follow.
+ *    1LLLLLLL DDDDDDDD   Copy L + 3 bytes from D + 1 bytes back in the sector.
+ * 
+ * Copies only reach 256 bytes back, so a sector is decoded in order through 
+ * a 256 byte window and can be handed out a packet at a time.
+ */
+
+#define LZVOL_SECTOR_SIZE 512
+#define LZVOL_MATCH       0x80
+#define LZVOL_MIN_MATCH   3
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** EXTERNAL IMAGE ****************************** */
+/* ************************************************************************** */
+
+extern const uint16_t g_lzvol_sectors; // Found in the packed image.
+extern const uint16_t g_lzvol_index[];
+extern const uint8_t  g_lzvol_data[];
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ FUNCTION DECLARATIONS *************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn void lzvol_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+ * 
+ * @brief Decompresses part of a volume sector.
+ * 
+ * Reading on from where the last call finished continues the decode, any 
+ * other offset starts the sector again. Sectors past the image read as zero.
+ * 
+ * @param lba Sector number.
+ * @param offset Byte offset into the sector.
+ * @param p_buffer Where the bytes go.
+ * @param bytes Number of bytes, within the sector.
+ * 
+ * <b>Code Example:</b>
+ * @code
+ * void msd_rx_sector(void)
+ * {
+ *     #ifdef MSD_LIMITED_RAM
+ *     lzvol_read(g_msd_rw_10_vars.LBA, g_msd_byte_of_sect, g_msd_ep_in, MSD_EP_SIZE);
+ *     #else
+ *     lzvol_read(g_msd_rw_10_vars.LBA, 0, g_msd_sect_data, BYTES_PER_BLOCK_LE);
+ *     #endif
+ * }
+ * @endcode
+ */
+void lzvol_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+
+/* ************************************************************************** */
+
+#endif /* USB_LZVOL_H */
@@ -0,0 +1,519 @@
+/**
+ * @file usb_midi.c
+ * @brief <i>USB-MIDI</i> streaming function core.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MIDI Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_midi.h"
+#include "usb_ch9.h"
+
+/* ************************************************************************** */
+/* *************************** MIDI ENDPOINTS ******************************* */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+uint8_t g_midi_ep_out[MIDI_EP_SIZE] __at(MIDI_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_midi_ep_in[MIDI_EP_SIZE]  __at(MIDI_EP_IN_BUFFER_BASE_ADDR);
+
+#define MIDI_BD_OUT_FIRST MIDI_BD_OUT
+#define MIDI_BD_IN_FIRST  MIDI_BD_IN
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+uint8_t g_midi_ep_out_even[MIDI_EP_SIZE] __at(MIDI_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_midi_ep_out_odd[MIDI_EP_SIZE]  __at(MIDI_EP_OUT_ODD_BUFFER_BASE_ADDR);
+uint8_t g_midi_ep_in_even[MIDI_EP_SIZE]  __at(MIDI_EP_IN_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_midi_ep_in_odd[MIDI_EP_SIZE]   __at(MIDI_EP_IN_ODD_BUFFER_BASE_ADDR);
+
+#define MIDI_BD_OUT_FIRST MIDI_BD_OUT_EVEN // ODD follows EVEN.
+#define MIDI_BD_IN_FIRST  MIDI_BD_IN_EVEN
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** LOCAL TYPES ******************************** */
+/* ************************************************************************** */
+
+// Byte stream parser state of one cable.
+typedef struct
+{
+    uint8_t Status;  // Running status, 0xF0 inside SysEx, 0 for none.
+    uint8_t Needed;  // Data bytes the status takes.
+    uint8_t Count;   // Bytes held in Data.
+    uint8_t Data[3];
+}midi_parser_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+#define IN_FIFO_MASK  (MIDI_IN_FIFO_SIZE - 1)
+#define OUT_FIFO_MASK (MIDI_OUT_FIFO_SIZE - 1)
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+static uint8_t* const m_out_buffers[MIDI_NUM_BD] = {g_midi_ep_out};
+static uint8_t* const m_in_buffers[MIDI_NUM_BD]  = {g_midi_ep_in};
+#else
+static uint8_t* const m_out_buffers[MIDI_NUM_BD] = {g_midi_ep_out_even, g_midi_ep_out_odd};
+static uint8_t* const m_in_buffers[MIDI_NUM_BD]  = {g_midi_ep_in_even, g_midi_ep_in_odd};
+#endif
+
+// FIFOs, the indexes run freely and are masked on use. Each has one writer.
+static midi_event_t     m_in_fifo[MIDI_IN_FIFO_SIZE];
+static volatile uint8_t m_in_head;    // Moved by midi_send_event() only.
+static volatile uint8_t m_in_tail;    // Moved by flush_in() only.
+static midi_event_t     m_out_fifo[MIDI_OUT_FIFO_SIZE];
+static volatile uint8_t m_out_head;   // Moved by unpack_out() only.
+static volatile uint8_t m_out_tail;   // Moved by midi_receive_event() only.
+
+// IN
+static volatile uint8_t m_in_pending; // IN BDs armed and not yet sent.
+static uint8_t          m_in_arm_ppb; // IN BD to arm next.
+static volatile uint8_t m_in_frames;  // Frames a partly filled packet has waited.
+
+// OUT
+static volatile uint8_t m_out_full;   // OUT BDs holding events not yet unpacked.
+static uint8_t          m_out_ppb;    // OUT BD to unpack next.
+static uint8_t          m_out_offset; // Bytes already unpacked from it.
+
+static midi_parser_t    m_parsers[MIDI_NUM_CABLES];
+
+// Event bytes used by each CIN (0 for the reserved CINs).
+static const uint8_t m_cin_sizes[16] = {0, 0, 2, 3, 3, 1, 2, 3, 3, 3, 3, 3, 2, 2, 3, 1};
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************* LOCAL FUNCTION DECLARATIONS ************************ */
+/* ************************************************************************** */
+
+/**
+ * @fn void flush_in(bool partial)
+ * 
+ * @brief Packs queued events into free IN BDs and arms them.
+ * 
+ * Run from the ISR, or with the USB interrupt disabled.
+ * 
+ * @param[in] partial Send a packet with less than MIDI_EVENTS_PER_PACKET events.
+ */
+static void flush_in(bool partial);
+
+/**
+ * @fn void unpack_out(void)
+ * 
+ * @brief Moves events from received OUT BDs into the OUT FIFO, re-arming each one emptied.
+ * 
+ * A BD is held while the FIFO is full. Run from the ISR, or with the USB 
+ * interrupt disabled.
+ */
+static void unpack_out(void);
+
+/**
+ * @fn void arm_out_bds(void)
+ * 
+ * @brief Drops held OUT events and arms every OUT BD, starting with the one the SIE uses next.
+ */
+static void arm_out_bds(void);
+
+/**
+ * @fn void parser_send(uint8_t cable, uint8_t cin, const uint8_t* data, uint8_t count)
+ * 
+ * @brief Queues an event put together by midi_parse_byte().
+ * 
+ * @param[in] cable Virtual cable number.
+ * @param[in] cin Code Index Number.
+ * @param[in] data MIDI bytes.
+ * @param[in] count Amount of MIDI bytes (unused bytes are sent as 0).
+ */
+static void parser_send(uint8_t cable, uint8_t cin, const uint8_t* data, uint8_t count);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** MIDI FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+void midi_init(void)
+{
+    uint8_t i;
+    
+    for(i = 0; i < MIDI_NUM_BD; i++)
+    {
+        g_usb_bd_table[MIDI_BD_OUT_FIRST + i].STAT = 0;
+        g_usb_bd_table[MIDI_BD_OUT_FIRST + i].ADR  = (uint16_t)m_out_buffers[i];
+        g_usb_bd_table[MIDI_BD_IN_FIRST + i].STAT  = 0;
+        g_usb_bd_table[MIDI_BD_IN_FIRST + i].ADR   = (uint16_t)m_in_buffers[i];
+    }
+    
+    // EP Settings
+    MIDI_UEPbits.EPHSHK   = 1; // Handshaking enabled 
+    MIDI_UEPbits.EPCONDIS = 0; // Don't allow SETUP
+    MIDI_UEPbits.EPOUTEN  = 1; // EP output enabled
+    MIDI_UEPbits.EPINEN   = 1; // EP input enabled
+    g_usb_ep_stat[MIDI_EP][OUT].Halt = 0;
+    g_usb_ep_stat[MIDI_EP][IN].Halt  = 0;
+    midi_clear_ep_toggle();
+    
+    m_in_head    = 0;
+    m_in_tail    = 0;
+    m_out_head   = 0;
+    m_out_tail   = 0;
+    m_in_pending = 0;
+    m_in_frames  = 0;
+    #if MIDI_NUM_BD == 2
+    m_in_arm_ppb = MIDI_EP_IN_LAST_PPB ^ 1;
+    #else
+    m_in_arm_ppb = 0;
+    #endif
+    for(i = 0; i < MIDI_NUM_CABLES; i++) m_parsers[i].Status = 0;
+    
+    arm_out_bds();
+}
+
+void midi_tasks(void)
+{
+    if(TRANSACTION_EP != MIDI_EP) return;
+    
+    if(TRANSACTION_DIR == IN)
+    {
+        #if MIDI_NUM_BD == 2
+        MIDI_EP_IN_LAST_PPB = PINGPONG_PARITY;
+        #endif
+        if(m_in_pending) m_in_pending--;
+        flush_in(m_in_frames >= MIDI_IN_FLUSH_FRAMES);
+    }
+    else
+    {
+        #if MIDI_NUM_BD == 2
+        MIDI_EP_OUT_LAST_PPB = PINGPONG_PARITY;
+        #endif
+        m_out_full++;
+        unpack_out();
+    }
+}
+
+void midi_sof(void)
+{
+    if(usb_get_state() != STATE_CONFIGURED) return;
+    if(m_in_head == m_in_tail) return;
+    
+    if(m_in_frames < MIDI_IN_FLUSH_FRAMES) m_in_frames++;
+    if(m_in_frames >= MIDI_IN_FLUSH_FRAMES) flush_in(true);
+}
+
+void midi_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
+{
+    if(ep != MIDI_EP) return;
+    
+    g_usb_ep_stat[ep][dir].Data_Toggle_Val = 0;
+    
+    if(g_usb_ep_stat[ep][dir].Halt)
+    {
+        g_usb_ep_stat[ep][dir].Halt      = 0;
+        g_usb_bd_table[bdt_index].STAT   = 0;
+        #if MIDI_NUM_BD == 2
+        g_usb_bd_table[++bdt_index].STAT = 0;
+        #endif
+        
+        if(dir == IN)
+        {
+            // Packets in the stalled BDs are dropped, newest first, leaving
+            // m_in_arm_ppb on the BD the SIE will use next.
+            while(m_in_pending)
+            {
+                #if MIDI_NUM_BD == 2
+                m_in_arm_ppb ^= 1;
+                #endif
+                m_in_pending--;
+            }
+        }
+        else arm_out_bds();
+    }
+    if(dir == IN) flush_in(true);
+}
+
+void midi_clear_ep_toggle(void)
+{
+    MIDI_EP_OUT_DATA_TOGGLE_VAL = 0;
+    MIDI_EP_IN_DATA_TOGGLE_VAL  = 0;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+static void flush_in(bool partial)
+{
+    uint8_t  queued;
+    uint8_t  events;
+    uint8_t  first;
+    uint8_t  run;
+    uint8_t* p_buffer;
+    
+    if(g_usb_ep_stat[MIDI_EP][IN].Halt) return;
+    
+    while(m_in_pending < MIDI_NUM_BD)
+    {
+        queued = (uint8_t)(m_in_head - m_in_tail);
+        if(queued == 0) 
+        {
+            m_in_frames = 0;
+            return;
+        }
+        if(queued < MIDI_EVENTS_PER_PACKET && !partial) return;
+        events = queued < MIDI_EVENTS_PER_PACKET ? queued : MIDI_EVENTS_PER_PACKET;
+        
+        // Copied as at most two runs, the second from the start of the FIFO.
+        p_buffer = m_in_buffers[m_in_arm_ppb];
+        first = m_in_tail & IN_FIFO_MASK;
+        run = MIDI_IN_FIFO_SIZE - first;
+        if(run > events) run = events;
+        usb_ram_copy(m_in_fifo[first].array, p_buffer, (uint8_t)(run * 4));
+        if(events > run) usb_ram_copy(m_in_fifo[0].array, p_buffer + (run * 4), (uint8_t)((events - run) * 4));
+        m_in_tail += events;
+        
+        usb_arm_endpoint(&g_usb_bd_table[MIDI_BD_IN_FIRST + m_in_arm_ppb], &g_usb_ep_stat[MIDI_EP][IN], (uint8_t)(events * 4));
+        MIDI_EP_IN_DATA_TOGGLE_VAL ^= 1; // The other BD may be armed before this one is sent.
+        #if MIDI_NUM_BD == 2
+        m_in_arm_ppb ^= 1;
+        #endif
+        m_in_pending++;
+        m_in_frames = 0;
+    }
+}
+
+static void unpack_out(void)
+{
+    bd_t*    p_bd;
+    uint8_t* p_event;
+    uint8_t  cnt;
+    
+    while(m_out_full)
+    {
+        p_bd = &g_usb_bd_table[MIDI_BD_OUT_FIRST + m_out_ppb];
+        cnt  = p_bd->CNT & 0xFC; // Whole event packets only.
+        
+        while(m_out_offset < cnt)
+        {
+            if((uint8_t)(m_out_head - m_out_tail) == MIDI_OUT_FIFO_SIZE) return; // Held until there's room.
+            
+            p_event = m_out_buffers[m_out_ppb] + m_out_offset;
+            if(p_event[0] & 0x0F) // CIN 0 is reserved, and pads packets.
+            {
+                usb_ram_copy(p_event, m_out_fifo[m_out_head & OUT_FIFO_MASK].array, 4);
+                m_out_head++;
+            }
+            m_out_offset += 4;
+        }
+        
+        m_out_offset = 0;
+        m_out_full--;
+        usb_arm_endpoint(p_bd, &g_usb_ep_stat[MIDI_EP][OUT], MIDI_EP_SIZE);
+        MIDI_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+        #if MIDI_NUM_BD == 2
+        m_out_ppb ^= 1;
+        #endif
+    }
+}
+
+static void arm_out_bds(void)
+{
+    uint8_t bd;
+    
+    m_out_full   = 0;
+    m_out_offset = 0;
+    #if MIDI_NUM_BD == 2
+    m_out_ppb    = MIDI_EP_OUT_LAST_PPB ^ 1;
+    #else
+    m_out_ppb    = 0;
+    #endif
+    for(bd = 0; bd < MIDI_NUM_BD; bd++)
+    {
+        usb_arm_endpoint(&g_usb_bd_table[MIDI_BD_OUT_FIRST + (m_out_ppb ^ bd)], &g_usb_ep_stat[MIDI_EP][OUT], MIDI_EP_SIZE);
+        MIDI_EP_OUT_DATA_TOGGLE_VAL ^= 1; // The other BD may be filled before this one is unpacked.
+    }
+}
+
+static void parser_send(uint8_t cable, uint8_t cin, const uint8_t* data, uint8_t count)
+{
+    midi_event_t event;
+    uint8_t i;
+    
+    event.array[0] = (uint8_t)((cable << 4) | cin);
+    for(i = 0; i < 3; i++) event.MIDI[i] = i < count ? data[i] : 0;
+    midi_send_event(&event);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+bool midi_send_event(const midi_event_t* p_event)
+{
+    if(usb_get_state() != STATE_CONFIGURED) return false;
+    if((uint8_t)(m_in_head - m_in_tail) == MIDI_IN_FIFO_SIZE) return false;
+    
+    m_in_fifo[m_in_head & IN_FIFO_MASK] = *p_event;
+    m_in_head++;
+    
+    // A full packet doesn't wait for SOF.
+    if(((uint8_t)(m_in_head - m_in_tail) >= MIDI_EVENTS_PER_PACKET) && (m_in_pending < MIDI_NUM_BD))
+    {
+        USB_INTERRUPT_ENABLE = 0;
+        flush_in(false);
+        USB_INTERRUPT_ENABLE = 1;
+    }
+    return true;
+}
+
+bool midi_send(uint8_t cable, uint8_t status, uint8_t data1, uint8_t data2)
+{
+    midi_event_t event;
+    
+    if(status < 0x80 || status > 0xEF) return false;
+    
+    event.array[0] = (uint8_t)((cable << 4) | (status >> 4));
+    event.MIDI[0]  = status;
+    event.MIDI[1]  = data1;
+    event.MIDI[2]  = m_cin_sizes[status >> 4] == 3 ? data2 : 0;
+    return midi_send_event(&event);
+}
+
+void midi_parse_byte(uint8_t cable, uint8_t byte)
+{
+    midi_parser_t* p_parser = &m_parsers[cable];
+    
+    if(byte >= 0xF8) // Real-Time, doesn't touch running status.
+    {
+        parser_send(cable, MIDI_CIN_SINGLE_BYTE, &byte, 1);
+        return;
+    }
+    
+    if(byte & 0x80)
+    {
+        if(byte == 0xF7)
+        {
+            if(p_parser->Status == 0xF0)
+            {
+                p_parser->Data[p_parser->Count++] = byte;
+                parser_send(cable, MIDI_CIN_SYSEX_END_1 + p_parser->Count - 1, p_parser->Data, p_parser->Count);
+            }
+            p_parser->Status = 0;
+            return;
+        }
+        
+        // Any other status byte starts a message, an unfinished one is dropped.
+        p_parser->Status  = byte;
+        p_parser->Data[0] = byte;
+        p_parser->Count   = 1;
+        if(byte == 0xF0) p_parser->Needed = 0;
+        else if(byte == 0xF1 || byte == 0xF3) p_parser->Needed = 1;
+        else if(byte == 0xF2) p_parser->Needed = 2;
+        else if(byte == 0xF6)
+        {
+            parser_send(cable, MIDI_CIN_SYSEX_END_1, &byte, 1); // Tune Request
+            p_parser->Status = 0;
+        }
+        else if(byte >= 0xF0) p_parser->Status = 0; // Undefined
+        else if((byte & 0xE0) == 0xC0) p_parser->Needed = 1; // Program Change, Channel Pressure
+        else p_parser->Needed = 2;
+        return;
+    }
+    
+    if(p_parser->Status == 0) return; // No running status to follow.
+    
+    if(p_parser->Status == 0xF0)
+    {
+        p_parser->Data[p_parser->Count++] = byte;
+        if(p_parser->Count == 3)
+        {
+            parser_send(cable, MIDI_CIN_SYSEX, p_parser->Data, 3);
+            p_parser->Count = 0;
+        }
+        return;
+    }
+    
+    p_parser->Data[p_parser->Count++] = byte;
+    if(p_parser->Count <= p_parser->Needed) return;
+    
+    if(p_parser->Status >= 0xF0) // System Common ends running status.
+    {
+        parser_send(cable, p_parser->Needed == 1 ? MIDI_CIN_SYSCOM_2 : MIDI_CIN_SYSCOM_3, p_parser->Data, p_parser->Count);
+        p_parser->Status = 0;
+    }
+    else
+    {
+        parser_send(cable, p_parser->Status >> 4, p_parser->Data, p_parser->Count);
+        p_parser->Count = 1; // Data[0] keeps the status for the next message.
+    }
+}
+
+void midi_flush_tasks(void)
+{
+    if(usb_get_state() != STATE_CONFIGURED) return;
+    
+    USB_INTERRUPT_ENABLE = 0;
+    flush_in(true);
+    USB_INTERRUPT_ENABLE = 1;
+}
+
+bool midi_receive_event(midi_event_t* p_event)
+{
+    if(m_out_head == m_out_tail) return false;
+    
+    *p_event = m_out_fifo[m_out_tail & OUT_FIFO_MASK];
+    m_out_tail++;
+    
+    if(m_out_full) // A held packet can be unpacked now.
+    {
+        USB_INTERRUPT_ENABLE = 0;
+        unpack_out();
+        USB_INTERRUPT_ENABLE = 1;
+    }
+    return true;
+}
+
+uint8_t midi_event_size(const midi_event_t* p_event)
+{
+    return m_cin_sizes[p_event->CIN];
+}
+
+/* ************************************************************************** */
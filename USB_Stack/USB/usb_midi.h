@@ -0,0 +1,426 @@
+/**
+ * @file usb_midi.h
+ * @brief <i>USB-MIDI</i> streaming function definitions, structures, and functions.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MIDI Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_MIDI_H
+#define USB_MIDI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_config.h"
+#include "usb_hal.h"
+#include "usb_midi_config.h"
+
+/* ************************************************************************** */
+/* ************************** PIC16 WARNING ********************************* */
+/* ************************************************************************** */
+
+#ifdef _PIC14E
+#warning "MIDI EP Buffer addresses have been manually set for PIC16 devices."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** SETTING CHECKS ****************************** */
+/* ************************************************************************** */
+
+#if MIDI_NUM_CABLES < 1 || MIDI_NUM_CABLES > 16
+#error "MIDI_NUM_CABLES must be 1 to 16."
+#endif
+
+#if (MIDI_IN_FIFO_SIZE & (MIDI_IN_FIFO_SIZE - 1)) || MIDI_IN_FIFO_SIZE > 128
+#error "MIDI_IN_FIFO_SIZE must be a power of 2 up to 128."
+#endif
+
+#if (MIDI_OUT_FIFO_SIZE & (MIDI_OUT_FIFO_SIZE - 1)) || MIDI_OUT_FIFO_SIZE > 128
+#error "MIDI_OUT_FIFO_SIZE must be a power of 2 up to 128."
+#endif
+
+#define MIDI_EVENTS_PER_PACKET (MIDI_EP_SIZE / 4)
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** MIDI EP ADDRESSES **************************** */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_1_15
+#define MIDI_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*2))
+#elif PINGPONG_MODE == PINGPONG_0_OUT
+#define MIDI_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*3))
+#else
+#define MIDI_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*4))
+#endif
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+#ifdef _PIC14E
+#define MIDI_EP_OUT_BUFFER_BASE_ADDR 0x2050
+#define MIDI_EP_IN_BUFFER_BASE_ADDR  0x20A0
+#else
+#define MIDI_EP_OUT_BUFFER_BASE_ADDR  MIDI_EP_BUFFERS_STARTING_ADDR
+#define MIDI_EP_IN_BUFFER_BASE_ADDR  (MIDI_EP_BUFFERS_STARTING_ADDR + MIDI_EP_SIZE)
+#endif
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#ifdef _PIC14E
+#define MIDI_EP_OUT_EVEN_BUFFER_BASE_ADDR 0x2050
+#define MIDI_EP_OUT_ODD_BUFFER_BASE_ADDR  0x20A0
+#define MIDI_EP_IN_EVEN_BUFFER_BASE_ADDR  0x20F0
+#define MIDI_EP_IN_ODD_BUFFER_BASE_ADDR   0x2140
+#else
+#define MIDI_EP_OUT_EVEN_BUFFER_BASE_ADDR  MIDI_EP_BUFFERS_STARTING_ADDR
+#define MIDI_EP_OUT_ODD_BUFFER_BASE_ADDR  (MIDI_EP_BUFFERS_STARTING_ADDR +  MIDI_EP_SIZE)
+#define MIDI_EP_IN_EVEN_BUFFER_BASE_ADDR  (MIDI_EP_BUFFERS_STARTING_ADDR + (MIDI_EP_SIZE * 2))
+#define MIDI_EP_IN_ODD_BUFFER_BASE_ADDR   (MIDI_EP_BUFFERS_STARTING_ADDR + (MIDI_EP_SIZE * 3))
+#endif
+#endif
+
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define MIDI_NUM_BD 2 // A packet can be armed while the other is in flight.
+#else
+#define MIDI_NUM_BD 1
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** MIDI EP STAT ******************************** */
+/* ************************************************************************** */
+
+#define MIDI_EP_OUT_LAST_PPB        g_usb_ep_stat[MIDI_EP][OUT].Last_PPB
+#define MIDI_EP_IN_LAST_PPB         g_usb_ep_stat[MIDI_EP][IN].Last_PPB
+#define MIDI_EP_OUT_DATA_TOGGLE_VAL g_usb_ep_stat[MIDI_EP][OUT].Data_Toggle_Val
+#define MIDI_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[MIDI_EP][IN].Data_Toggle_Val
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** MIDI CLASS CODES ***************************** */
+/* ************************************************************************** */
+
+// Audio Interface Subclass Codes
+#define MIDI_SUBCLASS_AUDIOCONTROL  0x01
+#define MIDI_SUBCLASS_MIDISTREAMING 0x03
+
+// Class-Specific Descriptor Types
+#define MIDI_CS_INTERFACE 0x24
+#define MIDI_CS_ENDPOINT  0x25
+
+// AudioControl Interface Descriptor Subtype
+#define MIDI_AC_HEADER 0x01
+
+// MIDIStreaming Interface Descriptor Subtypes
+#define MIDI_MS_HEADER     0x01
+#define MIDI_MIDI_IN_JACK  0x02
+#define MIDI_MIDI_OUT_JACK 0x03
+
+// MIDIStreaming Endpoint Descriptor Subtype
+#define MIDI_MS_GENERAL 0x01
+
+// Jack Types
+#define MIDI_JACK_EMBEDDED 0x01
+#define MIDI_JACK_EXTERNAL 0x02
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************* CODE INDEX NUMBERS ***************************** */
+/* ************************************************************************** */
+
+#define MIDI_CIN_MISC         0x0
+#define MIDI_CIN_CABLE_EVENT  0x1
+#define MIDI_CIN_SYSCOM_2     0x2 // Two byte System Common message.
+#define MIDI_CIN_SYSCOM_3     0x3 // Three byte System Common message.
+#define MIDI_CIN_SYSEX        0x4 // SysEx starts or continues.
+#define MIDI_CIN_SYSEX_END_1  0x5 // SysEx ends with one byte, or a one byte System Common message.
+#define MIDI_CIN_SYSEX_END_2  0x6
+#define MIDI_CIN_SYSEX_END_3  0x7
+#define MIDI_CIN_NOTE_OFF     0x8
+#define MIDI_CIN_NOTE_ON      0x9
+#define MIDI_CIN_POLY_KEY     0xA
+#define MIDI_CIN_CONTROL      0xB
+#define MIDI_CIN_PROGRAM      0xC
+#define MIDI_CIN_CHANNEL_PRES 0xD
+#define MIDI_CIN_PITCH_BEND   0xE
+#define MIDI_CIN_SINGLE_BYTE  0xF
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TYPES ********************************** */
+/* ************************************************************************** */
+
+/// USB-MIDI Event Packet
+typedef union
+{
+    uint8_t array[4];
+    struct
+    {
+        unsigned CIN   :4;
+        unsigned Cable :4;
+        uint8_t  MIDI[3];
+    };
+}midi_event_t;
+
+// Class-Specific AC Interface Header Descriptor (one streaming interface)
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint16_t bcdADC;
+    uint16_t wTotalLength;
+    uint8_t  bInCollection;
+    uint8_t  baInterfaceNr;
+}midi_ac_header_descriptor_t;
+
+// Class-Specific MS Interface Header Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint16_t bcdMSC;
+    uint16_t wTotalLength;
+}midi_ms_header_descriptor_t;
+
+// MIDI IN Jack Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bJackType;
+    uint8_t  bJackID;
+    uint8_t  iJack;
+}midi_in_jack_descriptor_t;
+
+// MIDI OUT Jack Descriptor (one input pin)
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bJackType;
+    uint8_t  bJackID;
+    uint8_t  bNrInputPins;
+    uint8_t  baSourceID;
+    uint8_t  baSourcePin;
+    uint8_t  iJack;
+}midi_out_jack_descriptor_t;
+
+// Standard MS Bulk Endpoint Descriptor
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bEndpointAddress;
+    uint8_t  bmAttributes;
+    uint16_t wMaxPacketSize;
+    uint8_t  bInterval;
+    uint8_t  bRefresh;
+    uint8_t  bSynchAddress;
+}midi_endpoint_descriptor_t;
+
+// Class-Specific MS Bulk Endpoint Descriptor (one embedded jack per cable)
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint8_t  bDescriptorSubtype;
+    uint8_t  bNumEmbMIDIJack;
+    uint8_t  baAssocJackID[MIDI_NUM_CABLES];
+}midi_cs_endpoint_descriptor_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************* VARS FROM: usb_midi.c ************************** */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+extern uint8_t g_midi_ep_out[MIDI_EP_SIZE] __at(MIDI_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_midi_ep_in[MIDI_EP_SIZE]  __at(MIDI_EP_IN_BUFFER_BASE_ADDR);
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+extern uint8_t g_midi_ep_out_even[MIDI_EP_SIZE] __at(MIDI_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_midi_ep_out_odd[MIDI_EP_SIZE]  __at(MIDI_EP_OUT_ODD_BUFFER_BASE_ADDR);
+extern uint8_t g_midi_ep_in_even[MIDI_EP_SIZE]  __at(MIDI_EP_IN_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_midi_ep_in_odd[MIDI_EP_SIZE]   __at(MIDI_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** MIDI FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn void midi_init(void)
+ * 
+ * @brief Used to initialize the EP used by the MIDI library.
+ * 
+ * Queued events are dropped.
+ */
+void midi_init(void);
+
+/**
+ * @fn void midi_tasks(void)
+ * 
+ * @brief Services the MIDI bulk EP.
+ * 
+ * Transactions on other EPs are ignored.
+ */
+void midi_tasks(void);
+
+/**
+ * @fn void midi_sof(void)
+ * 
+ * @brief Sends a partly filled IN packet once it has waited MIDI_IN_FLUSH_FRAMES.
+ * 
+ * Called from usb_sof().
+ */
+void midi_sof(void);
+
+/**
+ * @fn void midi_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
+ * 
+ * @brief Clear Endpoints used by the MIDI library.
+ * 
+ * @param[in] bdt_index Buffer Descriptor Index.
+ * @param[in] ep Endpoint number.
+ * @param[in] dir Endpoint direction.
+ * 
+ * Received events not yet unpacked, and IN packets that were armed, are dropped.
+ */
+void midi_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir);
+
+/**
+ * @fn void midi_clear_ep_toggle(void)
+ * 
+ * @brief Used to clear the MIDI EP's Data Toggle values.
+ */
+void midi_clear_ep_toggle(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool midi_send_event(const midi_event_t* p_event)
+ * 
+ * @brief Queues an event packet for the host.
+ * 
+ * Events are packed MIDI_EVENTS_PER_PACKET to a bulk packet. A full packet is
+ * armed straight away, a partly filled one on a later SOF. Lock-free against
+ * the USB ISR, only this side moves the FIFO's head.
+ * 
+ * @param[in] p_event Event packet.
+ * 
+ * @return Returns false if not configured or the FIFO is full.
+ */
+bool midi_send_event(const midi_event_t* p_event);
+
+/**
+ * @fn bool midi_send(uint8_t cable, uint8_t status, uint8_t data1, uint8_t data2)
+ * 
+ * @brief Queues a channel message for the host.
+ * 
+ * @param[in] cable Virtual cable number.
+ * @param[in] status Status byte (0x80 to 0xEF).
+ * @param[in] data1 First data byte.
+ * @param[in] data2 Second data byte (0 for Program Change and Channel Pressure).
+ * 
+ * @return Returns false if not configured or the FIFO is full.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * midi_send(0, 0xB0, 7, volume); // CC7 on channel 1.
+ * @endcode
+ * </li></ul>
+ */
+bool midi_send(uint8_t cable, uint8_t status, uint8_t data1, uint8_t data2);
+
+/**
+ * @fn void midi_parse_byte(uint8_t cable, uint8_t byte)
+ * 
+ * @brief Turns a MIDI byte stream, e.g. from a DIN MIDI IN UART, into event packets for the host.
+ * 
+ * Follows running status, so data bytes without a status byte repeat the last
+ * channel message. Real-Time bytes are sent as they arrive, even inside SysEx.
+ * 
+ * @param[in] cable Virtual cable the bytes came in on.
+ * @param[in] byte Received byte.
+ */
+void midi_parse_byte(uint8_t cable, uint8_t byte);
+
+/**
+ * @fn void midi_flush_tasks(void)
+ * 
+ * @brief Sends a partly filled IN packet, for builds without USE_SOF.
+ */
+void midi_flush_tasks(void);
+
+/**
+ * @fn bool midi_receive_event(midi_event_t* p_event)
+ * 
+ * @brief Takes the next event packet received from the host.
+ * 
+ * @param[out] p_event Event packet.
+ * 
+ * @return Returns false if there is none.
+ */
+bool midi_receive_event(midi_event_t* p_event);
+
+/**
+ * @fn uint8_t midi_event_size(const midi_event_t* p_event)
+ * 
+ * @brief Returns how many of the event's MIDI bytes are used, e.g. to forward it to a UART.
+ * 
+ * @param[in] p_event Event packet.
+ * 
+ * @return 0 to 3 bytes.
+ */
+uint8_t midi_event_size(const midi_event_t* p_event);
+
+/* ************************************************************************** */
+
+#endif /* USB_MIDI_H */
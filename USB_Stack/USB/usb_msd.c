@@ -66,6 +66,7 @@ uint8_t g_msd_ep_in_odd[MSD_EP_SIZE]   __at(MSD_EP_IN_ODD_BUFFER_BASE_ADDR);
 /****************************** SECTOR VARS ***********************************/
 /******************************************************************************/
 
+uint8_t  g_msd_lun;
 uint16_t g_msd_byte_of_sect;
 #ifndef MSD_LIMITED_RAM
 uint8_t g_msd_sect_data[512];
@@ -82,17 +83,16 @@ msd_cbw_t                 g_msd_cbw __at(CBW_DATA_ADDR);
 msd_csw_t                 g_msd_csw __at(CBW_DATA_ADDR);
 msd_rw_10_vars_t          g_msd_rw_10_vars;
 msd_bytes_to_transfer_t   g_msd_bytes_to_transfer;
-uint8_t                   g_msd_sense_key;
-uint8_t                   g_msd_additional_sense_code;
-uint8_t                   g_msd_additional_sense_code_qualifier;
 
 
 #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
 scsi_read_capacity_10_t g_msd_read_capacity_10;
-scsi_mode_sense_t       g_msd_mode_sense;
 #else
 scsi_read_capacity_10_t g_msd_read_capacity_10 __at(MSD_EP_IN_BUFFER_BASE_ADDR);
-scsi_mode_sense_t       g_msd_mode_sense       __at(MSD_EP_IN_BUFFER_BASE_ADDR);
+#endif
+
+#ifdef USE_MSD_STATS
+msd_stats_t g_msd_stats;
 #endif
 
 /******************************************************************************/
@@ -105,19 +105,42 @@ scsi_mode_sense_t       g_msd_mode_sense       __at(MSD_EP_IN_BUFFER_BASE_ADDR);
 static scsi_request_sense_cmd_t    m_request_sense_cmd    __at(CBW_DATA_ADDR + 15);
 static scsi_inquiry_cmd_t          m_inquiry_cmd          __at(CBW_DATA_ADDR + 15);
 static scsi_mode_sense_6_cmd_t     m_mode_sense_6_cmd     __at(CBW_DATA_ADDR + 15);
+static scsi_mode_sense_10_cmd_t    m_mode_sense_10_cmd    __at(CBW_DATA_ADDR + 15);
 static scsi_read_capacity_10_cmd_t m_read_capacity_10_cmd __at(CBW_DATA_ADDR + 15);
 static scsi_read_10_cmd_t          m_read_10_cmd          __at(CBW_DATA_ADDR + 15);
+static scsi_read_16_cmd_t          m_read_16_cmd          __at(CBW_DATA_ADDR + 15);
+static scsi_read_capacity_16_cmd_t m_read_capacity_16_cmd __at(CBW_DATA_ADDR + 15);
 static scsi_write_10_cmd_t         m_write_10_cmd         __at(CBW_DATA_ADDR + 15);
 static scsi_mode_select_6_cmd_t    m_mode_select_6_cmd    __at(CBW_DATA_ADDR + 15);
 static scsi_pamr_cmd_t             m_pamr_cmd             __at(CBW_DATA_ADDR + 15);
+static scsi_read_format_capacities_cmd_t m_read_format_capacities_cmd __at(CBW_DATA_ADDR + 15);
+
+/** Logical Unit State */
+typedef struct
+{
+    uint8_t Sense_Key;
+    uint8_t Additional_Sense_Code;
+    uint8_t Additional_Sense_Code_Qualifier;
+    bool    Media_Present;
+    bool    Unit_Attention;
+}lun_state_t;
+
+static uint32_t m_lun_blocks[MSD_NUM_LUNS]     = {MSD_LUN_BLOCKS};     // Changed by msd_set_capacity().
+static uint16_t m_lun_block_size[MSD_NUM_LUNS] = {MSD_LUN_BLOCK_SIZE};
+static const uint8_t  m_max_lun = MSD_NUM_LUNS - 1;
+
+volatile static lun_state_t m_lun_state[MSD_NUM_LUNS];
+static uint16_t m_block_size; // Bytes per block of the LUN being read or written.
+static uint8_t* m_in_ep;      // IN EP buffer for the current command's data.
 
 volatile static uint8_t m_msd_state;
 volatile static bool    m_end_data_short;
 volatile static bool    m_wait_for_bomsr;
 volatile static bool    m_clear_halt_event;
-
-volatile static bool    m_media_present;
-volatile static bool    m_unit_attention;
+volatile static bool    m_cbw_armed; // An OUT buffer is armed for the next CBW ahead of the CSW.
+#ifdef USE_WRITE_CACHE
+volatile static bool    m_sync_pending; // SYNCHRONIZE_CACHE_10's CSW waits on msd_media_busy().
+#endif
 
 volatile static uint8_t m_task_cnt;
 volatile static uint8_t m_task_put_index;
@@ -132,6 +155,81 @@ volatile static union
 /******************************************************************************/
 
 
+/******************************************************************************/
+/*************************** UF2 VIRTUAL VOLUME *******************************/
+/******************************************************************************/
+
+#ifdef USE_UF2
+static uint32_t m_uf2_target;      // Flash address of the current UF2 block's payload.
+static uint16_t m_uf2_payload_end; // Block offset the payload ends at, 0 if not a UF2 block.
+static bool     m_uf2_last;        // Current block is the last of the file.
+
+#define UF2_INFO_SIZE (sizeof(UF2_INFO_TEXT) - 1) // Must fit one block.
+
+static const uint8_t m_uf2_boot_sector[62] =
+{
+    0xEB, 0x3C, 0x90,                                       // jmpBoot
+    'M', 'S', 'D', 'O', 'S', '5', '.', '0',                 // OEMName
+    (uint8_t)BYTES_PER_BLOCK_LE, (uint8_t)(BYTES_PER_BLOCK_LE >> 8),
+    1,                                                      // SecPerClus
+    UF2_FAT_LBA, 0,                                         // RsvdSecCnt
+    1,                                                      // NumFATs
+    (uint8_t)(BYTES_PER_BLOCK_LE / 32), (uint8_t)((BYTES_PER_BLOCK_LE / 32) >> 8), // RootEntCnt
+    (uint8_t)VOL_CAPACITY_IN_BLOCKS, (uint8_t)(VOL_CAPACITY_IN_BLOCKS >> 8),      // TotSec16
+    0xF8,                                                   // Media
+    (uint8_t)UF2_FAT_SECTORS, (uint8_t)(UF2_FAT_SECTORS >> 8),
+    1, 0,                                                   // SecPerTrk
+    1, 0,                                                   // NumHeads
+    0, 0, 0, 0,                                             // HiddSec
+    0, 0, 0, 0,                                             // TotSec32
+    0x80, 0, 0x29,                                          // DrvNum, Reserved1, BootSig
+    0x55, 0x46, 0x32, 0x00,                                 // VolID
+    'U', 'F', '2', ' ', 'B', 'O', 'O', 'T', ' ', ' ', ' ',  // VolLab
+    'F', 'A', 'T', '1', '2', ' ', ' ', ' '                  // FilSysType
+};
+
+// Clusters 0 and 1, then the INFO file's single cluster (end of chain).
+static const uint8_t m_uf2_fat[6] = {0xF8, 0xFF, 0xFF, 0xFF, 0x0F, 0x00};
+
+static const uint8_t m_uf2_root[64] =
+{
+    'U', 'F', '2', ' ', 'B', 'O', 'O', 'T', ' ', ' ', ' ', 0x08, // Volume label
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    'I', 'N', 'F', 'O', '_', 'U', 'F', '2', 'T', 'X', 'T', 0x01, // Read-only file
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0x52, 0x5D,                                                   // WrtDate
+    2, 0,                                                         // FstClusLO
+    (uint8_t)UF2_INFO_SIZE, (uint8_t)(UF2_INFO_SIZE >> 8), 0, 0   // FileSize
+};
+
+static const char m_uf2_info[] = UF2_INFO_TEXT;
+#endif
+
+/******************************************************************************/
+
+
+/******************************************************************************/
+/******************************** STATISTICS **********************************/
+/******************************************************************************/
+
+#ifdef USE_MSD_STATS
+#define STATS_TICKS(since)  ((uint16_t)((MSD_STATS_TIME() - (since)) & MSD_STATS_TIME_MASK))
+#define STATS_RETRY_BYTES   10 // CDB bytes compared to spot a retry, all of a 10 byte CDB.
+
+static uint16_t m_stats_cbw;        // Time the current command's CBW was taken.
+static uint16_t m_stats_first;      // Time of its first data packet.
+static uint16_t m_stats_last;       // Time of its latest data packet.
+static bool     m_stats_data;       // It has had a data packet.
+static uint8_t  m_stats_row;        // Its row of g_msd_stats.Cmd.
+static uint16_t m_stats_busy_start; // Time msd_media_busy() started holding off MSD.
+static bool     m_stats_busy;
+static bool     m_stats_failed;     // m_stats_failed_cdb holds the last failed command.
+static uint8_t  m_stats_failed_cdb[STATS_RETRY_BYTES];
+#endif
+
+/******************************************************************************/
+
+
 /******************************************************************************/
 /****************** INQUIRY RESPONSE FROM: usb_scsi_inq.c *********************/
 /******************************************************************************/
@@ -163,6 +261,17 @@ static void service_cbw(void);
  */
 static void setup_cbw(void);
 
+/**
+ * @fn void arm_cbw(void)
+ * 
+ * @brief Arms MSD's OUT Endpoint for the next CBW.
+ * 
+ * Called as soon as the host won't send anything else before the next CBW, so 
+ * the CBW can land while the data and CSW are still being sent. setup_cbw() 
+ * then leaves the buffer alone, as the CBW may already be in it.
+ */
+static void arm_cbw(void);
+
 /**
  * @fn void setup_csw(void)
  * 
@@ -172,6 +281,102 @@ static void setup_cbw(void);
  */
 static void setup_csw(void);
 
+/**
+ * @fn void cmd_read_write(void)
+ * 
+ * @brief Starts READ_10, READ_16, WRITE_10 and WRITE_16 SCSI Commands.
+ * 
+ * The data stage is continued by service_read10() and service_write10().
+ */
+static void cmd_read_write(void);
+
+/**
+ * @fn void cmd_test_unit_ready(void)
+ * 
+ * @brief Services the TEST_UNIT_READY SCSI Command.
+ */
+static void cmd_test_unit_ready(void);
+
+/**
+ * @fn void cmd_request_sense(void)
+ * 
+ * @brief Services the REQUEST_SENSE SCSI Command.
+ */
+static void cmd_request_sense(void);
+
+/**
+ * @fn void cmd_inquiry(void)
+ * 
+ * @brief Services the INQUIRY SCSI Command.
+ */
+static void cmd_inquiry(void);
+
+/**
+ * @fn void cmd_mode_sense(void)
+ * 
+ * @brief Services the MODE_SENSE_6 and MODE_SENSE_10 SCSI Commands.
+ */
+static void cmd_mode_sense(void);
+
+/**
+ * @fn void cmd_read_capacity(void)
+ * 
+ * @brief Services the READ_CAPACITY SCSI Command.
+ */
+static void cmd_read_capacity(void);
+
+/**
+ * @fn void cmd_service_action_in(void)
+ * 
+ * @brief Services the SERVICE_ACTION_IN_16 SCSI Command (READ_CAPACITY_16).
+ */
+static void cmd_service_action_in(void);
+
+/**
+ * @fn void cmd_read_format_capacities(void)
+ * 
+ * @brief Services the READ_FORMAT_CAPACITIES UFI Command.
+ * 
+ * Windows sends this first when a drive is attached, answering it avoids a 
+ * STALL, CSW and REQUEST_SENSE before the volume is mounted.
+ */
+static void cmd_read_format_capacities(void);
+
+/**
+ * @fn void cmd_prevent_allow(void)
+ * 
+ * @brief Services the PREVENT_ALLOW_MEDIUM_REMOVAL SCSI Command.
+ * 
+ * Allowing removal always passes, preventing it passes only when 
+ * USE_PREVENT_ALLOW_MEDIUM_REMOVAL is defined.
+ */
+static void cmd_prevent_allow(void);
+
+#ifdef USE_START_STOP_UNIT
+/**
+ * @fn void cmd_start_stop_unit(void)
+ * 
+ * @brief Services the START_STOP_UNIT SCSI Command.
+ */
+static void cmd_start_stop_unit(void);
+#endif
+
+/**
+ * @fn void cmd_no_data(void)
+ * 
+ * @brief Passes SCSI Commands with nothing to do (VERIFY_10, SYNCHRONIZE_CACHE_10).
+ */
+static void cmd_no_data(void);
+
+#ifdef USE_WRITE_CACHE
+/**
+ * @fn void cmd_sync_cache(void)
+ * 
+ * @brief Services the SYNCHRONIZE_CACHE_10 SCSI Command with msd_sync_cache().
+ */
+static void cmd_sync_cache(void);
+#endif
+
 /**
  * @fn void service_read10(void)
  * 
@@ -252,6 +457,78 @@ static void send_data_response(uint8_t device_bytes);
  */
 static void cause_bomsr(void);
 
+#ifdef USE_UF2
+/**
+ * @fn void uf2_rx_packet(void)
+ * 
+ * @brief Fills the IN EP buffer with a packet of the virtual UF2 volume.
+ * 
+ * Only the boot sector, FAT, root directory and INFO_UF2.TXT hold data, 
+ * everything else reads as 0.
+ */
+static void uf2_rx_packet(void);
+
+/**
+ * @fn void uf2_tx_packet(void)
+ * 
+ * @brief Passes the payload in a received packet to msd_uf2_write().
+ * 
+ * A packet at the start of a 512 byte block is checked for a UF2 header. 
+ * Blocks without one (FAT, directory, other files) are dropped.
+ */
+static void uf2_tx_packet(void);
+#endif
+
+/**
+ * @fn void set_sense(uint8_t key, uint8_t asc, uint8_t ascq)
+ * 
+ * @brief Sets the sense values of the current LUN.
+ * 
+ * @param key Sense Key.
+ * @param asc Additional Sense Code.
+ * @param ascq Additional Sense Code Qualifier.
+ */
+static void set_sense(uint8_t key, uint8_t asc, uint8_t ascq);
+
+/**
+ * @fn void clear_unit_attention(void)
+ * 
+ * @brief Clears Unit Attention on every LUN.
+ */
+static void clear_unit_attention(void);
+
+/**
+ * @fn uint32_t get_be32(const uint8_t* p_src)
+ * 
+ * @brief Loads a big-endian value from a CDB.
+ * 
+ * @param p_src Where the 4 bytes are.
+ * @return The value.
+ */
+static uint32_t get_be32(const uint8_t* p_src);
+
+/**
+ * @fn void put_be32(uint8_t* p_dest, uint32_t val)
+ * 
+ * @brief Stores a value big-endian, as SCSI data is.
+ * 
+ * @param p_dest Where the 4 bytes go.
+ * @param val Value to store.
+ */
+static void put_be32(uint8_t* p_dest, uint32_t val);
+
+/**
+ * @fn void read_capacity_16_data(uint8_t* p_ep)
+ * 
+ * @brief Loads the 32 byte READ_CAPACITY_16 parameter data of the current LUN.
+ * 
+ * With USE_READ_CAPACITY, msd_read_capacity() supplies the capacity as it does 
+ * for READ_CAPACITY_10.
+ * 
+ * @param p_ep IN EP buffer.
+ */
+static void read_capacity_16_data(uint8_t* p_ep);
+
 /**
  * @fn void invalid_command_sense(void)
  * 
@@ -276,13 +553,130 @@ static void unit_attention_sense(void);
 /**
  * @fn bool check_for_media(void)
  * 
- * @brief Checks to see if media is present/available. Also sets 
- * m_unit_attention value to true when the media availability changes.
+ * @brief Checks to see if the current LUN's media is present/available. Also 
+ * sets its Unit_Attention value to true when the media availability changes.
  * 
  * @return Returns true when media is present.
  */
 static bool check_for_media(void);
 
+#ifdef USE_MSD_STATS
+/**
+ * @fn void rx_sector(void)
+ * 
+ * @brief Calls msd_rx_sector() and adds its time to g_msd_stats.
+ */
+static void rx_sector(void);
+
+/**
+ * @fn void tx_sector(void)
+ * 
+ * @brief Calls msd_tx_sector() and adds its time to g_msd_stats.
+ */
+static void tx_sector(void);
+
+/**
+ * @fn void stats_cbw(uint8_t index)
+ * 
+ * @brief Starts timing a command, and counts it as a retry if it repeats the 
+ * last failed one (REQUEST_SENSE in between is ignored).
+ * 
+ * @param index Entry of m_scsi_commands, SCSI_COMMANDS if unsupported.
+ */
+static void stats_cbw(uint8_t index);
+
+/**
+ * @fn void stats_data(void)
+ * 
+ * @brief Notes the time of a data packet of the current command.
+ */
+static void stats_data(void);
+
+/**
+ * @fn void stats_csw(void)
+ * 
+ * @brief Adds the finished command to its row once the CSW has been sent.
+ */
+static void stats_csw(void);
+
+/**
+ * @fn void stats_busy(bool busy)
+ * 
+ * @brief Sums the time msd_media_busy() holds off MSD.
+ * 
+ * @param busy What msd_media_busy() returned.
+ */
+static void stats_busy(bool busy);
+
+/**
+ * @fn void stats_add(uint16_t* p_count)
+ * 
+ * @brief Increments a counter, stopping at its maximum.
+ * 
+ * @param p_count Counter.
+ */
+static void stats_add(uint16_t* p_count);
+
+/**
+ * @fn uint8_t stats_bin(uint16_t ticks)
+ * 
+ * @brief Finds the histogram bin of a time, the number of bits it takes.
+ * 
+ * @param ticks Time.
+ * @return Bin, MSD_STATS_BINS - 1 at most.
+ */
+static uint8_t stats_bin(uint16_t ticks);
+#else
+#define rx_sector msd_rx_sector
+#define tx_sector msd_tx_sector
+#endif
+
+/******************************************************************************/
+
+
+/******************************************************************************/
+/***************************** SCSI COMMAND TABLE *****************************/
+/******************************************************************************/
+
+/** SCSI Command Handler */
+typedef struct
+{
+    uint8_t Opcode;
+    bool    Needs_Media; // Fails with MEDIUM NOT PRESENT first (USE_EXTERNAL_MEDIA).
+    void    (*Handler)(void);
+}scsi_command_t;
+
+// Searched in order, so the data commands come first.
+static const scsi_command_t m_scsi_commands[] =
+{
+    {READ_10,                      true,  cmd_read_write},
+    {WRITE_10,                     true,  cmd_read_write},
+    {TEST_UNIT_READY,              false, cmd_test_unit_ready},
+    {REQUEST_SENSE,                false, cmd_request_sense},
+    {READ_16,                      true,  cmd_read_write},
+    {WRITE_16,                     true,  cmd_read_write},
+    {INQUIRY,                      false, cmd_inquiry},
+    {READ_FORMAT_CAPACITIES,       false, cmd_read_format_capacities},
+    {READ_CAPACITY,                true,  cmd_read_capacity},
+    {SERVICE_ACTION_IN_16,         true,  cmd_service_action_in},
+    {MODE_SENSE_6,                 true,  cmd_mode_sense},
+    {MODE_SENSE_10,                true,  cmd_mode_sense},
+    {PREVENT_ALLOW_MEDIUM_REMOVAL, true,  cmd_prevent_allow},
+    #ifdef USE_WRITE_CACHE
+    {SYNCHRONIZE_CACHE_10,         true,  cmd_sync_cache},
+    #else
+    {SYNCHRONIZE_CACHE_10,         true,  cmd_no_data},
+    #endif
+    #ifdef USE_START_STOP_UNIT
+    {START_STOP_UNIT,              true,  cmd_start_stop_unit},
+    #endif
+    #ifdef USE_VERIFY_10
+    {VERIFY_10,                    true,  cmd_no_data},
+    #endif
+};
+
+#define SCSI_COMMANDS (sizeof(m_scsi_commands) / sizeof(m_scsi_commands[0]))
+
 /******************************************************************************/
 
 
@@ -316,6 +710,7 @@ void msd_arm_ep_in(uint8_t cnt)
 void msd_stall_ep_out(void)
 {
     g_usb_ep_stat[MSD_EP][OUT].Halt  = 1;
+    m_cbw_armed = false;
     
     #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
     usb_stall_ep(&g_usb_bd_table[MSD_BD_OUT_EVEN]);
@@ -340,27 +735,62 @@ void msd_stall_ep_in(void)
 
 bool msd_class_request(void)
 {   
+    #ifdef USE_MSD_STATS
+    if(g_usb_setup.bmRequestType_bits.Type == VENDOR && g_usb_setup.bRequest == MSD_STATS_REQUEST)
+    {
+        if(g_usb_setup.bmRequestType_bits.DataTransferDirection == DEVICE_TO_HOST)
+        {
+            usb_set_ram_ptr((uint8_t*)&g_msd_stats);
+            usb_setup_in_control_transfer(RAM, sizeof(msd_stats_t), g_usb_setup.wLength);
+            usb_in_control_transfer();
+            usb_set_control_stage(DATA_IN_STAGE);
+            return true;
+        }
+        if(g_usb_setup.wLength != 0) return false;
+        msd_stats_clear();
+        usb_arm_in_status();
+        usb_set_control_stage(STATUS_IN_STAGE);
+        return true;
+    }
+    #endif
+    
     if(g_usb_setup.bRequest == BOMSR) // Bulk Only Mass Storage Reset
     {
         if(g_usb_setup.wValue != 0 || g_usb_setup.wIndex != 0 || g_usb_setup.wLength != 0) return false;
+        #ifdef USE_MSD_STATS
+        stats_add(&g_msd_stats.BOMSRs);
+        #endif
         #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-        if(MSD_EP_OUT_LAST_PPB == ODD && g_usb_bd_table[MSD_BD_OUT_EVEN].STATbits.UOWN == 0) setup_cbw();
+        if(m_cbw_armed) setup_cbw(); // Only waits for the CBW.
+        else if(MSD_EP_OUT_LAST_PPB == ODD && g_usb_bd_table[MSD_BD_OUT_EVEN].STATbits.UOWN == 0) setup_cbw();
         else if (MSD_EP_OUT_LAST_PPB == EVEN && g_usb_bd_table[MSD_BD_OUT_ODD].STATbits.UOWN == 0) setup_cbw();
         #else
-        if(!g_usb_bd_table[MSD_BD_OUT].STATbits.UOWN) setup_cbw();
+        if(m_cbw_armed || !g_usb_bd_table[MSD_BD_OUT].STATbits.UOWN) setup_cbw();
         #endif
         m_task_cnt       = 0;
         m_task_put_index = 0;
         m_task_get_index = 0;
+        #ifdef USE_WRITE_CACHE
+        m_sync_pending   = false;
+        #endif
         
         m_wait_for_bomsr = false;
-        m_unit_attention = false;
+        clear_unit_attention();
         usb_arm_in_status();
         usb_set_control_stage(STATUS_IN_STAGE);
         return true;
     }
-
-    // Only supported class request is BOMSR, GET_MAX_LUN is not supported
+    
+    if(g_usb_setup.bRequest == GET_MAX_LUN)
+    {
+        if(g_usb_setup.wValue != 0 || g_usb_setup.wLength != 1) return false;
+        usb_set_rom_ptr(&m_max_lun);
+        usb_setup_in_control_transfer(ROM, 1, 1);
+        usb_in_control_transfer();
+        usb_set_control_stage(DATA_IN_STAGE);
+        return true;
+    }
+    
     return false;
 }
 
@@ -396,14 +826,22 @@ void msd_init(void)
     msd_clear_ep_toggle();
     
     m_wait_for_bomsr    = false;
-    m_unit_attention    = false;
     m_end_data_short    = false;
     m_clear_halt_event  = false;
+    m_cbw_armed         = false;
+    #ifdef USE_WRITE_CACHE
+    m_sync_pending      = false;
+    #endif
+    clear_unit_attention();
+    g_msd_lun = 0;
     
     m_task_cnt       = 0;
     m_task_put_index = 0;
     m_task_get_index = 0;
     
+    #ifdef USE_MSD_STATS
+    msd_stats_clear();
+    #endif
     setup_cbw();
 }
 
@@ -420,7 +858,26 @@ void msd_add_task(void)
 
 void msd_tasks(void)
 {
+    #ifdef USE_MEDIA_BUSY
+    #ifdef USE_MSD_STATS
+    if(msd_media_busy())
+    {
+        stats_busy(true);
+        return;
+    }
+    stats_busy(false);
+    #else
+    if(msd_media_busy()) return;
+    #endif
+    #endif
     USB_INTERRUPT_ENABLE = 0;
+    #ifdef USE_WRITE_CACHE
+    if(m_sync_pending) // msd_sync_cache()'s write back has finished.
+    {
+        m_sync_pending = false;
+        check_13_cases(0, Dn);
+    }
+    #endif
     if(m_task_cnt)
     {
         if(MSD_TRANSACTION_DIR == OUT)
@@ -429,6 +886,9 @@ void msd_tasks(void)
             #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
             MSD_EP_OUT_LAST_PPB = MSD_PINGPONG_PARITY;
             #endif
+            #ifdef USE_MSD_STATS
+            if(m_msd_state == MSD_WRITE_DATA) stats_data();
+            #endif
             switch(m_msd_state)
             {
                 #ifdef USE_WRITE_10
@@ -439,6 +899,9 @@ void msd_tasks(void)
                 case MSD_CBW:
                     service_cbw();
                     break;
+                default: // Not expected before the CSW, a pre-armed CBW buffer was used up.
+                    m_cbw_armed = false;
+                    break;
             }
         }
         else
@@ -447,6 +910,10 @@ void msd_tasks(void)
             #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
             MSD_EP_IN_LAST_PPB = MSD_PINGPONG_PARITY;
             #endif
+            #ifdef USE_MSD_STATS
+            if(m_msd_state == MSD_CSW) stats_csw();
+            else stats_data();
+            #endif
             switch(m_msd_state)
             {
                 case MSD_READ_DATA:
@@ -478,7 +945,7 @@ void msd_tasks(void)
     }
     else if(m_clear_halt_event)
     {
-        if(m_msd_state == MSD_WAIT_BOMSR) setup_cbw();
+        if(m_msd_state == MSD_WAIT_BOMSR || m_msd_state == MSD_CBW) setup_cbw(); // Waiting on a CBW after the toggle was reset.
         else if(m_msd_state == MSD_WAIT_CLEAR) setup_csw();
         m_clear_halt_event = false;
     }
@@ -491,6 +958,7 @@ void msd_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
     if(m_wait_for_bomsr) return;
 
     g_usb_ep_stat[ep][dir].Data_Toggle_Val = 0;
+    if(dir == OUT) m_cbw_armed = false; // Re-armed with the new toggle by setup_cbw().
     if(g_usb_ep_stat[ep][dir].Halt)
     {
         g_usb_ep_stat[ep][dir].Halt      = 0;
@@ -510,344 +978,469 @@ void msd_clear_ep_toggle(void)
 }
 
 
+bool msd_set_capacity(uint8_t lun, uint32_t blocks, uint16_t block_size)
+{
+    if(lun >= MSD_NUM_LUNS || block_size == 0 || (block_size % MSD_EP_SIZE)) return false;
+    #ifndef MSD_LIMITED_RAM
+    if(block_size > sizeof(g_msd_sect_data)) return false;
+    #endif
+    
+    m_lun_blocks[lun]     = blocks;
+    m_lun_block_size[lun] = block_size;
+    m_lun_state[lun].Unit_Attention = true;
+    return true;
+}
+
+
+#ifdef USE_MSD_STATS
+void msd_stats_clear(void)
+{
+    uint8_t i;
+    
+    usb_ram_set(0, (uint8_t*)&g_msd_stats, sizeof(msd_stats_t));
+    g_msd_stats.Version = MSD_STATS_VERSION;
+    g_msd_stats.Rows    = MSD_STATS_ROWS + 1;
+    g_msd_stats.Bins    = MSD_STATS_BINS;
+    g_msd_stats.Tick_Ns = MSD_STATS_TICK_NS;
+    for(i = 0; i < MSD_STATS_ROWS; i++)
+    {
+        g_msd_stats.Cmd[i].Opcode = i < SCSI_COMMANDS ? m_scsi_commands[i].Opcode : MSD_STATS_OTHER;
+    }
+    g_msd_stats.Cmd[MSD_STATS_ROWS].Opcode = MSD_STATS_OTHER;
+    m_stats_failed = false;
+}
+
+
+void msd_stats_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint8_t *p_stats = (uint8_t*)&g_msd_stats + (uint16_t)offset;
+    
+    while(bytes--) *p_buffer++ = *p_stats++; // Not atomic, counters may move on during a read.
+}
+#endif
+
+
 static void service_cbw(void)
 {
-    uint8_t  dev_expect;
+    const scsi_command_t *p_cmd;
 
     #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-    uint8_t *in_ep_addr;
-    
-    if(MSD_EP_IN_LAST_PPB == ODD) in_ep_addr = g_msd_ep_in_even;
-    else in_ep_addr = g_msd_ep_in_odd;
+    if(MSD_EP_IN_LAST_PPB == ODD) m_in_ep = g_msd_ep_in_even;
+    else m_in_ep = g_msd_ep_in_odd;
     
     if(MSD_EP_OUT_LAST_PPB == ODD) usb_ram_copy(g_msd_ep_out_odd, g_msd_cbw.BYTES, 31);
     else usb_ram_copy(g_msd_ep_out_even, g_msd_cbw.BYTES, 31);
     #else
+    m_in_ep = g_msd_ep_in;
     usb_ram_copy(g_msd_ep_out, g_msd_cbw.BYTES, 31);
     #endif
     
+    m_cbw_armed = false;
     if(!cbw_valid()) return;
+    g_msd_lun = g_msd_cbw.bCBWLUN;
     
-    switch(g_msd_cbw.CBWCB0[0])
+    // The CBW is copied out, if the host has no data to send the next CBW can be taken now.
+    if(g_msd_cbw.dCBWDataTransferLength == 0 || g_msd_cbw.Direction == IN) arm_cbw();
+    
+    for(p_cmd = m_scsi_commands; p_cmd < &m_scsi_commands[SCSI_COMMANDS]; p_cmd++)
     {
-        case WRITE_10:
-            #if defined(USE_WRITE_10) && defined(USE_WR_PROTECT)
-            if(msd_wr_protect())
-            {
-            #endif
-                #if !defined(USE_WRITE_10) || defined(USE_WR_PROTECT)
-                g_msd_sense_key                       = DATA_PROTECT;
-                g_msd_additional_sense_code           = ASC_WRITE_PROTECTED;
-                g_msd_additional_sense_code_qualifier = ASCQ_WRITE_PROTECTED;
-                fail_command();
-                return;
-                #endif
-            #if defined(USE_WRITE_10) && defined(USE_WR_PROTECT)
-            }
-            #endif
-        case READ_10:
-            #ifdef USE_WRITE_10
-            if(g_msd_cbw.CBWCB0[0] == READ_10) dev_expect = Di;	
-            else dev_expect = Do;	
-            #else	
-            dev_expect = Di;	
-            #endif
-            
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #endif
-            g_msd_rw_10_vars.TF_LEN_BYTES[0] = m_read_10_cmd.TF_LEN_BYTES[1];
-            g_msd_rw_10_vars.TF_LEN_BYTES[1] = m_read_10_cmd.TF_LEN_BYTES[0];
-            
-            if(g_msd_rw_10_vars.TF_LEN == 0)
-            {
-                check_13_cases(0, Dn);
-                return;
-            }
-            
-            g_msd_rw_10_vars.START_LBA_BYTES[0] = m_read_10_cmd.LBA_BYTES[3];
-            g_msd_rw_10_vars.START_LBA_BYTES[1] = m_read_10_cmd.LBA_BYTES[2];
-            g_msd_rw_10_vars.START_LBA_BYTES[2] = m_read_10_cmd.LBA_BYTES[1];
-            g_msd_rw_10_vars.START_LBA_BYTES[3] = m_read_10_cmd.LBA_BYTES[0];
-            g_msd_rw_10_vars.LBA = g_msd_rw_10_vars.START_LBA;
-            
-            if((g_msd_rw_10_vars.LBA + g_msd_rw_10_vars.TF_LEN) > VOL_CAPACITY_IN_BLOCKS)
-            {
-                g_msd_sense_key                       = ILLEGAL_REQUEST;
-                g_msd_additional_sense_code           = ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE;
-                g_msd_additional_sense_code_qualifier = ASCQ_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE;
-                fail_command();
-                return;
-            }
-            
-            g_msd_rw_10_vars.TF_LEN_IN_BYTES = ((uint32_t)g_msd_rw_10_vars.TF_LEN)*BYTES_PER_BLOCK_LE;
-            
-            if(!check_13_cases(g_msd_rw_10_vars.TF_LEN_IN_BYTES, dev_expect)) return;
-            
-            g_msd_byte_of_sect = 0;
-            
-            #ifdef USE_WRITE_10
-            if(dev_expect == Do)
-            {
-                #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-                msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + (MSD_EP_OUT_LAST_PPB ^ 1));
-                MSD_EP_OUT_DATA_TOGGLE_VAL ^= 1;
-                msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + MSD_EP_OUT_LAST_PPB);
-                #else
-                msd_arm_ep_out();
-                #endif
-                m_msd_state = MSD_WRITE_DATA;
-                return;
-            }
-            #endif
-            #ifdef MSD_LIMITED_RAM
-            #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-            MSD_EP_IN_LAST_PPB ^= 1;
-            service_read10();
-
-            MSD_EP_IN_DATA_TOGGLE_VAL ^= 1;
-            MSD_EP_IN_LAST_PPB ^= 1;
-            service_read10();
-            #else
-            service_read10();
-            #endif
-            #else
-            #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-            MSD_EP_IN_LAST_PPB ^= 1;
-            msd_rx_sector();
-            service_read10();
-
-            MSD_EP_IN_DATA_TOGGLE_VAL ^= 1;
-            MSD_EP_IN_LAST_PPB ^= 1;
-            service_read10();
-            #else
-            msd_rx_sector();
-            service_read10();
-            #endif
-            #endif
-            m_msd_state = MSD_READ_DATA;
-            break;
-            
-        case TEST_UNIT_READY:
-            #ifdef USE_EXTERNAL_MEDIA
-            m_media_present = check_for_media();
-            if(m_unit_attention)
-            {
-                m_unit_attention = false;
-                unit_attention_sense();
-                fail_command();
-                return;
-            }
-            
-            if(!m_media_present)
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #else
-            if(m_unit_attention)
-            {
-                m_unit_attention = false;
-                unit_attention_sense();
-                fail_command();
-                return;
-            }    
-            #endif
-            
-            #ifdef USE_TEST_UNIT_READY
-            if(check_13_cases(0, Dn) && msd_test_unit_ready()) fail_command();
-            #else
-            check_13_cases(0, Dn);
-            #endif
-            break;
-            
-            
-        #ifdef USE_PREVENT_ALLOW_MEDIUM_REMOVAL
-        case PREVENT_ALLOW_MEDIUM_REMOVAL:
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #endif
-            invalid_command_sense();
+        if(p_cmd->Opcode != g_msd_cbw.CBWCB0[0]) continue;
+        
+        #ifdef USE_MSD_STATS
+        stats_cbw((uint8_t)(p_cmd - m_scsi_commands));
+        #endif
+        #ifdef USE_EXTERNAL_MEDIA
+        if(p_cmd->Needs_Media && !check_for_media())
+        {
+            media_not_present_sense();
             fail_command();
-            break;
+            return;
+        }
         #endif
-            
-            
-        case REQUEST_SENSE:
-            g_msd_bytes_to_transfer.LB = m_request_sense_cmd.ALLOCATION_LENGTH;
-            g_msd_bytes_to_transfer.HB = 0;
-            if(g_msd_bytes_to_transfer.val)
-            {
-                if(g_msd_bytes_to_transfer.val > 18) g_msd_bytes_to_transfer.val = 18;
-                
-                #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-                usb_ram_set(0, in_ep_addr, g_msd_bytes_to_transfer.val);
-                
-                in_ep_addr[0] = CURRENT_FIXED; // RESPONSE_CODE
-                in_ep_addr[2] = g_msd_sense_key;
-                in_ep_addr[7] = 10; // ADDITIONAL_SENSE_LENGTH
-                in_ep_addr[12] = g_msd_additional_sense_code;
-                in_ep_addr[13] = g_msd_additional_sense_code_qualifier;
-                #else
-                usb_ram_set(0, g_msd_ep_in, g_msd_bytes_to_transfer.val);
-                
-                g_msd_ep_in[0] = CURRENT_FIXED; // RESPONSE_CODE
-                g_msd_ep_in[2] = g_msd_sense_key;
-                g_msd_ep_in[7] = 10; // ADDITIONAL_SENSE_LENGTH
-                g_msd_ep_in[12] = g_msd_additional_sense_code;
-                g_msd_ep_in[13] = g_msd_additional_sense_code_qualifier;
-                #endif
-                send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
-                return;
-            }
-            check_13_cases(0, Dn);
-            break;
-            
-            
-        case INQUIRY:
-            g_msd_bytes_to_transfer.LB = m_inquiry_cmd.ALLOCATION_LENGTH_BYTES[1];
-            g_msd_bytes_to_transfer.HB = m_inquiry_cmd.ALLOCATION_LENGTH_BYTES[0];
-            
-            if(g_msd_bytes_to_transfer.val)
-            {
-                if(g_msd_bytes_to_transfer.val > 36) g_msd_bytes_to_transfer.val = 36;
-                #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-                usb_rom_copy((const uint8_t*)&g_scsi_inquiry, in_ep_addr, (uint8_t)g_msd_bytes_to_transfer.val);
-                #else
-                usb_rom_copy((const uint8_t*)&g_scsi_inquiry, g_msd_ep_in, (uint8_t)g_msd_bytes_to_transfer.val);
-                #endif
-                send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
-                return;
-            } 
-            check_13_cases(0, Dn);
-            break;
-            
-            
-        case MODE_SENSE_6:
-            g_msd_bytes_to_transfer.LB = m_mode_sense_6_cmd.ALLOCATION_LENGTH;
-            g_msd_bytes_to_transfer.HB = 0;
-            
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #endif
-            
-            if(g_msd_bytes_to_transfer.val)
-            {
-                if(g_msd_bytes_to_transfer.val > 4) g_msd_bytes_to_transfer.val = 4;
-                g_msd_mode_sense.MODE_DATA_LENGTH          = 0x03;
-                g_msd_mode_sense.MEDIUM_TYPE               = 0x00;
-                g_msd_mode_sense.DEVICE_SPECIFIC_PARAMETER = 0x00; // 0x00 for R/W, 0x80 for R-only
-                g_msd_mode_sense.BLOCK_DESCRIPTOR_LENGTH   = 0x00;
-                #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-                usb_ram_copy((uint8_t*)&g_msd_mode_sense, in_ep_addr, (uint8_t)g_msd_bytes_to_transfer.val);
-                #endif
-                send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
-                return;
-            }
-            check_13_cases(0, Dn);
-            break;
-            
-        #ifdef USE_START_STOP_UNIT
-        case START_STOP_UNIT:
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #endif
-            if(check_13_cases(0, Dn) && msd_start_stop_unit())
-            {
-                fail_command();
-                return;
-            }
-            break;
+        p_cmd->Handler();
+        return;
+    }
+    #ifdef USE_MSD_STATS
+    stats_cbw(SCSI_COMMANDS);
+    #endif
+    invalid_command_sense();
+    fail_command();
+}
+
+
+static void cmd_read_write(void)
+{
+    uint8_t dev_expect = Di;
+    
+    if(g_msd_cbw.CBWCB0[0] == WRITE_10 || g_msd_cbw.CBWCB0[0] == WRITE_16)
+    {
+        #if defined(USE_WRITE_10) && defined(USE_WR_PROTECT)
+        if(msd_wr_protect())
         #endif
-            
-            
-        case READ_CAPACITY:
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
-            #endif
-            if((m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS != 0)&&(m_read_capacity_10_cmd.PMI == 0))
-            {
-                g_msd_sense_key                       = ILLEGAL_REQUEST;
-                g_msd_additional_sense_code           = ASC_INVALID_FIELD_IN_CBD;
-                g_msd_additional_sense_code_qualifier = ASCQ_INVALID_FIELD_IN_CBD;
-                fail_command();
-                return;
-            }
-            g_msd_rw_10_vars.START_LBA_BYTES[0] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[3];// Big-endian to little-endian
-            g_msd_rw_10_vars.START_LBA_BYTES[1] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[2];
-            g_msd_rw_10_vars.START_LBA_BYTES[2] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[1];
-            g_msd_rw_10_vars.START_LBA_BYTES[3] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[0];
+        #if !defined(USE_WRITE_10) || defined(USE_WR_PROTECT)
+        {
+            set_sense(DATA_PROTECT, ASC_WRITE_PROTECTED, ASCQ_WRITE_PROTECTED);
+            fail_command();
+            return;
+        }
+        #endif
+        #ifdef USE_WRITE_10
+        dev_expect = Do;
+        #endif
+    }
+    
+    if(g_msd_cbw.CBWCB0[0] & 0x80) // READ_16/WRITE_16
+    {
+        g_msd_rw_10_vars.TF_LEN = get_be32(m_read_16_cmd.TF_LEN_BYTES);
+    }
+    else
+    {
+        g_msd_rw_10_vars.TF_LEN_BYTES[0] = m_read_10_cmd.TF_LEN_BYTES[1];
+        g_msd_rw_10_vars.TF_LEN_BYTES[1] = m_read_10_cmd.TF_LEN_BYTES[0];
+        g_msd_rw_10_vars.TF_LEN_BYTES[2] = 0;
+        g_msd_rw_10_vars.TF_LEN_BYTES[3] = 0;
+    }
+    
+    if(g_msd_rw_10_vars.TF_LEN == 0)
+    {
+        check_13_cases(0, Dn);
+        return;
+    }
+    
+    if(g_msd_cbw.CBWCB0[0] & 0x80)
+    {
+        g_msd_rw_10_vars.START_LBA = get_be32(&m_read_16_cmd.LBA_BYTES[4]);
+        if(get_be32(m_read_16_cmd.LBA_BYTES)) g_msd_rw_10_vars.START_LBA = 0xFFFFFFFFUL; // Past any 32 bit capacity.
+    }
+    else g_msd_rw_10_vars.START_LBA = get_be32(m_read_10_cmd.LBA_BYTES);
+    g_msd_rw_10_vars.LBA = g_msd_rw_10_vars.START_LBA;
+    
+    if(g_msd_rw_10_vars.TF_LEN > m_lun_blocks[g_msd_lun] || 
+       g_msd_rw_10_vars.LBA > (m_lun_blocks[g_msd_lun] - g_msd_rw_10_vars.TF_LEN))
+    {
+        set_sense(ILLEGAL_REQUEST, ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE, ASCQ_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE);
+        fail_command();
+        return;
+    }
+    
+    m_block_size = m_lun_block_size[g_msd_lun];
+    if(g_msd_rw_10_vars.TF_LEN > (0xFFFFFFFFUL / m_block_size)) g_msd_rw_10_vars.TF_LEN_IN_BYTES = 0xFFFFFFFFUL; // More than any dCBWDataTransferLength.
+    else g_msd_rw_10_vars.TF_LEN_IN_BYTES = g_msd_rw_10_vars.TF_LEN * m_block_size;
+    
+    if(!check_13_cases(g_msd_rw_10_vars.TF_LEN_IN_BYTES, dev_expect)) return;
+    
+    g_msd_byte_of_sect = 0;
+    
+    #ifdef USE_WRITE_10
+    if(dev_expect == Do)
+    {
+        #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+        msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + (MSD_EP_OUT_LAST_PPB ^ 1));
+        MSD_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+        msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + MSD_EP_OUT_LAST_PPB);
+        #else
+        msd_arm_ep_out();
+        #endif
+        m_msd_state = MSD_WRITE_DATA;
+        return;
+    }
+    #endif
+    #ifdef MSD_LIMITED_RAM
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    MSD_EP_IN_LAST_PPB ^= 1;
+    service_read10();
 
-            g_msd_rw_10_vars.LBA = g_msd_rw_10_vars.START_LBA;
+    MSD_EP_IN_DATA_TOGGLE_VAL ^= 1;
+    MSD_EP_IN_LAST_PPB ^= 1;
+    service_read10();
+    #else
+    service_read10();
+    #endif
+    #else
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    MSD_EP_IN_LAST_PPB ^= 1;
+    rx_sector();
+    service_read10();
 
-            #ifdef USE_READ_CAPACITY
-            msd_read_capacity();
-            #else
+    MSD_EP_IN_DATA_TOGGLE_VAL ^= 1;
+    MSD_EP_IN_LAST_PPB ^= 1;
+    service_read10();
+    #else
+    rx_sector();
+    service_read10();
+    #endif
+    #endif
+    m_msd_state = MSD_READ_DATA;
+}
 
-            g_msd_read_capacity_10.RETURNED_LOGICAL_BLOCK_ADDRESS = g_msd_rw_10_vars.START_LBA > LAST_BLOCK_LE ? 0xFFFFFFFFUL : LAST_BLOCK_BE;
-            g_msd_read_capacity_10.BLOCK_LENGTH_IN_BYTES = BYTES_PER_BLOCK_BE;
-            #endif
-            #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
-            usb_ram_copy((uint8_t*)&g_msd_read_capacity_10, in_ep_addr, 8);
-            #endif
-            send_data_response(8);
-            break;
-            
-        #ifdef USE_VERIFY_10
-        case VERIFY_10:
-            #ifdef USE_EXTERNAL_MEDIA
-            if(!check_for_media())
-            {
-                media_not_present_sense();
-                fail_command();
-                return;
-            }
+
+static void cmd_test_unit_ready(void)
+{
+    #ifdef USE_EXTERNAL_MEDIA
+    check_for_media();
+    if(m_lun_state[g_msd_lun].Unit_Attention)
+    {
+        m_lun_state[g_msd_lun].Unit_Attention = false;
+        unit_attention_sense();
+        fail_command();
+        return;
+    }
+    
+    if(!m_lun_state[g_msd_lun].Media_Present)
+    {
+        media_not_present_sense();
+        fail_command();
+        return;
+    }
+    #else
+    if(m_lun_state[g_msd_lun].Unit_Attention)
+    {
+        m_lun_state[g_msd_lun].Unit_Attention = false;
+        unit_attention_sense();
+        fail_command();
+        return;
+    }    
+    #endif
+    
+    #ifdef USE_TEST_UNIT_READY
+    if(check_13_cases(0, Dn) && msd_test_unit_ready()) fail_command();
+    #else
+    check_13_cases(0, Dn);
+    #endif
+}
+
+
+static void cmd_request_sense(void)
+{
+    g_msd_bytes_to_transfer.LB = m_request_sense_cmd.ALLOCATION_LENGTH;
+    g_msd_bytes_to_transfer.HB = 0;
+    if(g_msd_bytes_to_transfer.val)
+    {
+        if(g_msd_bytes_to_transfer.val > 18) g_msd_bytes_to_transfer.val = 18;
+        usb_ram_set(0, m_in_ep, g_msd_bytes_to_transfer.val);
+        
+        m_in_ep[0] = CURRENT_FIXED; // RESPONSE_CODE
+        m_in_ep[2] = m_lun_state[g_msd_lun].Sense_Key;
+        m_in_ep[7] = 10; // ADDITIONAL_SENSE_LENGTH
+        m_in_ep[12] = m_lun_state[g_msd_lun].Additional_Sense_Code;
+        m_in_ep[13] = m_lun_state[g_msd_lun].Additional_Sense_Code_Qualifier;
+        send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
+        return;
+    }
+    check_13_cases(0, Dn);
+}
+
+
+static void cmd_inquiry(void)
+{
+    g_msd_bytes_to_transfer.LB = m_inquiry_cmd.ALLOCATION_LENGTH_BYTES[1];
+    g_msd_bytes_to_transfer.HB = m_inquiry_cmd.ALLOCATION_LENGTH_BYTES[0];
+    
+    if(g_msd_bytes_to_transfer.val)
+    {
+        if(g_msd_bytes_to_transfer.val > 36) g_msd_bytes_to_transfer.val = 36;
+        usb_rom_copy((const uint8_t*)&g_scsi_inquiry, m_in_ep, (uint8_t)g_msd_bytes_to_transfer.val);
+        send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
+        return;
+    } 
+    check_13_cases(0, Dn);
+}
+
+
+static void cmd_mode_sense(void)
+{
+    uint8_t header_len;
+    uint8_t data_len;
+    uint8_t device_specific;
+    
+    if(g_msd_cbw.CBWCB0[0] == MODE_SENSE_10)
+    {
+        g_msd_bytes_to_transfer.LB = m_mode_sense_10_cmd.ALLOCATION_LENGTH_BYTES[1];
+        g_msd_bytes_to_transfer.HB = m_mode_sense_10_cmd.ALLOCATION_LENGTH_BYTES[0];
+        header_len = 8;
+    }
+    else
+    {
+        g_msd_bytes_to_transfer.LB = m_mode_sense_6_cmd.ALLOCATION_LENGTH;
+        g_msd_bytes_to_transfer.HB = 0;
+        header_len = 4;
+    }
+    
+    if(g_msd_bytes_to_transfer.val)
+    {
+        #if !defined(USE_WRITE_10)
+        device_specific = 0x80; // 0x00 for R/W, 0x80 for R-only
+        #elif defined(USE_WR_PROTECT)
+        device_specific = msd_wr_protect() ? 0x80 : 0x00;
+        #else
+        device_specific = 0x00;
+        #endif
+        
+        // No block descriptors. The Caching page is the only page, it reports 
+        // write-through (write-back with USE_WRITE_CACHE) with nothing 
+        // changeable. Other pages return just the header rather than failing, 
+        // saving hosts a REQUEST_SENSE round trip while probing.
+        data_len = header_len;
+        usb_ram_set(0, m_in_ep, header_len + MODE_PAGE_CACHING_LEN);
+        if(m_mode_sense_6_cmd.PAGE_CODE == MODE_PAGE_CACHING || m_mode_sense_6_cmd.PAGE_CODE == MODE_PAGE_ALL)
+        {
+            m_in_ep[data_len]     = MODE_PAGE_CACHING;
+            m_in_ep[data_len + 1] = MODE_PAGE_CACHING_LEN - 2; // PAGE_LENGTH
+            #ifdef USE_WRITE_CACHE
+            if(m_mode_sense_6_cmd.PC != 1) m_in_ep[data_len + 2] = 0x04; // WCE, unless the changeable values (PC 1) were asked for.
             #endif
-            check_13_cases(0, Dn);
-            break;
+            data_len += MODE_PAGE_CACHING_LEN;
+        }
+        
+        if(header_len == 8)
+        {
+            m_in_ep[1] = data_len - 2; // MODE_DATA_LENGTH
+            m_in_ep[3] = device_specific;
+        }
+        else
+        {
+            m_in_ep[0] = data_len - 1; // MODE_DATA_LENGTH
+            m_in_ep[2] = device_specific;
+        }
+        
+        if(g_msd_bytes_to_transfer.val > data_len) g_msd_bytes_to_transfer.val = data_len;
+        send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
+        return;
+    }
+    check_13_cases(0, Dn);
+}
+
+
+static void cmd_read_capacity(void)
+{
+    if((m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS != 0)&&(m_read_capacity_10_cmd.PMI == 0))
+    {
+        set_sense(ILLEGAL_REQUEST, ASC_INVALID_FIELD_IN_CBD, ASCQ_INVALID_FIELD_IN_CBD);
+        fail_command();
+        return;
+    }
+    g_msd_rw_10_vars.START_LBA_BYTES[0] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[3];// Big-endian to little-endian
+    g_msd_rw_10_vars.START_LBA_BYTES[1] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[2];
+    g_msd_rw_10_vars.START_LBA_BYTES[2] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[1];
+    g_msd_rw_10_vars.START_LBA_BYTES[3] = m_read_capacity_10_cmd.LOGICAL_BLOCK_ADDRESS_BYTES[0];
+
+    g_msd_rw_10_vars.LBA = g_msd_rw_10_vars.START_LBA;
+
+    #ifdef USE_READ_CAPACITY
+    msd_read_capacity();
+    #else
+    if(g_msd_rw_10_vars.START_LBA >= m_lun_blocks[g_msd_lun])
+    {
+        put_be32((uint8_t*)&g_msd_read_capacity_10.RETURNED_LOGICAL_BLOCK_ADDRESS, 0xFFFFFFFFUL);
+    }
+    else put_be32((uint8_t*)&g_msd_read_capacity_10.RETURNED_LOGICAL_BLOCK_ADDRESS, m_lun_blocks[g_msd_lun] - 1);
+    put_be32((uint8_t*)&g_msd_read_capacity_10.BLOCK_LENGTH_IN_BYTES, m_lun_block_size[g_msd_lun]);
+    #endif
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    usb_ram_copy((uint8_t*)&g_msd_read_capacity_10, m_in_ep, 8);
+    #endif
+    send_data_response(8);
+}
+
+
+static void cmd_service_action_in(void)
+{
+    if(m_read_capacity_16_cmd.SERVICE_ACTION != SA_READ_CAPACITY_16)
+    {
+        invalid_command_sense();
+        fail_command();
+        return;
+    }
+    g_msd_bytes_to_transfer.val = get_be32(m_read_capacity_16_cmd.ALLOCATION_LENGTH_BYTES) > 32 ? 32 : 
+                                  m_read_capacity_16_cmd.ALLOCATION_LENGTH_BYTES[3];
+    if(g_msd_bytes_to_transfer.val)
+    {
+        read_capacity_16_data(m_in_ep);
+        send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
+        return;
+    }
+    check_13_cases(0, Dn);
+}
+
+
+static void cmd_read_format_capacities(void)
+{
+    g_msd_bytes_to_transfer.LB = m_read_format_capacities_cmd.ALLOCATION_LENGTH_BYTES[1];
+    g_msd_bytes_to_transfer.HB = m_read_format_capacities_cmd.ALLOCATION_LENGTH_BYTES[0];
+    
+    if(g_msd_bytes_to_transfer.val)
+    {
+        if(g_msd_bytes_to_transfer.val > 12) g_msd_bytes_to_transfer.val = 12;
+        
+        // Capacity List Header, then the Current/Maximum Capacity Descriptor.
+        usb_ram_set(0, m_in_ep, 12);
+        m_in_ep[3] = 8; // CAPACITY_LIST_LENGTH
+        put_be32(&m_in_ep[4], m_lun_blocks[g_msd_lun]);
+        m_in_ep[8] = FORMATTED_MEDIA;
+        #ifdef USE_EXTERNAL_MEDIA
+        if(!check_for_media()) m_in_ep[8] = NO_MEDIA_PRESENT;
         #endif
-        default:
-            invalid_command_sense();
-            fail_command();
-            break;
+        m_in_ep[10] = (uint8_t)(m_lun_block_size[g_msd_lun] >> 8);
+        m_in_ep[11] = (uint8_t)m_lun_block_size[g_msd_lun];
+        send_data_response((uint8_t)g_msd_bytes_to_transfer.val);
+        return;
     }
+    check_13_cases(0, Dn);
 }
 
 
+static void cmd_prevent_allow(void)
+{
+    #ifndef USE_PREVENT_ALLOW_MEDIUM_REMOVAL
+    if(m_pamr_cmd.PREVENT)
+    {
+        set_sense(ILLEGAL_REQUEST, ASC_INVALID_FIELD_IN_CBD, ASCQ_INVALID_FIELD_IN_CBD);
+        fail_command();
+        return;
+    }
+    #endif
+    check_13_cases(0, Dn);
+}
+
+
+#ifdef USE_START_STOP_UNIT
+static void cmd_start_stop_unit(void)
+{
+    if(check_13_cases(0, Dn) && msd_start_stop_unit()) fail_command();
+}
+#endif
+
+
+static void cmd_no_data(void)
+{
+    check_13_cases(0, Dn);
+}
+
+
+#ifdef USE_WRITE_CACHE
+static void cmd_sync_cache(void)
+{
+    msd_sync_cache();
+    m_sync_pending = true; // CSW is sent by msd_tasks() once msd_media_busy() is false.
+}
+#endif
+
+
 static void setup_cbw(void)
+{
+    if(!m_cbw_armed) arm_cbw();
+    m_msd_state = MSD_CBW;
+}
+
+
+static void arm_cbw(void)
 {
     #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
     msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + (MSD_EP_OUT_LAST_PPB ^ 1));
     #else
     msd_arm_ep_out();
     #endif
-    m_msd_state = MSD_CBW;
+    m_cbw_armed = true;
 }
 
 
@@ -938,6 +1531,9 @@ static bool check_13_cases(uint32_t device_bytes, uint8_t dev_expect)
     return true;
     
     phase_error:
+    #ifdef USE_MSD_STATS
+    stats_add(&g_msd_stats.Phase_Errors);
+    #endif
     cause_bomsr();
     g_msd_csw.bCSWStatus = PHASE_ERROR;
     return false;
@@ -953,9 +1549,13 @@ static bool cbw_valid(void)
     if(g_usb_bd_table[MSD_BD_OUT].CNT != 31) goto cbw_not_valid;
     #endif
     if(g_msd_cbw.dCBWSignature != CBW_SIG) goto cbw_not_valid;
+    if(g_msd_cbw.bCBWLUN >= MSD_NUM_LUNS) goto cbw_not_valid; // Not meaningful, GET_MAX_LUN gave the range.
     return true;
     
     cbw_not_valid:
+    #ifdef USE_MSD_STATS
+    stats_add(&g_msd_stats.Invalid_CBWs);
+    #endif
     m_wait_for_bomsr = true;
     cause_bomsr();
     m_msd_state = MSD_WAIT_BOMSR;
@@ -1026,18 +1626,20 @@ static void service_read10(void)
         bdt_index = MSD_BD_IN_EVEN;
     }
     
-    #ifdef MSD_LIMITED_RAM
-    msd_rx_sector();
+    #if defined(USE_UF2)
+    uf2_rx_packet();
+    #elif defined(MSD_LIMITED_RAM)
+    rx_sector();
     #else
     usb_ram_copy(g_msd_sect_data + g_msd_byte_of_sect, ep_address, MSD_EP_SIZE); // Load EP size worth of data from the g_msd_sect_data buffer.
     #endif
     
     g_msd_byte_of_sect += MSD_EP_SIZE;
-    if(g_msd_byte_of_sect == BYTES_PER_BLOCK_LE) // More than one sector is required. Last bytes of sector were sent, increment the address, and load new sector.
+    if(g_msd_byte_of_sect == m_block_size) // More than one sector is required. Last bytes of sector were sent, increment the address, and load new sector.
     {
         g_msd_rw_10_vars.LBA++;
         #ifndef MSD_LIMITED_RAM
-        msd_rx_sector();
+        rx_sector();
         #endif
         g_msd_byte_of_sect = 0;
     }
@@ -1055,18 +1657,20 @@ static void service_read10(void)
     return;
     
     #else
-    #ifdef MSD_LIMITED_RAM
-    msd_rx_sector();
+    #if defined(USE_UF2)
+    uf2_rx_packet();
+    #elif defined(MSD_LIMITED_RAM)
+    rx_sector();
     #else
     usb_ram_copy(g_msd_sect_data + g_msd_byte_of_sect, g_msd_ep_in, MSD_EP_SIZE); // Load EP size worth of data from the g_msd_sect_data buffer.
     #endif
 
     g_msd_byte_of_sect += MSD_EP_SIZE;
-    if(g_msd_byte_of_sect == BYTES_PER_BLOCK_LE) // More than one sector is required. Last bytes of sector were sent, increment the address, and load new sector.
+    if(g_msd_byte_of_sect == m_block_size) // More than one sector is required. Last bytes of sector were sent, increment the address, and load new sector.
     {
         g_msd_rw_10_vars.LBA++;
         #ifndef MSD_LIMITED_RAM
-        msd_rx_sector();
+        rx_sector();
         #endif
         g_msd_byte_of_sect = 0;
     }
@@ -1092,16 +1696,18 @@ static void service_write10(void)
     else ep_address = g_msd_ep_out_even;
     #endif
 
-    #ifdef MSD_LIMITED_RAM
-    msd_tx_sector();
+    #if defined(USE_UF2)
+    uf2_tx_packet();
+    #elif defined(MSD_LIMITED_RAM)
+    tx_sector();
     #else
     usb_ram_copy(ep_address, g_msd_sect_data + g_msd_byte_of_sect, MSD_EP_SIZE); // Load EP size worth of data from EP to g_msd_sect_data buffer.
     #endif
     g_msd_byte_of_sect += MSD_EP_SIZE;
-    if(g_msd_byte_of_sect == BYTES_PER_BLOCK_LE)
+    if(g_msd_byte_of_sect == m_block_size)
     {
         #ifndef MSD_LIMITED_RAM
-        msd_tx_sector();
+        tx_sector();
         #endif
         g_msd_rw_10_vars.LBA++;
         g_msd_byte_of_sect = 0;
@@ -1113,6 +1719,7 @@ static void service_write10(void)
     if(g_msd_rw_10_vars.TF_LEN_IN_BYTES == 0)
     {
         MSD_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+        m_cbw_armed = true; // The other buffer was armed for a packet past the end, the next CBW lands there.
         if(m_end_data_short)
         {
             msd_stall_ep_out();
@@ -1124,15 +1731,17 @@ static void service_write10(void)
     else msd_arm_ep_out((uint8_t)MSD_BD_OUT_EVEN + MSD_EP_OUT_LAST_PPB);
     
     #else
-    #ifdef MSD_LIMITED_RAM
-    msd_tx_sector();
+    #if defined(USE_UF2)
+    uf2_tx_packet();
+    #elif defined(MSD_LIMITED_RAM)
+    tx_sector();
     #else
     usb_ram_copy(g_msd_ep_out, g_msd_sect_data + g_msd_byte_of_sect, MSD_EP_SIZE); // Load EP size worth of data from EP to g_msd_sect_data buffer.
     #endif
     g_msd_byte_of_sect += MSD_EP_SIZE;
-    if(g_msd_byte_of_sect == BYTES_PER_BLOCK_LE){
+    if(g_msd_byte_of_sect == m_block_size){
         #ifndef MSD_LIMITED_RAM
-        msd_tx_sector();
+        tx_sector();
         #endif
         g_msd_rw_10_vars.LBA++;
         g_msd_byte_of_sect = 0;
@@ -1148,50 +1757,289 @@ static void service_write10(void)
             m_end_data_short = false;
             m_msd_state = MSD_WAIT_CLEAR;
         }
-        else setup_csw();
+        else
+        {
+            arm_cbw();
+            setup_csw();
+        }
     }
     else msd_arm_ep_out();
     #endif
 }
 
 
+#ifdef USE_UF2
+static void uf2_rx_packet(void)
+{
+    uint8_t* p_ep;
+    uint16_t bytes;
+    
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    p_ep = MSD_EP_IN_LAST_PPB == ODD ? g_msd_ep_in_odd : g_msd_ep_in_even;
+    #else
+    p_ep = g_msd_ep_in;
+    #endif
+    usb_ram_set(0, p_ep, MSD_EP_SIZE);
+    
+    if(g_msd_rw_10_vars.LBA == 0)
+    {
+        if(g_msd_byte_of_sect == 0) usb_rom_copy(m_uf2_boot_sector, p_ep, sizeof(m_uf2_boot_sector));
+        else if(g_msd_byte_of_sect == (512 - MSD_EP_SIZE))
+        {
+            p_ep[MSD_EP_SIZE - 2] = 0x55; // Signature word at 510.
+            p_ep[MSD_EP_SIZE - 1] = 0xAA;
+        }
+    }
+    else if(g_msd_rw_10_vars.LBA == UF2_FAT_LBA)
+    {
+        if(g_msd_byte_of_sect == 0) usb_rom_copy(m_uf2_fat, p_ep, sizeof(m_uf2_fat));
+    }
+    else if(g_msd_rw_10_vars.LBA == UF2_ROOT_LBA)
+    {
+        if(g_msd_byte_of_sect == 0) usb_rom_copy(m_uf2_root, p_ep, sizeof(m_uf2_root));
+    }
+    else if(g_msd_rw_10_vars.LBA == UF2_INFO_LBA && g_msd_byte_of_sect < UF2_INFO_SIZE)
+    {
+        bytes = UF2_INFO_SIZE - g_msd_byte_of_sect;
+        if(bytes > MSD_EP_SIZE) bytes = MSD_EP_SIZE;
+        usb_rom_copy((const uint8_t*)m_uf2_info + g_msd_byte_of_sect, p_ep, (uint8_t)bytes);
+    }
+}
+
+
+static void uf2_tx_packet(void)
+{
+    msd_uf2_header_t* p_header;
+    uint8_t*          p_ep;
+    uint16_t          offset;
+    uint16_t          start;
+    uint16_t          end;
+    
+    #if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+    p_ep = MSD_EP_OUT_LAST_PPB == ODD ? g_msd_ep_out_odd : g_msd_ep_out_even;
+    #else
+    p_ep = g_msd_ep_out;
+    #endif
+    offset = g_msd_byte_of_sect & (UF2_BLOCK_SIZE - 1); // 1024 byte blocks hold two UF2 blocks.
+    
+    if(offset == 0)
+    {
+        p_header = (msd_uf2_header_t*)p_ep;
+        m_uf2_payload_end = 0;
+        if(p_header->Magic_Start0 != UF2_MAGIC_START0 || p_header->Magic_Start1 != UF2_MAGIC_START1) return;
+        if(p_header->Flags & (UF2_FLAG_NOT_MAIN_FLASH | UF2_FLAG_FILE_CONTAINER)) return;
+        #if UF2_FAMILY_ID != 0
+        if(!(p_header->Flags & UF2_FLAG_FAMILY_ID) || p_header->Family_ID != UF2_FAMILY_ID) return;
+        #endif
+        if(p_header->Payload_Size == 0 || p_header->Payload_Size > UF2_MAX_PAYLOAD) return;
+        
+        m_uf2_target      = p_header->Target_Addr;
+        m_uf2_payload_end = UF2_DATA_OFFSET + (uint16_t)p_header->Payload_Size;
+        m_uf2_last        = (p_header->Block_No + 1) == p_header->Num_Blocks;
+    }
+    if(offset >= m_uf2_payload_end) return;
+    
+    start = offset < UF2_DATA_OFFSET ? UF2_DATA_OFFSET : offset;
+    end   = offset + MSD_EP_SIZE;
+    if(end > m_uf2_payload_end) end = m_uf2_payload_end;
+    
+    msd_uf2_write(m_uf2_target + (start - UF2_DATA_OFFSET), p_ep + (start - offset), (uint8_t)(end - start));
+    if(end == m_uf2_payload_end && m_uf2_last) msd_uf2_done();
+}
+#endif
+
+
+static void set_sense(uint8_t key, uint8_t asc, uint8_t ascq)
+{
+    m_lun_state[g_msd_lun].Sense_Key                       = key;
+    m_lun_state[g_msd_lun].Additional_Sense_Code           = asc;
+    m_lun_state[g_msd_lun].Additional_Sense_Code_Qualifier = ascq;
+}
+
+
+static void clear_unit_attention(void)
+{
+    uint8_t lun;
+    
+    for(lun = 0; lun < MSD_NUM_LUNS; lun++) m_lun_state[lun].Unit_Attention = false;
+}
+
+
+static uint32_t get_be32(const uint8_t* p_src)
+{
+    return ((uint32_t)p_src[0] << 24) | ((uint32_t)p_src[1] << 16) | ((uint16_t)p_src[2] << 8) | p_src[3];
+}
+
+
+static void put_be32(uint8_t* p_dest, uint32_t val)
+{
+    p_dest[0] = (uint8_t)(val >> 24);
+    p_dest[1] = (uint8_t)(val >> 16);
+    p_dest[2] = (uint8_t)(val >> 8);
+    p_dest[3] = (uint8_t)val;
+}
+
+
+static void read_capacity_16_data(uint8_t* p_ep)
+{
+    #ifdef USE_READ_CAPACITY
+    uint8_t capacity[8];
+    
+    g_msd_rw_10_vars.START_LBA = 0;
+    g_msd_rw_10_vars.LBA = 0;
+    msd_read_capacity();
+    usb_ram_copy((uint8_t*)&g_msd_read_capacity_10, capacity, 8); // May share p_ep, save it before clearing.
+    usb_ram_set(0, p_ep, 32);
+    usb_ram_copy(capacity, p_ep + 4, 8); // RETURNED LOGICAL BLOCK ADDRESS (upper 4 bytes are 0), LOGICAL BLOCK LENGTH IN BYTES
+    #else
+    usb_ram_set(0, p_ep, 32);
+    put_be32(p_ep + 4, m_lun_blocks[g_msd_lun] - 1); // RETURNED LOGICAL BLOCK ADDRESS, upper 4 bytes are 0.
+    put_be32(p_ep + 8, m_lun_block_size[g_msd_lun]); // LOGICAL BLOCK LENGTH IN BYTES
+    #endif
+}
+
+
 static void invalid_command_sense(void)
 {
-    g_msd_sense_key                       = ILLEGAL_REQUEST;
-    g_msd_additional_sense_code           = ASC_INVALID_COMMAND_OPCODE;
-    g_msd_additional_sense_code_qualifier = ASCQ_INVALID_COMMAND_OPCODE;
+    set_sense(ILLEGAL_REQUEST, ASC_INVALID_COMMAND_OPCODE, ASCQ_INVALID_COMMAND_OPCODE);
 }
 
 
 static void media_not_present_sense(void)
 {
-    g_msd_sense_key                       = NOT_READY;
-    g_msd_additional_sense_code           = ASC_MEDIUM_NOT_PRESENT;
-    g_msd_additional_sense_code_qualifier = ASCQ_MEDIUM_NOT_PRESENT;
+    set_sense(NOT_READY, ASC_MEDIUM_NOT_PRESENT, ASCQ_MEDIUM_NOT_PRESENT);
 }
 
 
 static void unit_attention_sense(void)
 {
-    g_msd_sense_key                       = UNIT_ATTENTION;
-    g_msd_additional_sense_code           = ASC_NOT_READY_TO_READY_CHANGE;
-    g_msd_additional_sense_code_qualifier = ASCQ_MEDIUM_MAY_HAVE_CHANGED;
+    set_sense(UNIT_ATTENTION, ASC_NOT_READY_TO_READY_CHANGE, ASCQ_MEDIUM_MAY_HAVE_CHANGED);
 }
 
 #ifdef USE_EXTERNAL_MEDIA
 static bool check_for_media(void)
 {
-    static bool prev_val = false;
     bool return_val;
     
     return_val = msd_media_present();
     
-    if(return_val != prev_val) m_unit_attention = true;
+    if(return_val != m_lun_state[g_msd_lun].Media_Present) m_lun_state[g_msd_lun].Unit_Attention = true;
     
-    prev_val = return_val;
+    m_lun_state[g_msd_lun].Media_Present = return_val;
     
     return return_val;
 }
 #endif
 
+#ifdef USE_MSD_STATS
+static void rx_sector(void)
+{
+    uint16_t start = MSD_STATS_TIME();
+    uint16_t ticks;
+    
+    msd_rx_sector();
+    ticks = STATS_TICKS(start);
+    stats_add(&g_msd_stats.Rx_Sector[stats_bin(ticks)]);
+    if(ticks > g_msd_stats.Rx_Sector_Max) g_msd_stats.Rx_Sector_Max = ticks;
+}
+
+
+static void tx_sector(void)
+{
+    uint16_t start = MSD_STATS_TIME();
+    uint16_t ticks;
+    
+    msd_tx_sector();
+    ticks = STATS_TICKS(start);
+    stats_add(&g_msd_stats.Tx_Sector[stats_bin(ticks)]);
+    if(ticks > g_msd_stats.Tx_Sector_Max) g_msd_stats.Tx_Sector_Max = ticks;
+}
+
+
+static void stats_cbw(uint8_t index)
+{
+    uint8_t i;
+    
+    m_stats_cbw  = MSD_STATS_TIME();
+    m_stats_data = false;
+    m_stats_row  = index < MSD_STATS_ROWS ? index : MSD_STATS_ROWS;
+    
+    if(!m_stats_failed || g_msd_cbw.CBWCB0[0] == REQUEST_SENSE) return;
+    m_stats_failed = false;
+    for(i = 0; i < STATS_RETRY_BYTES; i++)
+    {
+        if(g_msd_cbw.CBWCB0[i] != m_stats_failed_cdb[i]) return;
+    }
+    stats_add(&g_msd_stats.Retries);
+}
+
+
+static void stats_data(void)
+{
+    m_stats_last = MSD_STATS_TIME();
+    if(m_stats_data) return;
+    m_stats_first = m_stats_last;
+    m_stats_data  = true;
+}
+
+
+static void stats_csw(void)
+{
+    msd_stats_cmd_t *p_row = &g_msd_stats.Cmd[m_stats_row];
+    uint16_t now = MSD_STATS_TIME();
+    uint16_t total = (now - m_stats_cbw) & MSD_STATS_TIME_MASK;
+    uint8_t  i;
+    
+    stats_add(&p_row->Count);
+    stats_add(&p_row->Latency[stats_bin(total)]);
+    if(m_stats_data)
+    {
+        p_row->Setup_Ticks  += (m_stats_first - m_stats_cbw) & MSD_STATS_TIME_MASK;
+        p_row->Data_Ticks   += (m_stats_last - m_stats_first) & MSD_STATS_TIME_MASK;
+        p_row->Status_Ticks += (now - m_stats_last) & MSD_STATS_TIME_MASK;
+    }
+    else p_row->Setup_Ticks += total;
+    
+    if(g_msd_csw.bCSWStatus != COMMAND_FAILED) return;
+    stats_add(&g_msd_stats.Failed);
+    for(i = 0; i < STATS_RETRY_BYTES; i++) m_stats_failed_cdb[i] = g_msd_cbw.CBWCB0[i]; // Still there, the CSW is shorter than the CBW.
+    m_stats_failed = true;
+}
+
+
+static void stats_busy(bool busy)
+{
+    if(busy)
+    {
+        if(m_stats_busy) return;
+        m_stats_busy_start = MSD_STATS_TIME();
+        m_stats_busy = true;
+    }
+    else if(m_stats_busy)
+    {
+        g_msd_stats.Busy_Ticks += STATS_TICKS(m_stats_busy_start);
+        m_stats_busy = false;
+    }
+}
+
+
+static void stats_add(uint16_t* p_count)
+{
+    if(*p_count != 0xFFFF) (*p_count)++;
+}
+
+
+static uint8_t stats_bin(uint16_t ticks)
+{
+    uint8_t bin = 0;
+    
+    while(ticks && bin < (MSD_STATS_BINS - 1))
+    {
+        ticks >>= 1;
+        bin++;
+    }
+    return bin;
+}
+#endif
+
 /******************************************************************************/
\ No newline at end of file
@@ -89,6 +89,25 @@ extern uint8_t MSD_EP_IN_ODD[MSD_EP_SIZE]      __at(MSD_EP_IN_ODD_BUFFER_BASE_AD
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* **************************** SETTING CHECKS ****************************** */
+/* ************************************************************************** */
+
+#if MSD_NUM_LUNS < 1 || MSD_NUM_LUNS > 16
+#error "MSD_NUM_LUNS must be 1 to 16."
+#endif
+
+#if MSD_EP_SIZE < 32
+#error "MSD_EP_SIZE must be at least 32 (READ_CAPACITY_16 data is sent in one packet)."
+#endif
+
+#if defined(USE_WRITE_CACHE) && !defined(USE_MEDIA_BUSY)
+#error "USE_WRITE_CACHE holds SYNCHRONIZE_CACHE_10 with msd_media_busy(), define USE_MEDIA_BUSY."
+#endif
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* *************************** MSD 13 ERROR CASES *************************** */
 /* ************************************************************************** */
@@ -149,6 +168,66 @@ extern uint8_t MSD_EP_IN_ODD[MSD_EP_SIZE]      __at(MSD_EP_IN_ODD_BUFFER_BASE_AD
 /* ************************************************************************** */
 
 
+/* ************************************************************************** */
+/* ******************************** UF2 MODE ******************************** */
+/* ************************************************************************** */
+
+#ifdef USE_UF2
+#ifndef USE_WRITE_10
+#error "UF2 mode needs USE_WRITE_10."
+#endif
+#ifndef MSD_LIMITED_RAM
+#error "UF2 blocks are handled an EP packet at a time, define MSD_LIMITED_RAM."
+#endif
+#if MSD_EP_SIZE != 64
+#error "UF2 mode needs a 64 byte MSD EP (a UF2 header or boot sector per packet)."
+#endif
+#if MSD_NUM_LUNS != 1
+#error "UF2 mode has a single LUN."
+#endif
+
+// UF2 Block Magic Numbers
+#define UF2_MAGIC_START0 0x0A324655UL // "UF2\n"
+#define UF2_MAGIC_START1 0x9E5D5157UL
+#define UF2_MAGIC_END    0x0AB16F30UL
+
+// UF2 Block Flags
+#define UF2_FLAG_NOT_MAIN_FLASH   0x00000001UL
+#define UF2_FLAG_FILE_CONTAINER   0x00001000UL
+#define UF2_FLAG_FAMILY_ID        0x00002000UL
+
+#define UF2_BLOCK_SIZE   512
+#define UF2_DATA_OFFSET  32
+#define UF2_MAX_PAYLOAD  476
+
+// Virtual FAT12 Volume (one FAT, one sector root directory, one sector clusters)
+#define UF2_FAT_LBA      1
+#define UF2_FAT_SECTORS  ((((VOL_CAPACITY_IN_BLOCKS * 3) / 2) + BYTES_PER_BLOCK_LE - 1) / BYTES_PER_BLOCK_LE)
+#define UF2_ROOT_LBA     (UF2_FAT_LBA + UF2_FAT_SECTORS)
+#define UF2_INFO_LBA     (UF2_ROOT_LBA + 1) // Cluster 2
+#define UF2_CLUSTERS     (VOL_CAPACITY_IN_BLOCKS - UF2_INFO_LBA)
+
+#if UF2_CLUSTERS >= 4085
+#error "UF2 volume is too big for FAT12, lower VOL_CAPACITY_IN_BLOCKS."
+#endif
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ***************************** MSD STATISTICS ***************************** */
+/* ************************************************************************** */
+
+#ifdef USE_MSD_STATS
+#define MSD_STATS_VERSION 1
+#define MSD_STATS_BINS    8    // Ticks of 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63 and 64 up.
+#define MSD_STATS_OTHER   0xFF // Opcode of the row shared by the rest of the commands.
+#endif
+
+/* ************************************************************************** */
+
+
 /* ************************************************************************** */
 /* ******************************** MSD STATES ****************************** */
 /* ************************************************************************** */
@@ -254,7 +333,7 @@ typedef union
     };
 }msd_csw_t;
 
-/** READ_10 Variables Structure */
+/** READ_10/WRITE_10 and READ_16/WRITE_16 Variables Structure */
 typedef struct
 {
     union
@@ -265,8 +344,8 @@ typedef struct
     uint32_t LBA;
     union
     {
-        uint8_t TF_LEN_BYTES[2];
-        uint16_t TF_LEN;
+        uint8_t TF_LEN_BYTES[4];
+        uint32_t TF_LEN;
     };
     uint32_t TF_LEN_IN_BYTES;
 }msd_rw_10_vars_t;
@@ -282,6 +361,56 @@ typedef union
     };
 }msd_bytes_to_transfer_t;
 
+
+#ifdef USE_UF2
+/** UF2 Block Header (the payload follows at UF2_DATA_OFFSET) */
+typedef struct
+{
+    uint32_t Magic_Start0;
+    uint32_t Magic_Start1;
+    uint32_t Flags;
+    uint32_t Target_Addr;
+    uint32_t Payload_Size;
+    uint32_t Block_No;
+    uint32_t Num_Blocks;
+    uint32_t Family_ID; // File size with UF2_FLAG_FILE_CONTAINER.
+}msd_uf2_header_t;
+#endif
+
+#ifdef USE_MSD_STATS
+/** Timing of one SCSI command (or of every command without its own row). */
+typedef struct
+{
+    uint8_t  Opcode;
+    uint16_t Count;                   ///< Commands that reached the CSW.
+    uint16_t Latency[MSD_STATS_BINS]; ///< CBW to CSW.
+    uint32_t Setup_Ticks;             ///< CBW to first data packet (to the CSW without data), summed.
+    uint32_t Data_Ticks;              ///< First to last data packet, summed.
+    uint32_t Status_Ticks;            ///< Last data packet to CSW, summed.
+}msd_stats_cmd_t;
+
+/** Statistics (USE_MSD_STATS), little endian and unpadded for the host. */
+typedef struct
+{
+    uint8_t  Version;      ///< MSD_STATS_VERSION.
+    uint8_t  Rows;         ///< MSD_STATS_ROWS + 1.
+    uint8_t  Bins;         ///< MSD_STATS_BINS.
+    uint8_t  Reserved;
+    uint32_t Tick_Ns;      ///< MSD_STATS_TICK_NS.
+    uint16_t BOMSRs;       ///< Bulk Only Mass Storage Resets.
+    uint16_t Phase_Errors; ///< CSWs with PHASE_ERROR.
+    uint16_t Invalid_CBWs;
+    uint16_t Failed;       ///< CSWs with COMMAND_FAILED.
+    uint16_t Retries;      ///< Failed commands the host sent again.
+    uint16_t Rx_Sector[MSD_STATS_BINS]; ///< msd_rx_sector() call times.
+    uint16_t Tx_Sector[MSD_STATS_BINS]; ///< msd_tx_sector() call times.
+    uint16_t Rx_Sector_Max;
+    uint16_t Tx_Sector_Max;
+    uint32_t Busy_Ticks;   ///< msd_media_busy() holding off MSD (USE_MEDIA_BUSY), summed.
+    msd_stats_cmd_t Cmd[MSD_STATS_ROWS + 1]; ///< Last row is MSD_STATS_OTHER.
+}msd_stats_t;
+#endif
+
 /* ************************************************************************** */
 
 
@@ -299,6 +428,7 @@ extern uint8_t g_msd_ep_in_even[MSD_EP_SIZE]  __at(MSD_EP_IN_EVEN_BUFFER_BASE_AD
 extern uint8_t g_msd_ep_in_odd[MSD_EP_SIZE]   __at(MSD_EP_IN_ODD_BUFFER_BASE_ADDR);
 #endif
 
+extern uint8_t  g_msd_lun; // LUN of the current command.
 extern uint16_t g_msd_byte_of_sect;
 #ifndef MSD_LIMITED_RAM
 extern uint8_t g_msd_sect_data[512];
@@ -308,6 +438,9 @@ extern msd_csw_t                 g_msd_csw;
 extern msd_rw_10_vars_t          g_msd_rw_10_vars;
 extern msd_bytes_to_transfer_t   g_msd_bytes_to_transfer;
 extern scsi_fixed_format_sense_t g_msd_fixed_format_sense;
+#ifdef USE_MSD_STATS
+extern msd_stats_t               g_msd_stats;
+#endif
 
 /* ************************************************************************** */
 
@@ -480,16 +613,127 @@ void msd_stall_ep_out(void);
  */
 void msd_stall_ep_in(void);
 
+/**
+ * @fn bool msd_set_capacity(uint8_t lun, uint32_t blocks, uint16_t block_size)
+ * 
+ * @brief Changes a LUN's capacity at runtime.
+ * 
+ * MSD_LUN_BLOCKS and MSD_LUN_BLOCK_SIZE are only the starting values. Call 
+ * this once the real size is known, e.g. after an SD card has been 
+ * initialized. The host is told the medium may have changed.
+ * 
+ * @param[in] lun Logical Unit Number.
+ * @param[in] blocks Capacity in blocks.
+ * @param[in] block_size Bytes per block, a multiple of MSD_EP_SIZE (512 max 
+ * without MSD_LIMITED_RAM).
+ * @return Returns false if the LUN or block size isn't valid.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * if(sd_init()) msd_set_capacity(0, sd_get_blocks(), 512);
+ * @endcode
+ * </li></ul>
+ */
+bool msd_set_capacity(uint8_t lun, uint32_t blocks, uint16_t block_size);
+
+#ifdef USE_MSD_STATS
+/**
+ * @fn void msd_stats_clear(void)
+ * 
+ * @brief Zeroes g_msd_stats.
+ * 
+ * Done by msd_init() and by an OUT MSD_STATS_REQUEST vendor request.
+ */
+void msd_stats_clear(void);
+
+/**
+ * @fn void msd_stats_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes)
+ * 
+ * @brief Copies part of g_msd_stats, e.g. to serve it as a file.
+ * 
+ * The same as a vfat_read_t, so the statistics can be a file on a 
+ * usb_vfat.c volume. Hosts cache files, read it with O_DIRECT (or remount) 
+ * to see new values. An IN MSD_STATS_REQUEST vendor request returns the same 
+ * bytes without a volume. Tools/msd_stats.py prints them.
+ * 
+ * @param[in] offset Byte offset into g_msd_stats.
+ * @param[out] p_buffer Where the bytes go.
+ * @param[in] bytes Number of bytes, within sizeof(msd_stats_t).
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * {{'S','T','A','T','S',' ',' ',' ','B','I','N'}, sizeof(msd_stats_t), msd_stats_read}
+ * @endcode
+ * </li></ul>
+ */
+void msd_stats_read(uint32_t offset, uint8_t* p_buffer, uint16_t bytes);
+#endif
+
 // TODO: descriptions for these
 // USER FUNCTIONS TO PLACE IN MAIN
+// With more than one LUN, g_msd_lun holds the unit each call is for.
 bool    msd_media_present(void);
 uint8_t msd_test_unit_ready(void);
 uint8_t msd_start_stop_unit(void);
 void    msd_read_capacity(void);
 void    msd_rx_sector(void);
 void    msd_tx_sector(void);
+
+#ifdef USE_UF2
+/**
+ * @fn void msd_uf2_write(uint32_t target_addr, uint8_t* p_data, uint8_t bytes)
+ * 
+ * @brief Programs part of a UF2 block's payload, replaces msd_tx_sector() in UF2 mode.
+ * 
+ * Called as each packet of a block arrives, so a 256 byte payload comes as 
+ * 32, 64, 64, 64 and 32 byte pieces in address order. Only the start magic 
+ * numbers have been checked, the end magic arrives after the payload.
+ * 
+ * @param[in] target_addr Flash byte address from the block's header.
+ * @param[in] p_data Payload bytes in the OUT EP buffer.
+ * @param[in] bytes Amount of bytes.
+ */
+void msd_uf2_write(uint32_t target_addr, uint8_t* p_data, uint8_t bytes);
+
+/**
+ * @fn void msd_uf2_done(void)
+ * 
+ * @brief Called after the payload of a file's last block (Block_No = Num_Blocks - 1).
+ */
+void msd_uf2_done(void);
+#endif
 bool    msd_wr_protect(void);
 
+#ifdef USE_MEDIA_BUSY
+/**
+ * @fn bool msd_media_busy(void)
+ * 
+ * @brief Checked by msd_tasks() before it services anything.
+ * 
+ * While true, received packets are left in the EP buffers and nothing new is 
+ * armed, so the host is NAKed instead of msd_tx_sector() or msd_rx_sector() 
+ * being called. Lets long media operations (flash erase) be split into steps 
+ * done between msd_tasks() calls.
+ * 
+ * @return Returns true while the media can't take another sector.
+ */
+bool    msd_media_busy(void);
+#endif
+
+#ifdef USE_WRITE_CACHE
+/**
+ * @fn void msd_sync_cache(void)
+ * 
+ * @brief Called on SYNCHRONIZE_CACHE_10, starts writing back cached data.
+ * 
+ * The CSW isn't sent until msd_media_busy() returns false, so the host only 
+ * sees the command pass once the data is on the media.
+ */
+void    msd_sync_cache(void);
+#endif
+
 /* ************************************************************************** */
 
 #endif /* USB_MSD_H */
\ No newline at end of file
@@ -118,17 +118,17 @@
 #define MODE_SELECT_6                0x15 // Optional, not supported.
 #define MODE_SELECT_10               0x55 // Optional, not supported.
 #define MODE_SENSE_6                 0x1A // Optional, supported.      **
-#define MODE_SENSE_10                0x5A // Optional, not supported.
+#define MODE_SENSE_10                0x5A // Optional, supported.      **
 #define MOVE_MEDIUM                  0xA7 // Optional, not supported.
 #define PERSISTANT_RESERVE_IN        0x5E // Optional, not supported.
 #define PERSISTANT_RESERVE_OUT       0x5F // Optional, not supported.
 #define PRE_FETCH_10                 0x34 // Optional, not supported.
 #define PRE_FETCH_16                 0x90 // Optional, not supported.
-#define PREVENT_ALLOW_MEDIUM_REMOVAL 0x1E // Optional, not supported.  **
+#define PREVENT_ALLOW_MEDIUM_REMOVAL 0x1E // Optional, supported.      **
 #define READ_6                       0x08 // Manditory, not supported.
 #define READ_10                      0x28 // Manditory, supported.     **
 #define READ_12                      0xA8 // Optional, not supported.
-#define READ_16                      0x88 // Manditory, not supported.
+#define READ_16                      0x88 // Manditory, supported.     **
 #define READ_BUFFER                  0x3C // Optional, not supported.
 #define READ_CAPACITY                0x25 // Manditory, supported.     **
 #define READ_DEFECT_DATA_10          0x37 // Optional, not supported.
@@ -148,11 +148,12 @@
 #define RESERVE_6                    0x16 // Optional, not supported.
 #define RESERVE_10                   0x56 // Manditory, not supported.
 #define SEEK_10                      0x2B // Optional, not supported.
+#define SERVICE_ACTION_IN_16         0x9E // READ_CAPACITY_16 supported. **
 #define SEND_DIAGNOSTIC              0x1D // Manditory, not supported.
 #define SET_LIMITS_10                0x33 // Optional, not supported.
 #define SET_LIMITS_12                0xB3 // Optional, not supported.
 #define START_STOP_UNIT              0x1B // Optional, supported.      **
-#define SYNCHRONIZE_CACHE_10         0x35 // Optional, not supported.
+#define SYNCHRONIZE_CACHE_10         0x35 // Optional, supported.
 #define SYNCHRONIZE_CACHE_16         0x91 // Optional, not supported.
 #define TEST_UNIT_READY              0x00 // Manditory, supported.     **
 #define VERIFY_10                    0x2F // Optional, supported.      **
@@ -161,7 +162,7 @@
 #define WRITE_6                      0x0A // Optional, not supported.
 #define WRITE_10                     0x2A // Optional, supported.      **
 #define WRITE_12                     0xAA // Optional, not supported.
-#define WRITE_16                     0x8A // Optional, not supported.
+#define WRITE_16                     0x8A // Optional, supported.      **
 #define WRITE_AND_VERIFY_10          0x2E // Optional, not supported.
 #define WRITE_AND_VERIFY_12          0xAE // Optional, not supported.
 #define WRITE_AND_VERIFY_16          0x8E // Optional, not supported.
@@ -181,6 +182,22 @@
 #define XPWRITE_10                   0x51 // Optional, not supported.
 #define XPWRITE_32                   0x7F // Optional, not supported.
 
+// SERVICE_ACTION_IN_16 Service Actions
+#define SA_READ_CAPACITY_16          0x10
+
+// UFI/MMC Commands
+#define READ_FORMAT_CAPACITIES       0x23 // supported.                **
+
+// READ_FORMAT_CAPACITIES Descriptor Types
+#define UNFORMATTED_MEDIA            0x01
+#define FORMATTED_MEDIA              0x02
+#define NO_MEDIA_PRESENT             0x03
+
+// Mode Pages
+#define MODE_PAGE_CACHING            0x08
+#define MODE_PAGE_CACHING_LEN        20
+#define MODE_PAGE_ALL                0x3F
+
 /* ************************************************************************** */
 
 
@@ -260,6 +277,24 @@ typedef struct
     uint8_t CONTROL;
 }scsi_mode_sense_6_cmd_t;
 
+// 0x5A Mode Sense (10) Command
+typedef struct
+{
+    uint8_t OPERATION_CODE;
+    unsigned: 3;
+    unsigned DBD: 1;
+    unsigned LLBAA: 1;
+    unsigned: 3;
+    unsigned PAGE_CODE: 6;
+    unsigned PC: 2;
+    uint8_t SUBPAGE_CODE;
+    unsigned: 8;
+    unsigned: 8;
+    unsigned: 8;
+    uint8_t ALLOCATION_LENGTH_BYTES[2];
+    uint8_t CONTROL;
+}scsi_mode_sense_10_cmd_t;
+
 // 0x25 Read Capacity (10) Command
 typedef struct
 {
@@ -333,6 +368,36 @@ typedef struct
     uint8_t CONTROL;
 }scsi_write_10_cmd_t;
 
+// 0x88 Read (16) and 0x8A Write (16) Commands
+typedef struct
+{
+    uint8_t OPERATION_CODE;
+    unsigned: 1;
+    unsigned FUA_NV: 1;
+    unsigned: 1;
+    unsigned FUA: 1;
+    unsigned DPO: 1;
+    unsigned RDPROTECT: 3;
+    uint8_t LBA_BYTES[8];
+    uint8_t TF_LEN_BYTES[4];
+    unsigned GROUP_NUMBER: 5;
+    unsigned: 3;
+    uint8_t CONTROL;
+}scsi_read_16_cmd_t;
+
+// 0x9E/0x10 Read Capacity (16) Command
+typedef struct
+{
+    uint8_t OPERATION_CODE;
+    unsigned SERVICE_ACTION: 5;
+    unsigned: 3;
+    uint8_t LOGICAL_BLOCK_ADDRESS_BYTES[8];
+    uint8_t ALLOCATION_LENGTH_BYTES[4];
+    unsigned PMI: 1;
+    unsigned: 7;
+    uint8_t CONTROL;
+}scsi_read_capacity_16_cmd_t;
+
 // Mode Select (6) Command
 typedef struct
 {
@@ -367,6 +432,20 @@ typedef struct
     unsigned CONTROL: 8;
 }scsi_pamr_cmd_t;
 
+// 0x23 Read Format Capacities Command
+typedef struct
+{
+    uint8_t OPERATION_CODE;
+    unsigned: 8;
+    unsigned: 8;
+    unsigned: 8;
+    unsigned: 8;
+    unsigned: 8;
+    unsigned: 8;
+    uint8_t ALLOCATION_LENGTH_BYTES[2];
+    uint8_t CONTROL;
+}scsi_read_format_capacities_cmd_t;
+
 /* ************************************************************************** */
 
 #endif /* USB_SCSI_H */
\ No newline at end of file
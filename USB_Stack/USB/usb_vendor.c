@@ -0,0 +1,525 @@
+/**
+ * @file usb_vendor.c
+ * @brief <i>Vendor Specific</i> bulk interface core.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Vendor Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_vendor.h"
+#include "usb_ch9.h"
+
+/* ************************************************************************** */
+/* ************************** VENDOR ENDPOINTS ****************************** */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+uint8_t g_vendor_ep_out[VENDOR_EP_SIZE] __at(VENDOR_EP_OUT_BUFFER_BASE_ADDR);
+uint8_t g_vendor_ep_in[VENDOR_EP_SIZE]  __at(VENDOR_EP_IN_BUFFER_BASE_ADDR);
+
+#define VENDOR_BD_OUT_FIRST VENDOR_BD_OUT
+#define VENDOR_BD_IN_FIRST  VENDOR_BD_IN
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+uint8_t g_vendor_ep_out_even[VENDOR_EP_SIZE] __at(VENDOR_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_vendor_ep_out_odd[VENDOR_EP_SIZE]  __at(VENDOR_EP_OUT_ODD_BUFFER_BASE_ADDR);
+uint8_t g_vendor_ep_in_even[VENDOR_EP_SIZE]  __at(VENDOR_EP_IN_EVEN_BUFFER_BASE_ADDR);
+uint8_t g_vendor_ep_in_odd[VENDOR_EP_SIZE]   __at(VENDOR_EP_IN_ODD_BUFFER_BASE_ADDR);
+
+#define VENDOR_BD_OUT_FIRST VENDOR_BD_OUT_EVEN // ODD follows EVEN.
+#define VENDOR_BD_IN_FIRST  VENDOR_BD_IN_EVEN
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************** MICROSOFT OS 2.0 DESCRIPTORS ********************** */
+/* ************************************************************************** */
+
+#ifdef USE_MS_OS_20
+static const vendor_ms_os_20_descriptor_set_t m_ms_os_20_descriptor_set =
+{
+    10,                                     // wLength
+    MS_OS_20_SET_HEADER_DESCRIPTOR,         // wDescriptorType
+    MS_OS_20_WINDOWS_8_1,                   // dwWindowsVersion
+    sizeof(vendor_ms_os_20_descriptor_set_t), // wTotalLength
+    
+    #ifdef VENDOR_MS_OS_20_COMPOSITE
+    8,                                      // wLength
+    MS_OS_20_SUBSET_HEADER_CONFIGURATION,   // wDescriptorType
+    0,                                      // bConfigurationValue - Configuration index, not value
+    0,                                      // bReserved
+    sizeof(vendor_ms_os_20_descriptor_set_t) - 10, // wTotalLength - Includes this header
+    
+    8,                                      // wLength
+    MS_OS_20_SUBSET_HEADER_FUNCTION,        // wDescriptorType
+    VENDOR_INT,                             // bFirstInterface
+    0,                                      // bReserved
+    sizeof(vendor_ms_os_20_descriptor_set_t) - 18, // wSubsetLength - Includes this header
+    #endif
+    
+    20,                                     // wLength
+    MS_OS_20_FEATURE_COMPATIBLE_ID,         // wDescriptorType
+    {'W','I','N','U','S','B',0,0},          // CompatibleID
+    {0,0,0,0,0,0,0,0},                      // SubCompatibleID
+    
+    10 + 42 + 80,                           // wLength
+    MS_OS_20_FEATURE_REG_PROPERTY,          // wDescriptorType
+    MS_OS_20_REG_MULTI_SZ,                  // wPropertyDataType
+    42,                                     // wPropertyNameLength
+    {'D','e','v','i','c','e','I','n','t','e','r','f','a','c','e','G','U','I','D','s',0}, // PropertyName
+    80,                                     // wPropertyDataLength
+    {VENDOR_DEVICE_INTERFACE_GUID,0,0}      // PropertyData - REG_MULTI_SZ ends with two NULLs
+};
+
+static const vendor_bos_descriptor_t m_bos_descriptor =
+{
+    5,                                      // bLength
+    BOS_DESC,                               // bDescriptorType
+    sizeof(vendor_bos_descriptor_t),        // wTotalLength
+    1,                                      // bNumDeviceCaps
+    
+    28,                                     // bLength
+    DEVICE_CAPABILITY_DESC,                 // bDescriptorType
+    BOS_PLATFORM_CAPABILITY,                // bDevCapabilityType
+    0,                                      // bReserved
+    {0xDF,0x60,0xDD,0xD8,0x89,0x45,0xC7,0x4C,0x9C,0xD2,0x65,0x9D,0x9E,0x64,0x8A,0x9F}, // {D8DD60DF-4589-4CC7-9CD2-659D9E648A9F}
+    MS_OS_20_WINDOWS_8_1,                   // dwWindowsVersion
+    sizeof(vendor_ms_os_20_descriptor_set_t), // wMSOSDescriptorSetTotalLength
+    VENDOR_MS_VENDOR_CODE,                  // bMS_VendorCode
+    0                                       // bAltEnumCode
+};
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+static uint8_t* const m_out_buffers[VENDOR_NUM_BD] = {g_vendor_ep_out};
+static uint8_t* const m_in_buffers[VENDOR_NUM_BD]  = {g_vendor_ep_in};
+#else
+static uint8_t* const m_out_buffers[VENDOR_NUM_BD] = {g_vendor_ep_out_even, g_vendor_ep_out_odd};
+static uint8_t* const m_in_buffers[VENDOR_NUM_BD]  = {g_vendor_ep_in_even, g_vendor_ep_in_odd};
+#endif
+
+// Write (IN)
+static uint8_t*          m_write_ptr;
+static volatile uint16_t m_write_left;   // Bytes not yet copied into an IN BD.
+static volatile bool     m_write_zlp;    // A ZLP still has to be armed.
+static volatile bool     m_write_busy;   // Buffer hasn't been handed back yet.
+static volatile bool     m_write_done;   // vendor_write_done() is owed.
+static bool              m_in_callback;
+static volatile uint8_t  m_in_pending;   // IN BDs armed and not yet sent.
+static uint8_t           m_in_arm_ppb;   // IN BD to arm next.
+
+// Read (OUT)
+static uint8_t*          m_read_ptr;
+static volatile uint16_t m_read_left;    // Space left in the read buffer.
+static volatile uint16_t m_read_count;   // Bytes received into it.
+static volatile bool     m_read_busy;
+static volatile bool     m_read_done;    // vendor_read_done() is owed.
+static bool              m_out_callback;
+static volatile uint8_t  m_out_full;     // OUT BDs holding data not yet read.
+static uint8_t           m_out_ppb;      // OUT BD to read next.
+static uint8_t           m_out_offset;   // Bytes already read from it.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************* LOCAL FUNCTION DECLARATIONS ************************ */
+/* ************************************************************************** */
+
+/**
+ * @fn void fill_in_bds(void)
+ * 
+ * @brief Copies the write buffer into free IN BDs and arms them.
+ * 
+ * Run from the ISR, or with the USB interrupt disabled.
+ */
+static void fill_in_bds(void);
+
+/**
+ * @fn void read_out_bds(void)
+ * 
+ * @brief Copies received OUT BDs into the read buffer, re-arming each one emptied.
+ * 
+ * Run from the ISR, or with the USB interrupt disabled.
+ */
+static void read_out_bds(void);
+
+/**
+ * @fn void write_callbacks(void)
+ * 
+ * @brief Calls vendor_write_done() for every buffer handed back.
+ * 
+ * A vendor_write() from the callback is serviced by the same loop, not a
+ * nested one.
+ */
+static void write_callbacks(void);
+
+/**
+ * @fn void read_callbacks(void)
+ * 
+ * @brief Calls vendor_read_done() for every read finished.
+ */
+static void read_callbacks(void);
+
+/**
+ * @fn void arm_out_bds(void)
+ * 
+ * @brief Drops held OUT data and arms every OUT BD, starting with the one the SIE uses next.
+ */
+static void arm_out_bds(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** VENDOR FUNCTIONS ***************************** */
+/* ************************************************************************** */
+
+bool vendor_request(void)
+{
+    #ifdef USE_MS_OS_20
+    if(g_usb_setup.bmRequestType_bits.Type != VENDOR) return false;
+    if(g_usb_setup.bRequest != VENDOR_MS_VENDOR_CODE) return false;
+    if(g_usb_setup.wIndex != MS_OS_20_DESCRIPTOR_INDEX) return false;
+    if(g_usb_setup.bmRequestType_bits.DataTransferDirection != DEVICE_TO_HOST) return false;
+    if(g_usb_setup.bmRequestType_bits.Recipient != DEVICE) return false;
+    
+    usb_set_rom_ptr((const uint8_t*)&m_ms_os_20_descriptor_set);
+    usb_setup_in_control_transfer(ROM, sizeof(vendor_ms_os_20_descriptor_set_t), g_usb_setup.wLength);
+    usb_in_control_transfer();
+    usb_set_control_stage(DATA_IN_STAGE);
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+bool vendor_get_descriptor(const uint8_t** descriptor, uint16_t* size)
+{
+    #ifdef USE_MS_OS_20
+    // Stupid compiler cuts off address at 8 bits!
+    uint32_t address;
+    
+    if(g_usb_get_descriptor.DescriptorType != BOS_DESC) return false;
+    address = (uint32_t)&m_bos_descriptor;
+    *descriptor = (const uint8_t*)address;
+    *size = sizeof(vendor_bos_descriptor_t);
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+void vendor_init(void)
+{
+    uint8_t bd;
+    
+    for(bd = 0; bd < VENDOR_NUM_BD; bd++)
+    {
+        g_usb_bd_table[VENDOR_BD_OUT_FIRST + bd].STAT = 0;
+        g_usb_bd_table[VENDOR_BD_OUT_FIRST + bd].ADR  = (uint16_t)m_out_buffers[bd];
+        g_usb_bd_table[VENDOR_BD_IN_FIRST + bd].STAT  = 0;
+        g_usb_bd_table[VENDOR_BD_IN_FIRST + bd].ADR   = (uint16_t)m_in_buffers[bd];
+    }
+    
+    // EP Settings
+    VENDOR_UEPbits.EPHSHK   = 1; // Handshaking enabled 
+    VENDOR_UEPbits.EPCONDIS = 0; // Don't allow SETUP
+    VENDOR_UEPbits.EPOUTEN  = 1; // EP output enabled
+    VENDOR_UEPbits.EPINEN   = 1; // EP input enabled
+    g_usb_ep_stat[VENDOR_EP][OUT].Halt = 0;
+    g_usb_ep_stat[VENDOR_EP][IN].Halt  = 0;
+    vendor_clear_ep_toggle();
+    
+    m_write_left  = 0;
+    m_write_zlp   = false;
+    m_write_busy  = false;
+    m_write_done  = false;
+    m_in_callback = false;
+    m_in_pending  = 0;
+    #if VENDOR_NUM_BD == 2
+    m_in_arm_ppb  = VENDOR_EP_IN_LAST_PPB ^ 1;
+    #else
+    m_in_arm_ppb  = 0;
+    #endif
+    
+    m_read_left    = 0;
+    m_read_busy    = false;
+    m_read_done    = false;
+    m_out_callback = false;
+    arm_out_bds();
+}
+
+void vendor_tasks(void)
+{
+    if(TRANSACTION_EP != VENDOR_EP) return;
+    
+    if(TRANSACTION_DIR == IN)
+    {
+        #if VENDOR_NUM_BD == 2
+        VENDOR_EP_IN_LAST_PPB = PINGPONG_PARITY;
+        #endif
+        if(m_in_pending) m_in_pending--;
+        fill_in_bds(); // Data toggle was already moved on when the BD was armed.
+        write_callbacks();
+    }
+    else
+    {
+        #if VENDOR_NUM_BD == 2
+        VENDOR_EP_OUT_LAST_PPB = PINGPONG_PARITY;
+        #endif
+        m_out_full++;
+        read_out_bds();
+        read_callbacks();
+    }
+}
+
+void vendor_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
+{
+    if(ep != VENDOR_EP) return;
+    
+    g_usb_ep_stat[ep][dir].Data_Toggle_Val = 0;
+    
+    if(g_usb_ep_stat[ep][dir].Halt)
+    {
+        g_usb_ep_stat[ep][dir].Halt      = 0;
+        g_usb_bd_table[bdt_index].STAT   = 0;
+        #if VENDOR_NUM_BD == 2
+        g_usb_bd_table[++bdt_index].STAT = 0;
+        #endif
+        
+        if(dir == IN)
+        {
+            // Packets in the stalled BDs are dropped, newest first, leaving
+            // m_in_arm_ppb on the BD the SIE will use next.
+            while(m_in_pending)
+            {
+                #if VENDOR_NUM_BD == 2
+                m_in_arm_ppb ^= 1;
+                #endif
+                m_in_pending--;
+            }
+        }
+        else arm_out_bds();
+    }
+    if(dir == IN)
+    {
+        fill_in_bds();
+        write_callbacks();
+    }
+}
+
+void vendor_clear_ep_toggle(void)
+{
+    VENDOR_EP_OUT_DATA_TOGGLE_VAL = 0;
+    VENDOR_EP_IN_DATA_TOGGLE_VAL  = 0;
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+static void fill_in_bds(void)
+{
+    uint8_t cnt;
+    
+    if(g_usb_ep_stat[VENDOR_EP][IN].Halt) return;
+    
+    while((m_in_pending < VENDOR_NUM_BD) && ((m_write_left != 0) || m_write_zlp))
+    {
+        if(m_write_left < VENDOR_EP_SIZE) cnt = (uint8_t)m_write_left;
+        else cnt = VENDOR_EP_SIZE;
+        
+        if(cnt == 0) m_write_zlp = false;
+        else usb_ram_copy(m_write_ptr, m_in_buffers[m_in_arm_ppb], cnt);
+        usb_arm_endpoint(&g_usb_bd_table[VENDOR_BD_IN_FIRST + m_in_arm_ppb], &g_usb_ep_stat[VENDOR_EP][IN], cnt);
+        VENDOR_EP_IN_DATA_TOGGLE_VAL ^= 1; // The other BD may be armed before this one is sent.
+        #if VENDOR_NUM_BD == 2
+        m_in_arm_ppb ^= 1;
+        #endif
+        m_in_pending++;
+        m_write_ptr  += cnt;
+        m_write_left -= cnt;
+        
+        if((m_write_left == 0) && !m_write_zlp && m_write_busy)
+        {
+            m_write_busy = false;
+            m_write_done = true;
+        }
+    }
+}
+
+static void read_out_bds(void)
+{
+    bd_t*   p_bd;
+    uint8_t cnt;
+    uint8_t bytes;
+    
+    while(m_read_busy && m_out_full)
+    {
+        p_bd  = &g_usb_bd_table[VENDOR_BD_OUT_FIRST + m_out_ppb];
+        cnt   = p_bd->CNT;
+        bytes = cnt - m_out_offset;
+        if(bytes > m_read_left) bytes = (uint8_t)m_read_left;
+        
+        usb_ram_copy(m_out_buffers[m_out_ppb] + m_out_offset, m_read_ptr, bytes);
+        m_read_ptr   += bytes;
+        m_read_left  -= bytes;
+        m_read_count += bytes;
+        m_out_offset += bytes;
+        
+        if(m_out_offset == cnt) // Packet used up, hand the BD back to the SIE.
+        {
+            m_out_offset = 0;
+            m_out_full--;
+            usb_arm_endpoint(p_bd, &g_usb_ep_stat[VENDOR_EP][OUT], VENDOR_EP_SIZE);
+            VENDOR_EP_OUT_DATA_TOGGLE_VAL ^= 1;
+            #if VENDOR_NUM_BD == 2
+            m_out_ppb ^= 1;
+            #endif
+            if(cnt < VENDOR_EP_SIZE) m_read_left = 0; // Short packet ends the host's transfer.
+        }
+        
+        if(m_read_left == 0)
+        {
+            m_read_busy = false;
+            m_read_done = true;
+        }
+    }
+}
+
+static void write_callbacks(void)
+{
+    if(m_in_callback) return;
+    m_in_callback = true;
+    while(m_write_done)
+    {
+        m_write_done = false;
+        vendor_write_done();
+    }
+    m_in_callback = false;
+}
+
+static void read_callbacks(void)
+{
+    uint16_t count;
+    
+    if(m_out_callback) return;
+    m_out_callback = true;
+    while(m_read_done)
+    {
+        m_read_done = false;
+        count = m_read_count;
+        vendor_read_done(count);
+    }
+    m_out_callback = false;
+}
+
+static void arm_out_bds(void)
+{
+    uint8_t bd;
+    
+    m_out_full   = 0;
+    m_out_offset = 0;
+    #if VENDOR_NUM_BD == 2
+    m_out_ppb    = VENDOR_EP_OUT_LAST_PPB ^ 1;
+    #else
+    m_out_ppb    = 0;
+    #endif
+    for(bd = 0; bd < VENDOR_NUM_BD; bd++)
+    {
+        usb_arm_endpoint(&g_usb_bd_table[VENDOR_BD_OUT_FIRST + (m_out_ppb ^ bd)], &g_usb_ep_stat[VENDOR_EP][OUT], VENDOR_EP_SIZE);
+        VENDOR_EP_OUT_DATA_TOGGLE_VAL ^= 1; // The other BD may be filled before this one is read.
+    }
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+bool vendor_write(uint8_t* data, uint16_t len)
+{
+    if(usb_get_state() != STATE_CONFIGURED) return false;
+    if(m_write_busy) return false;
+    
+    USB_INTERRUPT_ENABLE = 0;
+    m_write_ptr  = data;
+    m_write_left = len;
+    #ifdef VENDOR_IN_ZLP
+    m_write_zlp  = (len & (VENDOR_EP_SIZE - 1u)) == 0; // A full last packet doesn't end the transfer.
+    #else
+    m_write_zlp  = len == 0;
+    #endif
+    m_write_busy = true;
+    fill_in_bds();
+    write_callbacks();
+    USB_INTERRUPT_ENABLE = 1;
+    return true;
+}
+
+bool vendor_write_busy(void)
+{
+    return m_write_busy;
+}
+
+bool vendor_read(uint8_t* data, uint16_t len)
+{
+    if(usb_get_state() != STATE_CONFIGURED) return false;
+    if(m_read_busy || len == 0) return false;
+    
+    USB_INTERRUPT_ENABLE = 0;
+    m_read_ptr   = data;
+    m_read_left  = len;
+    m_read_count = 0;
+    m_read_busy  = true;
+    read_out_bds();
+    read_callbacks();
+    USB_INTERRUPT_ENABLE = 1;
+    return true;
+}
+
+bool vendor_read_busy(void)
+{
+    return m_read_busy;
+}
+
+/* ************************************************************************** */
@@ -0,0 +1,379 @@
+/**
+ * @file usb_vendor.h
+ * @brief <i>Vendor Specific</i> bulk interface settings, structures, global variable and function declarations.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - Vendor Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_VENDOR_H
+#define USB_VENDOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_config.h"
+#include "usb_hal.h"
+#include "usb_vendor_config.h"
+
+/* ************************************************************************** */
+/* ************************** PIC16 WARNING ********************************* */
+/* ************************************************************************** */
+
+#ifdef _PIC14E
+#warning "Vendor EP Buffer addresses have been manually set for PIC16 devices."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** VENDOR EP ADDRESSES *************************** */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_1_15
+#define VENDOR_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*2))
+#elif PINGPONG_MODE == PINGPONG_0_OUT
+#define VENDOR_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*3))
+#else
+#define VENDOR_EP_BUFFERS_STARTING_ADDR (EP_BUFFERS_STARTING_ADDR + (EP0_SIZE*4))
+#endif
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+#ifdef _PIC14E
+#define VENDOR_EP_OUT_BUFFER_BASE_ADDR 0x2050
+#define VENDOR_EP_IN_BUFFER_BASE_ADDR  0x20A0
+#else
+#define VENDOR_EP_OUT_BUFFER_BASE_ADDR  VENDOR_EP_BUFFERS_STARTING_ADDR
+#define VENDOR_EP_IN_BUFFER_BASE_ADDR  (VENDOR_EP_BUFFERS_STARTING_ADDR + VENDOR_EP_SIZE)
+#endif
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#ifdef _PIC14E
+#define VENDOR_EP_OUT_EVEN_BUFFER_BASE_ADDR 0x2050
+#define VENDOR_EP_OUT_ODD_BUFFER_BASE_ADDR  0x20A0
+#define VENDOR_EP_IN_EVEN_BUFFER_BASE_ADDR  0x20F0
+#define VENDOR_EP_IN_ODD_BUFFER_BASE_ADDR   0x2140
+#else
+#define VENDOR_EP_OUT_EVEN_BUFFER_BASE_ADDR  VENDOR_EP_BUFFERS_STARTING_ADDR
+#define VENDOR_EP_OUT_ODD_BUFFER_BASE_ADDR  (VENDOR_EP_BUFFERS_STARTING_ADDR +  VENDOR_EP_SIZE)
+#define VENDOR_EP_IN_EVEN_BUFFER_BASE_ADDR  (VENDOR_EP_BUFFERS_STARTING_ADDR + (VENDOR_EP_SIZE * 2))
+#define VENDOR_EP_IN_ODD_BUFFER_BASE_ADDR   (VENDOR_EP_BUFFERS_STARTING_ADDR + (VENDOR_EP_SIZE * 3))
+#endif
+#endif
+
+#if PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+#define VENDOR_NUM_BD 2 // EVEN and ODD BDs are used in turn, so one can be armed while the other is serviced.
+#else
+#define VENDOR_NUM_BD 1
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** VENDOR EP STAT ******************************* */
+/* ************************************************************************** */
+
+#define VENDOR_EP_OUT_LAST_PPB        g_usb_ep_stat[VENDOR_EP][OUT].Last_PPB
+#define VENDOR_EP_IN_LAST_PPB         g_usb_ep_stat[VENDOR_EP][IN].Last_PPB
+#define VENDOR_EP_OUT_DATA_TOGGLE_VAL g_usb_ep_stat[VENDOR_EP][OUT].Data_Toggle_Val // DATA PID of the next OUT BD armed.
+#define VENDOR_EP_IN_DATA_TOGGLE_VAL  g_usb_ep_stat[VENDOR_EP][IN].Data_Toggle_Val  // DATA PID of the next IN BD armed.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ MICROSOFT OS 2.0 CODES ************************** */
+/* ************************************************************************** */
+
+#define MS_OS_20_DESCRIPTOR_INDEX 7 // wIndex of the MS OS 2.0 descriptor set request.
+
+// Descriptor Types
+#define MS_OS_20_SET_HEADER_DESCRIPTOR       0x00
+#define MS_OS_20_SUBSET_HEADER_CONFIGURATION 0x01
+#define MS_OS_20_SUBSET_HEADER_FUNCTION      0x02
+#define MS_OS_20_FEATURE_COMPATIBLE_ID       0x03
+#define MS_OS_20_FEATURE_REG_PROPERTY        0x04
+
+#define MS_OS_20_WINDOWS_8_1 0x06030000UL // dwWindowsVersion
+
+#define MS_OS_20_REG_MULTI_SZ 7
+
+#define BOS_PLATFORM_CAPABILITY 0x05
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ********************************* TYPES ********************************** */
+/* ************************************************************************** */
+
+#ifdef USE_MS_OS_20
+/// BOS Descriptor with the MS OS 2.0 Platform Capability
+typedef struct
+{
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t wTotalLength;
+    uint8_t  bNumDeviceCaps;
+    
+    uint8_t  bCapLength;
+    uint8_t  bCapDescriptorType;
+    uint8_t  bDevCapabilityType;
+    uint8_t  bReserved;
+    uint8_t  PlatformCapabilityUUID[16];
+    uint32_t dwWindowsVersion;
+    uint16_t wMSOSDescriptorSetTotalLength;
+    uint8_t  bMS_VendorCode;
+    uint8_t  bAltEnumCode;
+}vendor_bos_descriptor_t;
+
+/// MS OS 2.0 Descriptor Set (WinUSB Compatible ID and DeviceInterfaceGUIDs)
+typedef struct
+{
+    uint16_t wLength;
+    uint16_t wDescriptorType;
+    uint32_t dwWindowsVersion;
+    uint16_t wTotalLength;
+    
+    #ifdef VENDOR_MS_OS_20_COMPOSITE
+    uint16_t wConfigSubsetLength;
+    uint16_t wConfigSubsetType;
+    uint8_t  bConfigurationValue;
+    uint8_t  bConfigSubsetReserved;
+    uint16_t wConfigSubsetTotalLength;
+    
+    uint16_t wFunctionSubsetLength;
+    uint16_t wFunctionSubsetType;
+    uint8_t  bFirstInterface;
+    uint8_t  bFunctionSubsetReserved;
+    uint16_t wSubsetLength;
+    #endif
+    
+    uint16_t wCompatibleIdLength;
+    uint16_t wCompatibleIdType;
+    uint8_t  CompatibleID[8];
+    uint8_t  SubCompatibleID[8];
+    
+    uint16_t wPropertyLength;
+    uint16_t wPropertyType;
+    uint16_t wPropertyDataType;
+    uint16_t wPropertyNameLength;
+    uint16_t PropertyName[21];
+    uint16_t wPropertyDataLength;
+    uint16_t PropertyData[40];
+}vendor_ms_os_20_descriptor_set_t;
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ VARS FROM: usb_vendor.c ************************* */
+/* ************************************************************************** */
+
+#if PINGPONG_MODE == PINGPONG_DIS || PINGPONG_MODE == PINGPONG_0_OUT
+extern uint8_t g_vendor_ep_out[VENDOR_EP_SIZE] __at(VENDOR_EP_OUT_BUFFER_BASE_ADDR);
+extern uint8_t g_vendor_ep_in[VENDOR_EP_SIZE]  __at(VENDOR_EP_IN_BUFFER_BASE_ADDR);
+
+#else // PINGPONG_MODE == PINGPONG_1_15 || PINGPONG_MODE == PINGPONG_ALL_EP
+extern uint8_t g_vendor_ep_out_even[VENDOR_EP_SIZE] __at(VENDOR_EP_OUT_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_vendor_ep_out_odd[VENDOR_EP_SIZE]  __at(VENDOR_EP_OUT_ODD_BUFFER_BASE_ADDR);
+extern uint8_t g_vendor_ep_in_even[VENDOR_EP_SIZE]  __at(VENDOR_EP_IN_EVEN_BUFFER_BASE_ADDR);
+extern uint8_t g_vendor_ep_in_odd[VENDOR_EP_SIZE]   __at(VENDOR_EP_IN_ODD_BUFFER_BASE_ADDR);
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** VENDOR FUNCTIONS ****************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool vendor_request(void)
+ * 
+ * @brief Used to service Vendor Requests on EP0.
+ * 
+ * Answers the MS OS 2.0 descriptor set request (USE_MS_OS_20), a device to
+ * host request to the device. Other vendor requests, and this one sent the
+ * wrong way, return false, so the application can try them next.
+ * 
+ * @return Returns success (true) or failure (false) to execute the Request.
+ */
+bool vendor_request(void);
+
+/**
+ * @fn bool vendor_get_descriptor(const uint8_t** descriptor, uint16_t* size)
+ * 
+ * @brief Used to service Get Descriptor Requests for the BOS descriptor.
+ * 
+ * @param[out] descriptor The descriptor to respond with.
+ * @param[out] size Size of the response descriptor.
+ * 
+ * @return Returns success (true) or failure (false) to execute the Request.
+ */
+bool vendor_get_descriptor(const uint8_t** descriptor, uint16_t* size);
+
+/**
+ * @fn void vendor_init(void)
+ * 
+ * @brief Used to initialize the EP used by the Vendor library.
+ * 
+ * Any read or write in progress is dropped without its callback.
+ */
+void vendor_init(void);
+
+/**
+ * @fn void vendor_tasks(void)
+ * 
+ * @brief Services the Vendor bulk EP.
+ * 
+ * Transactions on other EPs are ignored.
+ */
+void vendor_tasks(void);
+
+/**
+ * @fn void vendor_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir)
+ * 
+ * @brief Clear Endpoints used by the Vendor library.
+ * 
+ * @param[in] bdt_index Buffer Descriptor Index.
+ * @param[in] ep Endpoint number.
+ * @param[in] dir Endpoint direction.
+ * 
+ * Received data not yet read, and IN packets that were armed, are dropped.
+ */
+void vendor_clear_halt(uint8_t bdt_index, uint8_t ep, uint8_t dir);
+
+/**
+ * @fn void vendor_clear_ep_toggle(void)
+ * 
+ * @brief Used to clear the Vendor EP's Data Toggle values.
+ */
+void vendor_clear_ep_toggle(void);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************** FUNCTIONS FOR MAIN **************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool vendor_write(uint8_t* data, uint16_t len)
+ * 
+ * @brief Starts sending a buffer on the Vendor bulk IN EP.
+ * 
+ * Packets are copied into the IN BDs as they free up. Once the last byte has
+ * been copied the buffer is handed back through vendor_write_done(), while its
+ * last packets are still being sent, so the next buffer can follow without a
+ * gap. Two buffers used in turn keep the EP busy. A zero length write sends a
+ * ZLP.
+ * 
+ * @param[in] data Data to send, must not change until vendor_write_done().
+ * @param[in] len Bytes to send.
+ * 
+ * @return Returns false if not configured or the last buffer hasn't been handed back.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * void vendor_write_done(void)
+ * {
+ *     m_fill ^= 1;
+ *     vendor_write(m_log[m_fill ^ 1], sizeof(m_log[0])); // Send the buffer just filled.
+ * }
+ * @endcode
+ * </li></ul>
+ */
+bool vendor_write(uint8_t* data, uint16_t len);
+
+/**
+ * @fn bool vendor_write_busy(void)
+ * 
+ * @brief Returns true while a vendor_write() buffer is still in use.
+ */
+bool vendor_write_busy(void);
+
+/**
+ * @fn bool vendor_read(uint8_t* data, uint16_t len)
+ * 
+ * @brief Starts receiving into a buffer from the Vendor bulk OUT EP.
+ * 
+ * The read finishes when the buffer is full or a short packet ends the host's
+ * transfer, then vendor_read_done() is called. A packet that doesn't fit is
+ * held in its BD, and the rest of it goes to the next read. The host is NAKed
+ * while both BDs hold data.
+ * 
+ * @param[out] data Buffer to receive into.
+ * @param[in] len Size of the buffer (1 or more).
+ * 
+ * @return Returns false if not configured, len is 0, or a read is in progress.
+ * 
+ * <b>Code Example:</b>
+ * <ul style="list-style-type:none"><li>
+ * @code
+ * void vendor_read_done(uint16_t count)
+ * {
+ *     process(m_rx, count);
+ *     vendor_read(m_rx, sizeof(m_rx));
+ * }
+ * @endcode
+ * </li></ul>
+ */
+bool vendor_read(uint8_t* data, uint16_t len);
+
+/**
+ * @fn bool vendor_read_busy(void)
+ * 
+ * @brief Returns true while a vendor_read() is in progress.
+ */
+bool vendor_read_busy(void);
+
+/**
+ * @fn void vendor_write_done(void)
+ * 
+ * @brief Application callback, the vendor_write() buffer can be used again.
+ * 
+ * Called from vendor_tasks() (ISR), or from vendor_write() when the buffer
+ * fits in the free IN BDs straight away. vendor_write() can be called from it.
+ */
+void vendor_write_done(void);
+
+/**
+ * @fn void vendor_read_done(uint16_t count)
+ * 
+ * @brief Application callback, a vendor_read() has finished.
+ * 
+ * Called from vendor_tasks() (ISR), or from vendor_read() when held data
+ * finishes it straight away. vendor_read() can be called from it.
+ * 
+ * @param count Bytes received.
+ */
+void vendor_read_done(uint16_t count);
+
+/* ************************************************************************** */
+
+#endif /* USB_VENDOR_H */
@@ -0,0 +1,261 @@
+/**
+ * @file usb_vfat.c
+ * @brief <i>Virtual FAT volume</i> generator.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MSD Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb.h"
+#include "usb_vfat.h"
+
+/* ************************************************************************** */
+/* ***************************** BOOT SECTOR ******************************** */
+/* ************************************************************************** */
+
+#define LE16(x) (uint8_t)(x), (uint8_t)((x) >> 8)
+#define LE32(x) LE16(x), LE16((uint32_t)(x) >> 16)
+
+#define BOOT_SIZE     62
+#define SIGNATURE_POS 510
+#define ENTRY_SIZE    32
+
+static const uint8_t m_boot_sector[BOOT_SIZE] =
+{
+    0xEB,0x3C,0x90,                             // jmpBoot
+    'M','S','D','O','S','5','.','0',            // OEMName
+    LE16(BYTES_PER_BLOCK_LE),                   // BytesPerSec
+    VFAT_SECTORS_PER_CLUSTER,                   // SecPerClus
+    LE16(VFAT_FAT_LBA),                         // RsvdSecCnt
+    1,                                          // NumFATs
+    LE16(VFAT_ROOT_ENTRIES),                    // RootEntCnt
+    #if VOL_CAPACITY_IN_BLOCKS < 0x10000
+    LE16(VOL_CAPACITY_IN_BLOCKS),               // TotSec16
+    #else
+    0,0,
+    #endif
+    0xF8,                                       // Media
+    LE16(VFAT_FAT_SECTORS),                     // FATSz16
+    LE16(1),                                    // SecPerTrk
+    LE16(1),                                    // NumHeads
+    0,0,0,0,                                    // HiddSec
+    #if VOL_CAPACITY_IN_BLOCKS < 0x10000
+    0,0,0,0,
+    #else
+    LE32(VOL_CAPACITY_IN_BLOCKS),               // TotSec32
+    #endif
+    0x80,                                       // DrvNum
+    0,                                          // Reserved1
+    0x29,                                       // BootSig
+    LE32(VFAT_VOLUME_ID),                       // VolID
+    VFAT_VOLUME_LABEL,                          // VolLab
+    'F','A','T','1','6',' ',' ',' '             // FilSysType
+};
+
+static const uint8_t m_volume_label[11] = {VFAT_VOLUME_LABEL};
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* *************************** LOCAL VARIABLES ****************************** */
+/* ************************************************************************** */
+
+static uint16_t m_first_cluster[VFAT_NUM_FILES + 1]; // [VFAT_NUM_FILES] is the first free cluster.
+static bool     m_laid_out; // Files fit the volume, false lists only the volume label.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ LOCAL FUNCTION DECLARATIONS ********************* */
+/* ************************************************************************** */
+
+static uint8_t file_of_cluster(uint16_t cluster);
+static void window_copy(uint8_t* p_src, uint16_t pos, uint8_t size, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+static void boot_sector(uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+static void fat_sector(uint16_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+static void root_sector(uint16_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+static void data_sector(uint32_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************* FUNCTIONS ******************************** */
+/* ************************************************************************** */
+
+bool vfat_init(void)
+{
+    uint8_t  i;
+    uint32_t cluster = 2;
+    
+    for(i = 0; i < VFAT_NUM_FILES; i++)
+    {
+        m_first_cluster[i] = (uint16_t)cluster;
+        cluster += (g_vfat_files[i].Size + VFAT_CLUSTER_BYTES - 1) / VFAT_CLUSTER_BYTES;
+        if(cluster > VFAT_CLUSTERS + 2) // Doesn't fit, show an empty volume.
+        {
+            for(i = 0; i <= VFAT_NUM_FILES; i++) m_first_cluster[i] = 2;
+            m_laid_out = false;
+            return false;
+        }
+    }
+    m_first_cluster[VFAT_NUM_FILES] = (uint16_t)cluster;
+    m_laid_out = true;
+    return true;
+}
+
+void vfat_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    usb_ram_set(0, p_buffer, bytes); // Anything not generated reads as zero.
+    
+    if(lba == 0) boot_sector(offset, p_buffer, bytes);
+    else if(lba < VFAT_ROOT_LBA) fat_sector((uint16_t)(lba - VFAT_FAT_LBA), offset, p_buffer, bytes);
+    else if(lba < VFAT_DATA_LBA) root_sector((uint16_t)(lba - VFAT_ROOT_LBA), offset, p_buffer, bytes);
+    else data_sector(lba - VFAT_DATA_LBA, offset, p_buffer, bytes);
+}
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** LOCAL FUNCTIONS ***************************** */
+/* ************************************************************************** */
+
+static uint8_t file_of_cluster(uint16_t cluster)
+{
+    uint8_t i;
+    
+    for(i = 0; i < VFAT_NUM_FILES; i++)
+    {
+        if(cluster >= m_first_cluster[i] && cluster < m_first_cluster[i + 1]) break;
+    }
+    return i; // VFAT_NUM_FILES when the cluster is free.
+}
+
+static void window_copy(uint8_t* p_src, uint16_t pos, uint8_t size, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint16_t start = pos > offset ? pos : offset;
+    uint16_t end = pos + size < offset + bytes ? pos + size : offset + bytes;
+    
+    if(start < end) usb_ram_copy(p_src + (start - pos), p_buffer + (start - offset), (uint8_t)(end - start));
+}
+
+static void boot_sector(uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    if(offset < BOOT_SIZE)
+    {
+        usb_rom_copy(m_boot_sector + offset, p_buffer, (uint8_t)(BOOT_SIZE - offset < bytes ? BOOT_SIZE - offset : bytes));
+    }
+    if(offset <= SIGNATURE_POS && offset + bytes > SIGNATURE_POS)
+    {
+        p_buffer[SIGNATURE_POS - offset] = 0x55;
+        p_buffer[SIGNATURE_POS + 1 - offset] = 0xAA;
+    }
+}
+
+static void fat_sector(uint16_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint16_t cluster = (sector * (BYTES_PER_BLOCK_LE / 2)) + (offset / 2);
+    uint16_t entry;
+    uint8_t  file = 0;
+    uint16_t i;
+    
+    for(i = 0; i < bytes; i += 2, cluster++)
+    {
+        if(cluster == 0) entry = 0xFFF8; // Media byte.
+        else if(cluster == 1) entry = 0xFFFF;
+        else if(cluster >= m_first_cluster[VFAT_NUM_FILES]) break; // Free from here on.
+        else
+        {
+            while(cluster >= m_first_cluster[file + 1]) file++;
+            if(cluster + 1 == m_first_cluster[file + 1]) entry = 0xFFFF; // End of chain.
+            else entry = cluster + 1;
+        }
+        p_buffer[i] = (uint8_t)entry;
+        p_buffer[i + 1] = (uint8_t)(entry >> 8);
+    }
+}
+
+static void root_sector(uint16_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint8_t  dir_entry[ENTRY_SIZE];
+    uint16_t pos = offset & ~(ENTRY_SIZE - 1);
+    uint16_t index = (sector * (BYTES_PER_BLOCK_LE / ENTRY_SIZE)) + (pos / ENTRY_SIZE);
+    uint16_t last = m_laid_out ? VFAT_NUM_FILES : 0; // Just the volume label if vfat_init() failed.
+    
+    for(; pos < offset + bytes && index <= last; pos += ENTRY_SIZE, index++)
+    {
+        usb_ram_set(0, dir_entry, ENTRY_SIZE);
+        if(index == 0)
+        {
+            usb_rom_copy(m_volume_label, dir_entry, 11);
+            dir_entry[11] = 0x08; // Volume ID.
+        }
+        else
+        {
+            const vfat_file_t* p_file = &g_vfat_files[index - 1];
+            uint16_t first = m_first_cluster[index - 1];
+            
+            usb_rom_copy(p_file->Name, dir_entry, 11);
+            dir_entry[11] = 0x21; // Read only, archive.
+            if(p_file->Size == 0) first = 0;
+            dir_entry[26] = (uint8_t)first;
+            dir_entry[27] = (uint8_t)(first >> 8);
+            dir_entry[28] = (uint8_t)p_file->Size;
+            dir_entry[29] = (uint8_t)(p_file->Size >> 8);
+            dir_entry[30] = (uint8_t)(p_file->Size >> 16);
+            dir_entry[31] = (uint8_t)(p_file->Size >> 24);
+        }
+        dir_entry[14] = dir_entry[22] = (uint8_t)VFAT_TIME; // CrtTime, WrtTime.
+        dir_entry[15] = dir_entry[23] = (uint8_t)(VFAT_TIME >> 8);
+        dir_entry[16] = dir_entry[18] = dir_entry[24] = (uint8_t)VFAT_DATE; // CrtDate, LstAccDate, WrtDate.
+        dir_entry[17] = dir_entry[19] = dir_entry[25] = (uint8_t)(VFAT_DATE >> 8);
+        window_copy(dir_entry, pos, ENTRY_SIZE, offset, p_buffer, bytes);
+    }
+}
+
+static void data_sector(uint32_t sector, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+{
+    uint32_t cluster = 2 + (sector / VFAT_SECTORS_PER_CLUSTER);
+    uint32_t file_offset;
+    uint32_t size;
+    uint8_t  file;
+    
+    if(cluster >= m_first_cluster[VFAT_NUM_FILES]) return;
+    file = file_of_cluster((uint16_t)cluster);
+    if(file == VFAT_NUM_FILES) return;
+    
+    file_offset = ((cluster - m_first_cluster[file]) * VFAT_CLUSTER_BYTES) + 
+                  ((sector % VFAT_SECTORS_PER_CLUSTER) * BYTES_PER_BLOCK_LE) + offset;
+    size = g_vfat_files[file].Size;
+    if(file_offset >= size) return; // Slack after the end of the file.
+    if(size - file_offset < bytes) bytes = (uint16_t)(size - file_offset);
+    g_vfat_files[file].Read(file_offset, p_buffer, bytes);
+}
+
+/* ************************************************************************** */
@@ -0,0 +1,165 @@
+/**
+ * @file usb_vfat.h
+ * @brief <i>Virtual FAT volume</i> generator.
+ * @author John Izzard
+ * @date 2026-10-18
+ * 
+ * USB uC - MSD Library.
+ * Copyright (C) 2017-2026 John Izzard
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef USB_VFAT_H
+#define USB_VFAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb_msd_config.h"
+#include "usb_vfat_config.h"
+
+/* ************************************************************************** */
+/* ***************************** VOLUME LAYOUT ****************************** */
+/* ************************************************************************** */
+
+/*
+ * A FAT16 volume is generated a sector at a time instead of being stored.
+ * Files get contiguous cluster runs in table order, so every FAT entry, 
+ * directory entry and data byte follows from arithmetic on the file table.
+ * 
+ *  LBA 0                 Boot sector
+ *  VFAT_FAT_LBA          FAT (one copy)
+ *  VFAT_ROOT_LBA         Root directory
+ *  VFAT_DATA_LBA         Cluster 2 onwards
+ */
+
+#define VFAT_CLUSTER_BYTES ((uint32_t)VFAT_SECTORS_PER_CLUSTER * BYTES_PER_BLOCK_LE)
+#define VFAT_FAT_LBA       1
+#define VFAT_FAT_SECTORS   ((((VOL_CAPACITY_IN_BLOCKS / VFAT_SECTORS_PER_CLUSTER) + 2) * 2 + BYTES_PER_BLOCK_LE - 1) / BYTES_PER_BLOCK_LE)
+#define VFAT_ROOT_LBA      (VFAT_FAT_LBA + VFAT_FAT_SECTORS)
+#define VFAT_ROOT_SECTORS  ((VFAT_ROOT_ENTRIES * 32) / BYTES_PER_BLOCK_LE)
+#define VFAT_DATA_LBA      (VFAT_ROOT_LBA + VFAT_ROOT_SECTORS)
+#define VFAT_CLUSTERS      ((VOL_CAPACITY_IN_BLOCKS - VFAT_DATA_LBA) / VFAT_SECTORS_PER_CLUSTER)
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* **************************** SETTING CHECKS ****************************** */
+/* ************************************************************************** */
+
+#if VFAT_SECTORS_PER_CLUSTER & (VFAT_SECTORS_PER_CLUSTER - 1)
+#error "VFAT_SECTORS_PER_CLUSTER must be a power of 2."
+#endif
+
+#if VFAT_CLUSTERS < 4085 || VFAT_CLUSTERS > 65524
+#error "VOL_CAPACITY_IN_BLOCKS / VFAT_SECTORS_PER_CLUSTER must give 4085 to 65524 clusters for FAT16."
+#endif
+
+#if (VFAT_ROOT_ENTRIES % 16) || VFAT_ROOT_ENTRIES < (VFAT_NUM_FILES + 1)
+#error "VFAT_ROOT_ENTRIES must be a multiple of 16, with room for the volume label and every file."
+#endif
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ******************************** TYPES *********************************** */
+/* ************************************************************************** */
+
+/**
+ * @brief Called to fill part of a file.
+ * 
+ * @param offset Byte offset into the file.
+ * @param p_buffer Where the bytes go.
+ * @param bytes Number of bytes, never past the end of the file.
+ */
+typedef void (*vfat_read_t)(uint32_t offset, uint8_t* p_buffer, uint16_t bytes);
+
+/** File Table Entry */
+typedef struct
+{
+    uint8_t     Name[11]; ///< 8.3 name, space padded, no dot. e.g. "HELLO   TXT".
+    uint32_t    Size;     ///< Size in bytes.
+    vfat_read_t Read;     ///< Supplies the contents.
+}vfat_file_t;
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ EXTERNAL FILE TABLE ***************************** */
+/* ************************************************************************** */
+
+extern const vfat_file_t g_vfat_files[VFAT_NUM_FILES]; // Found in the application.
+
+/* ************************************************************************** */
+
+
+/* ************************************************************************** */
+/* ************************ FUNCTION DECLARATIONS *************************** */
+/* ************************************************************************** */
+
+/**
+ * @fn bool vfat_init(void)
+ * 
+ * @brief Lays the files out in clusters.
+ * 
+ * Call once before usb_init(). Only one cluster number per file is kept in 
+ * RAM, the FAT itself is never stored.
+ * 
+ * @return Returns false if the files don't fit in the volume, it then shows 
+ *         empty (just the volume label).
+ * 
+ * <b>Code Example:</b>
+ * @code
+ * if(!vfat_init()) while(1){} // Shrink the files or grow the volume.
+ * usb_init();
+ * @endcode
+ */
+bool vfat_init(void);
+
+/**
+ * @fn void vfat_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes)
+ * 
+ * @brief Generates part of a volume sector.
+ * 
+ * @param lba Sector number.
+ * @param offset Byte offset into the sector.
+ * @param p_buffer Where the bytes go.
+ * @param bytes Number of bytes, even and within the sector.
+ * 
+ * <b>Code Example:</b>
+ * @code
+ * void msd_rx_sector(void)
+ * {
+ *     #ifdef MSD_LIMITED_RAM
+ *     vfat_read(g_msd_rw_10_vars.LBA, g_msd_byte_of_sect, g_msd_ep_in, MSD_EP_SIZE);
+ *     #else
+ *     vfat_read(g_msd_rw_10_vars.LBA, 0, g_msd_sect_data, BYTES_PER_BLOCK_LE);
+ *     #endif
+ * }
+ * @endcode
+ */
+void vfat_read(uint32_t lba, uint16_t offset, uint8_t* p_buffer, uint16_t bytes);
+
+/* ************************************************************************** */
+
+#endif /* USB_VFAT_H */